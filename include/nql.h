@@ -0,0 +1,56 @@
+#ifndef NQL_H
+#define NQL_H
+
+/*
+ * API pública de NQL para usar la base de datos desde C.
+ *
+ * Ejemplo:
+ *   nql_init();
+ *   nql_stmt *stmt = nql_prepare("INSERT INTO usuarios VALUES (?, ?)");
+ *   nql_bind_int(stmt, 1, 1);
+ *   nql_bind_string(stmt, 2, "Ana");
+ *   nql_execute(stmt);
+ *   nql_finalize(stmt);
+ *   nql_shutdown();
+ *
+ * Las funciones que devuelven int devuelven 0 si tuvieron éxito y -1 si hubo error.
+ * Los índices de los parámetros empiezan en 1.
+ */
+
+// Sentencia preparada (opaca)
+typedef struct nql_stmt nql_stmt;
+
+// Inicializa y libera la base de datos
+int nql_init(void);
+void nql_shutdown(void);
+
+// Ejecuta una sentencia SELECT, INSERT, UPDATE, DELETE, BEGIN, COMMIT o ROLLBACK sin
+// prepararla (los planes se reutilizan entre sentencias que solo difieren en sus literales)
+int nql_exec(const char *sql);
+
+// Prepara una sentencia SELECT, INSERT, UPDATE o DELETE (NULL si hay error)
+nql_stmt *nql_prepare(const char *sql);
+
+// Mensaje del último error producido por la API en el hilo que la llama
+const char *nql_last_error(void);
+
+// Número de parámetros '?' de la sentencia
+int nql_param_count(const nql_stmt *stmt);
+
+// Enlaza valores a los parámetros por posición
+int nql_bind_int(nql_stmt *stmt, int index, int value);
+int nql_bind_float(nql_stmt *stmt, int index, double value);
+int nql_bind_string(nql_stmt *stmt, int index, const char *value);
+int nql_bind_bool(nql_stmt *stmt, int index, int value);
+int nql_bind_null(nql_stmt *stmt, int index);
+
+// Ejecuta la sentencia con los valores enlazados
+int nql_execute(nql_stmt *stmt);
+
+// Restablece todos los parámetros a NULL
+void nql_clear_bindings(nql_stmt *stmt);
+
+// Libera la sentencia
+void nql_finalize(nql_stmt *stmt);
+
+#endif /* NQL_H */
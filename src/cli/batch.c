@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include "batch.h"
+#include "cli.h"
+#include "input_handler.h"
+#include "commands/cmd_registry.h"
+#include "../parser/lexer.h"
+#include "../utils/timing.h"
+
+// Entrada leída por bloques: los bytes aún sin usar están en [start, end)
+typedef struct {
+    int fd;
+    char *data;
+    size_t start;
+    size_t end;
+    size_t searched;          // Hasta dónde se ha buscado ya el fin de línea
+    size_t capacity;
+    int eof;
+    int failed;               // Falló la lectura o faltó memoria
+} BatchInput;
+
+// Sentencia que ocupa varias líneas
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} BatchStatement;
+
+// Lee el siguiente bloque de la entrada (0 si leyó algo, -1 al final o si hubo error)
+static int batch_fill(BatchInput *in) {
+    // La línea a medias pasa al principio del bloque
+    if (in->start > 0) {
+        memmove(in->data, in->data + in->start, in->end - in->start);
+        in->end -= in->start;
+        in->searched -= in->start;
+        in->start = 0;
+    }
+
+    // Una línea que no cabe en el bloque lo hace crecer
+    if (in->end == in->capacity) {
+        char *grown = (char *)realloc(in->data, in->capacity * 2);
+        if (!grown) {
+            in->failed = 1;
+            in->eof = 1;
+            return -1;
+        }
+        in->data = grown;
+        in->capacity *= 2;
+    }
+
+    ssize_t got;
+    do {
+        got = read(in->fd, in->data + in->end, in->capacity - in->end);
+    } while (got < 0 && errno == EINTR);
+
+    if (got <= 0) {
+        if (got < 0) in->failed = 1;
+        in->eof = 1;
+        return -1;
+    }
+    in->end += got;
+    return 0;
+}
+
+// Devuelve la siguiente línea con su '\n' (la última puede no tenerlo) o NULL al final.
+// La línea sigue siendo válida hasta la siguiente llamada.
+static char *batch_next_line(BatchInput *in, size_t *length) {
+    while (1) {
+        char *newline = (char *)memchr(in->data + in->searched, '\n', in->end - in->searched);
+        if (newline) {
+            char *line = in->data + in->start;
+            *length = newline + 1 - line;
+            in->start += *length;
+            in->searched = in->start;
+            return line;
+        }
+        in->searched = in->end;
+        if (in->eof || batch_fill(in) != 0) break;
+    }
+
+    if (in->start == in->end) return NULL;
+
+    char *line = in->data + in->start;
+    *length = in->end - in->start;
+    in->start = in->end;
+    in->searched = in->end;
+    return line;
+}
+
+// Añade texto a la sentencia (0 si tuvo éxito, -1 si faltó memoria)
+static int statement_append(BatchStatement *statement, const char *text, size_t length) {
+    size_t needed = statement->length + length + 1;
+    if (needed > statement->capacity) {
+        size_t capacity = statement->capacity == 0 ? 4096 : statement->capacity;
+        while (capacity < needed) capacity *= 2;
+        char *grown = (char *)realloc(statement->data, capacity);
+        if (!grown) return -1;
+        statement->data = grown;
+        statement->capacity = capacity;
+    }
+
+    memcpy(statement->data + statement->length, text, length);
+    statement->length += length;
+    statement->data[statement->length] = '\0';
+    return 0;
+}
+
+// Ejecuta las sentencias SQL acumuladas
+static int batch_flush(BatchStatement *script) {
+    if (script->length == 0) return 0;
+
+    int status = cmd_sql_script(script->data);
+    script->length = 0;
+    return status;
+}
+
+// Ejecuta una sentencia completa (entry es el comando con el que empieza). Las que se
+// ejecutan con cmd_sql_statement se acumulan en script para analizarlas y ejecutarlas
+// juntas (salvo con \timing, que mide cada una); cualquier otra ejecuta antes lo acumulado.
+static int batch_statement(BatchStatement *script, const CommandEntry *entry,
+                           const char *text, size_t length) {
+    if (entry && entry->sql_function == cmd_sql_statement && !timing_is_enabled()) {
+        // El salto de línea cierra un posible comentario al final de la sentencia
+        if (statement_append(script, text, length) != 0 || statement_append(script, "\n;", 2) != 0) {
+            printf("Error: Memoria insuficiente para leer el script\n");
+            return -1;
+        }
+        return script->length >= BATCH_READ_SIZE ? batch_flush(script) : 0;
+    }
+
+    int status = batch_flush(script);
+    char *command = strndup(text, length);
+    status |= command ? cli_execute(command) : -1;
+    free(command);
+    return status;
+}
+
+// Comando registrado con el que empieza el texto (su nombre tiene una o dos palabras)
+static const CommandEntry *batch_command(const char *text, size_t length) {
+    char name[MAX_COMMAND_LENGTH];
+    size_t used = 0;
+    size_t pos = 0;
+
+    for (int words = 0; words < 2; words++) {
+        while (pos < length && (text[pos] == ' ' || text[pos] == '\t')) pos++;
+
+        size_t start = pos;
+        while (pos < length && !isspace((unsigned char)text[pos]) && text[pos] != ';') pos++;
+        if (pos == start || used + 1 + (pos - start) >= sizeof(name)) return NULL;
+
+        if (words > 0) name[used++] = ' ';
+        memcpy(name + used, text + start, pos - start);
+        used += pos - start;
+        name[used] = '\0';
+
+        const CommandEntry *entry = cmd_get_entry(name);
+        if (entry) return entry;
+    }
+    return NULL;
+}
+
+// Pasa una sentencia completa al manejador: devuelve -1 si falló y marca finished
+// si el manejador pidió dejar de leer
+static int batch_handle(BatchHandler handler, void *ctx, const CommandEntry *entry,
+                        const char *text, size_t length, int *finished) {
+    int status = handler(ctx, entry, text, length);
+    if (status < 0) *finished = 1;
+    return status == 0 ? 0 : -1;
+}
+
+int batch_split(int fd, BatchHandler handler, void *ctx) {
+    BatchInput in = {fd, (char *)malloc(BATCH_READ_SIZE), 0, 0, 0, BATCH_READ_SIZE, 0, 0};
+    if (!in.data) {
+        printf("Error: Memoria insuficiente para leer el script\n");
+        return -1;
+    }
+
+    BatchStatement pending = {NULL, 0, 0};
+    const CommandEntry *pending_entry = NULL;    // Comando con el que empieza la sentencia
+    LexerScan scan = {LEXER_SCAN_CODE, 0};
+    int status = 0;
+    int finished = 0;
+    char *line;
+    size_t length;
+
+    while (!finished && (line = batch_next_line(&in, &length))) {
+        // Una sentencia sin ';' termina donde empieza el siguiente comando
+        if (scan.has_tokens && scan.state == LEXER_SCAN_CODE && batch_command(line, length)) {
+            status |= batch_handle(handler, ctx, pending_entry, pending.data, pending.length, &finished);
+            pending.length = 0;
+            scan.has_tokens = 0;
+        }
+
+        size_t pos = 0;
+        while (!finished && pos < length) {
+            // Los comandos que no son SQL ocupan el resto de la línea (o hasta un ';')
+            const CommandEntry *entry = NULL;
+            if (!scan.has_tokens && scan.state == LEXER_SCAN_CODE) {
+                entry = batch_command(line + pos, length - pos);
+                pending_entry = entry;
+            }
+            if (entry && !entry->sql_function) {
+                size_t end = pos + lexer_scan_statement(line + pos, length - pos, &scan);
+                scan.state = LEXER_SCAN_CODE;
+                scan.has_tokens = 0;
+
+                if (strcmp(entry->name, "exit") == 0) {
+                    finished = 1;
+                    break;
+                }
+
+                status |= batch_handle(handler, ctx, entry, line + pos, end - pos, &finished);
+                pos = end + 1;
+                continue;
+            }
+
+            size_t end = pos + lexer_scan_statement(line + pos, length - pos, &scan);
+            if (end == length) {
+                // La sentencia sigue en la línea siguiente
+                if (scan.has_tokens && statement_append(&pending, line + pos, length - pos) != 0) {
+                    in.failed = 1;
+                    finished = 1;
+                }
+                break;
+            }
+
+            // Sentencia completa: si empezó en esta línea se toma sin copiarla
+            if (pending.length == 0) {
+                if (scan.has_tokens) {
+                    status |= batch_handle(handler, ctx, pending_entry, line + pos, end - pos, &finished);
+                }
+            } else if (statement_append(&pending, line + pos, end - pos) == 0) {
+                status |= batch_handle(handler, ctx, pending_entry, pending.data, pending.length, &finished);
+                pending.length = 0;
+            } else {
+                in.failed = 1;
+                finished = 1;
+                break;
+            }
+            scan.has_tokens = 0;
+            pos = end + 1;
+        }
+    }
+
+    // La última sentencia puede no tener ';'
+    if (!finished && scan.has_tokens) {
+        status |= batch_handle(handler, ctx, pending_entry, pending.data, pending.length, &finished);
+    }
+
+    if (in.failed) {
+        printf("Error: No se pudo leer el script completo\n");
+        status = -1;
+    }
+
+    free(pending.data);
+    free(in.data);
+    return status == 0 ? 0 : -1;
+}
+
+// Pasa cada sentencia del script a batch_statement
+static int batch_run_statement(void *ctx, const CommandEntry *entry, const char *text, size_t length) {
+    return batch_statement((BatchStatement *)ctx, entry, text, length) == 0 ? 0 : 1;
+}
+
+int batch_run(int fd) {
+    BatchStatement script = {NULL, 0, 0};
+    int status = batch_split(fd, batch_run_statement, &script);
+    status |= batch_flush(&script);
+
+    free(script.data);
+    return status == 0 ? 0 : -1;
+}
@@ -0,0 +1,27 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include "commands/cmd_registry.h"
+
+// Bytes que se leen de una vez de un script (las líneas más largas hacen crecer el bloque)
+#define BATCH_READ_SIZE (1024 * 1024)
+
+// Ejecuta un script leído de fd hasta el final o hasta "exit", sin readline ni historial.
+// Las sentencias SQL terminan en ';' (fuera de cadenas y comentarios) y pueden ocupar
+// varias líneas; una sentencia sin ';' termina donde empieza otra línea con un comando.
+// Los demás comandos (CREATE TABLE, \format, help...) ocupan una línea.
+// Devuelve 0 si todo tuvo éxito y -1 si falló alguna sentencia o la lectura.
+int batch_run(int fd);
+
+// Recibe cada sentencia de un script sin su ';' (entry es el comando con el que empieza,
+// NULL si no es ninguno; text no acaba en '\0'). Devuelve 0 si tuvo éxito, 1 si la
+// sentencia falló y -1 para dejar de leer el script.
+typedef int (*BatchHandler)(void *ctx, const CommandEntry *entry, const char *text, size_t length);
+
+// Divide un script leído de fd con las mismas reglas que batch_run, pero en lugar de
+// ejecutar las sentencias las pasa a handler. Se detiene en "exit" (sin pasarlo).
+// Devuelve 0 si todas tuvieron éxito y -1 si falló alguna, la lectura o handler paró.
+int batch_split(int fd, BatchHandler handler, void *ctx);
+
+#endif
@@ -4,6 +4,10 @@
 #include "cli.h"
 #include "input_handler.h"
 #include "commands/cmd_registry.h"
+#include "../executor/prepared.h"
+#include "../executor/plan_cache.h"
+#include "../executor/transaction.h"
+#include "../utils/scheduler.h"
 
 // Inicializa la CLI
 void cli_init() {
@@ -11,6 +15,20 @@ void cli_init() {
     cmd_registry_init();
 }
 
+// Ejecuta una línea de entrada
+int cli_execute(char *input) {
+    char command[MAX_COMMAND_LENGTH];
+    char *args[MAX_ARGS] = {NULL};
+    int arg_count = 0;
+
+    input_parse(input, command, args, &arg_count);
+    if (strlen(command) == 0) return 0;
+
+    int status = cmd_execute_input(command, input, args, arg_count) == 0 ? 0 : -1;
+    input_cleanup_args(args, &arg_count);
+    return status;
+}
+
 // Ejecuta el bucle principal
 void cli_run() {
     char *input;
@@ -38,18 +56,24 @@ void cli_run() {
         if (strlen(command) > 0) {
             if (strcmp(command, "exit") == 0) {
                 printf("Goodbye!\n");
+                input_cleanup_args(args, &arg_count);
                 free(input);
                 break;
             } else {
-                cmd_execute(command, args, arg_count);
+                cmd_execute_input(command, input, args, arg_count);
             }
         }
         
+        input_cleanup_args(args, &arg_count);
         free(input);
     }
 }
 
 void cli_cleanup() {
+    transaction_cleanup();
     input_cleanup();
     cmd_registry_cleanup();
+    prepared_cleanup();
+    plan_cache_cleanup();
+    scheduler_shutdown();
 }
\ No newline at end of file
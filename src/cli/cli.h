@@ -7,6 +7,10 @@ void cli_init();
 // Ejecuta el bucle principal de la CLI
 void cli_run();
 
+// Ejecuta una línea de entrada: un comando o una sentencia SQL completa
+// (0 si tuvo éxito, -1 si hubo error)
+int cli_execute(char *input);
+
 // Limpia los recursos de la CLI
 void cli_cleanup();
 
@@ -3,6 +3,8 @@
 #include <string.h>
 #include "../cli.h"
 #include "cmd_registry.h"
+#include "../../utils/output.h"
+#include "../../utils/timing.h"
 
 // Declaraciones de funciones de comandos
 // Comandos de ayuda
@@ -14,18 +16,24 @@ int cmd_clear(char *args[], int arg_count);
 int cmd_create_table(char *args[], int arg_count);
 int cmd_alter_table(char *args[], int arg_count);
 int cmd_describe(char *args[], int arg_count);
+int cmd_analyze(char *args[], int arg_count);
 
 // Comandos de datos
-int cmd_insert(char *args[], int arg_count);
-int cmd_select(char *args[], int arg_count);
-int cmd_delete(char *args[], int arg_count);
-int cmd_update(char *args[], int arg_count);
-int cmd_count(char *args[], int arg_count);
+int cmd_count(const char *sql);
 
 // Comandos utilitarios
 int cmd_add(char *args[], int arg_count);
 int cmd_subtract(char *args[], int arg_count);
 int cmd_multiply(char *args[], int arg_count);
+int cmd_format(char *args[], int arg_count);
+int cmd_timing(char *args[], int arg_count);
+
+// Comandos SQL (reciben la sentencia completa)
+int cmd_sql_statement(const char *sql);
+int cmd_prepare(const char *sql);
+int cmd_execute_prepared(const char *sql);
+int cmd_deallocate(const char *sql);
+int cmd_explain(const char *sql);
 
 // Textos de ayuda detallados
 static const char *help_create_table = 
@@ -57,38 +65,60 @@ static const char *help_alter_table =
 
 static const char *help_insert = 
     "\n══════════ Ayuda: INSERT INTO ══════════\n\n"
-    "Sintaxis: INSERT INTO nombre_tabla VALUES (valor1, valor2, ...)\n\n"
-    "Función: Inserta una nueva fila en la tabla con los valores especificados.\n\n"
+    "Sintaxis: INSERT INTO nombre_tabla VALUES (valor1, valor2, ...) [, (valor1, valor2, ...) ...]\n\n"
+    "Función: Inserta una o varias filas en la tabla con los valores especificados.\n\n"
     "Notas:\n"
     "  - Los valores de texto deben ir entre comillas dobles.\n"
     "  - El número de valores debe coincidir con el número de columnas.\n"
-    "  - Los valores deben estar en el mismo orden que las columnas.\n\n"
-    "Ejemplo:\n"
+    "  - Los valores deben estar en el mismo orden que las columnas.\n"
+    "  - Si alguna fila no es válida no se inserta ninguna.\n\n"
+    "Ejemplos:\n"
     "  NQL> INSERT INTO usuarios VALUES (1, \"Juan Pérez\", 25, \"M\")\n"
-    "  1 fila insertada en usuarios\n\n"
+    "  1 fila insertada en usuarios\n"
+    "  NQL> INSERT INTO usuarios VALUES (2, \"Ana\", 30, \"F\"), (3, \"Luis\", 41, \"M\")\n"
+    "  2 filas insertadas en usuarios\n\n"
     "Para ver qué columnas tiene una tabla, use: DESCRIBE nombre_tabla";
 
 static const char *help_select = 
     "\n══════════ Ayuda: SELECT ══════════\n\n"
-    "Sintaxis: SELECT * FROM nombre_tabla\n\n"
-    "Función: Muestra todos los datos almacenados en una tabla.\n\n"
-    "Nota: Actualmente solo se admite SELECT * (todas las columnas).\n\n"
+    "Sintaxis: SELECT [*|columna1, columna2, ...] FROM nombre_tabla\n"
+    "          [JOIN otra_tabla ON tabla.columna = otra_tabla.columna] [WHERE condición]\n"
+    "          [GROUP BY columna1, columna2, ...] [ORDER BY columna [ASC|DESC], ...]\n"
+    "          [LIMIT n [OFFSET m]]\n\n"
+    "Función: Muestra los datos de una tabla que cumplen la condición.\n\n"
+    "La condición admite comparaciones (=, !=, <, >, <=, >=), operaciones\n"
+    "aritméticas y los operadores AND, OR y NOT.\n\n"
+    "Funciones de agregación: COUNT(*), COUNT(columna), SUM, MIN, MAX y AVG.\n"
+    "Con GROUP BY se muestra una fila por grupo; las columnas sin agregar\n"
+    "deben aparecer en GROUP BY. SUM de una columna INT da error si el total\n"
+    "no cabe en un INT. Sin filas, SUM, AVG, MIN y MAX de columnas numéricas\n"
+    "devuelven 0 (solo las columnas STRING pueden ser NULL).\n\n"
+    "ORDER BY ordena por una o varias columnas (ascendente por defecto) y\n"
+    "LIMIT/OFFSET muestran solo una página del resultado.\n\n"
+    "JOIN une las filas de dos tablas con el mismo valor en las columnas de ON;\n"
+    "las columnas se pueden calificar como tabla.columna.\n\n"
     "Ejemplo:\n"
-    "  NQL> SELECT * FROM usuarios\n"
-    "  +----+------------+-----+--------+\n"
-    "  | id | nombre     | edad| genero |\n"
-    "  +----+------------+-----+--------+\n"
-    "  | 1  | Juan Pérez | 25  | M      |\n"
-    "  | 2  | Ana López  | 30  | F      |\n"
-    "  +----+------------+-----+--------+\n"
-    "  2 filas en total";
+    "  NQL> SELECT nombre, edad FROM usuarios WHERE edad > 18\n"
+    "  +------------+-----+\n"
+    "  | nombre     | edad|\n"
+    "  +------------+-----+\n"
+    "  | Juan Pérez | 25  |\n"
+    "  | Ana López  | 30  |\n"
+    "  +------------+-----+\n"
+    "  2 filas en total\n"
+    "  NQL> SELECT sexo, COUNT(*), AVG(edad) FROM usuarios GROUP BY sexo\n"
+    "  NQL> SELECT * FROM usuarios ORDER BY edad DESC LIMIT 20 OFFSET 40\n"
+    "  NQL> SELECT nombre, total FROM usuarios JOIN pedidos ON usuarios.id = pedidos.usuario";
 
 static const char *help_delete = 
     "\n══════════ Ayuda: DELETE FROM ══════════\n\n"
-    "Sintaxis: DELETE FROM nombre_tabla WHERE rowid = índice\n\n"
-    "Función: Elimina una fila específica de la tabla.\n\n"
-    "Nota: Actualmente solo se permite eliminar por índice de fila.\n\n"
-    "Ejemplo:\n"
+    "Sintaxis: DELETE FROM nombre_tabla [WHERE condición]\n\n"
+    "Función: Elimina las filas de la tabla que cumplen la condición.\n\n"
+    "Nota: La pseudocolumna rowid contiene la posición de cada fila (desde 0).\n"
+    "Al eliminar una fila, las siguientes pasan a tener un rowid menos.\n\n"
+    "Ejemplos:\n"
+    "  NQL> DELETE FROM usuarios WHERE edad < 18\n"
+    "  2 filas eliminadas de usuarios\n\n"
     "  NQL> DELETE FROM usuarios WHERE rowid = 1\n"
     "  1 fila eliminada de usuarios";
 
@@ -109,22 +139,48 @@ static const char *help_describe =
     "  +------------+--------------+------------+-------------+\n"
     "  4 columnas en tabla";
 
+static const char *help_analyze = 
+    "\n══════════ Ayuda: ANALYZE ══════════\n\n"
+    "Sintaxis: ANALYZE nombre_tabla\n\n"
+    "Función: Calcula las estadísticas de una tabla y las guarda en el catálogo:\n"
+    "número de filas y, por columna, fracción de nulos, valores distintos\n"
+    "(estimados con HyperLogLog), mínimo, máximo y un histograma de igual\n"
+    "profundidad calculado sobre una muestra de la tabla.\n\n"
+    "EXPLAIN las usa para estimar cuántas filas cumplen el filtro de cada recorrido.\n"
+    "No se actualizan solas: vuelva a ejecutar ANALYZE tras cambiar muchas filas.\n"
+    "Solo las columnas STRING distinguen NULL; en las demás la fracción de nulos es 0.\n\n"
+    "Ejemplo:\n"
+    "  NQL> ANALYZE usuarios\n"
+    "  Tabla analizada: usuarios (2 filas)\n"
+    "  +------------+---------+-----------+--------------+--------------+------------+\n"
+    "  | Columna    | Nulos   | Distintos | Mínimo       | Máximo       | Intervalos |\n"
+    "  +------------+---------+-----------+--------------+--------------+------------+\n"
+    "  | id         |   0.00% |         2 | 1            | 2            |          2 |\n"
+    "  | nombre     |   0.00% |         2 | Ana López    | Juan Pérez   |          2 |\n"
+    "  +------------+---------+-----------+--------------+--------------+------------+";
+
 static const char *help_update = 
     "\n══════════ Ayuda: UPDATE ══════════\n\n"
-    "Sintaxis: UPDATE nombre_tabla SET columna = valor WHERE rowid = índice\n\n"
-    "Función: Actualiza el valor de una celda específica en una tabla.\n\n"
-    "Nota: Actualmente solo se permite actualizar por índice de fila.\n\n"
-    "Ejemplo:\n"
+    "Sintaxis: UPDATE nombre_tabla SET columna = expresión [, ...] [WHERE condición]\n\n"
+    "Función: Actualiza las filas de la tabla que cumplen la condición.\n\n"
+    "Nota: La pseudocolumna rowid contiene la posición de cada fila (desde 0).\n"
+    "Una fila actualizada pasa al final de la tabla y cambia de rowid.\n\n"
+    "Ejemplos:\n"
+    "  NQL> UPDATE usuarios SET edad = edad + 1 WHERE nombre = \"Ana López\"\n"
+    "  1 fila actualizada en usuarios\n\n"
     "  NQL> UPDATE usuarios SET edad = 26 WHERE rowid = 0\n"
     "  1 fila actualizada en usuarios";
 
 static const char *help_count = 
     "\n══════════ Ayuda: COUNT ══════════\n\n"
-    "Sintaxis: COUNT FROM nombre_tabla\n\n"
-    "Función: Cuenta el número de filas en una tabla.\n\n"
-    "Ejemplo:\n"
+    "Sintaxis: COUNT FROM nombre_tabla [WHERE condición]\n\n"
+    "Función: Cuenta las filas de una tabla que cumplen la condición.\n\n"
+    "Ejemplos:\n"
     "  NQL> COUNT FROM usuarios\n"
-    "  Cantidad de registros en usuarios: 2";
+    "  Cantidad de registros en usuarios: 2\n"
+    "  NQL> COUNT FROM usuarios WHERE edad > 30\n"
+    "  Cantidad de registros en usuarios: 1\n\n"
+    "Para contar por grupos use SELECT COUNT(*) ... GROUP BY columna";
 
 static const char *help_utils = 
     "\n══════════ Ayuda: Comandos Utilitarios ══════════\n\n"
@@ -139,7 +195,129 @@ static const char *help_utils =
     "    Multiplica los números proporcionados\n"
     "    Ejemplo: multiply 2 3 4  ->  Resultado: 24";
 
-#define MAX_COMMANDS 30
+static const char *help_prepare = 
+    "\n══════════ Ayuda: PREPARE ══════════\n\n"
+    "Sintaxis: PREPARE nombre AS sentencia\n\n"
+    "Función: Analiza, valida y compila una sentencia SELECT, INSERT, UPDATE\n"
+    "o DELETE una sola vez para ejecutarla después con EXECUTE.\n\n"
+    "Use '?' en lugar de los valores que cambian entre ejecuciones.\n\n"
+    "Ejemplo:\n"
+    "  NQL> PREPARE ins AS INSERT INTO usuarios VALUES (?, ?, ?, ?)\n"
+    "  Sentencia preparada: ins (4 parámetros)";
+
+static const char *help_execute = 
+    "\n══════════ Ayuda: EXECUTE ══════════\n\n"
+    "Sintaxis: EXECUTE nombre [(valor1, valor2, ...)]\n\n"
+    "Función: Ejecuta una sentencia preparada enlazando los valores a los\n"
+    "parámetros '?' por posición.\n\n"
+    "Ejemplo:\n"
+    "  NQL> EXECUTE ins (1, \"Juan Pérez\", 25, \"M\")\n"
+    "  1 fila insertada en usuarios";
+
+static const char *help_deallocate = 
+    "\n══════════ Ayuda: DEALLOCATE ══════════\n\n"
+    "Sintaxis: DEALLOCATE [PREPARE] nombre\n\n"
+    "Función: Elimina una sentencia preparada.\n\n"
+    "Ejemplo:\n"
+    "  NQL> DEALLOCATE ins\n"
+    "  Sentencia preparada eliminada: ins";
+
+static const char *help_transaction = 
+    "\n══════════ Ayuda: BEGIN / COMMIT / ROLLBACK ══════════\n\n"
+    "Sintaxis: BEGIN [TRANSACTION]\n"
+    "          COMMIT\n"
+    "          ROLLBACK\n\n"
+    "Función: Agrupa varias sentencias INSERT, UPDATE y DELETE en una transacción.\n"
+    "COMMIT confirma todos sus cambios a la vez y ROLLBACK los deshace.\n\n"
+    "Notas:\n"
+    "  - Las consultas de la transacción ven sus propios cambios; las demás no\n"
+    "    los ven hasta COMMIT.\n"
+    "  - Las tablas modificadas quedan bloqueadas para otras escrituras hasta\n"
+    "    terminar la transacción; una escritura de otra sesión espera como mucho\n"
+    "    5 segundos y falla.\n"
+    "  - Mientras haya una transacción abierta, CREATE TABLE, ALTER TABLE y ANALYZE\n"
+    "    de otras sesiones esperan como mucho 5 segundos y fallan.\n"
+    "  - Si una sentencia falla solo se deshace esa sentencia.\n"
+    "  - No se pueden crear ni modificar tablas dentro de una transacción.\n\n"
+    "Ejemplo:\n"
+    "  NQL> BEGIN\n"
+    "  Transacción iniciada\n"
+    "  NQL> UPDATE cuentas SET saldo = saldo - 50 WHERE id = 1\n"
+    "  1 fila actualizada en cuentas\n"
+    "  NQL> UPDATE cuentas SET saldo = saldo + 50 WHERE id = 2\n"
+    "  1 fila actualizada en cuentas\n"
+    "  NQL> COMMIT\n"
+    "  Transacción confirmada (2 filas modificadas)";
+
+static const char *help_explain = 
+    "\n══════════ Ayuda: EXPLAIN ══════════\n\n"
+    "Sintaxis: EXPLAIN [ANALYZE] sentencia\n\n"
+    "Función: Muestra el árbol de operadores con el que se ejecuta una sentencia\n"
+    "SELECT, INSERT, UPDATE o DELETE: tipo de recorrido (secuencial, paralelo por\n"
+    "morsels o Top-N), filtro del WHERE, índice usado, método del JOIN (hash o merge)\n"
+    "con el recorrido de cada una de sus tablas, agregación, ordenación y límite.\n\n"
+    "Con ANALYZE la sentencia se ejecuta sin escribir su resultado y cada operador\n"
+    "muestra las filas que produjo, las que leyó, sus lotes (morsels o lotes del JOIN)\n"
+    "y su propio tiempo; el de los recorridos de las tablas de un JOIN va incluido en\n"
+    "el del JOIN. Un INSERT, UPDATE o DELETE con ANALYZE sí modifica la tabla.\n\n"
+    "Sin ANALYZE no se recorren las tablas: si desde su último cambio ningún JOIN ha\n"
+    "comprobado si están ordenadas por la clave, el método aparece como \"Hash o merge\"\n"
+    "y se decide al ejecutar.\n\n"
+    "Ejemplo:\n"
+    "  NQL> EXPLAIN ANALYZE SELECT nombre FROM usuarios WHERE edad > 30 ORDER BY edad LIMIT 5\n"
+    "  -> Resultado  (filas: 5, leídas: 5, tiempo: 0.020 ms)\n"
+    "       Límite: LIMIT 5 OFFSET 0\n"
+    "     -> Top-N secuencial de usuarios (k = 5)  (filas: 5, leídas: 120, tiempo: 0.015 ms)\n"
+    "          Orden: edad ASC\n"
+    "          Filtro: (edad > 30)\n"
+    "          Índice: ninguno\n"
+    "  Tiempo de ejecución: 0.041 ms";
+
+static const char *help_format = 
+    "\n══════════ Ayuda: \\format ══════════\n\n"
+    "Sintaxis: \\format [table|csv|tsv|jsonl|binary]\n\n"
+    "Función: Cambia el formato en que se escriben los resultados de las consultas\n"
+    "en esta sesión. Sin argumentos muestra el formato actual.\n\n"
+    "Formatos:\n"
+    "  - table   (tabla con bordes, por defecto)\n"
+    "  - csv     (cabecera y valores separados por comas, RFC 4180)\n"
+    "  - tsv     (cabecera y valores separados por tabuladores)\n"
+    "  - jsonl   (un objeto JSON por fila)\n"
+    "  - binary  (formato binario descrito en src/db/result.h)\n\n"
+    "También se puede elegir al arrancar con --format.\n\n"
+    "Ejemplo:\n"
+    "  NQL> \\format csv\n"
+    "  Formato de salida: csv\n"
+    "  NQL> SELECT nombre, edad FROM usuarios\n"
+    "  nombre,edad\n"
+    "  Juan Pérez,25\n"
+    "  Ana López,30";
+
+static const char *help_timing = 
+    "\n══════════ Ayuda: \\timing ══════════\n\n"
+    "Sintaxis: \\timing [on|off]\n\n"
+    "Función: Muestra tras cada sentencia su tiempo real y de CPU, en total y repartido\n"
+    "en fases: léxico (normalización para la caché de planes), análisis, validación\n"
+    "(incluye compilar el plan), ejecución y salida (escritura de las filas). Sin\n"
+    "argumentos alterna entre activado y desactivado.\n\n"
+    "La CPU es la del hilo que ejecuta la sentencia más la de los hilos que recorren\n"
+    "la tabla en paralelo para ella; en el servidor no cuenta la de otras sesiones.\n"
+    "Medir cada fila escrita tiene un coste pequeño que se nota en consultas que\n"
+    "devuelven muchas filas. En un script, con \\timing activado cada sentencia se\n"
+    "analiza y ejecuta por separado.\n\n"
+    "Ejemplo:\n"
+    "  NQL> \\timing on\n"
+    "  Medición de tiempos: activada\n"
+    "  NQL> SELECT COUNT(*) FROM usuarios\n"
+    "  ...\n"
+    "  Tiempo: 0.215 ms (CPU 0.210 ms)\n"
+    "    léxico: 0.004 ms (CPU 0.004 ms)\n"
+    "    análisis: 0.000 ms (CPU 0.000 ms)\n"
+    "    validación: 0.000 ms (CPU 0.000 ms)\n"
+    "    ejecución: 0.151 ms (CPU 0.148 ms)\n"
+    "    salida: 0.031 ms (CPU 0.030 ms)";
+
+#define MAX_COMMANDS 40
 static CommandEntry commands[MAX_COMMANDS];
 static int num_commands = 0;
 
@@ -153,30 +331,43 @@ static void initialize_commands() {
     // Comandos SQL
     commands[num_commands++] = (CommandEntry){"CREATE TABLE", cmd_create_table, "Crea una nueva tabla", help_create_table};
     commands[num_commands++] = (CommandEntry){"ALTER TABLE", cmd_alter_table, "Modifica una tabla existente", help_alter_table};
-    commands[num_commands++] = (CommandEntry){"INSERT INTO", cmd_insert, "Inserta datos en una tabla", help_insert};
-    commands[num_commands++] = (CommandEntry){"SELECT", cmd_select, "Consulta datos de una tabla", help_select};
-    commands[num_commands++] = (CommandEntry){"DELETE FROM", cmd_delete, "Elimina datos de una tabla", help_delete};
+    commands[num_commands++] = (CommandEntry){"INSERT INTO", NULL, "Inserta datos en una tabla", help_insert, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"SELECT", NULL, "Consulta datos de una tabla", help_select, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"DELETE FROM", NULL, "Elimina datos de una tabla", help_delete, cmd_sql_statement};
     commands[num_commands++] = (CommandEntry){"DESCRIBE", cmd_describe, "Muestra la estructura de una tabla", help_describe};
-    commands[num_commands++] = (CommandEntry){"UPDATE", cmd_update, "Actualiza datos en una tabla", help_update};
-    commands[num_commands++] = (CommandEntry){"COUNT", cmd_count, "Cuenta registros en una tabla", help_count};
+    commands[num_commands++] = (CommandEntry){"ANALYZE", cmd_analyze, "Calcula las estadísticas de una tabla", help_analyze};
+    commands[num_commands++] = (CommandEntry){"UPDATE", NULL, "Actualiza datos en una tabla", help_update, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"COUNT", NULL, "Cuenta registros en una tabla", help_count, cmd_count};
+    commands[num_commands++] = (CommandEntry){"PREPARE", NULL, "Prepara una sentencia para ejecutarla varias veces", help_prepare, cmd_prepare};
+    commands[num_commands++] = (CommandEntry){"EXECUTE", NULL, "Ejecuta una sentencia preparada", help_execute, cmd_execute_prepared};
+    commands[num_commands++] = (CommandEntry){"DEALLOCATE", NULL, "Elimina una sentencia preparada", help_deallocate, cmd_deallocate};
+    commands[num_commands++] = (CommandEntry){"BEGIN", NULL, "Inicia una transacción", help_transaction, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"COMMIT", NULL, "Confirma la transacción en curso", help_transaction, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"ROLLBACK", NULL, "Deshace la transacción en curso", help_transaction, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"EXPLAIN", NULL, "Muestra el plan de ejecución de una sentencia", help_explain, cmd_explain};
     
     // Comandos utilitarios
     commands[num_commands++] = (CommandEntry){"add", cmd_add, "Suma números", help_utils};
     commands[num_commands++] = (CommandEntry){"subtract", cmd_subtract, "Resta números", help_utils};
     commands[num_commands++] = (CommandEntry){"multiply", cmd_multiply, "Multiplica números", help_utils};
     
+    // Opciones de la sesión
+    commands[num_commands++] = (CommandEntry){"\\format", cmd_format, "Cambia el formato de los resultados", help_format};
+    commands[num_commands++] = (CommandEntry){"\\timing", cmd_timing, "Mide el tiempo de cada sentencia", help_timing};
+    
     // Comandos alternativos (para compatibilidad)
     commands[num_commands++] = (CommandEntry){"create_table", cmd_create_table, "Crea una nueva tabla", help_create_table};
     commands[num_commands++] = (CommandEntry){"alter_table", cmd_alter_table, "Modifica una tabla existente", help_alter_table};
-    commands[num_commands++] = (CommandEntry){"insert", cmd_insert, "Inserta datos en una tabla", help_insert};
-    commands[num_commands++] = (CommandEntry){"select", cmd_select, "Consulta datos de una tabla", help_select};
-    commands[num_commands++] = (CommandEntry){"delete", cmd_delete, "Elimina datos de una tabla", help_delete};
+    commands[num_commands++] = (CommandEntry){"insert", NULL, "Inserta datos en una tabla", help_insert, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"select", NULL, "Consulta datos de una tabla", help_select, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"delete", NULL, "Elimina datos de una tabla", help_delete, cmd_sql_statement};
     commands[num_commands++] = (CommandEntry){"describe", cmd_describe, "Muestra la estructura de una tabla", help_describe};
-    commands[num_commands++] = (CommandEntry){"update", cmd_update, "Actualiza datos en una tabla", help_update};
-    commands[num_commands++] = (CommandEntry){"count", cmd_count, "Cuenta registros en una tabla"};
+    commands[num_commands++] = (CommandEntry){"analyze", cmd_analyze, "Calcula las estadísticas de una tabla", help_analyze};
+    commands[num_commands++] = (CommandEntry){"update", NULL, "Actualiza datos en una tabla", help_update, cmd_sql_statement};
+    commands[num_commands++] = (CommandEntry){"count", NULL, "Cuenta registros en una tabla", NULL, cmd_count};
     
     // Marca de fin de lista
-    commands[num_commands++] = (CommandEntry){NULL, NULL, NULL, NULL};
+    commands[num_commands++] = (CommandEntry){NULL, NULL, NULL, NULL, NULL};
 }
 
 // Array con solo los nombres de los comandos (para autocompletado)
@@ -221,11 +412,29 @@ int cmd_execute(const char *command, char *args[], int arg_count) {
         }
     }
     // Comando no encontrado
-    printf("Comando desconocido: %s\n", command);
-    printf("Escriba 'help' para ver los comandos disponibles.\n");
+    output_printf("Comando desconocido: %s\n", command);
+    output_printf("Escriba 'help' para ver los comandos disponibles.\n");
     return -1;
 }
 
+int cmd_execute_input(const char *command, const char *input, char *args[], int arg_count) {
+    const CommandEntry *entry = cmd_get_entry(command);
+    
+    // Los comandos SQL analizan la línea completa con el parser
+    if (entry && entry->sql_function) {
+        if (!timing_is_enabled()) return entry->sql_function(input);
+        
+        // \timing: tiempo de la sentencia repartido por fases
+        StatementTiming timing;
+        timing_begin();
+        int status = entry->sql_function(input);
+        if (timing_end(&timing) == 0) timing_print(&timing);
+        return status;
+    }
+    
+    return cmd_execute(command, args, arg_count);
+}
+
 const char **cmd_get_command_names() {
     return command_names;
 }
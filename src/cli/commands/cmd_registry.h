@@ -4,12 +4,16 @@
 // Tipo de función de comando
 typedef int (*CommandFunction)(char *args[], int arg_count);
 
+// Tipo de función de comando que recibe la sentencia SQL completa
+typedef int (*SqlCommandFunction)(const char *sql);
+
 // Estructura para almacenar información de un comando
 typedef struct {
     const char *name;           // Nombre del comando
     CommandFunction function;   // Función que implementa el comando
     const char *description;    // Descripción corta del comando
     const char *help_text;      // Texto de ayuda extendido
+    SqlCommandFunction sql_function; // Función que recibe la línea completa (opcional)
 } CommandEntry;
 
 // Inicializa el registro de comandos
@@ -21,10 +25,19 @@ void cmd_registry_cleanup();
 // Ejecuta un comando por su nombre
 int cmd_execute(const char *command, char *args[], int arg_count);
 
+// Ejecuta un comando con acceso a la línea de entrada completa
+int cmd_execute_input(const char *command, const char *input, char *args[], int arg_count);
+
 // Obtiene una lista de los nombres de comandos disponibles
 const char **cmd_get_command_names();
 
 // Obtiene la entrada de un comando por su nombre
 const CommandEntry *cmd_get_entry(const char *command);
 
+// Ejecuta una sentencia SELECT, INSERT, UPDATE, DELETE, BEGIN, COMMIT o ROLLBACK
+int cmd_sql_statement(const char *sql);
+
+// Ejecuta varias sentencias de las que admite cmd_sql_statement separadas por ';'
+int cmd_sql_script(const char *sql);
+
 #endif /* CMD_REGISTRY_H */
\ No newline at end of file
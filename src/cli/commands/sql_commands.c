@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../db/database.h"
+#include "../../parser/parser.h"
+#include "../../executor/prepared.h"
+#include "../../executor/plan_cache.h"
+#include "../../executor/script.h"
+#include "cmd_registry.h"
+#include "../../utils/output.h"
+
+/*
+* Analiza una sentencia completa y comprueba que sea del tipo esperado
+* @param sql Texto de la sentencia
+* @param expected Tipo de nodo esperado
+* @return AST de la sentencia, NULL si hubo un error
+*/
+static ASTNode *parse_sql(const char *sql, ASTNodeType expected) {
+    Parser *parser = parser_create(sql);
+    if (!parser) {
+        output_printf("Error: No se pudo crear el parser\n");
+        return NULL;
+    }
+
+    ASTNode *stmt = parser_parse(parser);
+    if (!stmt || parser_has_error(parser)) {
+        output_printf("Error: %s\n", parser_has_error(parser) ? parser_get_error(parser) : "Sentencia no válida");
+        if (stmt) ast_free_node(stmt);
+        parser_free(parser);
+        return NULL;
+    }
+
+    parser_free(parser);
+
+    if (stmt->type != expected) {
+        output_printf("Error: Sentencia no válida\n");
+        ast_free_node(stmt);
+        return NULL;
+    }
+
+    return stmt;
+}
+
+/*
+* Comando para ejecutar sentencias SELECT, INSERT, UPDATE, DELETE, BEGIN, COMMIT y ROLLBACK
+* Los planes se reutilizan entre sentencias que solo difieren en sus literales
+*/
+int cmd_sql_statement(const char *sql) {
+    ValidationResult *result = validator_create_result();
+    if (!result) return -1;
+
+    int status = plan_cache_execute(sql, db_get_database(), result);
+    if (status != 0) {
+        output_printf("Error: %s\n", result->error_message ? result->error_message : "Sentencia no válida");
+    }
+
+    validator_free_result(result);
+    return status;
+}
+
+/*
+* Ejecuta varias sentencias de las que admite cmd_sql_statement separadas por ';'
+* Se analizan todas de una vez y los INSERT consecutivos sobre una tabla se agrupan
+*/
+int cmd_sql_script(const char *sql) {
+    ParsedScript *script = parser_parse_script(sql);
+    if (!script) {
+        output_printf("Error: Memoria insuficiente para analizar el script\n");
+        return -1;
+    }
+
+    int status = script_execute(script, db_get_database());
+    parser_free_script(script);
+    return status;
+}
+
+/*
+* Comando para mostrar el plan de ejecución de una sentencia
+* EXPLAIN [ANALYZE] sentencia
+*/
+int cmd_explain(const char *sql) {
+    ASTNode *node = parse_sql(sql, NODE_EXPLAIN_STMT);
+    if (!node) return -1;
+
+    ExplainStmtData *data = (ExplainStmtData *)node->data;
+
+    ValidationResult *result = validator_create_result();
+    if (!result) {
+        ast_free_node(node);
+        return -1;
+    }
+
+    // El catálogo se mantiene tomado desde la compilación hasta la ejecución
+    db_lock_read();
+    Plan *plan = executor_compile(data->statement, data->num_params, db_get_database(), result);
+    int status = plan ? executor_explain(plan, NULL, 0, data->analyze, result) : -1;
+    db_unlock();
+
+    if (status != 0) {
+        output_printf("Error: %s\n", result->error_message ? result->error_message : "Sentencia no válida");
+    }
+
+    executor_free_plan(plan);
+    validator_free_result(result);
+    ast_free_node(node);
+    return status;
+}
+
+/*
+* Comando para preparar una sentencia
+* PREPARE nombre AS sentencia
+*/
+int cmd_prepare(const char *sql) {
+    ASTNode *node = parse_sql(sql, NODE_PREPARE_STMT);
+    if (!node) return -1;
+
+    PrepareStmtData *data = (PrepareStmtData *)node->data;
+
+    if (prepared_find(data->name)) {
+        output_printf("Error: La sentencia preparada '%s' ya existe\n", data->name);
+        ast_free_node(node);
+        return -1;
+    }
+
+    ValidationResult *result = validator_create_result();
+    if (!result) {
+        ast_free_node(node);
+        return -1;
+    }
+
+    PreparedStatement *prepared = prepared_create(data->name, data->statement, data->num_params,
+                                                  db_get_database(), result);
+    if (!prepared) {
+        output_printf("Error: %s\n", result->error_message);
+        validator_free_result(result);
+        ast_free_node(node);
+        return -1;
+    }
+    validator_free_result(result);
+
+    // La sentencia interna pasa a pertenecer a la sentencia preparada
+    data->statement = NULL;
+    ast_free_node(node);
+
+    if (prepared_register(prepared) != 0) {
+        prepared_free(prepared);
+        return -1;
+    }
+
+    output_printf("Sentencia preparada: %s (%d parámetro%s)\n", prepared->name,
+                  prepared->num_params, prepared->num_params == 1 ? "" : "s");
+    return 0;
+}
+
+/*
+* Comando para ejecutar una sentencia preparada
+* EXECUTE nombre [(valor1, valor2, ...)]
+*/
+int cmd_execute_prepared(const char *sql) {
+    ASTNode *node = parse_sql(sql, NODE_EXECUTE_STMT);
+    if (!node) return -1;
+
+    ExecuteStmtData *data = (ExecuteStmtData *)node->data;
+
+    PreparedStatement *prepared = prepared_find(data->name);
+    if (!prepared) {
+        output_printf("Error: La sentencia preparada '%s' no existe\n", data->name);
+        ast_free_node(node);
+        return -1;
+    }
+
+    // Los argumentos deben ser literales; se enlazan por posición sin copiarlos
+    int num_args = 0;
+    ASTNode **args = NULL;
+    if (data->arguments) {
+        ValueListData *values = (ValueListData *)data->arguments->data;
+        num_args = values->count;
+        args = values->values;
+    }
+
+    LiteralData params[num_args > 0 ? num_args : 1];
+    for (int i = 0; i < num_args; i++) {
+        if (args[i]->type != NODE_LITERAL) {
+            output_printf("Error: Los argumentos de EXECUTE deben ser literales\n");
+            ast_free_node(node);
+            return -1;
+        }
+        params[i] = *(LiteralData *)args[i]->data;
+    }
+
+    ValidationResult *result = validator_create_result();
+    if (!result) {
+        ast_free_node(node);
+        return -1;
+    }
+
+    int status = prepared_execute(prepared, params, num_args, db_get_database(), result);
+    if (status != 0) {
+        output_printf("Error: %s\n", result->error_message);
+    }
+
+    validator_free_result(result);
+    ast_free_node(node);
+    return status;
+}
+
+/*
+* Comando para eliminar una sentencia preparada
+* DEALLOCATE [PREPARE] nombre
+*/
+int cmd_deallocate(const char *sql) {
+    ASTNode *node = parse_sql(sql, NODE_DEALLOCATE_STMT);
+    if (!node) return -1;
+
+    DeallocateStmtData *data = (DeallocateStmtData *)node->data;
+
+    int status = prepared_remove(data->name);
+    if (status != 0) {
+        output_printf("Error: La sentencia preparada '%s' no existe\n", data->name);
+    } else {
+        output_printf("Sentencia preparada eliminada: %s\n", data->name);
+    }
+
+    ast_free_node(node);
+    return status;
+}
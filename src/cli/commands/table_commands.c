@@ -4,7 +4,10 @@
 #include "../../db/database.h"
 #include "../../db/table.h"
 #include "../../db/value.h"
+#include "../../executor/transaction.h"
+#include "../../executor/analyze.h"
 #include "cmd_registry.h"
+#include "../../utils/output.h"
 
 /*
 * Comando para crear una tabla
@@ -12,7 +15,12 @@
 */
 int cmd_create_table(char *args[], int arg_count) {
     if (arg_count < 1) {
-        printf("Error: Sintaxis: CREATE TABLE nombre_tabla\n");
+        output_printf("Error: Sintaxis: CREATE TABLE nombre_tabla\n");
+        return -1;
+    }
+    
+    if (transaction_active()) {
+        output_printf("Error: No se pueden crear tablas dentro de una transacción\n");
         return -1;
     }
     
@@ -24,11 +32,11 @@ int cmd_create_table(char *args[], int arg_count) {
         return -1;
     }
     
-    printf("Tabla creada: %s\n", table_name);
-    printf("\nPara añadir columnas use:\n");
-    printf("ALTER TABLE %s ADD COLUMN nombre_columna tipo [opciones]\n\n", table_name);
-    printf("Ejemplos de tipos: INT, FLOAT, STRING(50), BOOL\n");
-    printf("Opciones: PRIMARY KEY, NOT NULL\n");
+    output_printf("Tabla creada: %s\n", table_name);
+    output_printf("\nPara añadir columnas use:\n");
+    output_printf("ALTER TABLE %s ADD COLUMN nombre_columna tipo [opciones]\n\n", table_name);
+    output_printf("Ejemplos de tipos: INT, FLOAT, STRING(50), BOOL\n");
+    output_printf("Opciones: PRIMARY KEY, NOT NULL\n");
     
     return 0;
 }
@@ -39,15 +47,20 @@ int cmd_create_table(char *args[], int arg_count) {
 */
 int cmd_alter_table(char *args[], int arg_count) {
     if (arg_count < 5) {
-        printf("Error: Sintaxis: ALTER TABLE nombre_tabla ADD COLUMN nombre_columna tipo [opciones]\n");
-        printf("Tipos disponibles: INT, FLOAT, STRING(max_length), BOOL\n");
-        printf("Opciones: PRIMARY KEY, NOT NULL\n");
+        output_printf("Error: Sintaxis: ALTER TABLE nombre_tabla ADD COLUMN nombre_columna tipo [opciones]\n");
+        output_printf("Tipos disponibles: INT, FLOAT, STRING(max_length), BOOL\n");
+        output_printf("Opciones: PRIMARY KEY, NOT NULL\n");
         return -1;
     }
     
     // Verificar que sea "ADD COLUMN"
     if (strcasecmp(args[1], "ADD") != 0 || strcasecmp(args[2], "COLUMN") != 0) {
-        printf("Error: Solo se admite la operación 'ADD COLUMN'.\n");
+        output_printf("Error: Solo se admite la operación 'ADD COLUMN'.\n");
+        return -1;
+    }
+    
+    if (transaction_active()) {
+        output_printf("Error: No se pueden modificar tablas dentro de una transacción\n");
         return -1;
     }
     
@@ -55,10 +68,13 @@ int cmd_alter_table(char *args[], int arg_count) {
     const char* column_name = args[3];
     const char* type_str = args[4];
     
-    // Buscar la tabla
+    // Buscar la tabla (nadie puede eliminarla hasta añadir la columna)
+    if (db_lock_schema() != 0) return -1;
+    
     Table* table = db_find_table(table_name);
     if (!table) {
-        printf("Error: Tabla '%s' no encontrada.\n", table_name);
+        output_printf("Error: Tabla '%s' no encontrada.\n", table_name);
+        db_unlock();
         return -1;
     }
     
@@ -88,7 +104,8 @@ int cmd_alter_table(char *args[], int arg_count) {
             max_length = 255; // Valor por defecto
         }
     } else {
-        printf("Error: Tipo de dato '%s' no válido. Use INT, FLOAT, STRING(max_length), o BOOL.\n", type_str);
+        output_printf("Error: Tipo de dato '%s' no válido. Use INT, FLOAT, STRING(max_length), o BOOL.\n", type_str);
+        db_unlock();
         return -1;
     }
     
@@ -109,13 +126,15 @@ int cmd_alter_table(char *args[], int arg_count) {
     }
     
     // Agregar la columna
-    if (table_add_column(table, column_name, type, max_length, 
-                         is_primary_key, allows_null) == 0) {
-        printf("Columna añadida: %s (%s)\n", column_name, 
+    int status = db_add_column(table, column_name, type, max_length, is_primary_key, allows_null);
+    db_unlock();
+    
+    if (status == 0) {
+        output_printf("Columna añadida: %s (%s)\n", column_name, 
               column_type_to_string(type, max_length));
         return 0;
     } else {
-        printf("Error: No se pudo añadir la columna '%s'\n", column_name);
+        output_printf("Error: No se pudo añadir la columna '%s'\n", column_name);
         return -1;
     }
 }
@@ -126,39 +145,144 @@ int cmd_alter_table(char *args[], int arg_count) {
 */
 int cmd_describe(char *args[], int arg_count) {
     if (arg_count < 1) {
-        printf("Error: Sintaxis: DESCRIBE nombre_tabla\n");
+        output_printf("Error: Sintaxis: DESCRIBE nombre_tabla\n");
         return -1;
     }
     
     const char* table_name = args[0];
     
-    // Buscar la tabla
+    // Buscar la tabla (el catálogo se mantiene tomado mientras se lee su esquema)
+    db_lock_read();
+    
     Table* table = db_find_table(table_name);
     if (!table) {
-        printf("Error: Tabla '%s' no encontrada.\n", table_name);
+        output_printf("Error: Tabla '%s' no encontrada.\n", table_name);
+        db_unlock();
         return -1;
     }
     
     // Imprimir información de la estructura de la tabla
-    printf("Tabla: %s\n", table_name);
-    printf("+------------+--------------+------------+-------------+\n");
-    printf("| Campo      | Tipo         | Nulo       | Clave       |\n");
-    printf("+------------+--------------+------------+-------------+\n");
+    output_printf("Tabla: %s\n", table_name);
+    output_printf("+------------+--------------+------------+-------------+\n");
+    output_printf("| Campo      | Tipo         | Nulo       | Clave       |\n");
+    output_printf("+------------+--------------+------------+-------------+\n");
     
     for (int i = 0; i < table->num_columns; i++) {
         Column col = table->columns[i];
         const char* type_str = column_type_to_string(col.type, col.max_length);
         
-        printf("| %-10s | %-12s | %-10s | %-11s |\n",
-               col.name,
-               type_str,
-               col.allows_null ? "SI" : "NO",
-               col.is_primary_key ? "PRIMARIA" : "");
+        output_printf("| %-10s | %-12s | %-10s | %-11s |\n",
+                      col.name,
+                      type_str,
+                      col.allows_null ? "SI" : "NO",
+                      col.is_primary_key ? "PRIMARIA" : "");
     }
     
-    printf("+------------+--------------+------------+-------------+\n");
-    printf("%d columna%s en tabla\n", table->num_columns, 
-           table->num_columns == 1 ? "" : "s");
+    output_printf("+------------+--------------+------------+-------------+\n");
+    output_printf("%d columna%s en tabla\n", table->num_columns, 
+                  table->num_columns == 1 ? "" : "s");
     
+    db_unlock();
     return 0;
-}
\ No newline at end of file
+}
+
+/*
+* Escribe el valor de una estadística en una celda de la tabla de ANALYZE
+* @param stats Estadísticas de la columna
+* @param value Valor a escribir
+*/
+static void print_stats_value(const ColumnStats *stats, Value value) {
+    char buffer[VALUE_NUMBER_LENGTH];
+    int length;
+    const char *text = stats->has_bounds ? value_format(buffer, value, stats->type, &length) : "";
+    output_printf(" %-12.12s |", text);
+}
+
+/*
+* Comando para calcular las estadísticas de una tabla
+* ANALYZE nombre_tabla
+*/
+int cmd_analyze(char *args[], int arg_count) {
+    if (arg_count < 1) {
+        output_printf("Error: Sintaxis: ANALYZE nombre_tabla\n");
+        return -1;
+    }
+    
+    // La transacción tiene el catálogo en lectura, y las estadísticas solo se pueden
+    // sustituir con él en escritura
+    if (transaction_active()) {
+        output_printf("Error: No se puede usar ANALYZE dentro de una transacción\n");
+        return -1;
+    }
+    
+    const char* table_name = args[0];
+    
+    // Se analiza una instantánea con el catálogo en lectura: las consultas y escrituras
+    // siguen mientras tanto
+    db_lock_read();
+    
+    Table* table = db_find_table(table_name);
+    if (!table) {
+        output_printf("Error: Tabla '%s' no encontrada.\n", table_name);
+        db_unlock();
+        return -1;
+    }
+    
+    ValidationResult* result = validator_create_result();
+    if (!result) {
+        output_printf("Error: Error de memoria al analizar la tabla\n");
+        db_unlock();
+        return -1;
+    }
+    
+    unsigned int schema_version = db_get_database()->schema_version;
+    TableStats* stats = analyze_table(table, result);
+    db_unlock();
+    
+    if (!stats) {
+        output_printf("Error: %s\n", result->error_message);
+        validator_free_result(result);
+        return -1;
+    }
+    validator_free_result(result);
+    
+    int status = db_set_table_stats(table_name, schema_version, stats);
+    if (status != 0) {
+        stats_free(stats);
+        if (status == -1) output_printf("Error: La tabla '%s' cambió durante el análisis\n", table_name);
+        return -1;
+    }
+    
+    // Las estadísticas ya son del catálogo: se leen con él tomado
+    db_lock_read();
+    
+    table = db_find_table(table_name);
+    stats = table ? table->stats : NULL;
+    if (!stats) {
+        db_unlock();
+        return 0;
+    }
+    
+    output_printf("Tabla analizada: %s (%lld fila%s)\n", table_name, stats->num_rows,
+                  stats->num_rows == 1 ? "" : "s");
+    output_printf("+------------+---------+-----------+--------------+--------------+------------+\n");
+    output_printf("| Columna    | Nulos   | Distintos | Mínimo       | Máximo       | Intervalos |\n");
+    output_printf("+------------+---------+-----------+--------------+--------------+------------+\n");
+    
+    for (int i = 0; i < stats->num_columns; i++) {
+        const ColumnStats *column = &stats->columns[i];
+        
+        output_printf("| %-10s | %6.2f%% | %9lld |", table->columns[i].name,
+                      column->null_fraction * 100, column->num_distinct);
+        print_stats_value(column, column->min);
+        print_stats_value(column, column->max);
+        output_printf(" %10d |\n", column->num_buckets);
+    }
+    
+    output_printf("+------------+---------+-----------+--------------+--------------+------------+\n");
+    output_printf("Distintos estimados con HyperLogLog; histogramas de igual profundidad sobre "
+                  "una muestra de hasta %d filas\n", ANALYZE_SAMPLE_ROWS);
+    
+    db_unlock();
+    return 0;
+}
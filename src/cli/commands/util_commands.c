@@ -1,12 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include "../../utils/output.h"
+#include "../../db/result.h"
+#include "../../utils/timing.h"
 
 // Comando para sumar números
 int cmd_add(char *args[], int arg_count) {
     if (arg_count < 2) {
-        printf("Error: Se requieren al menos dos números para sumar\n");
-        printf("Uso: add número1 número2 [número3 ...]\n");
+        output_printf("Error: Se requieren al menos dos números para sumar\n");
+        output_printf("Uso: add número1 número2 [número3 ...]\n");
         return -1;
     }
     
@@ -15,15 +19,15 @@ int cmd_add(char *args[], int arg_count) {
         sum += atoi(args[i]);
     }
     
-    printf("Resultado: %d\n", sum);
+    output_printf("Resultado: %d\n", sum);
     return 0;
 }
 
 // Comando para restar números
 int cmd_subtract(char *args[], int arg_count) {
     if (arg_count < 2) {
-        printf("Error: Se requieren al menos dos números para restar\n");
-        printf("Uso: subtract número1 número2 [número3 ...]\n");
+        output_printf("Error: Se requieren al menos dos números para restar\n");
+        output_printf("Uso: subtract número1 número2 [número3 ...]\n");
         return -1;
     }
     
@@ -32,15 +36,15 @@ int cmd_subtract(char *args[], int arg_count) {
         result -= atoi(args[i]);
     }
     
-    printf("Resultado: %d\n", result);
+    output_printf("Resultado: %d\n", result);
     return 0;
 }
 
 // Comando para multiplicar números
 int cmd_multiply(char *args[], int arg_count) {
     if (arg_count < 2) {
-        printf("Error: Se requieren al menos dos números para multiplicar\n");
-        printf("Uso: multiply número1 número2 [número3 ...]\n");
+        output_printf("Error: Se requieren al menos dos números para multiplicar\n");
+        output_printf("Uso: multiply número1 número2 [número3 ...]\n");
         return -1;
     }
     
@@ -49,6 +53,44 @@ int cmd_multiply(char *args[], int arg_count) {
         result *= atoi(args[i]);
     }
     
-    printf("Resultado: %d\n", result);
+    output_printf("Resultado: %d\n", result);
     return 0;
-}
\ No newline at end of file
+}
+
+// Comando para consultar o cambiar el formato de los resultados de la sesión
+int cmd_format(char *args[], int arg_count) {
+    if (arg_count == 0) {
+        output_printf("Formato de salida: %s\n", result_format_name(result_get_format()));
+        return 0;
+    }
+    
+    ResultFormat format;
+    if (arg_count > 1 || result_format_from_name(args[0], &format) != 0) {
+        output_printf("Error: Formato de salida no válido: '%s'\n", args[0]);
+        output_printf("Uso: \\format [table|csv|tsv|jsonl|binary]\n");
+        return -1;
+    }
+    
+    result_set_format(format);
+    output_printf("Formato de salida: %s\n", result_format_name(format));
+    return 0;
+}
+
+// Comando para activar o desactivar la medición de tiempos de las sentencias
+int cmd_timing(char *args[], int arg_count) {
+    int enabled = !timing_is_enabled();
+    
+    if (arg_count == 1 && strcasecmp(args[0], "on") == 0) {
+        enabled = 1;
+    } else if (arg_count == 1 && strcasecmp(args[0], "off") == 0) {
+        enabled = 0;
+    } else if (arg_count > 0) {
+        output_printf("Error: Opción no válida: '%s'\n", args[0]);
+        output_printf("Uso: \\timing [on|off]\n");
+        return -1;
+    }
+    
+    timing_set_enabled(enabled);
+    output_printf("Medición de tiempos: %s\n", enabled ? "activada" : "desactivada");
+    return 0;
+}
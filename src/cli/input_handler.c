@@ -104,8 +104,9 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
         return;
     }
     
-    // Identificar primero el comando (CREATE, SELECT, etc.)
-    char *token = strtok(input_copy, " \t");
+    // Identificar primero el comando (CREATE, SELECT, etc.). Las sentencias de un
+    // script pueden ocupar varias líneas.
+    char *token = strtok(input_copy, " \t\r\n");
     if (!token) {
         free(input_copy);
         return;
@@ -124,7 +125,7 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
         first_word[MAX_COMMAND_LENGTH - 1] = '\0';
         
         // Capturar segunda palabra para comandos de dos palabras
-        token = strtok(NULL, " \t");
+        token = strtok(NULL, " \t\r\n");
         if (token && (
             (strcasecmp(first_word, "CREATE") == 0 && strcasecmp(token, "TABLE") == 0) ||
             (strcasecmp(first_word, "ALTER") == 0 && strcasecmp(token, "TABLE") == 0) ||
@@ -142,7 +143,7 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
                 // Hay suficiente espacio
                 sprintf(command, "%s %s", first_word, token);
             }
-            token = strtok(NULL, " \t");
+            token = strtok(NULL, " \t\r\n");
         } else {
             strncpy(command, first_word, MAX_COMMAND_LENGTH - 1);
             command[MAX_COMMAND_LENGTH - 1] = '\0';
@@ -150,7 +151,14 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
     } else {
         strncpy(command, token, MAX_COMMAND_LENGTH - 1);
         command[MAX_COMMAND_LENGTH - 1] = '\0';
-        token = strtok(NULL, " \t");
+        token = strtok(NULL, " \t\r\n");
+    }
+    
+    // Los comandos SQL reciben la sentencia completa: sus argumentos no se usan
+    const CommandEntry *entry = cmd_get_entry(command);
+    if (entry && entry->sql_function) {
+        free(input_copy);
+        return;
     }
     
     // Procesar argumentos con manejo de comillas
@@ -161,7 +169,8 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
         // Verificar si comienza con comilla
         if (!in_quotes && token[0] == '"') {
             in_quotes = 1;
-            strcpy(buffer, token + 1);  // Copiar sin la comilla inicial
+            strncpy(buffer, token + 1, MAX_INPUT_LENGTH - 1);  // Copiar sin la comilla inicial
+            buffer[MAX_INPUT_LENGTH - 1] = '\0';
             
             // Si termina con comilla en el mismo token
             size_t len = strlen(buffer);
@@ -174,9 +183,12 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
         }
         // Si ya estamos procesando un texto con comillas
         else if (in_quotes) {
+            // Las líneas pueden ser más largas que el buffer (p. ej. desde el servidor)
             size_t len = strlen(buffer);
-            buffer[len] = ' ';  // Añadir espacio entre tokens
-            strcpy(buffer + len + 1, token);
+            if (len + 1 + strlen(token) < MAX_INPUT_LENGTH) {
+                buffer[len] = ' ';  // Añadir espacio entre tokens
+                strcpy(buffer + len + 1, token);
+            }
             
             // Verificar si termina con comilla
             len = strlen(buffer);
@@ -192,7 +204,7 @@ void input_parse(char *input, char *command, char *args[], int *arg_count) {
             args[(*arg_count)++] = strdup(token);
         }
         
-        token = strtok(NULL, " \t");
+        token = strtok(NULL, " \t\r\n");
     }
     
     // Si quedó un texto con comillas sin cerrar, lo agregamos igual
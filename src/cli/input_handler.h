@@ -23,6 +23,9 @@ char *input_command_generator(const char *text, int state);
 // Parsea la entrada en comando y argumentos
 void input_parse(char *input, char *command, char *args[], int *arg_count);
 
+// Libera los argumentos que reservó input_parse
+void input_cleanup_args(char *args[], int *arg_count);
+
 // Limpia recursos del sistema de entrada
 void input_cleanup();
 
@@ -1,20 +1,114 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include "column.h"
 #include "table.h" 
 
-// Función para obtener el índice de una columna por su nombre
-int column_get_index(Table* table, const char* column_name) {
-    if (!table || !column_name) return -1;
+#define COLUMN_MAP_MIN_CAPACITY 16
+
+// Hash FNV-1a sobre el nombre en minúsculas
+static unsigned int column_name_hash(const char* name) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= (unsigned int)tolower(*p);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Inicializa un mapa de columnas vacío
+void column_map_init(ColumnMap* map) {
+    if (!map) return;
+    map->slots = NULL;
+    map->capacity = 0;
+    map->count = 0;
+}
+
+// Libera la memoria del mapa de columnas
+void column_map_free(ColumnMap* map) {
+    if (!map) return;
+    free(map->slots);
+    column_map_init(map);
+}
+
+// Coloca una entrada en la primera ranura libre (sondeo lineal)
+static void column_map_place(ColumnMapSlot* slots, int capacity, unsigned int hash, int index) {
+    int mask = capacity - 1;
+    int pos = (int)(hash & (unsigned int)mask);
+    while (slots[pos].index != -1) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos].hash = hash;
+    slots[pos].index = index;
+}
+
+// Duplica la capacidad del mapa y reubica las entradas existentes
+static int column_map_grow(ColumnMap* map) {
+    int new_capacity = map->capacity == 0 ? COLUMN_MAP_MIN_CAPACITY : map->capacity * 2;
+    ColumnMapSlot* new_slots = (ColumnMapSlot*)malloc(new_capacity * sizeof(ColumnMapSlot));
+    if (!new_slots) return -1;
     
-    for (int i = 0; i < table->num_columns; i++) {
-        if (strcmp(table->columns[i].name, column_name) == 0) {
-            return i;
+    for (int i = 0; i < new_capacity; i++) {
+        new_slots[i].index = -1;
+    }
+    
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->slots[i].index != -1) {
+            column_map_place(new_slots, new_capacity, map->slots[i].hash, map->slots[i].index);
         }
     }
     
-    return -1; // No se encontró la columna
+    free(map->slots);
+    map->slots = new_slots;
+    map->capacity = new_capacity;
+    return 0;
+}
+
+/*
+* Registra la columna columns[index] en el mapa
+* @return 0 si se insertó correctamente, -1 si hubo un error
+*/
+int column_map_insert(ColumnMap* map, const Column* columns, int index) {
+    if (!map || !columns || index < 0) return -1;
+    
+    // Mantener el factor de carga por debajo de 1/2
+    if ((map->count + 1) * 2 > map->capacity) {
+        if (column_map_grow(map) != 0) return -1;
+    }
+    
+    column_map_place(map->slots, map->capacity, column_name_hash(columns[index].name), index);
+    map->count++;
+    return 0;
+}
+
+/*
+* Busca una columna por nombre en el mapa
+* @return Índice de la columna, o -1 si no existe
+*/
+int column_map_find(const ColumnMap* map, const Column* columns, const char* column_name) {
+    if (!map || !columns || !column_name || map->capacity == 0) return -1;
+    
+    unsigned int hash = column_name_hash(column_name);
+    int mask = map->capacity - 1;
+    int pos = (int)(hash & (unsigned int)mask);
+    
+    while (map->slots[pos].index != -1) {
+        if (map->slots[pos].hash == hash &&
+            strcasecmp(columns[map->slots[pos].index].name, column_name) == 0) {
+            return map->slots[pos].index;
+        }
+        pos = (pos + 1) & mask;
+    }
+    
+    return -1;
+}
+
+// Función para obtener el índice de una columna por su nombre
+int column_get_index(Table* table, const char* column_name) {
+    if (!table || !column_name) return -1;
+    
+    return column_map_find(&table->column_map, table->columns, column_name);
 }
 
 // Función para obtener el tipo de dato de una columna como cadena
@@ -34,4 +128,4 @@ const char* column_type_to_string(DataType type, int max_length) {
         default:
             return "UNKNOWN";
     }
-}
\ No newline at end of file
+}
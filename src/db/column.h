@@ -15,11 +15,30 @@ typedef struct {
     int allows_null;
 } Column;
 
+// Entrada del mapa de columnas (hash precalculado + índice de columna)
+typedef struct {
+    unsigned int hash;
+    int index;       // -1 si la ranura está vacía
+} ColumnMapSlot;
+
+// Mapa hash de nombres de columna (direccionamiento abierto, sin distinguir mayúsculas)
+typedef struct {
+    ColumnMapSlot* slots;
+    int capacity;    // Siempre potencia de dos
+    int count;
+} ColumnMap;
+
 // Función para obtener el tipo de dato de una columna como cadena
 const char* column_type_to_string(DataType type, int max_length);
 
-// Obtener el índice de una columna por su nombre 
+// Obtener el índice de una columna por su nombre (sin distinguir mayúsculas)
 // Cambiamos para usar forward declaration
 int column_get_index(struct Table* table, const char* column_name);
 
-#endif
\ No newline at end of file
+// Funciones del mapa de columnas
+void column_map_init(ColumnMap* map);
+void column_map_free(ColumnMap* map);
+int column_map_insert(ColumnMap* map, const Column* columns, int index);
+int column_map_find(const ColumnMap* map, const Column* columns, const char* column_name);
+
+#endif
@@ -1,11 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <time.h>
 #include "database.h"
+#include "../utils/output.h"
 
 // Variables globales
 static Table* tables[MAX_TABLES];
-static int num_tables = 0;
+static Database database = { tables, 0, "main", MAX_TABLES, 0 };
+
+// Bloqueo del catálogo y veces que lo ha tomado el hilo actual
+static pthread_rwlock_t catalog_lock = PTHREAD_RWLOCK_INITIALIZER;
+static __thread int catalog_depth = 0;
 
 // Inicializa la base de datos
 void db_init() {
@@ -13,33 +20,42 @@ void db_init() {
     for (int i = 0; i < MAX_TABLES; i++) {
         tables[i] = NULL;
     }
-    num_tables = 0;
+    database.num_tables = 0;
+    database.schema_version = 0;
 }
 
 // Limpia los recursos de la base de datos
 void db_cleanup() {
+    db_lock_write();
+    
     // Liberar todas las tablas existentes
-    for (int i = 0; i < num_tables; i++) {
+    for (int i = 0; i < database.num_tables; i++) {
         if (tables[i]) {
             table_free(tables[i]);
             tables[i] = NULL;
         }
     }
-    num_tables = 0;
+    database.num_tables = 0;
+    
+    db_unlock();
 }
 
 // Crea una nueva tabla
 Table *db_create_table(const char *name) {
+    if (db_lock_schema() != 0) return NULL;
+    
     // Verificar límite de tablas
-    if (num_tables >= MAX_TABLES) {
-        printf("Error: Se ha alcanzado el límite máximo de tablas (%d)\n", MAX_TABLES);
+    if (database.num_tables >= MAX_TABLES) {
+        output_printf("Error: Se ha alcanzado el límite máximo de tablas (%d)\n", MAX_TABLES);
+        db_unlock();
         return NULL;
     }
     
     // Verificar si ya existe una tabla con ese nombre
-    for (int i = 0; i < num_tables; i++) {
+    for (int i = 0; i < database.num_tables; i++) {
         if (tables[i] && strcmp(tables[i]->name, name) == 0) {
-            printf("Error: Ya existe una tabla con el nombre '%s'\n", name);
+            output_printf("Error: Ya existe una tabla con el nombre '%s'\n", name);
+            db_unlock();
             return NULL;
         }
     }
@@ -47,44 +63,58 @@ Table *db_create_table(const char *name) {
     // Crear la tabla
     Table *table = table_create(name);
     if (!table) {
-        printf("Error: No se pudo crear la tabla '%s'\n", name);
+        output_printf("Error: No se pudo crear la tabla '%s'\n", name);
+        db_unlock();
         return NULL;
     }
     
     // Añadir a la lista de tablas
-    tables[num_tables++] = table;
+    tables[database.num_tables++] = table;
+    database.schema_version++;
     
+    db_unlock();
     return table;
 }
 
-// Busca una tabla por nombre
+// Busca una tabla por nombre (la tabla solo es segura mientras se tenga el catálogo)
 Table *db_find_table(const char *name) {
-    for (int i = 0; i < num_tables; i++) {
+    Table *table = NULL;
+    
+    db_lock_read();
+    for (int i = 0; i < database.num_tables; i++) {
         if (tables[i] && strcmp(tables[i]->name, name) == 0) {
-            return tables[i];
+            table = tables[i];
+            break;
         }
     }
-    return NULL;
+    db_unlock();
+    
+    return table;
 }
 
-// Elimina una tabla
+// Elimina una tabla (nadie puede estar usándola: las consultas tienen el catálogo en lectura)
 int db_drop_table(const char *name) {
-    for (int i = 0; i < num_tables; i++) {
+    if (db_lock_schema() != 0) return -1;
+    
+    for (int i = 0; i < database.num_tables; i++) {
         if (tables[i] && strcmp(tables[i]->name, name) == 0) {
             // Liberar la tabla
             table_free(tables[i]);
             
             // Compactar el array moviendo las tablas restantes
-            for (int j = i; j < num_tables - 1; j++) {
+            for (int j = i; j < database.num_tables - 1; j++) {
                 tables[j] = tables[j + 1];
             }
-            tables[num_tables - 1] = NULL;
-            num_tables--;
+            tables[database.num_tables - 1] = NULL;
+            database.num_tables--;
+            database.schema_version++;
             
+            db_unlock();
             return 0;
         }
     }
     
+    db_unlock();
     return -1; // Tabla no encontrada
 }
 
@@ -92,21 +122,25 @@ int db_drop_table(const char *name) {
 char **db_get_table_names(int *count) {
     if (!count) return NULL;
     
+    db_lock_read();
+    
     // No hay tablas
-    if (num_tables == 0) {
+    if (database.num_tables == 0) {
         *count = 0;
+        db_unlock();
         return NULL;
     }
     
     // Crear array para los nombres
-    char **names = (char**)malloc(num_tables * sizeof(char*));
+    char **names = (char**)malloc(database.num_tables * sizeof(char*));
     if (!names) {
         *count = 0;
+        db_unlock();
         return NULL;
     }
     
     // Copiar los nombres
-    for (int i = 0; i < num_tables; i++) {
+    for (int i = 0; i < database.num_tables; i++) {
         if (tables[i] && tables[i]->name) {
             names[i] = strdup(tables[i]->name);
         } else {
@@ -114,6 +148,89 @@ char **db_get_table_names(int *count) {
         }
     }
     
-    *count = num_tables;
+    *count = database.num_tables;
+    db_unlock();
     return names;
-}
\ No newline at end of file
+}
+
+// Añade una columna a una tabla registrando el cambio de esquema
+int db_add_column(Table *table, const char *name, DataType type, int max_length, int is_primary_key, int allows_null) {
+    if (db_lock_schema() != 0) return -1;
+    
+    if (table_add_column(table, name, type, max_length, is_primary_key, allows_null) != 0) {
+        db_unlock();
+        return -1;
+    }
+    
+    database.schema_version++;
+    db_unlock();
+    return 0;
+}
+
+// Guarda las estadísticas de un ANALYZE (las lecturas del plan tienen el catálogo en lectura)
+int db_set_table_stats(const char *name, unsigned int schema_version, TableStats *stats) {
+    if (db_lock_schema() != 0) return -2;
+    
+    // La tabla pudo eliminarse o cambiar de columnas mientras se analizaba
+    Table *table = database.schema_version == schema_version ? db_find_table(name) : NULL;
+    if (!table) {
+        db_unlock();
+        return -1;
+    }
+    
+    stats_free(table->stats);
+    table->stats = stats;
+    
+    db_unlock();
+    return 0;
+}
+
+// Obtiene la base de datos global (para el validador y el ejecutor)
+Database *db_get_database() {
+    return &database;
+}
+
+// Toma el catálogo en lectura (otras consultas pueden tomarlo a la vez)
+void db_lock_read() {
+    if (catalog_depth++ == 0) pthread_rwlock_rdlock(&catalog_lock);
+}
+
+// Toma el catálogo en exclusiva para cambiar el esquema
+void db_lock_write() {
+    if (catalog_depth++ == 0) pthread_rwlock_wrlock(&catalog_lock);
+}
+
+// Toma el catálogo en exclusiva esperando como mucho timeout_ms
+int db_lock_write_timeout(int timeout_ms) {
+    if (catalog_depth > 0) {
+        catalog_depth++;
+        return 0;
+    }
+    
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    if (pthread_rwlock_timedwrlock(&catalog_lock, &deadline) != 0) return -1;
+    catalog_depth = 1;
+    return 0;
+}
+
+// Toma el catálogo para cambiar el esquema sin esperar indefinidamente
+int db_lock_schema() {
+    if (db_lock_write_timeout(CATALOG_LOCK_TIMEOUT_MS) == 0) return 0;
+    
+    output_printf("Error: El esquema está en uso por otra sesión (una transacción abierta o una "
+                  "consulta larga); inténtelo de nuevo\n");
+    return -1;
+}
+
+// Libera el catálogo cuando el hilo lo suelta tantas veces como lo tomó
+void db_unlock() {
+    if (--catalog_depth == 0) pthread_rwlock_unlock(&catalog_lock);
+}
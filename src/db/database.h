@@ -12,6 +12,7 @@ typedef struct {
     int num_tables;
     char *name;	
     int max_tables;
+    unsigned int schema_version;  // Se incrementa con cada cambio de esquema
 } Database;
 
 
@@ -24,7 +25,7 @@ void db_cleanup();
 // Crea una nueva tabla
 Table *db_create_table(const char *name);
 
-// Busca una tabla por nombre
+// Busca una tabla por nombre (el puntero solo es seguro mientras se tenga el catálogo)
 Table *db_find_table(const char *name);
 
 // Elimina una tabla
@@ -33,4 +34,35 @@ int db_drop_table(const char *name);
 // Obtiene la lista de tablas
 char **db_get_table_names(int *count);
 
+// Añade una columna a una tabla (invalida los planes compilados)
+int db_add_column(Table *table, const char *name, DataType type, int max_length, int is_primary_key, int allows_null);
+
+// Sustituye las estadísticas de una tabla por las de un ANALYZE que empezó con el
+// esquema en la versión schema_version. Si el esquema cambió desde entonces (-1) o
+// no se pudo tomar el catálogo (-2, con el error ya escrito) no las guarda y el
+// llamador debe liberarlas. No se puede llamar con el catálogo en
+// lectura (dentro de una transacción).
+int db_set_table_stats(const char *name, unsigned int schema_version, TableStats *stats);
+
+// Obtiene la base de datos global
+Database *db_get_database();
+
+// Bloqueo del catálogo (lista de tablas y sus esquemas). Las consultas lo toman en
+// lectura mientras usan las tablas y los cambios de esquema en escritura. Un hilo
+// puede volver a tomarlo si ya lo tiene, pero no pasar de lectura a escritura.
+void db_lock_read();
+void db_lock_write();
+void db_unlock();
+
+// Milisegundos que un cambio de esquema espera por el catálogo. Una transacción lo
+// tiene en lectura hasta COMMIT o ROLLBACK, así que no se espera indefinidamente.
+#define CATALOG_LOCK_TIMEOUT_MS 5000
+
+// Toma el catálogo en exclusiva esperando como mucho timeout_ms (0 si lo tomó)
+int db_lock_write_timeout(int timeout_ms);
+
+// Toma el catálogo para un cambio de esquema con CATALOG_LOCK_TIMEOUT_MS de espera;
+// si no lo consigue escribe el error (0 si lo tomó, -1 si no)
+int db_lock_schema();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "mvcc.h"
+
+// Última versión confirmada y contador de escrituras
+static atomic_ullong current_version;
+static atomic_ullong last_write;
+
+// Solo se confirma una escritura a la vez, para que las versiones se publiquen en orden
+static pthread_mutex_t commit_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Versiones de las lecturas abiertas (puede haber repetidas)
+static pthread_mutex_t readers_lock = PTHREAD_MUTEX_INITIALIZER;
+static RowVersion *readers = NULL;
+static int num_readers = 0;
+static int readers_capacity = 0;
+
+/*
+* Función para abrir una lectura sobre la última versión confirmada
+* @param snapshot Versión que verá la lectura
+* @return 0 si tuvo éxito, -1 si faltó memoria
+*/
+int mvcc_begin_read(RowVersion *snapshot) {
+    pthread_mutex_lock(&readers_lock);
+
+    if (num_readers == readers_capacity) {
+        int capacity = readers_capacity == 0 ? 16 : readers_capacity * 2;
+        RowVersion *grown = (RowVersion *)realloc(readers, capacity * sizeof(RowVersion));
+        if (!grown) {
+            pthread_mutex_unlock(&readers_lock);
+            return -1;
+        }
+        readers = grown;
+        readers_capacity = capacity;
+    }
+
+    // Se lee la versión con el registro tomado: quien calcule la lectura más
+    // antigua después ya cuenta con esta
+    *snapshot = atomic_load(&current_version);
+    readers[num_readers++] = *snapshot;
+
+    pthread_mutex_unlock(&readers_lock);
+    return 0;
+}
+
+/*
+* Función para cerrar una lectura
+* @param snapshot Versión devuelta al abrirla
+*/
+void mvcc_end_read(RowVersion snapshot) {
+    pthread_mutex_lock(&readers_lock);
+
+    for (int i = 0; i < num_readers; i++) {
+        if (readers[i] == snapshot) {
+            readers[i] = readers[--num_readers];
+            break;
+        }
+    }
+
+    if (num_readers == 0) {
+        free(readers);
+        readers = NULL;
+        readers_capacity = 0;
+    }
+
+    pthread_mutex_unlock(&readers_lock);
+}
+
+/*
+* Función para obtener la versión más antigua que puede ver una lectura abierta
+* @return Esa versión, o la última confirmada si no hay lecturas
+*/
+RowVersion mvcc_oldest_read(void) {
+    pthread_mutex_lock(&readers_lock);
+
+    RowVersion oldest = atomic_load(&current_version);
+    for (int i = 0; i < num_readers; i++) {
+        if (readers[i] < oldest) oldest = readers[i];
+    }
+
+    pthread_mutex_unlock(&readers_lock);
+    return oldest;
+}
+
+RowVersion mvcc_current_version(void) {
+    return atomic_load(&current_version);
+}
+
+RowVersion mvcc_new_write(void) {
+    return ROW_VERSION_PENDING | (atomic_fetch_add(&last_write, 1) + 1);
+}
+
+RowVersion mvcc_begin_commit(void) {
+    pthread_mutex_lock(&commit_lock);
+    return atomic_load(&current_version) + 1;
+}
+
+void mvcc_end_commit(RowVersion version) {
+    atomic_store(&current_version, version);
+    pthread_mutex_unlock(&commit_lock);
+}
+
+/*
+* Función para comprobar si una fila existe para una lectura
+* @param row Fila a comprobar
+* @param snapshot Versión que ve la lectura
+* @param write Escritura cuyos cambios pendientes ve la lectura (0 ninguna)
+* @return 1 si es visible, 0 si no
+*/
+int mvcc_row_visible(const Row *row, RowVersion snapshot, RowVersion write) {
+    // Una escritura puede sellar la fila mientras se lee
+    RowVersion xmin = __atomic_load_n(&row->xmin, __ATOMIC_ACQUIRE);
+    if (xmin & ROW_VERSION_PENDING) {
+        if (xmin != write) return 0;
+    } else if (xmin > snapshot) {
+        return 0;
+    }
+
+    RowVersion xmax = __atomic_load_n(&row->xmax, __ATOMIC_ACQUIRE);
+    if (xmax == 0) return 1;
+    if (xmax & ROW_VERSION_PENDING) return xmax != write;
+    return xmax > snapshot;
+}
@@ -0,0 +1,66 @@
+#ifndef MVCC_H
+#define MVCC_H
+
+#include "row.h"
+
+// Bit de las versiones pendientes (el resto identifica la escritura)
+#define ROW_VERSION_PENDING (1ULL << 63)
+
+// Instantánea que ve todas las versiones confirmadas
+#define ROW_VERSION_LATEST (ROW_VERSION_PENDING - 1)
+
+/**
+ * Abre una lectura: devuelve la última versión confirmada y la registra para
+ * que no se liberen las versiones que aún puede ver
+ * @param snapshot Versión que verá la lectura
+ * @return 0 si tuvo éxito, -1 si faltó memoria
+ */
+int mvcc_begin_read(RowVersion *snapshot);
+
+/**
+ * Cierra una lectura abierta con mvcc_begin_read
+ * @param snapshot Versión devuelta al abrirla
+ */
+void mvcc_end_read(RowVersion snapshot);
+
+/**
+ * Versión más antigua que puede ver alguna lectura abierta
+ * @return Esa versión, o la última confirmada si no hay lecturas
+ */
+RowVersion mvcc_oldest_read(void);
+
+/**
+ * Última versión confirmada
+ */
+RowVersion mvcc_current_version(void);
+
+/**
+ * Marca para los cambios de una escritura nueva, aún sin confirmar
+ * @return Versión pendiente única (con ROW_VERSION_PENDING)
+ */
+RowVersion mvcc_new_write(void);
+
+/**
+ * Empieza a confirmar una escritura. Las confirmaciones se hacen de una en una:
+ * entre mvcc_begin_commit y mvcc_end_commit se sellan las filas con la versión
+ * devuelta, que las lecturas solo ven a partir de mvcc_end_commit.
+ * @return Versión de la confirmación
+ */
+RowVersion mvcc_begin_commit(void);
+
+/**
+ * Publica la versión confirmada
+ * @param version Versión devuelta por mvcc_begin_commit
+ */
+void mvcc_end_commit(RowVersion version);
+
+/**
+ * Indica si una fila existe para una lectura
+ * @param row Fila a comprobar
+ * @param snapshot Versión que ve la lectura
+ * @param write Escritura cuyos cambios pendientes ve la lectura (0 ninguna)
+ * @return 1 si es visible, 0 si no
+ */
+int mvcc_row_visible(const Row *row, RowVersion snapshot, RowVersion write);
+
+#endif /* MVCC_H */
@@ -0,0 +1,519 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include "result.h"
+#include "../utils/output.h"
+#include "../utils/timing.h"
+
+// Formato del hilo actual, como una opción de la sesión
+static __thread ResultFormat current_format = RESULT_FORMAT_TABLE;
+
+static const char *format_names[] = {"table", "csv", "tsv", "jsonl", "binary"};
+
+ResultFormat result_get_format(void) {
+    return current_format;
+}
+
+void result_set_format(ResultFormat format) {
+    current_format = format;
+}
+
+int result_format_from_name(const char *name, ResultFormat *format) {
+    for (int i = 0; i < (int)(sizeof(format_names) / sizeof(format_names[0])); i++) {
+        if (strcasecmp(name, format_names[i]) == 0) {
+            *format = (ResultFormat)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *result_format_name(ResultFormat format) {
+    return format_names[format];
+}
+
+/*
+* Función para pasar a la salida lo acumulado en el buffer
+* @param sink Resultado
+*/
+static void result_flush(ResultSink *sink) {
+    if (sink->length > 0) {
+        fwrite(sink->buffer, 1, sink->length, output_stream());
+        sink->length = 0;
+    }
+}
+
+/*
+* Función para añadir texto al buffer del resultado
+* @param sink Resultado
+* @param data Texto a escribir
+* @param length Longitud del texto
+*/
+static void result_write(ResultSink *sink, const char *data, size_t length) {
+    if (sink->length + length > RESULT_BUFFER_SIZE) {
+        result_flush(sink);
+        if (length > RESULT_BUFFER_SIZE) {
+            fwrite(data, 1, length, output_stream());
+            return;
+        }
+    }
+    memcpy(sink->buffer + sink->length, data, length);
+    sink->length += length;
+}
+
+/*
+* Función para añadir count veces un carácter al buffer del resultado
+* @param sink Resultado
+* @param c Carácter
+* @param count Repeticiones
+*/
+static void result_fill(ResultSink *sink, char c, int count) {
+    while (count > 0) {
+        if (sink->length == RESULT_BUFFER_SIZE) result_flush(sink);
+
+        int chunk = RESULT_BUFFER_SIZE - (int)sink->length;
+        if (chunk > count) chunk = count;
+        memset(sink->buffer + sink->length, c, chunk);
+        sink->length += chunk;
+        count -= chunk;
+    }
+}
+
+static void result_write_string(ResultSink *sink, const char *str) {
+    result_write(sink, str, strlen(str));
+}
+
+// Columna de la tabla que ocupa la posición i del resultado
+static int result_column(const ResultSink *sink, int i) {
+    return sink->columns ? sink->columns[i] : i;
+}
+
+// Texto de un valor en los formatos de exportación: los FLOAT con todas sus cifras
+static const char *result_export_text(char *buffer, Value value, DataType type, int *length) {
+    if (type == TYPE_FLOAT) {
+        *length = value_format_float(buffer, value.float_val);
+        return buffer;
+    }
+    return value_format(buffer, value, type, length);
+}
+
+/**
+ * Formato de tabla
+ */
+
+// Escribe una celda rellenada hasta el ancho de su columna
+static void result_write_cell(ResultSink *sink, int i, const char *text, int length) {
+    result_write(sink, " ", 1);
+    result_write(sink, text, length);
+    result_fill(sink, ' ', sink->widths[i] - 2 - length);
+    result_write(sink, "|", 1);
+}
+
+// Escribe una línea horizontal de separación
+static void result_write_separator(ResultSink *sink) {
+    result_write(sink, "+", 1);
+    for (int i = 0; i < sink->num_columns; i++) {
+        result_fill(sink, '-', sink->widths[i]);
+        result_write(sink, "+", 1);
+    }
+    result_write(sink, "\n", 1);
+}
+
+static void table_write_row(ResultSink *sink, const Row *row) {
+    const Table *table = sink->table;
+    char number[VALUE_NUMBER_LENGTH];
+
+    result_write(sink, "|", 1);
+    for (int i = 0; i < sink->num_columns; i++) {
+        int col = result_column(sink, i);
+        int length;
+        const char *text = value_format(number, row->values[col], table->columns[col].type, &length);
+        result_write_cell(sink, i, text, length);
+    }
+    result_write(sink, "\n", 1);
+}
+
+/*
+* Función para fijar los anchos con las filas de la muestra y escribir la cabecera
+* y las filas retenidas
+* @param sink Resultado
+*/
+static void result_start(ResultSink *sink) {
+    const Table *table = sink->table;
+    char number[VALUE_NUMBER_LENGTH];
+
+    for (int i = 0; i < sink->num_columns; i++) {
+        int col = result_column(sink, i);
+        int width = (int)strlen(table->columns[col].name);
+
+        for (int j = 0; j < sink->num_sample; j++) {
+            const Row *row = &table->rows[sink->sample[j]];
+            int value_width;
+            value_format(number, row->values[col], table->columns[col].type, &value_width);
+            if (value_width > width) width = value_width;
+        }
+
+        // Espacio para el relleno
+        sink->widths[i] = width + 2;
+    }
+
+    result_write_string(sink, "Tabla: ");
+    result_write_string(sink, table->name);
+    result_write(sink, "\n", 1);
+
+    result_write_separator(sink);
+    result_write(sink, "|", 1);
+    for (int i = 0; i < sink->num_columns; i++) {
+        const char *name = table->columns[result_column(sink, i)].name;
+        result_write_cell(sink, i, name, (int)strlen(name));
+    }
+    result_write(sink, "\n", 1);
+    result_write_separator(sink);
+
+    for (int j = 0; j < sink->num_sample; j++) {
+        table_write_row(sink, &table->rows[sink->sample[j]]);
+    }
+
+    free(sink->sample);
+    sink->sample = NULL;
+    sink->num_sample = 0;
+    sink->streaming = 1;
+}
+
+/**
+ * Formatos CSV y TSV
+ */
+
+// Escribe un campo CSV, entre comillas si contiene separadores, comillas o saltos de línea
+static void csv_write_field(ResultSink *sink, const char *text, int length) {
+    int quote = 0;
+    for (int i = 0; i < length && !quote; i++) {
+        quote = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+    }
+    if (!quote) {
+        result_write(sink, text, length);
+        return;
+    }
+
+    // Las comillas del valor se duplican
+    result_write(sink, "\"", 1);
+    int start = 0;
+    for (int i = 0; i < length; i++) {
+        if (text[i] == '"') {
+            result_write(sink, text + start, i + 1 - start);
+            start = i;
+        }
+    }
+    result_write(sink, text + start, length - start);
+    result_write(sink, "\"", 1);
+}
+
+// Escribe un campo TSV escapando tabuladores, saltos de línea y barras invertidas
+static void tsv_write_field(ResultSink *sink, const char *text, int length) {
+    int start = 0;
+    for (int i = 0; i < length; i++) {
+        const char *escape = NULL;
+        switch (text[i]) {
+            case '\t': escape = "\\t"; break;
+            case '\n': escape = "\\n"; break;
+            case '\r': escape = "\\r"; break;
+            case '\\': escape = "\\\\"; break;
+        }
+        if (escape) {
+            result_write(sink, text + start, i - start);
+            result_write(sink, escape, 2);
+            start = i + 1;
+        }
+    }
+    result_write(sink, text + start, length - start);
+}
+
+static void delimited_write_field(ResultSink *sink, const char *text, int length) {
+    if (sink->format == RESULT_FORMAT_CSV) {
+        csv_write_field(sink, text, length);
+    } else {
+        tsv_write_field(sink, text, length);
+    }
+}
+
+static void delimited_write_header(ResultSink *sink) {
+    const char *separator = sink->format == RESULT_FORMAT_CSV ? "," : "\t";
+
+    for (int i = 0; i < sink->num_columns; i++) {
+        const char *name = sink->table->columns[result_column(sink, i)].name;
+        if (i > 0) result_write(sink, separator, 1);
+        delimited_write_field(sink, name, (int)strlen(name));
+    }
+    result_write(sink, "\n", 1);
+}
+
+static void delimited_write_row(ResultSink *sink, const Row *row) {
+    const Table *table = sink->table;
+    const char *separator = sink->format == RESULT_FORMAT_CSV ? "," : "\t";
+    char number[VALUE_NUMBER_LENGTH];
+
+    for (int i = 0; i < sink->num_columns; i++) {
+        int col = result_column(sink, i);
+        int length;
+        const char *text = result_export_text(number, row->values[col], table->columns[col].type, &length);
+        if (i > 0) result_write(sink, separator, 1);
+        delimited_write_field(sink, text, length);
+    }
+    result_write(sink, "\n", 1);
+}
+
+/**
+ * Formato JSON Lines
+ */
+
+// Escribe una cadena JSON entre comillas con los caracteres especiales escapados
+static void json_write_string(ResultSink *sink, const char *text, int length) {
+    static const char hex[] = "0123456789abcdef";
+
+    result_write(sink, "\"", 1);
+    int start = 0;
+    for (int i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+        result_write(sink, text + start, i - start);
+        start = i + 1;
+
+        char escape[6] = {'\\', (char)c, 0, 0, 0, 0};
+        int escape_length = 2;
+        switch (c) {
+            case '"': case '\\': break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            default:
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = hex[c >> 4];
+                escape[5] = hex[c & 0xF];
+                escape_length = 6;
+                break;
+        }
+        result_write(sink, escape, escape_length);
+    }
+    result_write(sink, text + start, length - start);
+    result_write(sink, "\"", 1);
+}
+
+static void jsonl_write_row(ResultSink *sink, const Row *row) {
+    const Table *table = sink->table;
+    char number[VALUE_NUMBER_LENGTH];
+
+    result_write(sink, "{", 1);
+    for (int i = 0; i < sink->num_columns; i++) {
+        int col = result_column(sink, i);
+        const Column *column = &table->columns[col];
+        Value value = row->values[col];
+
+        if (i > 0) result_write(sink, ",", 1);
+        json_write_string(sink, column->name, (int)strlen(column->name));
+        result_write(sink, ":", 1);
+
+        // NULL y los FLOAT no finitos no tienen representación en JSON
+        int length;
+        const char *text = result_export_text(number, value, column->type, &length);
+        if ((column->type == TYPE_STRING && !value.string_val) ||
+            (column->type == TYPE_FLOAT && !isfinite(value.float_val))) {
+            result_write(sink, "null", 4);
+        } else if (column->type == TYPE_STRING) {
+            json_write_string(sink, text, length);
+        } else {
+            result_write(sink, text, length);
+        }
+    }
+    result_write(sink, "}\n", 2);
+}
+
+/**
+ * Formato binario
+ */
+
+static void binary_write_u8(ResultSink *sink, unsigned int value) {
+    unsigned char byte = (unsigned char)value;
+    result_write(sink, (const char *)&byte, 1);
+}
+
+static void binary_write_u16(ResultSink *sink, unsigned int value) {
+    unsigned char bytes[2] = {(unsigned char)value, (unsigned char)(value >> 8)};
+    result_write(sink, (const char *)bytes, 2);
+}
+
+static void binary_write_u32(ResultSink *sink, unsigned int value) {
+    unsigned char bytes[4] = {(unsigned char)value, (unsigned char)(value >> 8),
+                              (unsigned char)(value >> 16), (unsigned char)(value >> 24)};
+    result_write(sink, (const char *)bytes, 4);
+}
+
+static void binary_write_header(ResultSink *sink) {
+    result_write(sink, "NQLB", 4);
+    binary_write_u8(sink, RESULT_BINARY_VERSION);
+    binary_write_u16(sink, (unsigned int)sink->num_columns);
+
+    for (int i = 0; i < sink->num_columns; i++) {
+        const Column *column = &sink->table->columns[result_column(sink, i)];
+        int length = (int)strlen(column->name);
+        binary_write_u8(sink, column->type);
+        binary_write_u16(sink, (unsigned int)length);
+        result_write(sink, column->name, length);
+    }
+}
+
+static void binary_write_row(ResultSink *sink, const Row *row) {
+    const Table *table = sink->table;
+
+    result_write(sink, "R", 1);
+    for (int i = 0; i < sink->num_columns; i++) {
+        int col = result_column(sink, i);
+        Value value = row->values[col];
+
+        switch (table->columns[col].type) {
+            case TYPE_INT:
+                binary_write_u32(sink, (unsigned int)value.int_val);
+                break;
+            case TYPE_FLOAT: {
+                unsigned int bits;
+                memcpy(&bits, &value.float_val, sizeof(bits));
+                binary_write_u32(sink, bits);
+                break;
+            }
+            case TYPE_BOOL:
+                binary_write_u8(sink, value.bool_val ? 1 : 0);
+                break;
+            case TYPE_STRING:
+                if (!value.string_val) {
+                    binary_write_u32(sink, 0xFFFFFFFFu);
+                } else {
+                    int length = (int)strlen(value.string_val);
+                    binary_write_u32(sink, (unsigned int)length);
+                    result_write(sink, value.string_val, length);
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * Resultado
+ */
+
+/*
+* Función para preparar un resultado en el formato del hilo actual
+* @param sink Resultado a preparar
+* @param table Tabla de la que salen las filas
+* @param columns Columnas a escribir (NULL para las num_columns primeras)
+* @param num_columns Número de columnas
+* @return 0 si tuvo éxito, -1 si faltó memoria
+*/
+int result_open(ResultSink *sink, const Table *table, const int *columns, int num_columns) {
+    memset(sink, 0, sizeof(ResultSink));
+    sink->format = current_format;
+    sink->table = table;
+    sink->columns = columns;
+
+    // Sin columnas solo se avisa al cerrar
+    if (!table || num_columns <= 0) return 0;
+
+    // Solo la tabla necesita retener filas para calcular los anchos
+    sink->num_columns = num_columns;
+    sink->buffer = (char *)malloc(RESULT_BUFFER_SIZE);
+    if (sink->format == RESULT_FORMAT_TABLE) {
+        sink->widths = (int *)malloc(num_columns * sizeof(int));
+        sink->sample = (int *)malloc(RESULT_SAMPLE_ROWS * sizeof(int));
+    }
+    if (!sink->buffer || (sink->format == RESULT_FORMAT_TABLE && (!sink->widths || !sink->sample))) {
+        free(sink->widths);
+        free(sink->sample);
+        free(sink->buffer);
+        return -1;
+    }
+
+    switch (sink->format) {
+        case RESULT_FORMAT_CSV:
+        case RESULT_FORMAT_TSV: delimited_write_header(sink); break;
+        case RESULT_FORMAT_BINARY: binary_write_header(sink); break;
+        default: break;
+    }
+    return 0;
+}
+
+/*
+* Función para añadir una fila al resultado
+* @param sink Resultado
+* @param row_index Índice de la fila en la tabla
+*/
+void result_add_row(ResultSink *sink, int row_index) {
+    if (sink->num_columns == 0) return;
+
+    int mark = timing_enter(TIMING_OUTPUT);
+    const Row *row = &sink->table->rows[row_index];
+    sink->num_rows++;
+
+    switch (sink->format) {
+        case RESULT_FORMAT_TABLE:
+            if (sink->streaming) {
+                table_write_row(sink, row);
+            } else {
+                sink->sample[sink->num_sample++] = row_index;
+                if (sink->num_sample == RESULT_SAMPLE_ROWS) result_start(sink);
+            }
+            break;
+        case RESULT_FORMAT_CSV:
+        case RESULT_FORMAT_TSV: delimited_write_row(sink, row); break;
+        case RESULT_FORMAT_JSONL: jsonl_write_row(sink, row); break;
+        case RESULT_FORMAT_BINARY: binary_write_row(sink, row); break;
+    }
+    timing_leave(mark);
+}
+
+/*
+* Función para terminar un resultado
+* @param sink Resultado
+*/
+void result_close(ResultSink *sink) {
+    if (sink->num_columns == 0) {
+        if (sink->format == RESULT_FORMAT_TABLE) {
+            output_printf("Tabla vacía o sin columnas definidas.\n");
+        }
+        return;
+    }
+
+    int mark = timing_enter(TIMING_OUTPUT);
+    if (sink->format == RESULT_FORMAT_TABLE) {
+        if (!sink->streaming) result_start(sink);
+        result_write_separator(sink);
+
+        char footer[64];
+        snprintf(footer, sizeof(footer), "%d fila%s en total\n", sink->num_rows, sink->num_rows == 1 ? "" : "s");
+        result_write_string(sink, footer);
+    } else if (sink->format == RESULT_FORMAT_BINARY) {
+        result_write(sink, "E", 1);
+        binary_write_u32(sink, (unsigned int)sink->num_rows);
+    }
+    result_flush(sink);
+
+    free(sink->widths);
+    free(sink->buffer);
+    memset(sink, 0, sizeof(ResultSink));
+    timing_leave(mark);
+}
+
+/*
+* Función para liberar un resultado sin terminarlo
+* @param sink Resultado
+*/
+void result_discard(ResultSink *sink) {
+    free(sink->widths);
+    free(sink->sample);
+    free(sink->buffer);
+    memset(sink, 0, sizeof(ResultSink));
+}
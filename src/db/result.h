@@ -0,0 +1,70 @@
+#ifndef RESULT_H
+#define RESULT_H
+
+#include <stddef.h>
+#include "table.h"
+
+// Filas que se guardan antes de fijar el ancho de las columnas. Un resultado más corto
+// se imprime con los anchos exactos; en uno más largo las filas siguientes se escriben
+// según llegan con los anchos de la muestra (un valor más ancho desalinea su fila).
+#define RESULT_SAMPLE_ROWS 1000
+
+// Tamaño del buffer de escritura del resultado
+#define RESULT_BUFFER_SIZE (64 * 1024)
+
+// Formatos en los que se escriben los resultados
+typedef enum {
+    RESULT_FORMAT_TABLE,     // Tabla con bordes, para leerla en la terminal
+    RESULT_FORMAT_CSV,       // Cabecera y filas separadas por comas (comillas según RFC 4180)
+    RESULT_FORMAT_TSV,       // Cabecera y filas separadas por tabuladores (\t, \n, \r y \\ escapados)
+    RESULT_FORMAT_JSONL,     // Un objeto JSON por fila con los nombres de columna como claves
+    RESULT_FORMAT_BINARY     // Formato binario (ver abajo)
+} ResultFormat;
+
+// Formato binario (enteros little-endian):
+//   cabecera "NQLB", versión (1 byte = 1), número de columnas (u16) y por cada columna
+//   su DataType (u8), la longitud de su nombre (u16) y el nombre
+//   por fila 'R' y sus valores: INT i32, FLOAT f32, BOOL u8, STRING longitud (u32) y
+//   bytes (0xFFFFFFFF si es NULL)
+//   al final 'E' y el número de filas (u32)
+#define RESULT_BINARY_VERSION 1
+
+// Formato de los resultados del hilo actual (por defecto RESULT_FORMAT_TABLE)
+ResultFormat result_get_format(void);
+void result_set_format(ResultFormat format);
+
+// Busca un formato por su nombre: table, csv, tsv, jsonl o binary (0 si existe, -1 si no)
+int result_format_from_name(const char *name, ResultFormat *format);
+
+// Nombre de un formato
+const char *result_format_name(ResultFormat format);
+
+// Destino de las filas de un resultado: las escribe en la salida del hilo actual
+// (output_stream) en el formato del hilo, sin recorrer el resultado dos veces
+typedef struct {
+    ResultFormat format;
+    const Table *table;
+    const int *columns;      // Columnas a escribir (NULL para las num_columns primeras)
+    int num_columns;
+    int *widths;             // Ancho de cada columna, incluido el relleno
+    int *sample;             // Filas retenidas hasta fijar los anchos
+    int num_sample;
+    int streaming;           // Anchos fijados y cabecera escrita
+    int num_rows;            // Filas recibidas
+    char *buffer;
+    size_t length;
+} ResultSink;
+
+// Prepara un resultado con las columnas indicadas de table (0 si tuvo éxito, -1 si faltó memoria)
+int result_open(ResultSink *sink, const Table *table, const int *columns, int num_columns);
+
+// Añade la fila row_index de la tabla al resultado
+void result_add_row(ResultSink *sink, int row_index);
+
+// Escribe lo pendiente y el total de filas y libera el resultado
+void result_close(ResultSink *sink);
+
+// Libera el resultado sin escribir lo pendiente (la consulta falló a mitad)
+void result_discard(ResultSink *sink);
+
+#endif /* RESULT_H */
@@ -22,6 +22,8 @@ int row_find_by_primary_key(Table* table, Value key_value, int* row_index) {
     
     // Buscar la fila con el valor de clave primaria
     for (int i = 0; i < table->num_rows; i++) {
+        if (!table_row_visible(table, &table->rows[i])) continue;
+        
         Value row_value = table->rows[i].values[pk_col];
         int match = 0;
         
@@ -6,10 +6,17 @@
 // Forward declaration
 struct Table;
 
-// Estructura para la fila de una tabla
+// Versión en la que se confirmó un cambio. Las versiones con el bit alto
+// (ROW_VERSION_PENDING) marcan cambios de una escritura aún sin confirmar.
+typedef unsigned long long RowVersion;
+
+// Estructura para la fila de una tabla. Cada fila es una versión: existe para
+// las lecturas posteriores a xmin y anteriores a xmax.
 typedef struct {
     Value* values;  // Array of values, one for each column
     int is_deleted; // Soft delete flag
+    RowVersion xmin; // Versión que creó la fila (0: existía desde el principio)
+    RowVersion xmax; // Versión que la eliminó o sustituyó (0 si sigue viva)
 } Row;
 
 // Función para buscar una fila por valor de clave primaria
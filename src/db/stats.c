@@ -0,0 +1,139 @@
+#include <stdlib.h>
+#include <string.h>
+#include "stats.h"
+
+/*
+* Función para crear estadísticas vacías
+* @param types Tipo de cada columna
+* @param num_columns Número de columnas
+* @return Estadísticas creadas (NULL si falta memoria)
+*/
+TableStats* stats_create(const DataType* types, int num_columns) {
+    TableStats* stats = (TableStats*)calloc(1, sizeof(TableStats));
+    if (!stats) return NULL;
+
+    if (num_columns > 0) {
+        stats->columns = (ColumnStats*)calloc(num_columns, sizeof(ColumnStats));
+        if (!stats->columns) {
+            free(stats);
+            return NULL;
+        }
+    }
+
+    stats->num_columns = num_columns;
+    for (int i = 0; i < num_columns; i++) {
+        stats->columns[i].type = types[i];
+    }
+    return stats;
+}
+
+// Libera un valor de las estadísticas (solo las cadenas tienen memoria propia)
+static void stats_free_value(Value value, DataType type) {
+    if (type == TYPE_STRING) free(value.string_val);
+}
+
+/*
+* Función para liberar unas estadísticas
+* @param stats Estadísticas a liberar
+*/
+void stats_free(TableStats* stats) {
+    if (!stats) return;
+
+    for (int i = 0; i < stats->num_columns; i++) {
+        ColumnStats* column = &stats->columns[i];
+        if (column->has_bounds) {
+            stats_free_value(column->min, column->type);
+            stats_free_value(column->max, column->type);
+        }
+        if (column->bounds) {
+            for (int b = 0; b <= column->num_buckets; b++) {
+                stats_free_value(column->bounds[b], column->type);
+            }
+            free(column->bounds);
+        }
+    }
+
+    free(stats->columns);
+    free(stats);
+}
+
+/*
+* Función para obtener las estadísticas de una columna
+* @param stats Estadísticas de la tabla (puede ser NULL)
+* @param column Índice de la columna
+* @return Estadísticas de la columna, o NULL si no se analizó
+*/
+const ColumnStats* stats_get_column(const TableStats* stats, int column) {
+    if (!stats || column < 0 || column >= stats->num_columns) return NULL;
+    return &stats->columns[column];
+}
+
+/*
+* Función para comparar dos valores del mismo tipo
+* @param a Primer valor
+* @param b Segundo valor
+* @param type Tipo de ambos
+* @return Negativo si a < b, 0 si son iguales, positivo si a > b
+*/
+int stats_compare_values(Value a, Value b, DataType type) {
+    switch (type) {
+        case TYPE_INT: return (a.int_val > b.int_val) - (a.int_val < b.int_val);
+        case TYPE_FLOAT: return (a.float_val > b.float_val) - (a.float_val < b.float_val);
+        case TYPE_BOOL: return (a.bool_val != 0) - (b.bool_val != 0);
+        case TYPE_STRING:
+            if (!a.string_val || !b.string_val) {
+                return (a.string_val != NULL) - (b.string_val != NULL);
+            }
+            return strcmp(a.string_val, b.string_val);
+    }
+    return 0;
+}
+
+// Posición de value entre low y high (de 0 a 1). Las cadenas no tienen una distancia
+// con sentido, así que se toma el punto medio.
+static double stats_interpolate(Value low, Value value, Value high, DataType type) {
+    double from, at, to;
+    switch (type) {
+        case TYPE_INT: from = low.int_val; at = value.int_val; to = high.int_val; break;
+        case TYPE_FLOAT: from = low.float_val; at = value.float_val; to = high.float_val; break;
+        case TYPE_BOOL: from = low.bool_val != 0; at = value.bool_val != 0; to = high.bool_val != 0; break;
+        default: return 0.5;
+    }
+
+    if (to <= from) return 0.5;
+    double position = (at - from) / (to - from);
+    return position < 0 ? 0 : (position > 1 ? 1 : position);
+}
+
+/*
+* Función para estimar qué parte de una columna está por debajo de un valor
+* @param stats Estadísticas de la columna
+* @param value Valor del tipo de la columna
+* @param inclusive 1 para contar también los valores iguales
+* @return Fracción de los valores no nulos (de 0 a 1)
+*/
+double stats_fraction_below(const ColumnStats* stats, Value value, int inclusive) {
+    if (!stats || !stats->has_bounds || stats->num_buckets <= 0) return 0;
+
+    const Value* bounds = stats->bounds;
+    int buckets = stats->num_buckets;
+    DataType type = stats->type;
+
+    if (inclusive) {
+        if (stats_compare_values(value, bounds[0], type) < 0) return 0;
+        if (stats_compare_values(value, bounds[buckets], type) >= 0) return 1;
+
+        // Último intervalo que empieza en un valor <= value: bounds[i] <= value < bounds[i + 1]
+        int i = buckets - 1;
+        while (i > 0 && stats_compare_values(bounds[i], value, type) > 0) i--;
+        return (i + stats_interpolate(bounds[i], value, bounds[i + 1], type)) / buckets;
+    }
+
+    if (stats_compare_values(value, bounds[0], type) <= 0) return 0;
+    if (stats_compare_values(value, bounds[buckets], type) > 0) return 1;
+
+    // Primer intervalo que acaba en un valor >= value: bounds[i] < value <= bounds[i + 1]
+    int i = 0;
+    while (i < buckets - 1 && stats_compare_values(bounds[i + 1], value, type) < 0) i++;
+    return (i + stats_interpolate(bounds[i], value, bounds[i + 1], type)) / buckets;
+}
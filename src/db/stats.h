@@ -0,0 +1,48 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "value.h"
+
+// Intervalos de los histogramas (cada uno con aproximadamente las mismas filas)
+#define STATS_HISTOGRAM_BUCKETS 16
+
+// Estadísticas de una columna calculadas por ANALYZE. Solo las cadenas distinguen
+// NULL (las demás columnas guardan un NULL como 0), así que en el resto la fracción
+// de nulos es siempre 0.
+typedef struct {
+    DataType type;             // Tipo de la columna al analizarla
+    long long num_nulls;
+    double null_fraction;      // num_nulls / filas de la tabla
+    long long num_distinct;    // Valores distintos sin contar NULL (estimación HyperLogLog)
+    int has_bounds;            // Hay algún valor no nulo (min, max e histograma son válidos)
+    Value min;                 // Las cadenas pertenecen a las estadísticas
+    Value max;
+    int num_buckets;           // Intervalos del histograma (0 si no hay valores)
+    Value* bounds;             // num_buckets + 1 límites en orden; entre dos seguidos
+                               // cae la misma fracción de los valores no nulos
+} ColumnStats;
+
+// Estadísticas de una tabla. Las columnas añadidas después del ANALYZE no tienen.
+typedef struct TableStats {
+    long long num_rows;        // Filas visibles al analizarla
+    int num_columns;
+    ColumnStats* columns;
+} TableStats;
+
+// Crea estadísticas vacías para num_columns columnas de los tipos indicados
+TableStats* stats_create(const DataType* types, int num_columns);
+
+// Libera unas estadísticas
+void stats_free(TableStats* stats);
+
+// Estadísticas de una columna (NULL si no hay o la columna es posterior al ANALYZE)
+const ColumnStats* stats_get_column(const TableStats* stats, int column);
+
+// Fracción de los valores no nulos de la columna menores que value (o iguales si
+// inclusive), interpolando dentro del intervalo del histograma en que cae
+double stats_fraction_below(const ColumnStats* stats, Value value, int inclusive);
+
+// Compara dos valores de un mismo tipo (negativo, 0 o positivo)
+int stats_compare_values(Value a, Value b, DataType type);
+
+#endif /* STATS_H */
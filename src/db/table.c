@@ -1,7 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "table.h"
+#include "mvcc.h"
+#include "result.h"
+#include "../utils/output.h"
+
+// Array de filas sustituido que aún puede estar leyendo una vista
+typedef struct RetiredRows {
+    Row* rows;
+    RowVersion version;           // Última versión confirmada al sustituirlo
+    struct RetiredRows* next;
+} RetiredRows;
 
 /*
 * Función para crear una tabla
@@ -15,9 +26,23 @@ Table* table_create(const char* name) {
     table->name = strdup(name);
     table->columns = NULL;
     table->num_columns = 0;
+    column_map_init(&table->column_map);
     table->rows = NULL;
     table->num_rows = 0;
     table->capacity = 0;
+    pthread_rwlock_init(&table->lock, NULL);
+    pthread_mutex_init(&table->latch, NULL);
+    table->readers = 0;
+    table->num_dead = 0;
+    table->retired = NULL;
+    table->snapshot = ROW_VERSION_LATEST;
+    table->write = 0;
+    table->stats = NULL;
+    table->changes = 1;
+    table->last_commit = 0;
+    table->key_order = NULL;
+    table->order_changes = 0;
+    table->origin = NULL;
     
     return table;
 }
@@ -29,14 +54,6 @@ Table* table_create(const char* name) {
 void table_free(Table* table) {
     if (!table) return;
     
-    // Liberar memoria de las columnas
-    if (table->columns) {
-        for (int i = 0; i < table->num_columns; i++) {
-            free(table->columns[i].name);
-        }
-        free(table->columns);
-    }
-    
     // Liberar memoria de las filas y sus valores
     if (table->rows) {
         for (int i = 0; i < table->num_rows; i++) {
@@ -54,6 +71,27 @@ void table_free(Table* table) {
         free(table->rows);
     }
     
+    // Liberar memoria de las columnas (después de las filas, que consultan sus tipos)
+    if (table->columns) {
+        for (int i = 0; i < table->num_columns; i++) {
+            free(table->columns[i].name);
+        }
+        free(table->columns);
+    }
+    column_map_free(&table->column_map);
+    stats_free(table->stats);
+    free(table->key_order);
+    pthread_rwlock_destroy(&table->lock);
+    pthread_mutex_destroy(&table->latch);
+    
+    // Los arrays retirados comparten los valores con el actual, ya liberados
+    while (table->retired) {
+        RetiredRows* retired = table->retired;
+        table->retired = retired->next;
+        free(retired->rows);
+        free(retired);
+    }
+    
     free(table->name);
     free(table);
 }
@@ -86,8 +124,19 @@ int table_add_column(Table* table, const char* name, DataType type,
     table->columns[table->num_columns].is_primary_key = is_primary_key;
     table->columns[table->num_columns].allows_null = allows_null;
     
+    // Registrar el nombre en el mapa de columnas
+    if (column_map_insert(&table->column_map, table->columns, table->num_columns) != 0) {
+        free(table->columns[table->num_columns].name);
+        return -1;
+    }
+    
     table->num_columns++;
     
+    // El orden guardado tiene una entrada por columna
+    free(table->key_order);
+    table->key_order = NULL;
+    table->changes++;
+    
     // Si ya existen filas, debemos expandir sus arrays de valores
     for (int i = 0; i < table->num_rows; i++) {
         Value* new_values = (Value*)realloc(table->rows[i].values, 
@@ -102,6 +151,84 @@ int table_add_column(Table* table, const char* name, DataType type,
     return 0;
 }
 
+/*
+* Función para crear una tabla vacía con las columnas de dos tablas unidas
+* Las columnas se llaman tabla.columna para que no se repitan entre ambas
+* @param left Tabla izquierda (sus columnas van primero)
+* @param right Tabla derecha
+* @return Puntero a la tabla creada, o NULL si hubo un error
+*/
+Table* table_create_joined(const Table* left, const Table* right) {
+    if (!left || !right) return NULL;
+    
+    char name[256];
+    snprintf(name, sizeof(name), "%s JOIN %s", left->name, right->name);
+    
+    Table* joined = table_create(name);
+    if (!joined) return NULL;
+    
+    const Table* sources[2] = { left, right };
+    for (int t = 0; t < 2; t++) {
+        for (int i = 0; i < sources[t]->num_columns; i++) {
+            const Column* column = &sources[t]->columns[i];
+            char column_name[256];
+            snprintf(column_name, sizeof(column_name), "%s.%s", sources[t]->name, column->name);
+            
+            if (table_add_column(joined, column_name, column->type, column->max_length, 0,
+                                 column->allows_null) != 0) {
+                table_free(joined);
+                return NULL;
+            }
+        }
+    }
+    
+    return joined;
+}
+
+/*
+* Función para asegurar espacio para needed filas. Si hay vistas abiertas el array
+* no se redimensiona en su sitio: se copia y el antiguo se conserva hasta que
+* nadie pueda leerlo.
+* @param table Puntero a la tabla
+* @param needed Número de filas que debe poder contener
+* @return 0 si hay espacio, -1 si faltó memoria
+*/
+static int table_reserve(Table* table, int needed) {
+    if (needed <= table->capacity) return 0;
+    
+    int new_capacity = table->capacity == 0 ? 1 : table->capacity;
+    while (new_capacity < needed) new_capacity *= 2;
+    
+    pthread_mutex_lock(&table->latch);
+    
+    Row* new_rows;
+    if (table->readers == 0) {
+        new_rows = (Row*)realloc(table->rows, new_capacity * sizeof(Row));
+    } else {
+        new_rows = (Row*)malloc(new_capacity * sizeof(Row));
+        RetiredRows* retired = (RetiredRows*)malloc(sizeof(RetiredRows));
+        if (new_rows && retired) {
+            memcpy(new_rows, table->rows, table->num_rows * sizeof(Row));
+            retired->rows = table->rows;
+            retired->version = mvcc_current_version();
+            retired->next = table->retired;
+            table->retired = retired;
+        } else {
+            free(new_rows);
+            free(retired);
+            new_rows = NULL;
+        }
+    }
+    
+    if (new_rows) {
+        table->rows = new_rows;
+        table->capacity = new_capacity;
+    }
+    
+    pthread_mutex_unlock(&table->latch);
+    return new_rows ? 0 : -1;
+}
+
 /*
 * Función para agregar una fila a una tabla
 * @param table Puntero a la tabla
@@ -112,20 +239,15 @@ int table_add_row(Table* table, Value* values) {
     if (!table || !values) return -1;
     
     // Expandir el array de filas si es necesario
-    if (table->num_rows >= table->capacity) {
-        int new_capacity = table->capacity == 0 ? 1 : table->capacity * 2;
-        Row* new_rows = (Row*)realloc(table->rows, new_capacity * sizeof(Row));
-        if (!new_rows) return -1;
-        
-        table->rows = new_rows;
-        table->capacity = new_capacity;
-    }
+    if (table_reserve(table, table->num_rows + 1) != 0) return -1;
     
     // Inicializar la nueva fila
     table->rows[table->num_rows].values = (Value*)malloc(table->num_columns * sizeof(Value));
     if (!table->rows[table->num_rows].values) return -1;
     
     table->rows[table->num_rows].is_deleted = 0;
+    table->rows[table->num_rows].xmin = 0;
+    table->rows[table->num_rows].xmax = 0;
     
     // Copiar los valores proporcionados
     for (int i = 0; i < table->num_columns; i++) {
@@ -136,7 +258,80 @@ int table_add_row(Table* table, Value* values) {
         }
     }
     
+    pthread_mutex_lock(&table->latch);
     table->num_rows++;
+    table->changes++;
+    pthread_mutex_unlock(&table->latch);
+    
+    return 0;
+}
+
+/*
+* Función para agregar varias filas a una tabla con una sola reserva de memoria
+* @param table Puntero a la tabla
+* @param values Valores de las filas, una fila tras otra (num_rows * num_columns)
+* @param num_rows Número de filas a agregar
+* @return 0 si se agregaron todas las filas, -1 si hubo un error (no se agrega ninguna)
+*/
+int table_append_rows(Table* table, Value* values, int num_rows) {
+    return table_append_versions(table, values, num_rows, 0);
+}
+
+/*
+* Función para agregar varias filas creadas por una escritura
+* Las filas quedan visibles para las vistas que se abran después, que las
+* descartan mientras xmin siga pendiente
+* @param table Puntero a la tabla
+* @param values Valores de las filas, una fila tras otra (num_rows * num_columns)
+* @param num_rows Número de filas a agregar
+* @param xmin Versión que crea las filas
+* @return 0 si se agregaron todas las filas, -1 si hubo un error (no se agrega ninguna)
+*/
+int table_append_versions(Table* table, Value* values, int num_rows, RowVersion xmin) {
+    if (!table || (num_rows > 0 && !values)) return -1;
+    
+    // Reservar espacio para todas las filas de una vez
+    if (table_reserve(table, table->num_rows + num_rows) != 0) return -1;
+    
+    // Un único bloque para los valores de todas las filas nuevas no se puede
+    // liberar fila a fila, así que cada fila recibe su propio array
+    int added = 0;
+    for (; added < num_rows; added++) {
+        Row* row = &table->rows[table->num_rows + added];
+        const Value* source = &values[added * table->num_columns];
+        
+        row->values = (Value*)malloc((table->num_columns > 0 ? table->num_columns : 1) * sizeof(Value));
+        if (!row->values) break;
+        row->is_deleted = 0;
+        __atomic_store_n(&row->xmin, xmin, __ATOMIC_RELEASE);
+        __atomic_store_n(&row->xmax, 0, __ATOMIC_RELEASE);
+        
+        for (int i = 0; i < table->num_columns; i++) {
+            if (table->columns[i].type == TYPE_STRING && source[i].string_val) {
+                row->values[i].string_val = strdup(source[i].string_val);
+            } else {
+                row->values[i] = source[i];
+            }
+        }
+    }
+    
+    // Si faltó memoria, deshacer las filas ya copiadas
+    if (added < num_rows) {
+        for (int r = 0; r < added; r++) {
+            Row* row = &table->rows[table->num_rows + r];
+            for (int i = 0; i < table->num_columns; i++) {
+                if (table->columns[i].type == TYPE_STRING) free(row->values[i].string_val);
+            }
+            free(row->values);
+        }
+        return -1;
+    }
+    
+    // Las filas ya están completas cuando una vista puede verlas
+    pthread_mutex_lock(&table->latch);
+    table->num_rows += num_rows;
+    table->changes++;
+    pthread_mutex_unlock(&table->latch);
     
     return 0;
 }
@@ -167,6 +362,7 @@ int table_delete_row(Table* table, int row_index) {
     }
     
     table->num_rows--;
+    table->changes++;
     
     return 0;
 }
@@ -179,102 +375,386 @@ void table_print(Table* table) {
     if (!table) return;
     
     // Imprimir el nombre de la tabla
-    printf("Table: %s\n", table->name);
+    output_printf("Table: %s\n", table->name);
     
     // Imprimir los nombres de las columnas
     for (int i = 0; i < table->num_columns; i++) {
-        printf("%s\t", table->columns[i].name);
+        output_printf("%s\t", table->columns[i].name);
     }
-    printf("\n");
+    output_printf("\n");
     
     // Imprimir los valores de las filas
     for (int i = 0; i < table->num_rows; i++) {
         for (int j = 0; j < table->num_columns; j++) {
-            Value value = table->rows[i].values[j];
-            const char* str_value = value_to_string(value, table->columns[j].type);
-            printf("%s\t", str_value);
+            char number[VALUE_NUMBER_LENGTH];
+            int length;
+            const char* str_value = value_format(number, table->rows[i].values[j], table->columns[j].type, &length);
+            output_printf("%s\t", str_value);
         }
-        printf("\n");
+        output_printf("\n");
     }
 }
 
 /*
-* Función para imprimir una tabla con formato mejorado
-* @param table Puntero a la tabla a imprimir
+* Función para eliminar varias filas de una tabla en una sola pasada
+* @param table Puntero a la tabla
+* @param row_indices Índices de las filas a eliminar, en orden ascendente
+* @param count Número de filas a eliminar
+* @return Número de filas eliminadas, -1 si hubo un error
 */
-void table_print_formatted(Table* table) {
-    if (!table || table->num_columns == 0) {
-        printf("Tabla vacía o sin columnas definidas.\n");
-        return;
-    }
+int table_delete_rows(Table* table, const int* row_indices, int count) {
+    if (!table || (count > 0 && !row_indices)) return -1;
     
-    // Calcular el ancho máximo para cada columna
-    int* col_widths = (int*)malloc(table->num_columns * sizeof(int));
-    for (int i = 0; i < table->num_columns; i++) {
-        // Inicializar con el ancho del nombre de columna
-        col_widths[i] = strlen(table->columns[i].name);
-        
-        // Revisar todos los valores para encontrar el más ancho
-        for (int j = 0; j < table->num_rows; j++) {
-            const char* str_value = value_to_string(table->rows[j].values[i], 
-                                                  table->columns[i].type);
-            int value_width = strlen(str_value);
-            if (value_width > col_widths[i]) {
-                col_widths[i] = value_width;
+    int next = 0;      // Siguiente índice a eliminar
+    int write = 0;     // Posición de escritura al compactar
+    
+    for (int i = 0; i < table->num_rows; i++) {
+        if (next < count && row_indices[next] == i) {
+            // Liberar memoria de los valores de tipo string
+            for (int j = 0; j < table->num_columns; j++) {
+                if (table->columns[j].type == TYPE_STRING && 
+                    table->rows[i].values[j].string_val) {
+                    free(table->rows[i].values[j].string_val);
+                }
             }
+            free(table->rows[i].values);
+            next++;
+        } else {
+            table->rows[write++] = table->rows[i];
         }
-        
-        // Añadir espacio para padding
-        col_widths[i] += 2;
     }
     
-    // Imprimir encabezado con nombre de tabla
-    printf("Tabla: %s\n", table->name);
+    int deleted = table->num_rows - write;
+    table->num_rows = write;
+    table->changes++;
     
-    // Imprimir línea superior
-    printf("+");
-    for (int i = 0; i < table->num_columns; i++) {
-        for (int j = 0; j < col_widths[i]; j++) printf("-");
-        printf("+");
+    return deleted;
+}
+
+/*
+* Función para bloquear una tabla en modo lectura (compatible con otros lectores)
+* @param table Puntero a la tabla
+*/
+void table_lock_read(Table* table) {
+    pthread_rwlock_rdlock(&table->lock);
+}
+
+/*
+* Función para bloquear una tabla en modo escritura (excluye a lectores y escritores)
+* @param table Puntero a la tabla
+*/
+void table_lock_write(Table* table) {
+    pthread_rwlock_wrlock(&table->lock);
+}
+
+/*
+* Función para bloquear una tabla en modo escritura con un tiempo de espera máximo
+* @param table Puntero a la tabla
+* @param timeout_ms Milisegundos que se espera como mucho
+* @return 0 si se bloqueó, -1 si se agotó el tiempo
+*/
+int table_lock_write_timeout(Table* table, int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
     }
-    printf("\n");
     
-    // Imprimir nombres de columnas
-    printf("|");
-    for (int i = 0; i < table->num_columns; i++) {
-        printf(" %-*s|", col_widths[i]-2, table->columns[i].name);
+    return pthread_rwlock_timedwrlock(&table->lock, &deadline) == 0 ? 0 : -1;
+}
+
+/*
+* Función para liberar el bloqueo de una tabla
+* @param table Puntero a la tabla
+*/
+void table_unlock(Table* table) {
+    pthread_rwlock_unlock(&table->lock);
+}
+
+/*
+* Función para marcar filas como eliminadas por una versión
+* @param table Puntero a la tabla
+* @param row_indices Índices de las filas
+* @param count Número de filas
+* @param xmax Versión que las elimina (0 para revivirlas)
+*/
+void table_set_xmax(Table* table, const int* row_indices, int count, RowVersion xmax) {
+    for (int i = 0; i < count; i++) {
+        __atomic_store_n(&table->rows[row_indices[i]].xmax, xmax, __ATOMIC_RELEASE);
     }
-    printf("\n");
+}
+
+/*
+* Función para sellar con su versión confirmada los cambios de una escritura
+* @param table Puntero a la tabla
+* @param first_new Primera fila añadida por la escritura
+* @param num_new Número de filas añadidas
+* @param old_rows Filas eliminadas o sustituidas por la escritura
+* @param num_old Número de filas eliminadas o sustituidas
+* @param version Versión confirmada
+*/
+void table_commit_versions(Table* table, int first_new, int num_new,
+                           const int* old_rows, int num_old, RowVersion version) {
+    // Las vistas que se abran antes de publicar la versión no pueden usar el orden guardado
+    pthread_mutex_lock(&table->latch);
+    table->changes++;
+    table->last_commit = version;
+    pthread_mutex_unlock(&table->latch);
+    
+    for (int i = first_new; i < first_new + num_new; i++) {
+        __atomic_store_n(&table->rows[i].xmin, version, __ATOMIC_RELEASE);
+    }
+    table_set_xmax(table, old_rows, num_old, version);
+    table->num_dead += num_old;
+}
+
+/*
+* Función para deshacer una escritura sin confirmar
+* @param table Puntero a la tabla
+* @param first_new Primera fila añadida por la escritura (se quitan todas desde ella)
+* @param old_rows Filas que la escritura marcó como eliminadas
+* @param num_old Número de filas marcadas
+*/
+void table_rollback_versions(Table* table, int first_new, const int* old_rows, int num_old) {
+    table_set_xmax(table, old_rows, num_old, 0);
     
-    // Imprimir línea divisoria
-    printf("+");
-    for (int i = 0; i < table->num_columns; i++) {
-        for (int j = 0; j < col_widths[i]; j++) printf("-");
-        printf("+");
+    // Una vista abierta puede incluir las filas añadidas, pero las descarta por su
+    // xmin pendiente sin leer sus valores
+    pthread_mutex_lock(&table->latch);
+    for (int i = first_new; i < table->num_rows; i++) {
+        for (int j = 0; j < table->num_columns; j++) {
+            if (table->columns[j].type == TYPE_STRING) free(table->rows[i].values[j].string_val);
+        }
+        free(table->rows[i].values);
     }
-    printf("\n");
+    if (first_new < table->num_rows) table->num_rows = first_new;
+    table->changes++;
+    pthread_mutex_unlock(&table->latch);
+}
+
+// Libera los arrays retirados que ya no puede leer ninguna vista (con el latch tomado)
+static void table_free_retired(Table* table, RowVersion oldest) {
+    RetiredRows** link = &table->retired;
+    
+    while (*link) {
+        RetiredRows* retired = *link;
+        
+        // Una vista que lee el array se abrió como muy tarde en su versión
+        if (table->readers == 0 || retired->version < oldest) {
+            *link = retired->next;
+            free(retired->rows);
+            free(retired);
+        } else {
+            link = &retired->next;
+        }
+    }
+}
+
+/*
+* Función para abrir una vista de solo lectura sobre la tabla
+* La vista comparte columnas y filas con la tabla y no se puede modificar ni bloquear
+* @param table Puntero a la tabla
+* @param view Vista a rellenar
+* @param snapshot Versión confirmada que ve la vista
+* @param write Escritura cuyos cambios pendientes ve la vista (0 ninguna)
+*/
+void table_open_snapshot(Table* table, Table* view, RowVersion snapshot, RowVersion write) {
+    memset(view, 0, sizeof(Table));
+    view->name = table->name;
+    view->columns = table->columns;
+    view->num_columns = table->num_columns;
+    view->column_map = table->column_map;
+    view->snapshot = snapshot;
+    view->write = write;
+    view->stats = table->stats;
+    
+    view->origin = table;
+    
+    pthread_mutex_lock(&table->latch);
+    view->rows = table->rows;
+    view->num_rows = table->num_rows;
+    view->capacity = table->num_rows;
+    table->readers++;
+    
+    // Sin cambios pendientes y con todo lo confirmado en la tabla, la vista ve lo mismo
+    // que cualquier otra abierta en esas condiciones hasta la siguiente escritura
+    if (write == 0 && snapshot >= table->last_commit) view->changes = table->changes;
+    pthread_mutex_unlock(&table->latch);
+}
+
+/*
+* Función para cerrar una vista abierta con table_open_snapshot
+* @param table Puntero a la tabla sobre la que se abrió
+*/
+void table_close_snapshot(Table* table) {
+    pthread_mutex_lock(&table->latch);
+    table->readers--;
+    if (table->readers == 0) table_free_retired(table, 0);
+    pthread_mutex_unlock(&table->latch);
+}
+
+/*
+* Función para consultar el orden guardado de las filas de una vista
+* @param view Vista abierta con table_open_snapshot
+* @param column Columna por la que se ordena
+* @return 1 si están ordenadas de forma ascendente, 0 si no, -1 si no se sabe
+*/
+int table_cached_order(const Table* view, int column) {
+    Table* table = view->origin;
+    if (!table || view->changes == 0) return -1;
+    
+    int order = -1;
+    pthread_mutex_lock(&table->latch);
+    if (table->key_order && table->order_changes == view->changes && column < table->num_columns) {
+        order = table->key_order[column];
+    }
+    pthread_mutex_unlock(&table->latch);
     
-    // Imprimir filas
+    return order;
+}
+
+/*
+* Función para guardar si las filas de una vista están ordenadas por una columna
+* No guarda nada si la tabla ha cambiado desde que se abrió la vista
+* @param view Vista abierta con table_open_snapshot
+* @param column Columna por la que se ordena
+* @param sorted 1 si están ordenadas de forma ascendente, 0 si no
+*/
+void table_cache_order(const Table* view, int column, int sorted) {
+    Table* table = view->origin;
+    if (!table || view->changes == 0) return;
+    
+    pthread_mutex_lock(&table->latch);
+    if (table->changes == view->changes && column < table->num_columns) {
+        if (table->order_changes != table->changes || !table->key_order) {
+            if (!table->key_order) {
+                table->key_order = (signed char*)malloc(table->num_columns);
+            }
+            if (table->key_order) memset(table->key_order, -1, table->num_columns);
+            table->order_changes = table->changes;
+        }
+        if (table->key_order) table->key_order[column] = sorted ? 1 : 0;
+    }
+    pthread_mutex_unlock(&table->latch);
+}
+
+/*
+* Función para comprobar si una fila existe para quien lee la tabla o vista
+* @param table Tabla o vista
+* @param row Fila a comprobar
+* @return 1 si es visible, 0 si no
+*/
+int table_row_visible(const Table* table, const Row* row) {
+    return mvcc_row_visible(row, table->snapshot, table->write);
+}
+
+// Indica si ninguna lectura puede ver ya la fila
+static int row_is_reclaimable(const Row* row, RowVersion oldest) {
+    RowVersion xmax = row->xmax;
+    return xmax != 0 && !(xmax & ROW_VERSION_PENDING) && xmax <= oldest;
+}
+
+// Quita las versiones que ninguna lectura puede ver (con el latch tomado). Con
+// vistas abiertas se compacta en un array nuevo: las vistas siguen leyendo el
+// antiguo, donde esas filas figuran como eliminadas y no se leen sus valores.
+static void table_vacuum(Table* table, RowVersion oldest) {
+    int reclaimable = 0;
     for (int i = 0; i < table->num_rows; i++) {
-        printf("|");
-        for (int j = 0; j < table->num_columns; j++) {
-            const char* str_value = value_to_string(table->rows[i].values[j], 
-                                                  table->columns[j].type);
-            printf(" %-*s|", col_widths[j]-2, str_value);
+        reclaimable += row_is_reclaimable(&table->rows[i], oldest);
+    }
+    if (reclaimable == 0) return;
+    
+    Row* target = table->rows;
+    RetiredRows* retired = NULL;
+    if (table->readers > 0) {
+        target = (Row*)malloc(table->capacity * sizeof(Row));
+        retired = (RetiredRows*)malloc(sizeof(RetiredRows));
+        if (!target || !retired) {
+            free(target);
+            free(retired);
+            return;
         }
-        printf("\n");
     }
     
-    // Imprimir línea inferior
-    printf("+");
-    for (int i = 0; i < table->num_columns; i++) {
-        for (int j = 0; j < col_widths[i]; j++) printf("-");
-        printf("+");
+    int write = 0;
+    for (int i = 0; i < table->num_rows; i++) {
+        Row* row = &table->rows[i];
+        
+        if (row_is_reclaimable(row, oldest)) {
+            for (int j = 0; j < table->num_columns; j++) {
+                if (table->columns[j].type == TYPE_STRING) free(row->values[j].string_val);
+            }
+            free(row->values);
+        } else {
+            target[write++] = *row;
+        }
+    }
+    
+    if (retired) {
+        retired->rows = table->rows;
+        retired->version = mvcc_current_version();
+        retired->next = table->retired;
+        table->retired = retired;
+        table->rows = target;
+    }
+    
+    table->num_rows = write;
+    table->num_dead -= reclaimable;
+}
+
+/*
+* Función para liberar las versiones que ya no puede ver ninguna lectura
+* Debe llamarla quien tenga la tabla bloqueada en escritura
+* @param table Puntero a la tabla
+* @param oldest Versión más antigua que ve alguna lectura abierta
+*/
+void table_collect_garbage(Table* table, RowVersion oldest) {
+    pthread_mutex_lock(&table->latch);
+    
+    table_free_retired(table, oldest);
+    
+    // Compactar solo cuando las versiones muertas son una parte apreciable de la tabla.
+    // Un array retirado guarda copias de las filas anteriores a sus últimos cambios de
+    // xmax, así que mientras quede alguno no se liberan valores.
+    if (!table->retired && table->num_dead > 0 && table->num_dead * 4 >= table->num_rows) {
+        table_vacuum(table, oldest);
+    }
+    
+    pthread_mutex_unlock(&table->latch);
+}
+
+/*
+* Función para imprimir una tabla con formato mejorado
+* @param table Puntero a la tabla a imprimir
+*/
+void table_print_formatted(Table* table) {
+    if (!table || table->num_columns == 0) {
+        output_printf("Tabla vacía o sin columnas definidas.\n");
+        return;
     }
-    printf("\n");
     
-    // Imprimir conteo de filas
-    printf("%d fila%s en total\n", table->num_rows, table->num_rows == 1 ? "" : "s");
+    table_print_rows(table, NULL, table->num_rows, NULL, table->num_columns);
+}
+
+/*
+* Función para imprimir un subconjunto de filas y columnas con formato mejorado
+* @param table Puntero a la tabla
+* @param row_indices Índices de las filas a imprimir (NULL para las primeras num_rows)
+* @param num_rows Número de filas a imprimir
+* @param column_indices Índices de las columnas a imprimir (NULL para todas)
+* @param num_cols Número de columnas a imprimir
+*/
+void table_print_rows(Table* table, const int* row_indices, int num_rows, 
+                      const int* column_indices, int num_cols) {
+    ResultSink sink;
+    if (result_open(&sink, table, column_indices, num_cols) != 0) return;
+    
+    for (int j = 0; j < num_rows && sink.num_columns > 0; j++) {
+        result_add_row(&sink, row_indices ? row_indices[j] : j);
+    }
     
-    free(col_widths);
+    result_close(&sink);
 }
@@ -1,18 +1,46 @@
 #ifndef TABLE_H
 #define TABLE_H
 
+#include <pthread.h>
 #include "value.h"
 #include "column.h"
 #include "row.h"
+#include "stats.h"
+
+struct RetiredRows;
 
 // Estructura para la tabla
 typedef struct Table {
     char *name;
     Column *columns;
     int num_columns;
+    ColumnMap column_map;   // Índice hash nombre -> columna
     Row *rows;
     int num_rows;
     int capacity;
+    pthread_rwlock_t lock;  // Lectores concurrentes, escritores en exclusiva
+
+    // Versiones de las filas (MVCC). Las lecturas trabajan sobre una instantánea:
+    // una vista con el array de filas y la versión que ven, sin bloquear la tabla
+    pthread_mutex_t latch;        // Protege rows, num_rows y capacity al abrir vistas
+    int readers;                  // Vistas abiertas sobre la tabla
+    int num_dead;                 // Versiones eliminadas o sustituidas aún guardadas
+    struct RetiredRows *retired;  // Arrays de filas sustituidos que aún puede leer una vista
+    RowVersion snapshot;          // Versión que se lee (ROW_VERSION_LATEST en la tabla real)
+    RowVersion write;             // Escritura cuyos cambios pendientes se ven (0 ninguna)
+
+    // Estadísticas del último ANALYZE (NULL si no se ha analizado). Pertenecen a la
+    // tabla real; solo se sustituyen con el catálogo tomado en escritura.
+    TableStats *stats;
+
+    // Orden por columna de las filas que ve una lectura sin cambios pendientes, que
+    // calcula el primer JOIN y reutilizan los siguientes mientras no cambie la tabla.
+    // Se guarda en la tabla real y se protege con latch.
+    unsigned long changes;        // Se incrementa con cada escritura (0 en una vista que no puede usarlo)
+    RowVersion last_commit;       // Última versión confirmada que modificó la tabla
+    signed char *key_order;       // Por columna: -1 sin calcular, 0 desordenada, 1 ordenada
+    unsigned long order_changes;  // Valor de changes con el que se calculó key_order
+    struct Table *origin;         // Tabla sobre la que se abrió la vista (NULL en la real)
 } Table;
 
 // Crea una nueva tabla
@@ -24,16 +52,73 @@ void table_free(Table *table);
 // Añade una columna a la tabla
 int table_add_column(Table *table, const char *name, DataType type, int max_length, int is_primary_key, int allows_null);
 
+// Crea una tabla vacía con las columnas de left y right (nombradas tabla.columna)
+Table *table_create_joined(const Table *left, const Table *right);
+
 // Añade una fila a la tabla
 int table_add_row(Table *table, Value *values);
 
-// Elimina una fila de la tabla
+// Añade varias filas (num_rows * num_columns valores) reservando memoria una sola vez
+int table_append_rows(Table *table, Value *values, int num_rows);
+
+// Añade filas creadas por la versión xmin (pendiente hasta confirmarla)
+int table_append_versions(Table *table, Value *values, int num_rows, RowVersion xmin);
+
+// Marca las filas indicadas como eliminadas por la versión xmax (0 para revivirlas)
+void table_set_xmax(Table *table, const int *row_indices, int count, RowVersion xmax);
+
+// Sella con la versión confirmada las filas añadidas [first_new, first_new + num_new)
+// y las filas eliminadas o sustituidas por una escritura
+void table_commit_versions(Table *table, int first_new, int num_new,
+                           const int *old_rows, int num_old, RowVersion version);
+
+// Deshace una escritura sin confirmar: quita las filas añadidas desde first_new
+// y revive las filas que marcó como eliminadas
+void table_rollback_versions(Table *table, int first_new, const int *old_rows, int num_old);
+
+// Abre una vista de solo lectura con las filas actuales; la vista ve las versiones
+// confirmadas hasta snapshot y los cambios pendientes de write
+void table_open_snapshot(Table *table, Table *view, RowVersion snapshot, RowVersion write);
+
+// Cierra una vista abierta sobre la tabla
+void table_close_snapshot(Table *table);
+
+// Orden guardado de las filas de una vista por una columna: 1 ordenadas de forma
+// ascendente, 0 no, -1 si no se sabe o la vista no puede usarlo
+int table_cached_order(const Table *view, int column);
+
+// Guarda para las siguientes vistas si las filas de esta están ordenadas por la columna
+void table_cache_order(const Table *view, int column, int sorted);
+
+// Indica si una fila de la tabla (o vista) existe para quien la lee
+int table_row_visible(const Table *table, const Row *row);
+
+// Libera las versiones y arrays de filas que ya no puede ver ninguna lectura
+// (oldest: versión más antigua que ve alguna lectura abierta)
+void table_collect_garbage(Table *table, RowVersion oldest);
+
+// Elimina una fila de la tabla (solo en tablas sin vistas abiertas)
 int table_delete_row(Table *table, int row_index);
 
+// Elimina varias filas (índices en orden ascendente) en una sola pasada
+// (solo en tablas sin vistas abiertas)
+int table_delete_rows(Table *table, const int *row_indices, int count);
+
+// Bloquea la tabla para leer (varios lectores a la vez) o para modificar sus filas
+void table_lock_read(Table *table);
+void table_lock_write(Table *table);
+
+// Bloquea la tabla para modificarla esperando como mucho timeout_ms (0 si la bloqueó)
+int table_lock_write_timeout(Table *table, int timeout_ms);
+void table_unlock(Table *table);
+
 // Imprime la tabla con formato
 void table_print(Table *table);
 
 // Imprime la tabla con formato mejorado
 void table_print_formatted(Table *table);
 
+// Imprime un subconjunto de filas y columnas con formato mejorado
+void table_print_rows(Table *table, const int *row_indices, int num_rows, const int *column_indices, int num_cols);
+
 #endif
\ No newline at end of file
@@ -1,62 +1,672 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
 #include "value.h"
 
-// Convierte una cadena a un valor del tipo especificado
-Value string_to_value(const char* str, DataType type) {
-    Value value;
-    memset(&value, 0, sizeof(Value)); // Inicializar con ceros
-    
-    if (!str) return value;
-    
+/**
+ * Lectura de números
+ */
+
+// Potencias de 10 que un double representa exactamente
+static const double POW10_EXACT[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Cifras decimales que caben siempre en un uint64_t
+#define MAX_MANTISSA_DIGITS 19
+
+// Número decimal leído: mantissa * 10^exponent
+typedef struct {
+    uint64_t mantissa;
+    int digits;              // Cifras acumuladas en mantissa
+    int exponent;
+    int truncated;           // Se descartaron cifras distintas de cero
+} Decimal;
+
+/*
+* Función para leer 8 bytes como un entero little-endian
+* @param text Bytes
+* @return Entero con text[0] en el byte bajo
+*/
+static uint64_t load_eight(const char* text) {
+    uint64_t chunk;
+    memcpy(&chunk, text, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    chunk = __builtin_bswap64(chunk);
+#endif
+    return chunk;
+}
+
+/*
+* Función para comprobar a la vez que 8 bytes son cifras: un byte menor que '0' se
+* desborda al restar y uno mayor que '9' al sumar, y en los dos casos enciende su bit alto
+* @param chunk Bytes leídos con load_eight
+* @return 1 si los 8 bytes están entre '0' y '9'
+*/
+static int is_eight_digits(uint64_t chunk) {
+    return (((chunk + 0x4646464646464646ull) | (chunk - 0x3030303030303030ull)) &
+            0x8080808080808080ull) == 0;
+}
+
+/*
+* Función para convertir 8 cifras en su valor sin recorrerlas una a una: primero se
+* combinan por parejas, luego de cuatro en cuatro y al final las dos mitades
+* @param chunk Bytes leídos con load_eight (ya comprobados con is_eight_digits)
+* @return Valor de las 8 cifras
+*/
+static uint32_t parse_eight_digits(uint64_t chunk) {
+    chunk -= 0x3030303030303030ull;
+    chunk = chunk * 10 + (chunk >> 8);
+    chunk = ((chunk & 0x000000FF000000FFull) * (100 + (1000000ull << 32)) +
+             ((chunk >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))) >> 32;
+    return (uint32_t)chunk;
+}
+
+/*
+* Función para comprobar que un texto solo tiene cifras
+* @param text Texto
+* @param length Longitud
+* @return 1 si todos sus bytes son cifras
+*/
+static int all_digits(const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if ((unsigned char)(text[i] - '0') > 9) return 0;
+    }
+    return 1;
+}
+
+/*
+* Función para leer una serie de cifras y acumularlas en un decimal
+* @param text Texto
+* @param length Longitud del texto
+* @param pos Posición de la primera cifra; se deja tras la última
+* @param fraction 1 si las cifras van tras el punto decimal
+* @param decimal Número que se va formando
+* @return Cifras leídas
+*/
+static size_t read_digits(const char* text, size_t length, size_t* pos, int fraction, Decimal* decimal) {
+    size_t start = *pos;
+    size_t i = *pos;
+
+    while (i < length) {
+        // De 8 en 8 mientras quepan en la mantisa
+        if (length - i >= 8 && decimal->digits + 8 <= MAX_MANTISSA_DIGITS) {
+            uint64_t chunk = load_eight(text + i);
+            if (is_eight_digits(chunk)) {
+                decimal->mantissa = decimal->mantissa * 100000000u + parse_eight_digits(chunk);
+                if (decimal->mantissa) decimal->digits += 8;
+                if (fraction) decimal->exponent -= 8;
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned digit = (unsigned char)(text[i] - '0');
+        if (digit > 9) break;
+
+        if (decimal->digits < MAX_MANTISSA_DIGITS) {
+            decimal->mantissa = decimal->mantissa * 10 + digit;
+            if (decimal->mantissa) decimal->digits++;
+            if (fraction) decimal->exponent--;
+        } else {
+            // Las cifras que no caben solo cuentan para la magnitud
+            if (digit) decimal->truncated = 1;
+            if (!fraction) decimal->exponent++;
+        }
+        i++;
+    }
+
+    *pos = i;
+    return i - start;
+}
+
+ValueParseStatus value_parse_int(const char* text, size_t length, int negative, int* out) {
+    if (!text || length == 0) return VALUE_PARSE_INVALID;
+
+    // Los ceros a la izquierda no cuentan para el rango
+    size_t pos = 0;
+    while (pos < length - 1 && text[pos] == '0') pos++;
+
+    // Más de 10 cifras significativas nunca caben en un int
+    if (length - pos > 10) {
+        return all_digits(text + pos, length - pos) ? VALUE_PARSE_RANGE : VALUE_PARSE_INVALID;
+    }
+
+    uint64_t magnitude = 0;
+    if (length - pos >= 8) {
+        uint64_t chunk = load_eight(text + pos);
+        if (!is_eight_digits(chunk)) return VALUE_PARSE_INVALID;
+        magnitude = parse_eight_digits(chunk);
+        pos += 8;
+    }
+    for (; pos < length; pos++) {
+        unsigned digit = (unsigned char)(text[pos] - '0');
+        if (digit > 9) return VALUE_PARSE_INVALID;
+        magnitude = magnitude * 10 + digit;
+    }
+
+    if (magnitude > (negative ? 2147483648u : 2147483647u)) return VALUE_PARSE_RANGE;
+    *out = (int)(negative ? -(int64_t)magnitude : (int64_t)magnitude);
+    return VALUE_PARSE_OK;
+}
+
+/*
+* Función para convertir un decimal a float en el caso rápido (Clinger): si la mantisa y la
+* potencia de 10 son exactas en double, el producto o el cociente se redondea una sola vez.
+* Al pasar a float se redondea otra vez, lo que solo puede fallar si el double cae justo
+* en medio de dos float
+* @param decimal Número sin cifras descartadas
+* @param out Resultado
+* @return 0 si se pudo convertir así, -1 si hay que usar el caso lento
+*/
+static int decimal_to_float_fast(const Decimal* decimal, float* out) {
+    if (decimal->mantissa > (1ull << 53) || decimal->exponent < -22 || decimal->exponent > 22) return -1;
+
+    double value = (double)decimal->mantissa;
+    if (decimal->exponent < 0) {
+        value /= POW10_EXACT[-decimal->exponent];
+    } else {
+        value *= POW10_EXACT[decimal->exponent];
+    }
+
+    // Los 29 bits del double que el float no guarda valen 1000...0: punto medio
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x1FFFFFFFu) == 0x10000000u) return -1;
+
+    *out = (float)value;
+    return 0;
+}
+
+/*
+* Función para convertir un número ya validado en el caso lento (más de 19 cifras,
+* exponentes grandes o puntos medios). El programa no cambia el locale, así que strtof
+* usa el punto como separador decimal
+* @param text Texto validado
+* @param length Longitud
+* @param out Resultado
+* @return VALUE_PARSE_OK o VALUE_PARSE_MEMORY
+*/
+static ValueParseStatus decimal_to_float_slow(const char* text, size_t length, float* out) {
+    char local[64];
+    char* copy = length < sizeof(local) ? local : (char*)malloc(length + 1);
+    if (!copy) return VALUE_PARSE_MEMORY;
+
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    *out = strtof(copy, NULL);
+
+    if (copy != local) free(copy);
+    return VALUE_PARSE_OK;
+}
+
+ValueParseStatus value_parse_float(const char* text, size_t length, int negative, float* out) {
+    if (!text) return VALUE_PARSE_INVALID;
+
+    Decimal decimal = {0};
+    size_t pos = 0;
+    size_t digits = read_digits(text, length, &pos, 0, &decimal);
+    if (pos < length && text[pos] == '.') {
+        pos++;
+        digits += read_digits(text, length, &pos, 1, &decimal);
+    }
+    if (digits == 0) return VALUE_PARSE_INVALID;
+
+    if (pos < length && (text[pos] == 'e' || text[pos] == 'E')) {
+        pos++;
+        int exponent_negative = 0;
+        if (pos < length && (text[pos] == '+' || text[pos] == '-')) {
+            exponent_negative = text[pos] == '-';
+            pos++;
+        }
+        if (pos == length) return VALUE_PARSE_INVALID;
+
+        // Un exponente enorme da siempre 0 o infinito: no hace falta su valor exacto
+        int exponent = 0;
+        for (; pos < length; pos++) {
+            unsigned digit = (unsigned char)(text[pos] - '0');
+            if (digit > 9) return VALUE_PARSE_INVALID;
+            if (exponent < 100000) exponent = exponent * 10 + (int)digit;
+        }
+        decimal.exponent += exponent_negative ? -exponent : exponent;
+    }
+    if (pos != length) return VALUE_PARSE_INVALID;
+
+    float value = 0.0f;
+    if (decimal.mantissa != 0 &&
+        (decimal.truncated || decimal_to_float_fast(&decimal, &value) != 0)) {
+        ValueParseStatus status = decimal_to_float_slow(text, length, &value);
+        if (status != VALUE_PARSE_OK) return status;
+    }
+    if (isinf(value)) return VALUE_PARSE_RANGE;
+
+    *out = negative ? -value : value;
+    return VALUE_PARSE_OK;
+}
+
+ValueParseStatus string_to_value(const char* str, DataType type, Value* value) {
+    memset(value, 0, sizeof(Value));
+    if (!str) return VALUE_PARSE_INVALID;
+
+    int negative = 0;
+    if (type == TYPE_INT || type == TYPE_FLOAT) {
+        if (*str == '-' || *str == '+') negative = *str++ == '-';
+    }
+
     switch (type) {
         case TYPE_INT:
-            value.int_val = atoi(str);
-            break;
+            return value_parse_int(str, strlen(str), negative, &value->int_val);
         case TYPE_FLOAT:
-            value.float_val = atof(str);
-            break;
+            return value_parse_float(str, strlen(str), negative, &value->float_val);
         case TYPE_STRING:
-            value.string_val = strdup(str);
-            break;
+            value->string_val = strdup(str);
+            return value->string_val ? VALUE_PARSE_OK : VALUE_PARSE_MEMORY;
         case TYPE_BOOL:
             // Aceptar diferentes formatos de booleano
-            if (strcasecmp(str, "true") == 0 || strcasecmp(str, "1") == 0 || 
+            if (strcasecmp(str, "true") == 0 || strcmp(str, "1") == 0 ||
                 strcasecmp(str, "yes") == 0 || strcasecmp(str, "y") == 0) {
-                value.bool_val = 1;
+                value->bool_val = 1;
+                return VALUE_PARSE_OK;
+            }
+            if (strcasecmp(str, "false") == 0 || strcmp(str, "0") == 0 ||
+                strcasecmp(str, "no") == 0 || strcasecmp(str, "n") == 0) {
+                return VALUE_PARSE_OK;
+            }
+            return VALUE_PARSE_INVALID;
+    }
+    return VALUE_PARSE_INVALID;
+}
+
+/**
+ * Formato de números
+ */
+
+/*
+* Función para escribir un entero sin signo en decimal (sin '\0')
+* @param buffer Destino
+* @param value Entero
+* @return Número de cifras
+*/
+static int format_digits(char* buffer, unsigned long long value) {
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char digits[20];
+    int count = 0;
+
+    // Dos cifras por división
+    while (value >= 100) {
+        int pair = (int)(value % 100) * 2;
+        value /= 100;
+        digits[count++] = pairs[pair + 1];
+        digits[count++] = pairs[pair];
+    }
+    if (value >= 10) {
+        digits[count++] = pairs[value * 2 + 1];
+        digits[count++] = pairs[value * 2];
+    } else {
+        digits[count++] = (char)('0' + value);
+    }
+
+    for (int i = 0; i < count; i++) buffer[i] = digits[count - 1 - i];
+    return count;
+}
+
+/*
+* Función para escribir un INT en decimal
+* @param buffer Destino (al menos VALUE_NUMBER_LENGTH bytes)
+* @param value Entero
+* @return Longitud escrita
+*/
+int value_format_int(char* buffer, int value) {
+    int length = 0;
+    unsigned int magnitude = (unsigned int)value;
+    if (value < 0) {
+        buffer[length++] = '-';
+        magnitude = 0u - magnitude;
+    }
+    length += format_digits(buffer + length, magnitude);
+    buffer[length] = '\0';
+    return length;
+}
+
+/*
+* Función para escribir un FLOAT con un número fijo de decimales, igual que "%.*f"
+* @param buffer Destino (al menos VALUE_NUMBER_LENGTH bytes)
+* @param value Valor
+* @param decimals Decimales (de 0 a 6)
+* @return Longitud escrita
+*/
+int value_format_float_fixed(char* buffer, float value, int decimals) {
+    static const double scales[] = {1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0};
+
+    // value * 10^decimals es exacto en double (24 bits de mantisa y como mucho 20 del
+    // factor), así que el redondeo al par en el .5 coincide con el de printf
+    double scaled = fabs((double)value) * scales[decimals];
+    if (!isfinite(scaled) || scaled >= 1e15) {
+        return snprintf(buffer, VALUE_NUMBER_LENGTH, "%.*f", decimals, value);
+    }
+
+    unsigned long long units = (unsigned long long)scaled;
+    double fraction = scaled - (double)units;
+    if (fraction > 0.5 || (fraction == 0.5 && (units & 1))) units++;
+
+    char digits[20];
+    int count = format_digits(digits, units);
+
+    int length = 0;
+    if (signbit(value)) buffer[length++] = '-';
+
+    // Parte entera (al menos un 0) y decimales completados con ceros a la izquierda
+    int integer_digits = count - decimals;
+    if (integer_digits <= 0) {
+        buffer[length++] = '0';
+    } else {
+        memcpy(buffer + length, digits, integer_digits);
+        length += integer_digits;
+    }
+    if (decimals > 0) {
+        buffer[length++] = '.';
+        for (int i = integer_digits; i < 0; i++) buffer[length++] = '0';
+        int first = integer_digits < 0 ? 0 : integer_digits;
+        memcpy(buffer + length, digits + first, count - first);
+        length += count - first;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/*
+ * Representación más corta de un FLOAT: algoritmo Ryu (Ulf Adams, "Ryū: fast
+ * float-to-string conversion", PLDI 2018), que calcula con aritmética entera de
+ * 64 bits el decimal con menos cifras dentro del intervalo que redondea al valor.
+ */
+
+#define FLOAT_MANTISSA_BITS 23
+#define FLOAT_BIAS 127
+#define FLOAT_POW5_INV_BITCOUNT 59
+#define FLOAT_POW5_BITCOUNT 61
+
+// floor(2^(pow5_bits(i) - 1 + 59) / 5^i) + 1
+static const uint64_t FLOAT_POW5_INV_SPLIT[31] = {
+    576460752303423489u, 461168601842738791u, 368934881474191033u, 295147905179352826u,
+    472236648286964522u, 377789318629571618u, 302231454903657294u, 483570327845851670u,
+    386856262276681336u, 309485009821345069u, 495176015714152110u, 396140812571321688u,
+    316912650057057351u, 507060240091291761u, 405648192073033409u, 324518553658426727u,
+    519229685853482763u, 415383748682786211u, 332306998946228969u, 531691198313966350u,
+    425352958651173080u, 340282366920938464u, 544451787073501542u, 435561429658801234u,
+    348449143727040987u, 557518629963265579u, 446014903970612463u, 356811923176489971u,
+    570899077082383953u, 456719261665907162u, 365375409332725730u
+};
+
+// 5^i normalizado a 61 bits
+static const uint64_t FLOAT_POW5_SPLIT[47] = {
+    1152921504606846976u, 1441151880758558720u, 1801439850948198400u, 2251799813685248000u,
+    1407374883553280000u, 1759218604441600000u, 2199023255552000000u, 1374389534720000000u,
+    1717986918400000000u, 2147483648000000000u, 1342177280000000000u, 1677721600000000000u,
+    2097152000000000000u, 1310720000000000000u, 1638400000000000000u, 2048000000000000000u,
+    1280000000000000000u, 1600000000000000000u, 2000000000000000000u, 1250000000000000000u,
+    1562500000000000000u, 1953125000000000000u, 1220703125000000000u, 1525878906250000000u,
+    1907348632812500000u, 1192092895507812500u, 1490116119384765625u, 1862645149230957031u,
+    1164153218269348144u, 1455191522836685180u, 1818989403545856475u, 2273736754432320594u,
+    1421085471520200371u, 1776356839400250464u, 2220446049250313080u, 1387778780781445675u,
+    1734723475976807094u, 2168404344971008868u, 1355252715606880542u, 1694065894508600678u,
+    2117582368135750847u, 1323488980084844279u, 1654361225106055349u, 2067951531382569187u,
+    1292469707114105741u, 1615587133892632177u, 2019483917365790221u
+};
+
+// ceil(log2(5^e)) (1 si e es 0), para 0 <= e <= 3528
+static int pow5_bits(int e) {
+    return (int)((((uint32_t)e * 1217359) >> 19) + 1);
+}
+
+// floor(log10(2^e)), para 0 <= e <= 1650
+static uint32_t log10_pow2(int e) {
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+// floor(log10(5^e)), para 0 <= e <= 2620
+static uint32_t log10_pow5(int e) {
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+static int multiple_of_pow5(uint32_t value, uint32_t p) {
+    uint32_t count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static int multiple_of_pow2(uint32_t value, uint32_t p) {
+    return (value & ((1u << p) - 1)) == 0;
+}
+
+// (m * factor) >> shift, con shift > 32
+static uint32_t mul_shift(uint32_t m, uint64_t factor, int shift) {
+    uint64_t low = (uint64_t)m * (uint32_t)factor;
+    uint64_t high = (uint64_t)m * (uint32_t)(factor >> 32);
+    return (uint32_t)(((low >> 32) + high) >> (shift - 32));
+}
+
+/*
+* Función para obtener las cifras más cortas de un FLOAT finito y positivo
+* @param bits Representación IEEE del valor (sin signo)
+* @param exponent Exponente decimal: el valor es digits * 10^exponent
+* @return Cifras
+*/
+static uint32_t float_shortest(uint32_t bits, int* exponent) {
+    uint32_t ieee_mantissa = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+    uint32_t ieee_exponent = bits >> FLOAT_MANTISSA_BITS;
+
+    int e2;
+    uint32_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (int)ieee_exponent - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = (1u << FLOAT_MANTISSA_BITS) | ieee_mantissa;
+    }
+    int accept_bounds = (m2 & 1) == 0;
+
+    // Intervalo de valores que redondean al FLOAT: (mm, mp) alrededor de mv, por 4
+    uint32_t mv = 4 * m2;
+    uint32_t mp = 4 * m2 + 2;
+    uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    // Paso a base 10 de los tres extremos
+    uint32_t vr, vp, vm;
+    int e10;
+    int vm_trailing_zeros = 0;
+    int vr_trailing_zeros = 0;
+    uint32_t last_removed = 0;
+    if (e2 >= 0) {
+        uint32_t q = log10_pow2(e2);
+        e10 = (int)q;
+        int k = FLOAT_POW5_INV_BITCOUNT + pow5_bits((int)q) - 1;
+        int i = -e2 + (int)q + k;
+        vr = mul_shift(mv, FLOAT_POW5_INV_SPLIT[q], i);
+        vp = mul_shift(mp, FLOAT_POW5_INV_SPLIT[q], i);
+        vm = mul_shift(mm, FLOAT_POW5_INV_SPLIT[q], i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            int l = FLOAT_POW5_INV_BITCOUNT + pow5_bits((int)(q - 1)) - 1;
+            last_removed = mul_shift(mv, FLOAT_POW5_INV_SPLIT[q - 1], -e2 + (int)q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            // Como mucho uno de mp, mv y mm es múltiplo de 5
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mm, q);
+            } else {
+                vp -= multiple_of_pow5(mp, q);
+            }
+        }
+    } else {
+        uint32_t q = log10_pow5(-e2);
+        e10 = (int)q + e2;
+        int i = -e2 - (int)q;
+        int k = pow5_bits(i) - FLOAT_POW5_BITCOUNT;
+        int j = (int)q - k;
+        vr = mul_shift(mv, FLOAT_POW5_SPLIT[i], j);
+        vp = mul_shift(mp, FLOAT_POW5_SPLIT[i], j);
+        vm = mul_shift(mm, FLOAT_POW5_SPLIT[i], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = (int)q - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            last_removed = mul_shift(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10;
+        }
+        if (q <= 1) {
+            // mv tiene siempre al menos dos ceros binarios al final
+            vr_trailing_zeros = 1;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
             } else {
-                value.bool_val = 0;
+                vp--;
             }
-            break;
+        } else if (q < 31) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q - 1);
+        }
     }
-    return value;
+
+    // Se quitan cifras mientras el intervalo siga conteniendo un decimal más corto
+    int removed = 0;
+    uint32_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        // Empate exacto en ...50..0: redondeo al par
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) last_removed = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            last_removed = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || last_removed >= 5);
+    }
+
+    *exponent = e10 + removed;
+    return output;
 }
 
-// Convierte un valor al formato de cadena
-const char* value_to_string(Value value, DataType type) {
-    static char buffer[256]; // Buffer estático para la conversión
-    
+/*
+* Función para escribir un FLOAT con la representación más corta que lo conserva
+* @param buffer Destino (al menos VALUE_NUMBER_LENGTH bytes)
+* @param value Valor
+* @return Longitud escrita
+*/
+int value_format_float(char* buffer, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int length = 0;
+    if (bits >> 31) buffer[length++] = '-';
+    bits &= 0x7FFFFFFFu;
+
+    if (bits >= 0x7F800000u) {
+        const char* text = bits == 0x7F800000u ? "inf" : "nan";
+        if (bits != 0x7F800000u) length = 0;
+        memcpy(buffer + length, text, 4);
+        return length + 3;
+    }
+    if (bits == 0) {
+        memcpy(buffer + length, "0", 2);
+        return length + 1;
+    }
+
+    int exponent;
+    char digits[10];
+    int count = format_digits(digits, float_shortest(bits, &exponent));
+
+    // Posición de la coma respecto a las cifras (valor = 0.cifras * 10^point)
+    int point = count + exponent;
+    if (point > 21 || point < -5) {
+        // Notación científica: d[.ddd]e±x
+        buffer[length++] = digits[0];
+        if (count > 1) {
+            buffer[length++] = '.';
+            memcpy(buffer + length, digits + 1, count - 1);
+            length += count - 1;
+        }
+        buffer[length++] = 'e';
+        buffer[length++] = point - 1 < 0 ? '-' : '+';
+        length += format_digits(buffer + length, (unsigned long long)(point - 1 < 0 ? 1 - point : point - 1));
+    } else if (point <= 0) {
+        // 0.000ddd
+        buffer[length++] = '0';
+        buffer[length++] = '.';
+        for (int i = point; i < 0; i++) buffer[length++] = '0';
+        memcpy(buffer + length, digits, count);
+        length += count;
+    } else if (point >= count) {
+        // ddd000
+        memcpy(buffer + length, digits, count);
+        length += count;
+        for (int i = count; i < point; i++) buffer[length++] = '0';
+    } else {
+        // dd.ddd
+        memcpy(buffer + length, digits, point);
+        length += point;
+        buffer[length++] = '.';
+        memcpy(buffer + length, digits + point, count - point);
+        length += count - point;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/*
+* Función para obtener el texto de un valor tal como se muestra en las tablas
+* @param buffer Espacio para los números (al menos VALUE_NUMBER_LENGTH bytes)
+* @param value Valor
+* @param type Tipo del valor
+* @param length Longitud del texto
+* @return Texto del valor (las cadenas se devuelven sin copiarlas)
+*/
+const char* value_format(char* buffer, Value value, DataType type, int* length) {
     switch (type) {
         case TYPE_INT:
-            snprintf(buffer, sizeof(buffer), "%d", value.int_val);
-            break;
+            *length = value_format_int(buffer, value.int_val);
+            return buffer;
         case TYPE_FLOAT:
-            snprintf(buffer, sizeof(buffer), "%.2f", value.float_val);
-            break;
+            *length = value_format_float_fixed(buffer, value.float_val, VALUE_DISPLAY_DECIMALS);
+            return buffer;
         case TYPE_STRING:
-            if (value.string_val) {
-                snprintf(buffer, sizeof(buffer), "%s", value.string_val);
-            } else {
-                buffer[0] = '\0'; // String vacío para NULL
-            }
-            break;
+            if (!value.string_val) break;
+            *length = (int)strlen(value.string_val);
+            return value.string_val;
         case TYPE_BOOL:
-            snprintf(buffer, sizeof(buffer), "%s", value.bool_val ? "true" : "false");
-            break;
-        default:
-            buffer[0] = '\0';
-    }
-    
-    return buffer;
-}
\ No newline at end of file
+            *length = value.bool_val ? 4 : 5;
+            return value.bool_val ? "true" : "false";
+    }
+
+    *length = 0;
+    return "";
+}
@@ -1,6 +1,8 @@
 #ifndef VALUE_H
 #define VALUE_H
 
+#include <stddef.h>
+
 // Data types supported in our simple SQL-like table
 typedef enum {
     TYPE_INT,
@@ -17,8 +19,43 @@ typedef union {
     int bool_val;
 } Value;
 
-// Function prototypes for data type conversion
-Value string_to_value(const char* str, DataType type);
-const char* value_to_string(Value value, DataType type);
+// Espacio que necesita el texto de cualquier INT o FLOAT, incluido el '\0'
+#define VALUE_NUMBER_LENGTH 48
+
+// Decimales con los que se muestran los FLOAT en las tablas
+#define VALUE_DISPLAY_DECIMALS 2
+
+// Resultado de leer un número de un texto
+typedef enum {
+    VALUE_PARSE_OK = 0,
+    VALUE_PARSE_INVALID = -1,    // El texto no es un número del tipo pedido
+    VALUE_PARSE_RANGE = -2,      // Es un número pero no cabe en el tipo
+    VALUE_PARSE_MEMORY = -3      // No hubo memoria para copiar una cadena
+} ValueParseStatus;
+
+// Convierte un texto al tipo indicado. INT y FLOAT admiten un signo delante; BOOL acepta
+// true/false, 1/0, yes/no e y/n. Las cadenas se copian. No depende del locale.
+ValueParseStatus string_to_value(const char* str, DataType type, Value* value);
+
+// Leen los length bytes de text como un número sin signo (negative indica un '-' ya leído,
+// como el que el lexer separa del literal). INT solo admite cifras; FLOAT cifras con un
+// punto y un exponente (e/E) opcionales. No necesitan el '\0' final ni dependen del locale.
+ValueParseStatus value_parse_int(const char* text, size_t length, int negative, int* out);
+ValueParseStatus value_parse_float(const char* text, size_t length, int negative, float* out);
+
+// Escriben un número en buffer (al menos VALUE_NUMBER_LENGTH bytes) y devuelven su longitud.
+// Son reentrantes y no usan printf.
+int value_format_int(char* buffer, int value);
+
+// FLOAT con la representación decimal más corta que vuelve a leerse como el mismo valor
+// (notación científica por debajo de 1e-6 y desde 1e21; nan, inf y -inf si no es finito)
+int value_format_float(char* buffer, float value);
+
+// FLOAT con decimals decimales (de 0 a 6), igual que "%.*f"
+int value_format_float_fixed(char* buffer, float value, int decimals);
+
+// Texto de un valor tal como se muestra en las tablas. Los números se escriben en buffer
+// (VALUE_NUMBER_LENGTH bytes); las cadenas se devuelven sin copiarlas ("" si son NULL).
+const char* value_format(char* buffer, Value value, DataType type, int* length);
 
 #endif
\ No newline at end of file
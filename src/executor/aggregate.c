@@ -0,0 +1,593 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include "aggregate.h"
+#include "parallel.h"
+#include "../db/table.h"
+
+/**
+ * Tabla hash de grupos
+ */
+
+// Acumulador de una función de agregación para un grupo
+typedef struct {
+    int count;            // Valores no nulos (filas para COUNT(*))
+    long long int_sum;    // Suma exacta para columnas INT y BOOL
+    double sum;           // Suma para columnas FLOAT
+    Value min;            // Apuntan a los valores de la tabla (no se copian)
+    Value max;
+} AggState;
+
+// Ranura de la tabla hash (hash precalculado + índice de grupo)
+typedef struct {
+    unsigned int hash;
+    int group;            // -1 si la ranura está vacía
+} GroupSlot;
+
+// Grupos con direccionamiento abierto: las ranuras solo guardan hash e índice
+// para que el sondeo lineal recorra memoria contigua; los acumuladores de cada
+// grupo están juntos en un único array
+typedef struct {
+    GroupSlot* slots;
+    int capacity;         // Siempre potencia de dos
+    int* group_rows;      // Fila representativa de cada grupo (valores de la clave)
+    AggState* states;     // num_states acumuladores por grupo, grupo tras grupo
+    int num_states;
+    int num_groups;
+    int group_capacity;
+} GroupTable;
+
+// Hash FNV-1a de una secuencia de bytes, continuando desde hash
+static unsigned int hash_bytes(unsigned int hash, const void* data, int length) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (int i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Hash de la clave de agrupación de una fila
+static unsigned int group_hash(const Plan* plan, const Row* row) {
+    unsigned int hash = 2166136261u;
+
+    for (int g = 0; g < plan->num_group_columns; g++) {
+        int col = plan->group_columns[g];
+        Value value = row->values[col];
+
+        switch (plan->table->columns[col].type) {
+            case TYPE_STRING:
+                if (value.string_val) {
+                    hash = hash_bytes(hash, value.string_val, strlen(value.string_val) + 1);
+                } else {
+                    hash = hash_bytes(hash, "\xff", 1);
+                }
+                break;
+            case TYPE_FLOAT: {
+                // 0.0 y -0.0 son el mismo grupo
+                float f = value.float_val == 0 ? 0 : value.float_val;
+                hash = hash_bytes(hash, &f, sizeof(f));
+                break;
+            }
+            default:
+                hash = hash_bytes(hash, &value.int_val, sizeof(value.int_val));
+                break;
+        }
+    }
+
+    return hash;
+}
+
+// Indica si dos filas tienen la misma clave de agrupación
+static int group_keys_equal(const Plan* plan, const Row* a, const Row* b) {
+    for (int g = 0; g < plan->num_group_columns; g++) {
+        int col = plan->group_columns[g];
+        Value x = a->values[col];
+        Value y = b->values[col];
+
+        switch (plan->table->columns[col].type) {
+            case TYPE_STRING:
+                if (!x.string_val || !y.string_val) {
+                    if (x.string_val != y.string_val) return 0;
+                } else if (strcmp(x.string_val, y.string_val) != 0) {
+                    return 0;
+                }
+                break;
+            case TYPE_FLOAT:
+                if (x.float_val != y.float_val) return 0;
+                break;
+            case TYPE_BOOL:
+                if ((x.bool_val != 0) != (y.bool_val != 0)) return 0;
+                break;
+            default:
+                if (x.int_val != y.int_val) return 0;
+                break;
+        }
+    }
+
+    return 1;
+}
+
+static int group_table_init(GroupTable* groups, int num_states) {
+    memset(groups, 0, sizeof(GroupTable));
+
+    groups->capacity = AGGREGATE_INITIAL_SLOTS;
+    groups->slots = (GroupSlot*)malloc(groups->capacity * sizeof(GroupSlot));
+    if (!groups->slots) return -1;
+
+    for (int i = 0; i < groups->capacity; i++) groups->slots[i].group = -1;
+    groups->num_states = num_states > 0 ? num_states : 1;
+    return 0;
+}
+
+static void group_table_free(GroupTable* groups) {
+    free(groups->slots);
+    free(groups->group_rows);
+    free(groups->states);
+}
+
+// Duplica el número de ranuras y recoloca los grupos existentes
+static int group_table_grow(GroupTable* groups) {
+    int capacity = groups->capacity * 2;
+    GroupSlot* slots = (GroupSlot*)malloc(capacity * sizeof(GroupSlot));
+    if (!slots) return -1;
+
+    for (int i = 0; i < capacity; i++) slots[i].group = -1;
+
+    unsigned int mask = (unsigned int)capacity - 1;
+    for (int i = 0; i < groups->capacity; i++) {
+        if (groups->slots[i].group < 0) continue;
+
+        unsigned int pos = groups->slots[i].hash & mask;
+        while (slots[pos].group >= 0) pos = (pos + 1) & mask;
+        slots[pos] = groups->slots[i];
+    }
+
+    free(groups->slots);
+    groups->slots = slots;
+    groups->capacity = capacity;
+    return 0;
+}
+
+// Añade un grupo nuevo con sus acumuladores a cero (devuelve su índice o -1)
+static int group_table_add(GroupTable* groups, int row) {
+    if (groups->num_groups >= groups->group_capacity) {
+        int capacity = groups->group_capacity == 0 ? 16 : groups->group_capacity * 2;
+
+        int* group_rows = (int*)realloc(groups->group_rows, capacity * sizeof(int));
+        if (!group_rows) return -1;
+        groups->group_rows = group_rows;
+
+        AggState* states = (AggState*)realloc(groups->states,
+                                              (size_t)capacity * groups->num_states * sizeof(AggState));
+        if (!states) return -1;
+        groups->states = states;
+
+        groups->group_capacity = capacity;
+    }
+
+    int group = groups->num_groups++;
+    groups->group_rows[group] = row;
+    memset(&groups->states[(size_t)group * groups->num_states], 0, groups->num_states * sizeof(AggState));
+    return group;
+}
+
+// Busca el grupo de una fila y lo crea si no existe (devuelve su índice o -1)
+static int group_table_find_or_add(GroupTable* groups, const Plan* plan, int row) {
+    const Row* rows = plan->table->rows;
+
+    // Mantener el factor de carga por debajo de 1/2
+    if ((groups->num_groups + 1) * 2 > groups->capacity) {
+        if (group_table_grow(groups) != 0) return -1;
+    }
+
+    unsigned int hash = group_hash(plan, &rows[row]);
+    unsigned int mask = (unsigned int)groups->capacity - 1;
+    unsigned int pos = hash & mask;
+
+    while (groups->slots[pos].group >= 0) {
+        GroupSlot* slot = &groups->slots[pos];
+        if (slot->hash == hash &&
+            group_keys_equal(plan, &rows[groups->group_rows[slot->group]], &rows[row])) {
+            return slot->group;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    int group = group_table_add(groups, row);
+    if (group < 0) return -1;
+
+    groups->slots[pos].hash = hash;
+    groups->slots[pos].group = group;
+    return group;
+}
+
+/**
+ * Acumulación
+ */
+
+// Compara dos valores de una columna del mismo tipo
+static int compare_column_values(Value a, Value b, DataType type) {
+    switch (type) {
+        case TYPE_STRING: return strcmp(a.string_val, b.string_val);
+        case TYPE_FLOAT: return (a.float_val > b.float_val) - (a.float_val < b.float_val);
+        case TYPE_BOOL: return (a.bool_val != 0) - (b.bool_val != 0);
+        default: return (a.int_val > b.int_val) - (a.int_val < b.int_val);
+    }
+}
+
+// Acumula los valores de una fila en los acumuladores de su grupo
+static void accumulate_row(const Plan* plan, const Row* row, AggState* states) {
+    for (int i = 0; i < plan->num_out_columns; i++) {
+        int aggregate = plan->out_aggregates[i];
+        int col = plan->out_columns[i];
+        AggState* state = &states[i];
+
+        if (aggregate == AGG_NONE) continue;
+
+        // COUNT(*) cuenta todas las filas
+        if (col < 0) {
+            state->count++;
+            continue;
+        }
+
+        DataType type = plan->table->columns[col].type;
+        Value value = row->values[col];
+
+        // Los valores nulos no se agregan
+        if (type == TYPE_STRING && !value.string_val) continue;
+
+        switch (aggregate) {
+            case AGG_SUM:
+            case AGG_AVG:
+                if (type == TYPE_FLOAT) {
+                    state->sum += value.float_val;
+                } else {
+                    state->int_sum += type == TYPE_BOOL ? (value.bool_val != 0) : value.int_val;
+                }
+                break;
+            case AGG_MIN:
+                if (state->count == 0 || compare_column_values(value, state->min, type) < 0) {
+                    state->min = value;
+                }
+                break;
+            case AGG_MAX:
+                if (state->count == 0 || compare_column_values(value, state->max, type) > 0) {
+                    state->max = value;
+                }
+                break;
+            default:
+                break;
+        }
+
+        state->count++;
+    }
+}
+
+// Suma a dst los acumuladores parciales de src (mismo grupo, calculado en otro hilo)
+static void merge_states(const Plan* plan, AggState* dst, const AggState* src) {
+    for (int i = 0; i < plan->num_out_columns; i++) {
+        int aggregate = plan->out_aggregates[i];
+        int col = plan->out_columns[i];
+
+        if (aggregate == AGG_NONE || src[i].count == 0) continue;
+
+        if (col >= 0) {
+            DataType type = plan->table->columns[col].type;
+
+            if (aggregate == AGG_MIN &&
+                (dst[i].count == 0 || compare_column_values(src[i].min, dst[i].min, type) < 0)) {
+                dst[i].min = src[i].min;
+            }
+            if (aggregate == AGG_MAX &&
+                (dst[i].count == 0 || compare_column_values(src[i].max, dst[i].max, type) > 0)) {
+                dst[i].max = src[i].max;
+            }
+        }
+
+        dst[i].count += src[i].count;
+        dst[i].int_sum += src[i].int_sum;
+        dst[i].sum += src[i].sum;
+    }
+}
+
+// Prepara la tabla de grupos (sin GROUP BY hay un único grupo, aunque no haya filas)
+static int aggregate_groups_init(GroupTable* groups, const Plan* plan) {
+    if (group_table_init(groups, plan->num_out_columns) != 0) return -1;
+
+    if (plan->num_group_columns == 0 && group_table_add(groups, -1) < 0) {
+        group_table_free(groups);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Acumula las filas rows[start, end) en sus grupos (0 si tuvo éxito, -1 si faltó memoria)
+static int aggregate_rows_into(GroupTable* groups, const Plan* plan, const int* rows, int start, int end) {
+    for (int i = start; i < end; i++) {
+        int group = plan->num_group_columns == 0 ? 0
+                                                 : group_table_find_or_add(groups, plan, rows[i]);
+        if (group < 0) return -1;
+
+        accumulate_row(plan, &plan->table->rows[rows[i]],
+                       &groups->states[(size_t)group * groups->num_states]);
+    }
+
+    return 0;
+}
+
+/**
+ * Resultado
+ */
+
+// Tipo de la columna de salida de un agregado
+static DataType aggregate_result_type(int aggregate, int col, const Table* table) {
+    switch (aggregate) {
+        case AGG_COUNT: return TYPE_INT;
+        case AGG_AVG: return TYPE_FLOAT;
+        case AGG_SUM: return table->columns[col].type == TYPE_FLOAT ? TYPE_FLOAT : TYPE_INT;
+        default: return table->columns[col].type;
+    }
+}
+
+// Valor de la columna de salida i para un grupo (0 si tuvo éxito, -1 si la suma de
+// una columna INT no cabe en un INT). Sin valores, SUM, AVG, MIN y MAX de columnas
+// numéricas dan 0: solo las cadenas pueden ser NULL.
+static int aggregate_result_value(const Plan* plan, int i, const AggState* state, int group_row,
+                                  Value* out, ValidationResult* result) {
+    int aggregate = plan->out_aggregates[i];
+    int col = plan->out_columns[i];
+    int is_float = col >= 0 && plan->table->columns[col].type == TYPE_FLOAT;
+    Value value;
+
+    memset(&value, 0, sizeof(Value));
+
+    switch (aggregate) {
+        case AGG_NONE:
+            value = plan->table->rows[group_row].values[col];
+            break;
+        case AGG_COUNT:
+            value.int_val = state->count;
+            break;
+        case AGG_SUM:
+            if (is_float) {
+                value.float_val = (float)state->sum;
+            } else if (state->int_sum < INT_MIN || state->int_sum > INT_MAX) {
+                char error[256];
+                snprintf(error, sizeof(error), "La suma de la columna %.100s está fuera de rango (%lld)",
+                         plan->table->columns[col].name, state->int_sum);
+                validator_set_error(result, 417, error);
+                return -1;
+            } else {
+                value.int_val = (int)state->int_sum;
+            }
+            break;
+        case AGG_AVG:
+            if (state->count > 0) {
+                value.float_val = (float)((is_float ? state->sum : (double)state->int_sum) / state->count);
+            }
+            break;
+        case AGG_MIN:
+            if (state->count > 0) value = state->min;
+            break;
+        case AGG_MAX:
+            if (state->count > 0) value = state->max;
+            break;
+    }
+
+    *out = value;
+    return 0;
+}
+
+// Crea la tabla temporal con las columnas de salida del plan (NULL si falta memoria)
+static Table* aggregate_create_output(const Plan* plan) {
+    const Table* table = plan->table;
+    Table* output = table_create(table->name);
+    if (!output) return NULL;
+
+    for (int i = 0; i < plan->num_out_columns; i++) {
+        int aggregate = plan->out_aggregates[i];
+        int col = plan->out_columns[i];
+        char name[128];
+
+        if (aggregate == AGG_NONE) {
+            snprintf(name, sizeof(name), "%s", table->columns[col].name);
+        } else {
+            snprintf(name, sizeof(name), "%s(%s)", ast_aggregate_name(aggregate),
+                     col < 0 ? "*" : table->columns[col].name);
+        }
+
+        DataType type = aggregate == AGG_NONE ? table->columns[col].type
+                                              : aggregate_result_type(aggregate, col, table);
+        if (table_add_column(output, name, type, 0, 0, 1) != 0) {
+            table_free(output);
+            return NULL;
+        }
+    }
+
+    return output;
+}
+
+// Construye la tabla temporal con una fila por grupo, en el orden de order
+// (índices de grupo) o en el de creación si order es NULL
+static Table* aggregate_output(const Plan* plan, const GroupTable* groups, const int* order,
+                               ValidationResult* result) {
+    int num_cols = plan->num_out_columns;
+
+    Table* output = aggregate_create_output(plan);
+    Value* values = (Value*)malloc(((size_t)groups->num_groups * num_cols + 1) * sizeof(Value));
+    if (!output || !values) {
+        validator_set_error(result, 404, "Error de memoria al agrupar filas");
+        free(values);
+        table_free(output);
+        return NULL;
+    }
+
+    for (int g = 0; g < groups->num_groups; g++) {
+        int group = order ? order[g] : g;
+        const AggState* states = &groups->states[(size_t)group * groups->num_states];
+        for (int i = 0; i < num_cols; i++) {
+            if (aggregate_result_value(plan, i, &states[i], groups->group_rows[group],
+                                       &values[(size_t)g * num_cols + i], result) != 0) {
+                free(values);
+                table_free(output);
+                return NULL;
+            }
+        }
+    }
+
+    // La tabla temporal copia las cadenas, así que se libera sin tocar la original
+    if (table_append_rows(output, values, groups->num_groups) != 0) {
+        validator_set_error(result, 404, "Error de memoria al agrupar filas");
+        table_free(output);
+        output = NULL;
+    }
+
+    free(values);
+    return output;
+}
+
+/**
+ * Agregación en paralelo
+ */
+
+// Cada hilo agrupa sus morsels en su propia tabla de grupos
+typedef struct {
+    const Plan* plan;
+    const int* rows;
+    GroupTable partials[PARALLEL_MAX_WORKERS];
+    int ready[PARALLEL_MAX_WORKERS];
+    atomic_int failed;
+} AggregateTask;
+
+static void aggregate_morsel(void* ctx, int worker, int start, int end) {
+    AggregateTask* task = (AggregateTask*)ctx;
+    GroupTable* partial = &task->partials[worker];
+
+    if (atomic_load(&task->failed)) return;
+
+    if (!task->ready[worker]) {
+        if (aggregate_groups_init(partial, task->plan) != 0) {
+            atomic_store(&task->failed, 1);
+            return;
+        }
+        task->ready[worker] = 1;
+    }
+
+    if (aggregate_rows_into(partial, task->plan, task->rows, start, end) != 0) {
+        atomic_store(&task->failed, 1);
+    }
+}
+
+// Mezcla una tabla parcial en la final. Cada grupo conserva como fila
+// representativa la primera en aparecer.
+static int aggregate_merge(GroupTable* groups, const Plan* plan, const GroupTable* partial) {
+    for (int g = 0; g < partial->num_groups; g++) {
+        int row = partial->group_rows[g];
+        int group = plan->num_group_columns == 0 ? 0 : group_table_find_or_add(groups, plan, row);
+        if (group < 0) return -1;
+
+        if (row < groups->group_rows[group]) groups->group_rows[group] = row;
+
+        merge_states(plan, &groups->states[(size_t)group * groups->num_states],
+                     &partial->states[(size_t)g * partial->num_states]);
+    }
+
+    return 0;
+}
+
+// Grupo y fila representativa, para ordenar los grupos por su primera fila
+typedef struct {
+    int row;
+    int group;
+} GroupOrder;
+
+static int compare_group_order(const void* a, const void* b) {
+    const GroupOrder* x = (const GroupOrder*)a;
+    const GroupOrder* y = (const GroupOrder*)b;
+    return (x->row > y->row) - (x->row < y->row);
+}
+
+// Orden de salida de los grupos: el mismo que daría el recorrido secuencial
+static int* aggregate_first_row_order(const GroupTable* groups) {
+    GroupOrder* pairs = (GroupOrder*)malloc((groups->num_groups + 1) * sizeof(GroupOrder));
+    int* order = (int*)malloc((groups->num_groups + 1) * sizeof(int));
+    if (!pairs || !order) {
+        free(pairs);
+        free(order);
+        return NULL;
+    }
+
+    for (int g = 0; g < groups->num_groups; g++) {
+        pairs[g].row = groups->group_rows[g];
+        pairs[g].group = g;
+    }
+    qsort(pairs, groups->num_groups, sizeof(GroupOrder), compare_group_order);
+
+    for (int g = 0; g < groups->num_groups; g++) order[g] = pairs[g].group;
+
+    free(pairs);
+    return order;
+}
+
+// Agrupa en paralelo y mezcla las tablas parciales en groups (0 si tuvo éxito)
+static int aggregate_parallel(GroupTable* groups, const Plan* plan, const int* rows, int num_rows) {
+    AggregateTask task;
+    int status = 0;
+
+    memset(&task, 0, sizeof(AggregateTask));
+    task.plan = plan;
+    task.rows = rows;
+    atomic_init(&task.failed, 0);
+
+    parallel_for_morsels(num_rows, aggregate_morsel, &task);
+    if (atomic_load(&task.failed)) status = -1;
+
+    for (int w = 0; w < PARALLEL_MAX_WORKERS; w++) {
+        if (!task.ready[w]) continue;
+
+        if (status == 0 && aggregate_merge(groups, plan, &task.partials[w]) != 0) status = -1;
+        group_table_free(&task.partials[w]);
+    }
+
+    return status;
+}
+
+// Agrupa las filas y construye la tabla con los agregados de cada grupo
+Table* aggregate_build(const Plan* plan, const int* rows, int num_rows, ValidationResult* result) {
+    GroupTable groups;
+    int* order = NULL;
+    int status;
+
+    if (aggregate_groups_init(&groups, plan) != 0) {
+        validator_set_error(result, 404, "Error de memoria al agrupar filas");
+        return NULL;
+    }
+
+    // Con muchas filas cada hilo agrupa sus morsels y luego se mezclan los parciales;
+    // los grupos se devuelven en el orden de su primera fila, como en el caso secuencial
+    if (num_rows >= PARALLEL_MIN_ROWS) {
+        status = aggregate_parallel(&groups, plan, rows, num_rows);
+        if (status == 0) {
+            order = aggregate_first_row_order(&groups);
+            if (!order) status = -1;
+        }
+    } else {
+        status = aggregate_rows_into(&groups, plan, rows, 0, num_rows);
+    }
+
+    if (status != 0) {
+        group_table_free(&groups);
+        validator_set_error(result, 404, "Error de memoria al agrupar filas");
+        return NULL;
+    }
+
+    Table* output = aggregate_output(plan, &groups, order, result);
+
+    free(order);
+    group_table_free(&groups);
+    return output;
+}
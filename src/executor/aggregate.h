@@ -0,0 +1,13 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include "executor.h"
+
+// Capacidad inicial de la tabla hash de grupos (potencia de dos)
+#define AGGREGATE_INITIAL_SLOTS 64
+
+// Agrupa las filas indicadas por las columnas de agrupación del plan y devuelve
+// una tabla temporal con una fila por grupo y sus agregados (NULL si hubo error)
+Table* aggregate_build(const Plan* plan, const int* rows, int num_rows, ValidationResult* result);
+
+#endif /* AGGREGATE_H */
@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "analyze.h"
+#include "sort.h"
+#include "../db/mvcc.h"
+
+#define HLL_REGISTERS (1 << ANALYZE_HLL_BITS)
+
+// Selectividad de las condiciones que no se pueden estimar con las estadísticas
+#define DEFAULT_EQ_SELECTIVITY 0.005
+#define DEFAULT_RANGE_SELECTIVITY (1.0 / 3.0)
+#define DEFAULT_SELECTIVITY 0.5
+
+/**
+ * HyperLogLog
+ */
+
+// Mezcla final de splitmix64: reparte cualquier entrada por los 64 bits
+static uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash de un valor no nulo (los FLOAT 0 y -0 son el mismo valor)
+static uint64_t hash_value(Value value, DataType type) {
+    switch (type) {
+        case TYPE_INT: return hash_mix((uint32_t)value.int_val);
+        case TYPE_BOOL: return hash_mix(value.bool_val != 0);
+        case TYPE_FLOAT: {
+            float number = value.float_val == 0.0f ? 0.0f : value.float_val;
+            uint32_t bits;
+            memcpy(&bits, &number, sizeof(bits));
+            return hash_mix(bits);
+        }
+        case TYPE_STRING: {
+            // FNV-1a de 64 bits
+            uint64_t hash = 14695981039346656037ULL;
+            for (const unsigned char* c = (const unsigned char*)value.string_val; *c; c++) {
+                hash ^= *c;
+                hash *= 1099511628211ULL;
+            }
+            return hash_mix(hash);
+        }
+    }
+    return 0;
+}
+
+// Los primeros bits del hash eligen el registro; el registro guarda la posición del
+// primer 1 en el resto (el máximo visto estima log2 de los valores distintos)
+static void hll_add(unsigned char* registers, uint64_t hash) {
+    int index = (int)(hash >> (64 - ANALYZE_HLL_BITS));
+    uint64_t rest = (hash << ANALYZE_HLL_BITS) | (1ULL << (ANALYZE_HLL_BITS - 1));
+    unsigned char rank = (unsigned char)(__builtin_clzll(rest) + 1);
+    if (rank > registers[index]) registers[index] = rank;
+}
+
+// Valores distintos según los registros, con linear counting si hay pocos
+static double hll_estimate(const unsigned char* registers) {
+    double m = HLL_REGISTERS;
+    double sum = 0;
+    int zeros = 0;
+
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        sum += ldexp(1.0, -registers[i]);
+        zeros += registers[i] == 0;
+    }
+
+    double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / zeros);
+    return estimate;
+}
+
+/**
+ * ANALYZE
+ */
+
+// Acumulado de una columna durante el recorrido
+typedef struct {
+    unsigned char* registers;   // HyperLogLog (HLL_REGISTERS bytes)
+    long long num_values;       // Valores no nulos
+    Value min;                  // Apuntan a los valores de la tabla (no se copian)
+    Value max;
+} ColumnScan;
+
+// Indica si una celda es NULL (solo se distingue en las cadenas)
+static int value_is_null(Value value, DataType type) {
+    return type == TYPE_STRING && !value.string_val;
+}
+
+// Copia un valor para las estadísticas (0 si tuvo éxito, -1 si faltó memoria)
+static int copy_value(Value value, DataType type, Value* out) {
+    *out = value;
+    if (type != TYPE_STRING) return 0;
+
+    out->string_val = strdup(value.string_val);
+    return out->string_val ? 0 : -1;
+}
+
+// Generador xorshift64 para la muestra (con semilla fija, para que ANALYZE dé siempre
+// lo mismo sobre los mismos datos)
+static uint64_t sample_next(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Construye el histograma de una columna con las filas de la muestra en que no es
+// NULL. Los extremos son el mínimo y el máximo de toda la tabla.
+static int build_histogram(const Table* view, int column, const int* sample, int sample_size,
+                           ColumnStats* stats) {
+    DataType type = stats->type;
+    int* rows = (int*)malloc((sample_size > 0 ? sample_size : 1) * sizeof(int));
+    if (!rows) return -1;
+
+    int count = 0;
+    for (int i = 0; i < sample_size; i++) {
+        if (!value_is_null(view->rows[sample[i]].values[column], type)) rows[count++] = sample[i];
+    }
+
+    SortKey key = { column, 0 };
+    if (count == 0 || sort_rows(view, rows, count, &key, 1) != 0) {
+        free(rows);
+        return count == 0 ? 0 : -1;
+    }
+
+    int buckets = count < STATS_HISTOGRAM_BUCKETS ? count : STATS_HISTOGRAM_BUCKETS;
+    stats->bounds = (Value*)calloc(buckets + 1, sizeof(Value));
+    if (!stats->bounds) {
+        free(rows);
+        return -1;
+    }
+
+    // Cada límite es el valor que deja por debajo b / buckets de la muestra
+    int status = 0;
+    for (int b = 0; b <= buckets; b++) {
+        Value bound = b == 0 ? stats->min : (b == buckets ? stats->max :
+                      view->rows[rows[(long long)b * (count - 1) / buckets]].values[column]);
+        if (copy_value(bound, type, &stats->bounds[b]) != 0) {
+            status = -1;
+            break;
+        }
+        // Si falta memoria a medias, stats_free libera los límites ya copiados
+        stats->num_buckets = b;
+    }
+
+    free(rows);
+    return status;
+}
+
+TableStats* analyze_table(Table* table, ValidationResult* result) {
+    if (!table || !result) return NULL;
+
+    DataType* types = (DataType*)malloc((table->num_columns > 0 ? table->num_columns : 1) * sizeof(DataType));
+    if (!types) {
+        validator_set_error(result, 404, "Error de memoria al analizar la tabla");
+        return NULL;
+    }
+    for (int c = 0; c < table->num_columns; c++) types[c] = table->columns[c].type;
+
+    TableStats* stats = stats_create(types, table->num_columns);
+    free(types);
+
+    int num_columns = table->num_columns;
+    ColumnScan* scans = (ColumnScan*)calloc(num_columns > 0 ? num_columns : 1, sizeof(ColumnScan));
+    int* sample = (int*)malloc(ANALYZE_SAMPLE_ROWS * sizeof(int));
+    int status = stats && scans && sample ? 0 : -1;
+    for (int c = 0; status == 0 && c < num_columns; c++) {
+        scans[c].registers = (unsigned char*)calloc(HLL_REGISTERS, 1);
+        if (!scans[c].registers) status = -1;
+    }
+
+    // Solo cuentan las filas confirmadas, no los cambios de una transacción en curso
+    RowVersion version = 0;
+    if (status == 0 && mvcc_begin_read(&version) != 0) status = -1;
+
+    if (status == 0) {
+        Table view;
+        table_open_snapshot(table, &view, version, 0);
+
+        // Un recorrido para los nulos, el mínimo, el máximo y los valores distintos;
+        // la muestra para los histogramas se elige a la vez (reservoir sampling)
+        uint64_t seed = 0x9e3779b97f4a7c15ULL;
+        long long num_rows = 0;
+        int sample_size = 0;
+
+        for (int r = 0; r < view.num_rows; r++) {
+            const Row* row = &view.rows[r];
+            if (!table_row_visible(&view, row)) continue;
+
+            if (num_rows < ANALYZE_SAMPLE_ROWS) {
+                sample[sample_size++] = r;
+            } else {
+                uint64_t slot = sample_next(&seed) % (uint64_t)(num_rows + 1);
+                if (slot < ANALYZE_SAMPLE_ROWS) sample[slot] = r;
+            }
+            num_rows++;
+
+            for (int c = 0; c < num_columns; c++) {
+                Value value = row->values[c];
+                DataType type = stats->columns[c].type;
+                ColumnScan* scan = &scans[c];
+
+                if (value_is_null(value, type)) {
+                    stats->columns[c].num_nulls++;
+                    continue;
+                }
+                if (scan->num_values == 0 || stats_compare_values(value, scan->min, type) < 0) scan->min = value;
+                if (scan->num_values == 0 || stats_compare_values(value, scan->max, type) > 0) scan->max = value;
+                scan->num_values++;
+                hll_add(scan->registers, hash_value(value, type));
+            }
+        }
+        stats->num_rows = num_rows;
+
+        for (int c = 0; status == 0 && c < num_columns; c++) {
+            ColumnStats* column = &stats->columns[c];
+            ColumnScan* scan = &scans[c];
+
+            column->null_fraction = num_rows > 0 ? (double)column->num_nulls / num_rows : 0;
+            if (scan->num_values == 0) continue;
+
+            // La estimación no puede pasar de los valores que hay
+            long long distinct = llround(hll_estimate(scan->registers));
+            if (distinct < 1) distinct = 1;
+            if (distinct > scan->num_values) distinct = scan->num_values;
+            column->num_distinct = distinct;
+
+            if (copy_value(scan->min, column->type, &column->min) != 0 ||
+                copy_value(scan->max, column->type, &column->max) != 0) {
+                // Con min copiado y max no, se libera aquí lo que stats_free no verá
+                if (column->type == TYPE_STRING) {
+                    free(column->min.string_val);
+                    free(column->max.string_val);
+                }
+                status = -1;
+                break;
+            }
+            column->has_bounds = 1;
+
+            if (build_histogram(&view, c, sample, sample_size, column) != 0) status = -1;
+        }
+
+        table_close_snapshot(table);
+        mvcc_end_read(version);
+    }
+
+    for (int c = 0; scans && c < num_columns; c++) free(scans[c].registers);
+    free(scans);
+    free(sample);
+
+    if (status != 0) {
+        stats_free(stats);
+        validator_set_error(result, 404, "Error de memoria al analizar la tabla");
+        return NULL;
+    }
+    return stats;
+}
+
+/**
+ * Estimación de filas
+ */
+
+// Convierte un literal al tipo de la columna con que se compara (-1 si no es del mismo
+// tipo, como una cadena comparada con un INT)
+static int literal_to_stats_value(const LiteralData* literal, DataType type, Value* out) {
+    memset(out, 0, sizeof(Value));
+    switch (type) {
+        case TYPE_INT:
+            if (literal->lit_type != LIT_INTEGER) return -1;
+            out->int_val = literal->int_value;
+            return 0;
+        case TYPE_FLOAT:
+            if (literal->lit_type == LIT_INTEGER) out->float_val = (float)literal->int_value;
+            else if (literal->lit_type == LIT_FLOAT) out->float_val = (float)literal->float_value;
+            else return -1;
+            return 0;
+        case TYPE_BOOL:
+            if (literal->lit_type != LIT_BOOLEAN) return -1;
+            out->bool_val = literal->bool_value;
+            return 0;
+        case TYPE_STRING:
+            if (literal->lit_type != LIT_STRING) return -1;
+            out->string_val = literal->string_value;
+            return 0;
+    }
+    return -1;
+}
+
+// Operador equivalente con los operandos cambiados de lado (5 < edad es edad > 5)
+static BinaryOpType swap_comparison(BinaryOpType op) {
+    switch (op) {
+        case OP_LT: return OP_GT;
+        case OP_GT: return OP_LT;
+        case OP_LTE: return OP_GTE;
+        case OP_GTE: return OP_LTE;
+        default: return op;
+    }
+}
+
+// Selectividad de una comparación sin estadísticas de la columna
+static double default_comparison(BinaryOpType op) {
+    switch (op) {
+        case OP_EQ: return DEFAULT_EQ_SELECTIVITY;
+        case OP_NEQ: return 1.0 - DEFAULT_EQ_SELECTIVITY;
+        default: return DEFAULT_RANGE_SELECTIVITY;
+    }
+}
+
+// Selectividad de "columna op literal"
+static double comparison_selectivity(const Table* table, BinaryOpType op, const IdentifierData* column,
+                                     const LiteralData* literal) {
+    // Cualquier comparación con NULL es falsa
+    if (literal->lit_type == LIT_NULL) return 0;
+
+    const ColumnStats* stats = stats_get_column(table->stats, column->column_index);
+    Value value;
+    if (!stats || literal_to_stats_value(literal, stats->type, &value) != 0) {
+        return default_comparison(op);
+    }
+    if (!stats->has_bounds) return 0;
+
+    double not_null = 1.0 - stats->null_fraction;
+    int outside = stats_compare_values(value, stats->min, stats->type) < 0 ||
+                  stats_compare_values(value, stats->max, stats->type) > 0;
+    double equal = outside ? 0 : not_null / stats->num_distinct;
+
+    switch (op) {
+        case OP_EQ: return equal;
+        case OP_NEQ: return not_null - equal;
+        case OP_LT: return not_null * stats_fraction_below(stats, value, 0);
+        case OP_LTE: return not_null * stats_fraction_below(stats, value, 1);
+        case OP_GT: return not_null * (1.0 - stats_fraction_below(stats, value, 1));
+        case OP_GTE: return not_null * (1.0 - stats_fraction_below(stats, value, 0));
+        default: return DEFAULT_SELECTIVITY;
+    }
+}
+
+// Fracción de las filas que cumplen una condición. AND y OR suponen que sus dos
+// lados son independientes.
+static double condition_selectivity(const Table* table, const ASTNode* condition) {
+    if (!condition) return 1.0;
+
+    if (condition->type == NODE_UNARY_EXPR) {
+        UnaryExprData* data = (UnaryExprData*)condition->data;
+        if (data->op_type == OP_NOT) return 1.0 - condition_selectivity(table, data->operand);
+        return DEFAULT_SELECTIVITY;
+    }
+    if (condition->type != NODE_BINARY_EXPR) return DEFAULT_SELECTIVITY;
+
+    BinaryExprData* data = (BinaryExprData*)condition->data;
+    switch (data->op_type) {
+        case OP_AND:
+            return condition_selectivity(table, data->left) * condition_selectivity(table, data->right);
+        case OP_OR: {
+            double left = condition_selectivity(table, data->left);
+            double right = condition_selectivity(table, data->right);
+            return left + right - left * right;
+        }
+        case OP_EQ: case OP_NEQ: case OP_LT: case OP_GT: case OP_LTE: case OP_GTE:
+            break;
+        default:
+            return DEFAULT_SELECTIVITY;
+    }
+
+    // Comparación de una columna con un literal, en cualquier orden
+    const ASTNode* column = data->left;
+    const ASTNode* literal = data->right;
+    BinaryOpType op = data->op_type;
+    if (column->type == NODE_LITERAL && literal->type == NODE_IDENTIFIER) {
+        column = data->right;
+        literal = data->left;
+        op = swap_comparison(op);
+    }
+    if (column->type != NODE_IDENTIFIER || literal->type != NODE_LITERAL) {
+        return default_comparison(op);
+    }
+
+    return comparison_selectivity(table, op, (const IdentifierData*)column->data,
+                                  (const LiteralData*)literal->data);
+}
+
+long long analyze_estimate_rows(const Table* table, const ASTNode* condition) {
+    if (!table || !table->stats) return -1;
+
+    double selectivity = condition_selectivity(table, condition);
+    if (selectivity < 0) selectivity = 0;
+    if (selectivity > 1) selectivity = 1;
+    // Nunca se estima que no salga ninguna fila de una tabla con filas
+    long long rows = llround(selectivity * table->stats->num_rows);
+    return rows < 1 && table->stats->num_rows > 0 ? 1 : rows;
+}
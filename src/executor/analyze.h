@@ -0,0 +1,25 @@
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include "../parser/ast.h"
+#include "../parser/validator.h"
+#include "../db/table.h"
+
+// Registros de HyperLogLog por columna (2^ANALYZE_HLL_BITS, error típico del 1.6%)
+#define ANALYZE_HLL_BITS 12
+
+// Filas de la muestra con la que se construyen los histogramas
+#define ANALYZE_SAMPLE_ROWS 30000
+
+// Calcula las estadísticas de las filas confirmadas de una tabla: filas, nulos,
+// valores distintos (HyperLogLog), mínimo y máximo de todas ellas, e histogramas de
+// igual profundidad sobre una muestra. Lee una instantánea, así que no bloquea la
+// tabla. El llamador debe tener el catálogo en lectura. NULL si hubo error.
+TableStats* analyze_table(Table* table, ValidationResult* result);
+
+// Filas que se estima que cumplen condition según las estadísticas de la tabla
+// (todas si condition es NULL; al menos 1 si la tabla tenía filas; -1 si no se ha
+// analizado)
+long long analyze_estimate_rows(const Table* table, const ASTNode* condition);
+
+#endif /* ANALYZE_H */
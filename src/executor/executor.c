@@ -0,0 +1,2065 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include "executor.h"
+#include "aggregate.h"
+#include "join.h"
+#include "parallel.h"
+#include "transaction.h"
+#include "explain.h"
+#include "analyze.h"
+#include "../db/mvcc.h"
+#include "../db/result.h"
+#include "../utils/output.h"
+#include "../utils/timing.h"
+
+/**
+ * Conversión de valores
+ */
+
+// Convierte un literal al tipo de una columna (las cadenas resultantes son propias)
+static int literal_to_column_value(const LiteralData* lit, const Column* column,
+                                   Value* out, ValidationResult* result) {
+    char error[200];
+    memset(out, 0, sizeof(Value));
+
+    // Verificar restricción NOT NULL
+    if (lit->lit_type == LIT_NULL) {
+        if (!column->allows_null) {
+            snprintf(error, sizeof(error), "No se permite NULL en la columna '%s'", column->name);
+            validator_set_error(result, 401, error);
+            return -1;
+        }
+        return 0;
+    }
+
+    int literal_type = ast_type_to_column_type(lit->lit_type);
+    if (!validator_check_type_compatibility(column->type, literal_type)) {
+        snprintf(error, sizeof(error), "Tipo no compatible para columna '%s'. Valor de tipo %d no es compatible con columna de tipo %d",
+                 column->name, literal_type, column->type);
+        validator_set_error(result, 402, error);
+        return -1;
+    }
+
+    switch (column->type) {
+        case TYPE_INT:
+            out->int_val = lit->lit_type == LIT_BOOLEAN ? lit->bool_value : lit->int_value;
+            break;
+        case TYPE_FLOAT:
+            out->float_val = lit->lit_type == LIT_INTEGER ? (float)lit->int_value
+                                                          : (float)lit->float_value;
+            break;
+        case TYPE_BOOL:
+            out->bool_val = lit->bool_value;
+            break;
+        case TYPE_STRING: {
+            char buffer[64];
+            const char* text = buffer;
+
+            switch (lit->lit_type) {
+                case LIT_STRING:
+                    text = lit->string_value ? lit->string_value : "";
+                    break;
+                case LIT_INTEGER:
+                    snprintf(buffer, sizeof(buffer), "%d", lit->int_value);
+                    break;
+                case LIT_FLOAT:
+                    snprintf(buffer, sizeof(buffer), "%g", lit->float_value);
+                    break;
+                default:
+                    text = lit->bool_value ? "true" : "false";
+                    break;
+            }
+
+            // Para strings, verificar longitud máxima
+            int length = strlen(text);
+            if (column->max_length > 0 && length > column->max_length) {
+                snprintf(error, sizeof(error), "El valor excede la longitud máxima para columna '%s'. Longitud: %d, máximo permitido: %d",
+                         column->name, length, column->max_length);
+                validator_set_error(result, 403, error);
+                return -1;
+            }
+
+            out->string_val = strdup(text);
+            if (!out->string_val) {
+                validator_set_error(result, 404, "Error de memoria al convertir valor");
+                return -1;
+            }
+            break;
+        }
+    }
+
+    return 0;
+}
+
+// Convierte un literal en un valor de expresión (sin copiar cadenas)
+static void expr_from_literal(const LiteralData* lit, ExprValue* out) {
+    memset(out, 0, sizeof(ExprValue));
+
+    switch (lit->lit_type) {
+        case LIT_INTEGER:
+            out->type = TYPE_INT;
+            out->value.int_val = lit->int_value;
+            break;
+        case LIT_FLOAT:
+            out->type = TYPE_FLOAT;
+            out->value.float_val = (float)lit->float_value;
+            break;
+        case LIT_STRING:
+            out->type = TYPE_STRING;
+            out->value.string_val = lit->string_value;
+            break;
+        case LIT_BOOLEAN:
+            out->type = TYPE_BOOL;
+            out->value.bool_val = lit->bool_value;
+            break;
+        case LIT_NULL:
+            out->is_null = 1;
+            break;
+    }
+}
+
+// Convierte un valor de expresión en literal (sin copiar cadenas)
+static void literal_from_expr(const ExprValue* value, LiteralData* out) {
+    memset(out, 0, sizeof(LiteralData));
+
+    if (value->is_null) {
+        out->lit_type = LIT_NULL;
+        return;
+    }
+
+    switch (value->type) {
+        case TYPE_INT:
+            out->lit_type = LIT_INTEGER;
+            out->int_value = value->value.int_val;
+            break;
+        case TYPE_FLOAT:
+            out->lit_type = LIT_FLOAT;
+            out->float_value = value->value.float_val;
+            break;
+        case TYPE_STRING:
+            out->lit_type = LIT_STRING;
+            out->string_value = value->value.string_val;
+            break;
+        case TYPE_BOOL:
+            out->lit_type = LIT_BOOLEAN;
+            out->bool_value = value->value.bool_val;
+            break;
+    }
+}
+
+// Libera las cadenas de un array de valores de columnas
+static void free_column_values(const Table* table, const int* columns, Value* values, int count) {
+    for (int i = 0; i < count; i++) {
+        int col = columns ? columns[i] : i;
+        if (table->columns[col].type == TYPE_STRING && values[i].string_val) {
+            free(values[i].string_val);
+            values[i].string_val = NULL;
+        }
+    }
+}
+
+// Recoge el tipo esperado de cada parámetro anotado por el validador
+static void collect_param_types(ASTNode* node, int* types, int num_params) {
+    for (; node; node = node->next) {
+        switch (node->type) {
+            case NODE_PARAMETER: {
+                ParameterData* data = (ParameterData*)node->data;
+                if (data->index < num_params) types[data->index] = data->expected_type;
+                break;
+            }
+            case NODE_BINARY_EXPR:
+                collect_param_types(((BinaryExprData*)node->data)->left, types, num_params);
+                collect_param_types(((BinaryExprData*)node->data)->right, types, num_params);
+                break;
+            case NODE_UNARY_EXPR:
+                collect_param_types(((UnaryExprData*)node->data)->operand, types, num_params);
+                break;
+            case NODE_SELECT_STMT:
+                collect_param_types(((SelectStmtData*)node->data)->where_clause, types, num_params);
+                collect_param_types(((SelectStmtData*)node->data)->limit, types, num_params);
+                collect_param_types(((SelectStmtData*)node->data)->offset, types, num_params);
+                break;
+            case NODE_INSERT_STMT:
+                collect_param_types(((InsertStmtData*)node->data)->values, types, num_params);
+                break;
+            case NODE_UPDATE_STMT:
+                collect_param_types(((UpdateStmtData*)node->data)->assignments, types, num_params);
+                collect_param_types(((UpdateStmtData*)node->data)->where_clause, types, num_params);
+                break;
+            case NODE_DELETE_STMT:
+                collect_param_types(((DeleteStmtData*)node->data)->where_clause, types, num_params);
+                break;
+            case NODE_WHERE_CLAUSE:
+                collect_param_types(((WhereClauseData*)node->data)->condition, types, num_params);
+                break;
+            case NODE_ASSIGNMENT:
+                // Las asignaciones son hermanas; el bucle recorre las siguientes
+                collect_param_types(((AssignmentData*)node->data)->value, types, num_params);
+                break;
+            case NODE_VALUE_LIST: {
+                ValueListData* data = (ValueListData*)node->data;
+                for (int i = 0; i < data->count; i++) {
+                    collect_param_types(data->values[i], types, num_params);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Evaluación de expresiones
+ */
+
+static int is_numeric(const ExprValue* value) {
+    return value->type == TYPE_INT || value->type == TYPE_FLOAT || value->type == TYPE_BOOL;
+}
+
+static double as_double(const ExprValue* value) {
+    switch (value->type) {
+        case TYPE_INT: return value->value.int_val;
+        case TYPE_FLOAT: return value->value.float_val;
+        case TYPE_BOOL: return value->value.bool_val;
+        default: return 0;
+    }
+}
+
+// Evalúa un valor como condición (NULL se considera falso)
+static int expr_is_true(const ExprValue* value) {
+    if (value->is_null) return 0;
+
+    switch (value->type) {
+        case TYPE_INT: return value->value.int_val != 0;
+        case TYPE_FLOAT: return value->value.float_val != 0;
+        case TYPE_BOOL: return value->value.bool_val != 0;
+        default: return 0;
+    }
+}
+
+// Compara dos valores no nulos (-1 si no son comparables)
+static int compare_values(const ExprValue* a, const ExprValue* b, int* cmp) {
+    if (a->type == TYPE_STRING && b->type == TYPE_STRING) {
+        *cmp = strcmp(a->value.string_val ? a->value.string_val : "",
+                      b->value.string_val ? b->value.string_val : "");
+        return 0;
+    }
+
+    if (!is_numeric(a) || !is_numeric(b)) return -1;
+
+    if (a->type != TYPE_FLOAT && b->type != TYPE_FLOAT) {
+        int x = a->type == TYPE_INT ? a->value.int_val : a->value.bool_val;
+        int y = b->type == TYPE_INT ? b->value.int_val : b->value.bool_val;
+        *cmp = (x > y) - (x < y);
+    } else {
+        double x = as_double(a);
+        double y = as_double(b);
+        *cmp = (x > y) - (x < y);
+    }
+
+    return 0;
+}
+
+static int eval_expr(ASTNode* expr, const Table* table, const Row* row, int rowid,
+                     const LiteralData* params, ExprValue* out, ValidationResult* result);
+
+// Evalúa una expresión binaria
+static int eval_binary(BinaryExprData* data, const Table* table, const Row* row, int rowid,
+                       const LiteralData* params, ExprValue* out, ValidationResult* result) {
+    ExprValue left, right;
+
+    memset(out, 0, sizeof(ExprValue));
+
+    if (eval_expr(data->left, table, row, rowid, params, &left, result) != 0) return -1;
+
+    // Operadores lógicos con cortocircuito
+    if (data->op_type == OP_AND || data->op_type == OP_OR) {
+        int left_true = expr_is_true(&left);
+        out->type = TYPE_BOOL;
+
+        if (data->op_type == OP_AND && !left_true) return 0;
+        if (data->op_type == OP_OR && left_true) {
+            out->value.bool_val = 1;
+            return 0;
+        }
+
+        if (eval_expr(data->right, table, row, rowid, params, &right, result) != 0) return -1;
+        out->value.bool_val = expr_is_true(&right);
+        return 0;
+    }
+
+    if (eval_expr(data->right, table, row, rowid, params, &right, result) != 0) return -1;
+
+    // Cualquier operación con NULL produce NULL
+    if (left.is_null || right.is_null) {
+        out->is_null = 1;
+        return 0;
+    }
+
+    switch (data->op_type) {
+        case OP_EQ: case OP_NEQ: case OP_LT: case OP_GT: case OP_LTE: case OP_GTE: {
+            int cmp;
+            out->type = TYPE_BOOL;
+
+            // Valores no comparables (cadena frente a número) no cumplen la condición
+            if (compare_values(&left, &right, &cmp) != 0) {
+                out->value.bool_val = data->op_type == OP_NEQ;
+                return 0;
+            }
+
+            switch (data->op_type) {
+                case OP_EQ: out->value.bool_val = cmp == 0; break;
+                case OP_NEQ: out->value.bool_val = cmp != 0; break;
+                case OP_LT: out->value.bool_val = cmp < 0; break;
+                case OP_GT: out->value.bool_val = cmp > 0; break;
+                case OP_LTE: out->value.bool_val = cmp <= 0; break;
+                default: out->value.bool_val = cmp >= 0; break;
+            }
+            return 0;
+        }
+
+        default: {
+            // Operadores aritméticos
+            if (!is_numeric(&left) || !is_numeric(&right)) {
+                validator_set_error(result, 405, "Operación aritmética no válida para cadenas");
+                return -1;
+            }
+
+            if (left.type != TYPE_FLOAT && right.type != TYPE_FLOAT) {
+                int x = (int)as_double(&left);
+                int y = (int)as_double(&right);
+                out->type = TYPE_INT;
+
+                switch (data->op_type) {
+                    case OP_PLUS: out->value.int_val = x + y; break;
+                    case OP_MINUS: out->value.int_val = x - y; break;
+                    case OP_MULTIPLY: out->value.int_val = x * y; break;
+                    default:
+                        if (y == 0) {
+                            validator_set_error(result, 406, "División por cero");
+                            return -1;
+                        }
+                        out->value.int_val = x / y;
+                        break;
+                }
+            } else {
+                double x = as_double(&left);
+                double y = as_double(&right);
+                out->type = TYPE_FLOAT;
+
+                switch (data->op_type) {
+                    case OP_PLUS: out->value.float_val = x + y; break;
+                    case OP_MINUS: out->value.float_val = x - y; break;
+                    case OP_MULTIPLY: out->value.float_val = x * y; break;
+                    default:
+                        if (y == 0) {
+                            validator_set_error(result, 406, "División por cero");
+                            return -1;
+                        }
+                        out->value.float_val = x / y;
+                        break;
+                }
+            }
+            return 0;
+        }
+    }
+}
+
+// Evalúa una expresión sobre una fila; rowid es el valor de la pseudocolumna rowid
+// para esa fila (su posición entre las filas visibles)
+static int eval_expr(ASTNode* expr, const Table* table, const Row* row, int rowid,
+                     const LiteralData* params, ExprValue* out, ValidationResult* result) {
+    memset(out, 0, sizeof(ExprValue));
+
+    switch (expr->type) {
+        case NODE_IDENTIFIER: {
+            // El validador ya resolvió el índice de la columna
+            IdentifierData* data = (IdentifierData*)expr->data;
+            if (data->column_index == ROWID_COLUMN_INDEX) {
+                out->type = TYPE_INT;
+                out->value.int_val = rowid;
+                return 0;
+            }
+            out->type = table->columns[data->column_index].type;
+            out->value = row->values[data->column_index];
+            out->is_null = out->type == TYPE_STRING && !out->value.string_val;
+            return 0;
+        }
+
+        case NODE_LITERAL:
+            expr_from_literal((LiteralData*)expr->data, out);
+            return 0;
+
+        case NODE_PARAMETER:
+            expr_from_literal(&params[((ParameterData*)expr->data)->index], out);
+            return 0;
+
+        case NODE_UNARY_EXPR: {
+            UnaryExprData* data = (UnaryExprData*)expr->data;
+            ExprValue operand;
+
+            if (eval_expr(data->operand, table, row, rowid, params, &operand, result) != 0) return -1;
+
+            if (data->op_type == OP_NOT) {
+                out->type = TYPE_BOOL;
+                out->is_null = operand.is_null;
+                out->value.bool_val = !expr_is_true(&operand);
+                return 0;
+            }
+
+            // Negación numérica
+            if (operand.is_null) {
+                out->is_null = 1;
+                return 0;
+            }
+            if (!is_numeric(&operand)) {
+                validator_set_error(result, 405, "Operación aritmética no válida para cadenas");
+                return -1;
+            }
+
+            *out = operand;
+            if (operand.type == TYPE_FLOAT) {
+                out->value.float_val = -operand.value.float_val;
+            } else {
+                out->type = TYPE_INT;
+                out->value.int_val = -(int)as_double(&operand);
+            }
+            return 0;
+        }
+
+        case NODE_BINARY_EXPR:
+            return eval_binary((BinaryExprData*)expr->data, table, row, rowid, params, out, result);
+
+        default:
+            validator_set_error(result, 407, "Tipo de expresión no soportado por el ejecutor");
+            return -1;
+    }
+}
+
+// Indica si una fila existe para el plan (visible para su instantánea y no borrada)
+static int plan_row_visible(const Plan* plan, const Row* row) {
+    return table_row_visible(plan->table, row) && !row->is_deleted;
+}
+
+// Evalúa la condición del plan sobre una fila (1 si cumple, 0 si no, -1 si hay error).
+// rowid cuenta las filas visibles recorridas: es el rowid de la siguiente fila visible
+// y avanza con cada una, de modo que rowid va de 0 a n - 1 aunque haya versiones muertas.
+static int plan_row_matches(const Plan* plan, const Row* row, int* rowid, const LiteralData* params,
+                            ValidationResult* result) {
+    if (!plan_row_visible(plan, row)) return 0;
+    int position = (*rowid)++;
+    if (!plan->condition) return 1;
+
+    ExprValue value;
+    if (eval_expr(plan->condition, plan->table, row, position, params, &value, result) != 0) return -1;
+
+    return expr_is_true(&value);
+}
+
+/**
+ * Recorridos paralelos
+ */
+
+// Sin límite, las tablas grandes se recorren por morsels en paralelo
+static int scan_is_parallel(int num_rows, int max_rows) {
+    return max_rows < 0 && num_rows >= PARALLEL_MIN_ROWS;
+}
+
+// Con tablas grandes cada hilo conserva sus k primeras si los montículos
+// no ocupan más que la propia tabla
+static int top_n_is_parallel(int num_rows, int k) {
+    if (k > num_rows) k = num_rows;
+    return num_rows >= PARALLEL_MIN_ROWS && (long long)k * parallel_num_workers() <= num_rows;
+}
+
+// Morsels en que se reparte un recorrido paralelo
+static int scan_num_morsels(int num_rows) {
+    return (num_rows + MORSEL_SIZE - 1) / MORSEL_SIZE;
+}
+
+// Estado compartido de un recorrido por morsels: cada hilo anota sus errores en su
+// propio resultado y el primero que falla detiene a los demás
+typedef struct {
+    const Plan* plan;
+    const LiteralData* params;
+    int* rows;                     // Coincidencias de cada morsel al principio de su tramo
+    int* morsel_counts;            // Número de coincidencias de cada morsel
+    int* morsel_rowids;            // rowid de la primera fila visible de cada morsel
+                                   // (NULL si la condición no usa rowid)
+    TopN* heaps;                   // Montículo de cada hilo (top-N)
+    ValidationResult errors[PARALLEL_MAX_WORKERS];
+    atomic_int failed;
+} ScanTask;
+
+// Prepara un recorrido por morsels. Si la condición usa rowid, cuenta antes las filas
+// visibles de cada morsel para que cada hilo sepa por qué rowid empieza (0 o -1)
+static int scan_task_init(ScanTask* task, const Plan* plan, const LiteralData* params,
+                          ValidationResult* result) {
+    memset(task, 0, sizeof(ScanTask));
+    task->plan = plan;
+    task->params = params;
+    atomic_init(&task->failed, 0);
+
+    if (!validator_uses_rowid(plan->condition)) return 0;
+
+    int num_morsels = scan_num_morsels(plan->table->num_rows);
+    task->morsel_rowids = (int*)malloc((num_morsels > 0 ? num_morsels : 1) * sizeof(int));
+    if (!task->morsel_rowids) {
+        validator_set_error(result, 404, "Error de memoria al recorrer la tabla");
+        return -1;
+    }
+
+    int visible = 0;
+    for (int i = 0; i < plan->table->num_rows; i++) {
+        if (i % MORSEL_SIZE == 0) task->morsel_rowids[i / MORSEL_SIZE] = visible;
+        visible += plan_row_visible(plan, &plan->table->rows[i]);
+    }
+    return 0;
+}
+
+// rowid con el que empieza el morsel que arranca en start
+static int scan_task_rowid(const ScanTask* task, int start) {
+    return task->morsel_rowids ? task->morsel_rowids[start / MORSEL_SIZE] : 0;
+}
+
+// Pasa el primer error de los hilos a result y libera los mensajes (-1 si hubo error)
+static int scan_task_finish(ScanTask* task, ValidationResult* result) {
+    int status = 0;
+
+    for (int w = 0; w < PARALLEL_MAX_WORKERS; w++) {
+        if (task->errors[w].error_code != 0 && status == 0) {
+            validator_set_error(result, task->errors[w].error_code, task->errors[w].error_message);
+            status = -1;
+        }
+        free(task->errors[w].error_message);
+    }
+
+    free(task->morsel_rowids);
+    return status;
+}
+
+// Filtra un morsel y deja sus coincidencias al principio de su tramo de rows
+static void scan_morsel(void* ctx, int worker, int start, int end) {
+    ScanTask* task = (ScanTask*)ctx;
+    const Row* rows = task->plan->table->rows;
+    int rowid = scan_task_rowid(task, start);
+    int count = 0;
+
+    if (atomic_load(&task->failed)) return;
+
+    for (int i = start; i < end; i++) {
+        int match = plan_row_matches(task->plan, &rows[i], &rowid, task->params, &task->errors[worker]);
+        if (match < 0) {
+            atomic_store(&task->failed, 1);
+            return;
+        }
+        if (match) task->rows[start + count++] = i;
+    }
+
+    task->morsel_counts[start / MORSEL_SIZE] = count;
+}
+
+// Filtra toda la tabla en paralelo; rows tiene una posición por fila de la tabla
+static int plan_scan_parallel(const Plan* plan, const LiteralData* params, int* rows,
+                              ValidationResult* result) {
+    int num_rows = plan->table->num_rows;
+    int num_morsels = scan_num_morsels(num_rows);
+    ScanTask task;
+
+    if (scan_task_init(&task, plan, params, result) != 0) return -1;
+    task.rows = rows;
+    task.morsel_counts = (int*)calloc(num_morsels > 0 ? num_morsels : 1, sizeof(int));
+    if (!task.morsel_counts) {
+        validator_set_error(result, 404, "Error de memoria al recorrer la tabla");
+        scan_task_finish(&task, result);
+        return -1;
+    }
+
+    parallel_for_morsels(num_rows, scan_morsel, &task);
+
+    // Juntar las coincidencias de los morsels en orden
+    int count = 0;
+    if (scan_task_finish(&task, result) == 0) {
+        for (int m = 0; m < num_morsels; m++) {
+            memmove(rows + count, rows + (size_t)m * MORSEL_SIZE, task.morsel_counts[m] * sizeof(int));
+            count += task.morsel_counts[m];
+        }
+    } else {
+        count = -1;
+    }
+
+    free(task.morsel_counts);
+    return count;
+}
+
+// Recoge los índices de las filas que cumplen la condición, deteniendo el recorrido
+// al llegar a max_rows (-1 sin límite). Devuelve el número de filas o -1
+static int plan_collect_rows(const Plan* plan, const LiteralData* params, int max_rows,
+                             int** rows_out, ValidationResult* result) {
+    Table* table = plan->table;
+    int capacity = max_rows >= 0 && max_rows < table->num_rows ? max_rows : table->num_rows;
+    int* rows = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    if (!rows) {
+        validator_set_error(result, 404, "Error de memoria al recorrer la tabla");
+        return -1;
+    }
+
+    if (scan_is_parallel(table->num_rows, max_rows)) {
+        int count = plan_scan_parallel(plan, params, rows, result);
+        if (count < 0) {
+            free(rows);
+            return -1;
+        }
+        *rows_out = rows;
+        return count;
+    }
+
+    int count = 0;
+    int rowid = 0;
+    for (int i = 0; i < table->num_rows && count != max_rows; i++) {
+        int match = plan_row_matches(plan, &table->rows[i], &rowid, params, result);
+        if (match < 0) {
+            free(rows);
+            return -1;
+        }
+        if (match) rows[count++] = i;
+    }
+
+    *rows_out = rows;
+    return count;
+}
+
+// Escribe las filas que cumplen la condición según las encuentra el recorrido, saltando
+// las offset primeras y parando tras limit (-1 sin límite). Anota en el operador node
+// de explain las filas escritas y las leídas.
+static int plan_stream_rows(const Plan* plan, const LiteralData* params, int offset, int limit,
+                            ExplainPlan* explain, int node, ValidationResult* result) {
+    long long start = explain_start(explain);
+    Table* table = plan->table;
+    ResultSink sink;
+    if (result_open(&sink, table, plan->out_columns, plan->num_out_columns) != 0) {
+        validator_set_error(result, 404, "Error de memoria al escribir el resultado");
+        return -1;
+    }
+
+    int skipped = 0;
+    int rowid = 0;
+    int i = 0;
+    for (; i < table->num_rows && sink.num_rows != limit; i++) {
+        int match = plan_row_matches(plan, &table->rows[i], &rowid, params, result);
+        if (match < 0) {
+            result_discard(&sink);
+            return -1;
+        }
+        if (!match) continue;
+
+        if (skipped < offset) {
+            skipped++;
+        } else {
+            result_add_row(&sink, i);
+        }
+    }
+
+    int written = sink.num_rows;
+    result_close(&sink);
+    explain_record(explain, node, written, i, -1, explain_elapsed(explain, start));
+    return 0;
+}
+
+/**
+ * Compilación de planes
+ */
+
+static int compile_insert(Plan* plan, ValidationResult* result) {
+    InsertStmtData* data = (InsertStmtData*)plan->stmt->data;
+    Table* table = plan->table;
+
+    int count = data->num_rows * table->num_columns;
+    if (count < 1) count = 1;
+
+    plan->num_insert_rows = data->num_rows;
+    plan->insert_values = (Value*)calloc(count, sizeof(Value));
+    plan->insert_types = (DataType*)malloc(count * sizeof(DataType));
+    plan->insert_params = (int*)malloc(count * sizeof(int));
+    if (!plan->insert_values || !plan->insert_types || !plan->insert_params) {
+        validator_set_error(result, 404, "Error de memoria al compilar INSERT");
+        return -1;
+    }
+
+    // Convertir los literales una sola vez; los parámetros se convierten al enlazar
+    int i = 0;
+    for (ASTNode* row = data->values; row; row = row->next) {
+        ValueListData* values = (ValueListData*)row->data;
+
+        for (int col = 0; col < table->num_columns; col++, i++) {
+            ASTNode* value = values->values[col];
+
+            plan->insert_types[i] = table->columns[col].type;
+            plan->num_insert_values = i + 1;
+
+            if (value->type == NODE_PARAMETER) {
+                plan->insert_params[i] = ((ParameterData*)value->data)->index;
+            } else {
+                plan->insert_params[i] = -1;
+                if (literal_to_column_value((LiteralData*)value->data, &table->columns[col],
+                                            &plan->insert_values[i], result) != 0) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int compile_select(Plan* plan, ValidationResult* result) {
+    SelectStmtData* data = (SelectStmtData*)plan->stmt->data;
+    ColumnListData* columns = (ColumnListData*)data->columns->data;
+    int num_columns = plan->table->num_columns;
+
+    // JOIN: el validador garantiza que ON iguala una columna de cada tabla
+    if (plan->join_table) {
+        BinaryExprData* on = (BinaryExprData*)data->join_condition->data;
+        int a = ((IdentifierData*)on->left->data)->column_index;
+        int b = ((IdentifierData*)on->right->data)->column_index;
+
+        plan->join_left_key = a < b ? a : b;
+        plan->join_right_key = (a < b ? b : a) - num_columns;
+        num_columns += plan->join_table->num_columns;
+    }
+
+    plan->num_out_columns = columns->is_all ? num_columns : columns->count;
+    plan->out_columns = (int*)malloc((plan->num_out_columns > 0 ? plan->num_out_columns : 1) * sizeof(int));
+    if (!plan->out_columns) {
+        validator_set_error(result, 404, "Error de memoria al compilar SELECT");
+        return -1;
+    }
+
+    for (int i = 0; i < plan->num_out_columns; i++) {
+        plan->out_columns[i] = columns->is_all ? i : columns->column_indices[i];
+    }
+
+    if (data->where_clause) {
+        plan->condition = ((WhereClauseData*)data->where_clause->data)->condition;
+    }
+
+    // Ordenación: con agregación las claves son columnas del resultado
+    if (data->order_by) {
+        ColumnListData* order_by = (ColumnListData*)data->order_by->data;
+
+        plan->num_order_keys = order_by->count;
+        plan->order_keys = (SortKey*)malloc(order_by->count * sizeof(SortKey));
+        if (!plan->order_keys) {
+            validator_set_error(result, 404, "Error de memoria al compilar SELECT");
+            return -1;
+        }
+
+        for (int i = 0; i < order_by->count; i++) {
+            int column = order_by->column_indices[i];
+            if (columns->aggregates || data->group_by) {
+                column = validator_find_select_item(columns, order_by->aggregates ? order_by->aggregates[i] : AGG_NONE,
+                                                    column);
+            }
+            plan->order_keys[i].column = column;
+            plan->order_keys[i].descending = order_by->descending[i];
+        }
+    }
+
+    plan->limit = data->limit;
+    plan->offset = data->offset;
+
+    // Agregación: el validador garantiza que las demás columnas están en GROUP BY
+    if (columns->aggregates || data->group_by) {
+        ColumnListData* group_by = data->group_by ? (ColumnListData*)data->group_by->data : NULL;
+
+        plan->is_aggregate = 1;
+        plan->num_group_columns = group_by ? group_by->count : 0;
+        plan->out_aggregates = (int*)malloc(plan->num_out_columns * sizeof(int));
+        plan->group_columns = (int*)malloc((plan->num_group_columns > 0 ? plan->num_group_columns : 1) * sizeof(int));
+        if (!plan->out_aggregates || !plan->group_columns) {
+            validator_set_error(result, 404, "Error de memoria al compilar SELECT");
+            return -1;
+        }
+
+        for (int i = 0; i < plan->num_out_columns; i++) {
+            plan->out_aggregates[i] = columns->aggregates ? columns->aggregates[i] : AGG_NONE;
+        }
+        for (int i = 0; i < plan->num_group_columns; i++) {
+            plan->group_columns[i] = group_by->column_indices[i];
+        }
+    }
+
+    return 0;
+}
+
+static int compile_update(Plan* plan, ValidationResult* result) {
+    UpdateStmtData* data = (UpdateStmtData*)plan->stmt->data;
+
+    for (ASTNode* current = data->assignments; current; current = current->next) {
+        plan->num_assignments++;
+    }
+
+    plan->assign_columns = (int*)malloc(plan->num_assignments * sizeof(int));
+    plan->assign_values = (ASTNode**)malloc(plan->num_assignments * sizeof(ASTNode*));
+    if (!plan->assign_columns || !plan->assign_values) {
+        validator_set_error(result, 404, "Error de memoria al compilar UPDATE");
+        return -1;
+    }
+
+    int i = 0;
+    for (ASTNode* current = data->assignments; current; current = current->next, i++) {
+        AssignmentData* assign = (AssignmentData*)current->data;
+        plan->assign_columns[i] = assign->column_index;
+        plan->assign_values[i] = assign->value;
+    }
+
+    if (data->where_clause) {
+        plan->condition = ((WhereClauseData*)data->where_clause->data)->condition;
+    }
+
+    return 0;
+}
+
+static int compile_delete(Plan* plan, ValidationResult* result) {
+    DeleteStmtData* data = (DeleteStmtData*)plan->stmt->data;
+
+    if (data->where_clause) {
+        plan->condition = ((WhereClauseData*)data->where_clause->data)->condition;
+    }
+
+    return 0;
+}
+
+// Valida una sentencia y construye su plan
+// BEGIN, COMMIT y ROLLBACK no usan tablas ni parámetros
+static Plan* compile_transaction(ASTNode* stmt, int num_params, Database* db, ValidationResult* result) {
+    Plan* plan = (Plan*)calloc(1, sizeof(Plan));
+    int* param_types = (int*)malloc(sizeof(int));
+    if (!plan || !param_types) {
+        free(plan);
+        free(param_types);
+        validator_set_error(result, 404, "Error de memoria al compilar la sentencia");
+        return NULL;
+    }
+
+    plan->type = stmt->type;
+    plan->stmt = stmt;
+    plan->param_types = param_types;
+    plan->num_params = num_params;
+    plan->schema_version = db->schema_version;
+    return plan;
+}
+
+// Valida una sentencia y construye su plan
+static Plan* compile_plan(ASTNode* stmt, int num_params, Database* db, ValidationResult* result) {
+    if (!stmt || !db || !result) return NULL;
+
+    const char* table_name;
+    switch (stmt->type) {
+        case NODE_SELECT_STMT: table_name = ((SelectStmtData*)stmt->data)->table_name; break;
+        case NODE_INSERT_STMT: table_name = ((InsertStmtData*)stmt->data)->table_name; break;
+        case NODE_UPDATE_STMT: table_name = ((UpdateStmtData*)stmt->data)->table_name; break;
+        case NODE_DELETE_STMT: table_name = ((DeleteStmtData*)stmt->data)->table_name; break;
+        case NODE_BEGIN_STMT:
+        case NODE_COMMIT_STMT:
+        case NODE_ROLLBACK_STMT:
+            return compile_transaction(stmt, num_params, db, result);
+        default:
+            validator_set_error(result, 408, "Solo se pueden ejecutar sentencias SELECT, INSERT, UPDATE o DELETE");
+            return NULL;
+    }
+
+    // Las tablas del plan no pueden desaparecer mientras se valida y compila
+    db_lock_read();
+    if (!validator_validate(stmt, db, result)) {
+        db_unlock();
+        return NULL;
+    }
+
+    Plan* plan = (Plan*)calloc(1, sizeof(Plan));
+    if (!plan) {
+        db_unlock();
+        validator_set_error(result, 404, "Error de memoria al compilar la sentencia");
+        return NULL;
+    }
+
+    plan->type = stmt->type;
+    plan->stmt = stmt;
+    plan->table = validator_find_table(table_name, db);
+    if (stmt->type == NODE_SELECT_STMT && ((SelectStmtData*)stmt->data)->join_table) {
+        plan->join_table = validator_find_table(((SelectStmtData*)stmt->data)->join_table, db);
+    }
+    plan->schema_version = db->schema_version;
+    plan->num_params = num_params;
+
+    // Tipos esperados de los parámetros para comprobarlos al enlazar
+    plan->param_types = (int*)malloc((num_params > 0 ? num_params : 1) * sizeof(int));
+    if (!plan->param_types) {
+        db_unlock();
+        validator_set_error(result, 404, "Error de memoria al compilar la sentencia");
+        free(plan);
+        return NULL;
+    }
+    for (int i = 0; i < num_params; i++) plan->param_types[i] = -1;
+    collect_param_types(stmt, plan->param_types, num_params);
+
+    int status;
+    switch (stmt->type) {
+        case NODE_INSERT_STMT: status = compile_insert(plan, result); break;
+        case NODE_SELECT_STMT: status = compile_select(plan, result); break;
+        case NODE_UPDATE_STMT: status = compile_update(plan, result); break;
+        default: status = compile_delete(plan, result); break;
+    }
+    db_unlock();
+
+    if (status != 0) {
+        executor_free_plan(plan);
+        return NULL;
+    }
+
+    return plan;
+}
+
+// Validar y compilar cuentan como la fase de validación de \timing
+Plan* executor_compile(ASTNode* stmt, int num_params, Database* db, ValidationResult* result) {
+    int mark = timing_enter(TIMING_VALIDATE);
+    Plan* plan = compile_plan(stmt, num_params, db, result);
+    timing_leave(mark);
+    return plan;
+}
+
+// Indica si el esquema cambió desde que se compiló el plan
+int executor_plan_is_stale(const Plan* plan, const Database* db) {
+    return !plan || !db || plan->schema_version != db->schema_version;
+}
+
+// Libera un plan
+void executor_free_plan(Plan* plan) {
+    if (!plan) return;
+
+    // No se consulta la tabla: puede haberse eliminado desde la compilación
+    for (int i = 0; i < plan->num_insert_values; i++) {
+        if (plan->insert_types[i] == TYPE_STRING) free(plan->insert_values[i].string_val);
+    }
+    free(plan->insert_values);
+    free(plan->insert_types);
+    free(plan->insert_params);
+    free(plan->param_types);
+    free(plan->out_columns);
+    free(plan->out_aggregates);
+    free(plan->group_columns);
+    free(plan->order_keys);
+    free(plan->assign_columns);
+    free(plan->assign_values);
+    free(plan);
+}
+
+/**
+ * Ejecución de planes
+ */
+
+// Prepara las filas de un INSERT enlazando sus parámetros (0 si tuvo éxito)
+static int insert_bind_values(const Plan* plan, const LiteralData* params, Value* values,
+                              ValidationResult* result) {
+    Table* table = plan->table;
+    int count = plan->num_insert_rows * table->num_columns;
+
+    // Partir de los literales precalculados y enlazar los parámetros
+    memcpy(values, plan->insert_values, count * sizeof(Value));
+    for (int i = 0; i < count; i++) {
+        if (plan->insert_params[i] >= 0) {
+            values[i].string_val = NULL;
+            if (literal_to_column_value(&params[plan->insert_params[i]],
+                                        &table->columns[i % table->num_columns],
+                                        &values[i], result) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Libera las cadenas de los parámetros enlazados en las filas de un INSERT
+static void insert_free_values(const Plan* plan, Value* values) {
+    int count = plan->num_insert_rows * plan->table->num_columns;
+    for (int i = 0; i < count; i++) {
+        if (plan->insert_params[i] >= 0 && plan->insert_types[i] == TYPE_STRING) {
+            free(values[i].string_val);
+        }
+    }
+}
+
+void executor_report_insert(const Plan* plan) {
+    output_printf("%d fila%s insertada%s en %s\n", plan->num_insert_rows,
+                  plan->num_insert_rows == 1 ? "" : "s",
+                  plan->num_insert_rows == 1 ? "" : "s", plan->table->name);
+}
+
+static int run_insert(Plan* plan, const LiteralData* params, WriteSet* ws, ValidationResult* result) {
+    Table* table = plan->table;
+    int count = plan->num_insert_rows * table->num_columns;
+
+    Value* values = (Value*)malloc((count > 0 ? count : 1) * sizeof(Value));
+    if (!values) {
+        validator_set_error(result, 404, "Error de memoria al insertar filas");
+        return -1;
+    }
+
+    int status = insert_bind_values(plan, params, values, result);
+
+    // Todas las filas se añaden juntas o ninguna
+    if (status == 0) {
+        if (table_append_versions(table, values, plan->num_insert_rows, ws->txn) == 0) {
+            ws->num_new = plan->num_insert_rows;
+            executor_report_insert(plan);
+        } else {
+            validator_set_error(result, 409, "No se pudo insertar la fila");
+            status = -1;
+        }
+    }
+
+    insert_free_values(plan, values);
+    free(values);
+    return status;
+}
+
+// Evalúa LIMIT u OFFSET (deja value sin cambiar si la cláusula no existe)
+static int eval_row_count(ASTNode* expr, const LiteralData* params, int* value,
+                          ValidationResult* result) {
+    if (!expr) return 0;
+
+    ExprValue count;
+    if (eval_expr(expr, NULL, NULL, -1, params, &count, result) != 0) return -1;
+
+    if (count.is_null || count.type != TYPE_INT || count.value.int_val < 0) {
+        validator_set_error(result, 413, "LIMIT y OFFSET deben ser números enteros no negativos");
+        return -1;
+    }
+
+    *value = count.value.int_val;
+    return 0;
+}
+
+// Filtra un morsel y pasa sus coincidencias por el montículo del hilo
+static void top_n_morsel(void* ctx, int worker, int start, int end) {
+    ScanTask* task = (ScanTask*)ctx;
+    const Row* rows = task->plan->table->rows;
+    int rowid = scan_task_rowid(task, start);
+
+    if (atomic_load(&task->failed)) return;
+
+    for (int i = start; i < end; i++) {
+        int match = plan_row_matches(task->plan, &rows[i], &rowid, task->params, &task->errors[worker]);
+        if (match < 0) {
+            atomic_store(&task->failed, 1);
+            return;
+        }
+        if (match) topn_push(&task->heaps[worker], i);
+    }
+}
+
+// Top-N en paralelo: un montículo por hilo y al final se mezclan en topn
+static int plan_top_n_parallel(const Plan* plan, const LiteralData* params, TopN* topn,
+                               ValidationResult* result) {
+    int workers = parallel_num_workers();
+    TopN heaps[PARALLEL_MAX_WORKERS];
+    ScanTask task;
+    int status = 0;
+
+    if (scan_task_init(&task, plan, params, result) != 0) return -1;
+    task.heaps = heaps;
+
+    int ready = 0;
+    for (; ready < workers; ready++) {
+        if (topn_init(&heaps[ready], plan->table, plan->order_keys, plan->num_order_keys,
+                      topn->capacity) != 0) {
+            break;
+        }
+    }
+
+    if (ready < workers) {
+        scan_task_finish(&task, result);
+        validator_set_error(result, 404, "Error de memoria al ordenar filas");
+        status = -1;
+    } else {
+        parallel_for_morsels(plan->table->num_rows, top_n_morsel, &task);
+        status = scan_task_finish(&task, result);
+    }
+
+    for (int w = 0; w < ready; w++) {
+        for (int i = 0; status == 0 && i < heaps[w].size; i++) topn_push(topn, heaps[w].rows[i]);
+        topn_free(&heaps[w]);
+    }
+
+    return status;
+}
+
+// Recoge las k primeras filas según el ORDER BY del plan con un montículo acotado
+static int plan_collect_top_n(const Plan* plan, const LiteralData* params, int k,
+                              int** rows_out, ValidationResult* result) {
+    // No se pueden conservar más filas que las que tiene la tabla
+    if (k > plan->table->num_rows) k = plan->table->num_rows;
+
+    TopN topn;
+    if (topn_init(&topn, plan->table, plan->order_keys, plan->num_order_keys, k) != 0) {
+        validator_set_error(result, 404, "Error de memoria al ordenar filas");
+        return -1;
+    }
+
+    if (top_n_is_parallel(plan->table->num_rows, k)) {
+        if (plan_top_n_parallel(plan, params, &topn, result) != 0) {
+            topn_free(&topn);
+            return -1;
+        }
+        *rows_out = topn.rows;
+        return topn_finish(&topn);
+    }
+
+    int rowid = 0;
+    for (int i = 0; i < plan->table->num_rows; i++) {
+        int match = plan_row_matches(plan, &plan->table->rows[i], &rowid, params, result);
+        if (match < 0) {
+            topn_free(&topn);
+            return -1;
+        }
+        if (match) topn_push(&topn, i);
+    }
+
+    *rows_out = topn.rows;
+    return topn_finish(&topn);
+}
+
+// Ordena las filas indicadas (todas si window < 0, o solo las window primeras)
+// y devuelve cuántas quedan en rows
+static int order_rows(const Plan* plan, const Table* table, int* rows, int count, int window,
+                      ValidationResult* result) {
+    if (plan->num_order_keys == 0) {
+        return window >= 0 && window < count ? window : count;
+    }
+
+    if (window < 0) {
+        if (sort_rows(table, rows, count, plan->order_keys, plan->num_order_keys) != 0) {
+            validator_set_error(result, 404, "Error de memoria al ordenar filas");
+            return -1;
+        }
+        return count;
+    }
+
+    TopN topn;
+    if (topn_init(&topn, table, plan->order_keys, plan->num_order_keys, window) != 0) {
+        validator_set_error(result, 404, "Error de memoria al ordenar filas");
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) topn_push(&topn, rows[i]);
+    count = topn_finish(&topn);
+    memcpy(rows, topn.rows, count * sizeof(int));
+
+    topn_free(&topn);
+    return count;
+}
+
+// Lo que hizo un JOIN, para EXPLAIN ANALYZE
+typedef struct {
+    JoinMethod method;
+    long long pairs;               // Parejas con la misma clave, antes del WHERE
+    int batches;                   // Lotes de parejas
+    JoinInput left;                // Filas leídas de cada tabla
+    JoinInput right;
+} JoinStats;
+
+// Une las tablas del plan (merge join o hash join) y devuelve una tabla temporal con las
+// filas que cumplen la condición, como máximo max_rows (-1 sin límite). Si stats no es
+// NULL anota en él el método, las parejas, los lotes y lo leído de cada tabla.
+static Table* plan_build_join(const Plan* plan, const LiteralData* params, int max_rows,
+                              JoinStats* stats, ValidationResult* result) {
+    const Table* left = plan->table;
+    const Table* right = plan->join_table;
+    int width = left->num_columns + right->num_columns;
+
+    Table* joined = table_create_joined(left, right);
+    int* left_rows = (int*)malloc(JOIN_BATCH_SIZE * sizeof(int));
+    int* right_rows = (int*)malloc(JOIN_BATCH_SIZE * sizeof(int));
+    Value* values = (Value*)malloc(JOIN_BATCH_SIZE * (width > 0 ? width : 1) * sizeof(Value));
+    Join join;
+    int status = 0;
+
+    if (!joined || !left_rows || !right_rows || !values ||
+        join_init(&join, left, plan->join_left_key, right, plan->join_right_key) != 0) {
+        validator_set_error(result, 404, "Error de memoria al unir las tablas");
+        table_free(joined);
+        free(left_rows);
+        free(right_rows);
+        free(values);
+        return NULL;
+    }
+    if (stats) stats->method = join.method;
+
+    // Cada lote de parejas se filtra con el WHERE y solo se copian las que lo cumplen
+    int pairs;
+    while (status == 0 && joined->num_rows != max_rows &&
+           (pairs = join_next(&join, left_rows, right_rows, JOIN_BATCH_SIZE)) > 0) {
+        int count = 0;
+
+        if (stats) {
+            stats->pairs += pairs;
+            stats->batches++;
+        }
+
+        for (int i = 0; i < pairs && joined->num_rows + count != max_rows; i++) {
+            Value* row_values = values + count * width;
+            memcpy(row_values, left->rows[left_rows[i]].values, left->num_columns * sizeof(Value));
+            memcpy(row_values + left->num_columns, right->rows[right_rows[i]].values,
+                   right->num_columns * sizeof(Value));
+
+            if (plan->condition) {
+                Row row = { row_values, 0 };
+                ExprValue value;
+                if (eval_expr(plan->condition, joined, &row, -1, params, &value, result) != 0) {
+                    status = -1;
+                    break;
+                }
+                if (!expr_is_true(&value)) continue;
+            }
+            count++;
+        }
+
+        if (status == 0 && table_append_rows(joined, values, count) != 0) {
+            validator_set_error(result, 404, "Error de memoria al unir las tablas");
+            status = -1;
+        }
+    }
+
+    if (stats) join_inputs(&join, &stats->left, &stats->right);
+    join_free(&join);
+    free(left_rows);
+    free(right_rows);
+    free(values);
+
+    if (status != 0) {
+        table_free(joined);
+        return NULL;
+    }
+    return joined;
+}
+
+/**
+ * Plan físico (EXPLAIN)
+ */
+
+// Forma en que run_select obtiene las filas del resultado
+typedef enum {
+    SELECT_STREAM,        // Se escriben según las encuentra el recorrido
+    SELECT_COLLECT,       // Se recogen todas (recorrido paralelo) y se escriben después
+    SELECT_AGGREGATE,     // Se agrupan todas; el orden y el límite se aplican a los grupos
+    SELECT_TOP_N,         // Montículo con las OFFSET + LIMIT primeras según el ORDER BY
+    SELECT_SORT           // Se recogen todas y se ordenan
+} SelectStrategy;
+
+// Operadores de un SELECT en el plan de EXPLAIN (-1 si la consulta no los usa)
+typedef struct {
+    int output;           // Escritura del resultado con OFFSET y LIMIT
+    int sort;             // Ordenación de las filas o de los grupos
+    int aggregate;        // Agregación
+    int scan;             // Recorrido de la tabla o del resultado del JOIN
+    int join;             // JOIN de las dos tablas
+    int join_left;        // Recorrido de cada tabla del JOIN
+    int join_right;
+} SelectNodes;
+
+// Operadores de un INSERT, UPDATE o DELETE (-1 si la sentencia no los usa)
+typedef struct {
+    int write;            // Escritura de las filas
+    int scan;             // Recorrido que busca las filas a cambiar
+} WriteNodes;
+
+// Elige cómo obtener las filas de un SELECT sobre num_rows filas (-1 si no se sabe, como
+// en un JOIN que no se ha ejecutado). Sin agregación ni ORDER BY las filas se escriben
+// según aparecen, salvo en los recorridos paralelos (tablas grandes sin LIMIT), que
+// primero las recogen.
+static SelectStrategy select_strategy(const Plan* plan, int num_rows, int window) {
+    if (plan->is_aggregate) return SELECT_AGGREGATE;
+    if (plan->num_order_keys > 0) return window >= 0 ? SELECT_TOP_N : SELECT_SORT;
+    if (window >= 0 || (num_rows >= 0 && num_rows < PARALLEL_MIN_ROWS)) return SELECT_STREAM;
+    return SELECT_COLLECT;
+}
+
+// Método que elegirá join_init para las tablas del plan. EXPLAIN no recorre las tablas
+// para saberlo: solo usa el orden que ya comprobó un JOIN anterior.
+static JoinMethod plan_join_method(const Plan* plan) {
+    int left = table_cached_order(plan->table, plan->join_left_key);
+    int right = table_cached_order(plan->join_table, plan->join_right_key);
+
+    if (left == 0 || right == 0) return JOIN_HASH;
+    return left == 1 && right == 1 ? JOIN_MERGE : JOIN_UNDECIDED;
+}
+
+// Lotes de un recorrido: sus morsels si es paralelo (-1 si no)
+static long long scan_batches(int num_rows, int parallel) {
+    return parallel ? scan_num_morsels(num_rows) : -1;
+}
+
+// Añade a un operador una expresión como detalle ("Filtro: (edad > 30)")
+static void describe_expr(ExplainPlan* explain, int node, const char* label, const ASTNode* expr) {
+    char text[EXPLAIN_TEXT_SIZE];
+    ast_format_expr(expr, text, sizeof(text));
+    explain_detail(explain, node, "%s: %s", label, text);
+}
+
+// Añade a un operador las columnas de una lista ("Orden: edad DESC, nombre ASC")
+static void describe_columns(ExplainPlan* explain, int node, const char* label, const ASTNode* list) {
+    ColumnListData* data = (ColumnListData*)list->data;
+    char text[EXPLAIN_TEXT_SIZE] = "*";
+    size_t length = 0;
+
+    for (int i = 0; i < data->count && length < sizeof(text); i++) {
+        const char* name = data->columns[i] ? data->columns[i] : "*";
+        const char* direction = data->descending ? (data->descending[i] ? " DESC" : " ASC") : "";
+        int written;
+
+        if (data->aggregates && data->aggregates[i] != AGG_NONE) {
+            written = snprintf(text + length, sizeof(text) - length, "%s%s(%s)%s", i > 0 ? ", " : "",
+                               ast_aggregate_name(data->aggregates[i]), name, direction);
+        } else {
+            written = snprintf(text + length, sizeof(text) - length, "%s%s%s", i > 0 ? ", " : "",
+                               name, direction);
+        }
+        if (written < 0) break;
+        length += written;
+    }
+
+    explain_detail(explain, node, "%s: %s", label, text);
+}
+
+// Añade a un operador el OFFSET y el LIMIT de la consulta, si los tiene
+static void describe_limit(ExplainPlan* explain, int node, const Plan* plan, int limit, int offset) {
+    if (limit >= 0) {
+        explain_detail(explain, node, "Límite: LIMIT %d OFFSET %d", limit, offset);
+    } else if (plan->offset) {
+        explain_detail(explain, node, "Límite: OFFSET %d", offset);
+    }
+}
+
+// Añade a un recorrido las filas que se espera que cumplan el filtro, si la tabla se
+// ha analizado con ANALYZE
+static void describe_estimate(ExplainPlan* explain, int node, const Plan* plan) {
+    long long estimate = analyze_estimate_rows(plan->table, plan->condition);
+    if (estimate < 0) return;
+    explain_detail(explain, node, "Filas estimadas: %lld de %lld (según ANALYZE)", estimate,
+                   plan->table->stats->num_rows);
+}
+
+// Añade el recorrido de la tabla de un plan sin JOIN: modo, filtro, índice y estimación
+static int describe_scan(ExplainPlan* explain, int depth, const Plan* plan, int parallel) {
+    int node = explain_add(explain, depth, "Recorrido %s de %s", parallel ? "paralelo" : "secuencial",
+                           plan->table->name);
+    if (parallel) {
+        int workers = parallel_num_workers();
+        explain_detail(explain, node, "Morsels de %d filas entre %d hilo%s", MORSEL_SIZE, workers,
+                       workers == 1 ? "" : "s");
+    }
+    if (plan->condition) describe_expr(explain, node, "Filtro", plan->condition);
+
+    // No hay índices secundarios: toda búsqueda recorre la tabla
+    explain_detail(explain, node, "Índice: ninguno");
+    describe_estimate(explain, node, plan);
+    return node;
+}
+
+// Añade el recorrido de una tabla del JOIN. Lo hace el propio JOIN en un solo hilo,
+// saltando las filas sin clave; el WHERE se aplica después a cada pareja.
+static int describe_join_input(ExplainPlan* explain, int depth, const Table* table, int key,
+                               const char* role) {
+    int node = explain_add(explain, depth, "Recorrido secuencial de %s (%s)", table->name, role);
+    explain_detail(explain, node, "Filtro: clave %s no nula", table->columns[key].name);
+    explain_detail(explain, node, "Hilos: 1 (dentro del JOIN)");
+    explain_detail(explain, node, "Índice: ninguno");
+    return node;
+}
+
+// Añade el JOIN de un plan como entrada del operador de nivel depth - 1, seguido del
+// recorrido de cada tabla (en nodes->join_left y nodes->join_right)
+static int describe_join(ExplainPlan* explain, int depth, const Plan* plan, JoinMethod method, int max_rows,
+                         SelectNodes* nodes) {
+    SelectStmtData* data = (SelectStmtData*)plan->stmt->data;
+    const Table* left = plan->table;
+    const Table* right = plan->join_table;
+
+    const char* name = method == JOIN_MERGE ? "Merge" : method == JOIN_HASH ? "Hash" : "Hash o merge";
+    int node = explain_add(explain, depth, "%s join de %s y %s", name, left->name, right->name);
+    describe_expr(explain, node, "Condición", data->join_condition);
+
+    if (method == JOIN_MERGE) {
+        explain_detail(explain, node, "Las dos tablas ya están ordenadas por la clave");
+    } else if (method == JOIN_UNDECIDED) {
+        explain_detail(explain, node, "Se decide al ejecutar: merge join si las dos tablas están "
+                       "ordenadas por la clave, si no hash join");
+    } else {
+        // hash_join_init construye la tabla hash sobre la tabla con menos filas
+        int build_is_left = left->num_rows <= right->num_rows;
+        explain_detail(explain, node, "Tabla hash sobre %s (%d filas); se sondea %s por lotes de %d",
+                       build_is_left ? left->name : right->name,
+                       build_is_left ? left->num_rows : right->num_rows,
+                       build_is_left ? right->name : left->name, JOIN_BATCH_SIZE);
+    }
+
+    if (plan->condition) describe_expr(explain, node, "Filtro", plan->condition);
+    if (max_rows >= 0) explain_detail(explain, node, "Se detiene tras %d filas", max_rows);
+
+    // Con hash join primero se lee entera la tabla de construcción
+    if (method == JOIN_MERGE) {
+        nodes->join_left = describe_join_input(explain, depth + 1, left, plan->join_left_key, "en orden de la clave");
+        nodes->join_right = describe_join_input(explain, depth + 1, right, plan->join_right_key, "en orden de la clave");
+    } else if (method == JOIN_UNDECIDED) {
+        nodes->join_left = describe_join_input(explain, depth + 1, left, plan->join_left_key, "izquierda");
+        nodes->join_right = describe_join_input(explain, depth + 1, right, plan->join_right_key, "derecha");
+    } else if (left->num_rows <= right->num_rows) {
+        nodes->join_left = describe_join_input(explain, depth + 1, left, plan->join_left_key, "construcción");
+        nodes->join_right = describe_join_input(explain, depth + 1, right, plan->join_right_key, "sondeo");
+    } else {
+        nodes->join_right = describe_join_input(explain, depth + 1, right, plan->join_right_key, "construcción");
+        nodes->join_left = describe_join_input(explain, depth + 1, left, plan->join_left_key, "sondeo");
+    }
+    return node;
+}
+
+// Describe los operadores de un SELECT. num_rows son las filas que recorre la consulta
+// (las de la tabla o las del resultado del JOIN, -1 si no se conocen).
+static void describe_select(ExplainPlan* explain, const Plan* plan, SelectStrategy strategy,
+                            int limit, int offset, int window, int num_rows, JoinMethod method,
+                            SelectNodes* nodes) {
+    SelectStmtData* data = (SelectStmtData*)plan->stmt->data;
+    int depth = 0;
+
+    if (strategy != SELECT_STREAM) {
+        nodes->output = explain_add(explain, depth++, "Resultado");
+        describe_limit(explain, nodes->output, plan, limit, offset);
+    }
+
+    if (strategy == SELECT_AGGREGATE && plan->num_order_keys > 0) {
+        if (window < 0) {
+            nodes->sort = explain_add(explain, depth++, "Ordenación de los grupos");
+        } else {
+            nodes->sort = explain_add(explain, depth++, "Top-N de los grupos (k = %d)", window);
+        }
+        describe_columns(explain, nodes->sort, "Orden", data->order_by);
+    } else if (strategy == SELECT_SORT) {
+        nodes->sort = explain_add(explain, depth++, "Ordenación completa");
+        describe_columns(explain, nodes->sort, "Orden", data->order_by);
+    }
+
+    if (strategy == SELECT_AGGREGATE) {
+        if (plan->num_group_columns > 0) {
+            nodes->aggregate = explain_add(explain, depth++, "Agregación hash");
+            describe_columns(explain, nodes->aggregate, "Grupos", data->group_by);
+        } else {
+            nodes->aggregate = explain_add(explain, depth++, "Agregación (un solo grupo)");
+        }
+        describe_columns(explain, nodes->aggregate, "Columnas", data->columns);
+    }
+
+    // Sin JOIN el recorrido es el de la tabla; con JOIN se recorre su resultado
+    int parallel = strategy == SELECT_TOP_N ? top_n_is_parallel(num_rows, window)
+                                            : strategy != SELECT_STREAM && scan_is_parallel(num_rows, -1);
+    if (!plan->join_table) {
+        if (strategy == SELECT_TOP_N) {
+            nodes->scan = explain_add(explain, depth, "Top-N %s de %s (k = %d)",
+                                      parallel ? "paralelo" : "secuencial", plan->table->name, window);
+            describe_columns(explain, nodes->scan, "Orden", data->order_by);
+            if (parallel) explain_detail(explain, nodes->scan, "Un montículo por hilo, mezclados al final");
+            if (plan->condition) describe_expr(explain, nodes->scan, "Filtro", plan->condition);
+            explain_detail(explain, nodes->scan, "Índice: ninguno");
+            describe_estimate(explain, nodes->scan, plan);
+        } else {
+            nodes->scan = describe_scan(explain, depth, plan, parallel);
+        }
+    } else {
+        const char* mode = num_rows < 0 ? "" : (parallel ? " paralelo" : " secuencial");
+        if (strategy == SELECT_TOP_N) {
+            nodes->scan = explain_add(explain, depth, "Top-N%s del resultado del JOIN (k = %d)", mode, window);
+            describe_columns(explain, nodes->scan, "Orden", data->order_by);
+        } else {
+            nodes->scan = explain_add(explain, depth, "Recorrido%s del resultado del JOIN", mode);
+        }
+        if (num_rows < 0 && strategy != SELECT_STREAM) {
+            explain_detail(explain, nodes->scan, "En paralelo si el JOIN da %d filas o más", PARALLEL_MIN_ROWS);
+        }
+    }
+
+    if (strategy == SELECT_STREAM) {
+        explain_detail(explain, nodes->scan, "Salida: cada fila se escribe al encontrarla");
+        describe_limit(explain, nodes->scan, plan, limit, offset);
+    }
+
+    if (plan->join_table) {
+        int max_rows = plan->is_aggregate || plan->num_order_keys > 0 ? -1 : window;
+        nodes->join = describe_join(explain, depth + 1, plan, method, max_rows, nodes);
+    }
+}
+
+// Describe los operadores de un INSERT, UPDATE o DELETE
+static void describe_write(ExplainPlan* explain, const Plan* plan, WriteNodes* nodes) {
+    nodes->write = -1;
+    nodes->scan = -1;
+
+    switch (plan->type) {
+        case NODE_INSERT_STMT:
+            nodes->write = explain_add(explain, 0, "Inserción en %s", plan->table->name);
+            explain_detail(explain, nodes->write, "Filas: %d", plan->num_insert_rows);
+            return;
+
+        case NODE_UPDATE_STMT: {
+            nodes->write = explain_add(explain, 0, "Actualización de %s", plan->table->name);
+
+            UpdateStmtData* data = (UpdateStmtData*)plan->stmt->data;
+            for (ASTNode* current = data->assignments; current; current = current->next) {
+                AssignmentData* assignment = (AssignmentData*)current->data;
+                char label[EXPLAIN_TEXT_SIZE];
+                snprintf(label, sizeof(label), "Asigna %s", assignment->column_name);
+                describe_expr(explain, nodes->write, label, assignment->value);
+            }
+            break;
+        }
+
+        case NODE_DELETE_STMT:
+            nodes->write = explain_add(explain, 0, "Borrado en %s", plan->table->name);
+            break;
+
+        default:
+            return;
+    }
+
+    // UPDATE y DELETE buscan primero todas las filas a cambiar
+    nodes->scan = describe_scan(explain, 1, plan, scan_is_parallel(plan->table->num_rows, -1));
+}
+
+// Con explain describe la consulta en él y, si es EXPLAIN ANALYZE, anota lo que hace
+// cada operador al ejecutarla (sin EXPLAIN ANALYZE no la ejecuta)
+static int run_select(Plan* plan, const LiteralData* params, ExplainPlan* explain,
+                      ValidationResult* result) {
+    int limit = -1;
+    int offset = 0;
+
+    if (eval_row_count(plan->limit, params, &limit, result) != 0 ||
+        eval_row_count(plan->offset, params, &offset, result) != 0) {
+        return -1;
+    }
+
+    // Filas necesarias para cubrir OFFSET + LIMIT (-1 si no hay límite)
+    int window = limit < 0 ? -1 : (limit > INT_MAX - offset ? INT_MAX : offset + limit);
+    int execute = !explain || explain->analyze;
+
+    // JOIN: el resto de la consulta se ejecuta sobre el resultado ya filtrado
+    const Plan* described = plan;
+    Plan joined_plan;
+    Table* joined = NULL;
+    JoinStats join_stats = { JOIN_HASH, 0, 0, { 0, 0 }, { 0, 0 } };
+    long long join_time = 0;
+    if (plan->join_table && execute) {
+        long long start = explain_start(explain);
+        int max_rows = plan->is_aggregate || plan->num_order_keys > 0 ? -1 : window;
+        joined = plan_build_join(plan, params, max_rows, &join_stats, result);
+        if (!joined) return -1;
+        join_time = explain_elapsed(explain, start);
+
+        joined_plan = *plan;
+        joined_plan.table = joined;
+        joined_plan.condition = NULL;
+        plan = &joined_plan;
+    }
+
+    // Sin ejecutar el JOIN no se sabe cuántas filas tendrá su resultado
+    int num_rows = described->join_table && !joined ? -1 : plan->table->num_rows;
+    SelectStrategy strategy = select_strategy(plan, num_rows, window);
+
+    SelectNodes nodes = { -1, -1, -1, -1, -1, -1, -1 };
+    if (explain) {
+        JoinMethod method = joined ? join_stats.method : JOIN_HASH;
+        if (described->join_table && !joined) method = plan_join_method(described);
+
+        describe_select(explain, described, strategy, limit, offset, window, num_rows, method, &nodes);
+        explain_record(explain, nodes.join, joined ? joined->num_rows : 0, join_stats.pairs,
+                       join_stats.batches, join_time);
+
+        // Las tablas se leen a la vez que se unen: su tiempo es el del JOIN
+        explain_record(explain, nodes.join_left, join_stats.left.used, join_stats.left.read, -1, -1);
+        explain_record(explain, nodes.join_right, join_stats.right.used, join_stats.right.read, -1, -1);
+    }
+    if (!execute) return 0;
+
+    if (strategy == SELECT_STREAM) {
+        int status = plan_stream_rows(plan, params, offset, limit, explain, nodes.scan, result);
+        table_free(joined);
+        return status;
+    }
+
+    Table* table = plan->table;
+    Table* output = NULL;
+    int* rows = NULL;
+    int count;
+    long long start = explain_start(explain);
+
+    if (strategy == SELECT_TOP_N) {
+        count = plan_collect_top_n(plan, params, window, &rows, result);
+        explain_record(explain, nodes.scan, count, table->num_rows,
+                       scan_batches(table->num_rows, top_n_is_parallel(table->num_rows, window)),
+                       explain_elapsed(explain, start));
+    } else {
+        count = plan_collect_rows(plan, params, -1, &rows, result);
+        explain_record(explain, nodes.scan, count, table->num_rows,
+                       scan_batches(table->num_rows, scan_is_parallel(table->num_rows, -1)),
+                       explain_elapsed(explain, start));
+    }
+
+    if (count >= 0 && strategy == SELECT_AGGREGATE) {
+        // Se agrupan todas las filas; el orden y el límite se aplican al resultado
+        start = explain_start(explain);
+        output = aggregate_build(plan, rows, count, result);
+        free(rows);
+        rows = NULL;
+        explain_record(explain, nodes.aggregate, output ? output->num_rows : 0, count, -1,
+                       explain_elapsed(explain, start));
+
+        count = -1;
+        if (output) {
+            count = output->num_rows;
+            rows = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+            if (!rows) {
+                validator_set_error(result, 404, "Error de memoria al ordenar filas");
+                count = -1;
+            }
+        }
+        if (count >= 0) {
+            for (int i = 0; i < count; i++) rows[i] = i;
+
+            start = explain_start(explain);
+            int groups = count;
+            count = order_rows(plan, output, rows, count, window, result);
+            explain_record(explain, nodes.sort, count, groups, -1, explain_elapsed(explain, start));
+        }
+    } else if (count >= 0 && strategy == SELECT_SORT) {
+        start = explain_start(explain);
+        int collected = count;
+        count = order_rows(plan, table, rows, count, -1, result);
+        explain_record(explain, nodes.sort, count, collected, -1, explain_elapsed(explain, start));
+    }
+
+    if (count >= 0) {
+        int first = offset < count ? offset : count;
+
+        start = explain_start(explain);
+        if (output) {
+            table_print_rows(output, rows + first, count - first, NULL, output->num_columns);
+        } else {
+            table_print_rows(table, rows + first, count - first, plan->out_columns, plan->num_out_columns);
+        }
+        explain_record(explain, nodes.output, count - first, count, -1, explain_elapsed(explain, start));
+    }
+
+    free(rows);
+    table_free(output);
+    table_free(joined);
+    return count < 0 ? -1 : 0;
+}
+
+// Recoge las filas que cambiarán un UPDATE o un DELETE y anota el recorrido en el
+// operador node de explain
+static int plan_find_rows(const Plan* plan, const LiteralData* params, int** rows_out,
+                          ExplainPlan* explain, int node, ValidationResult* result) {
+    long long start = explain_start(explain);
+    int count = plan_collect_rows(plan, params, -1, rows_out, result);
+
+    int num_rows = plan->table->num_rows;
+    explain_record(explain, node, count, num_rows, scan_batches(num_rows, scan_is_parallel(num_rows, -1)),
+                   explain_elapsed(explain, start));
+    return count;
+}
+
+// Cada fila modificada se sustituye por una versión nueva al final de la tabla, de
+// modo que las lecturas en curso siguen viendo la anterior
+static int run_update(Plan* plan, const LiteralData* params, WriteSet* ws, ExplainPlan* explain,
+                      int scan_node, ValidationResult* result) {
+    Table* table = plan->table;
+    int* rows = NULL;
+    int count = plan_find_rows(plan, params, &rows, explain, scan_node, result);
+    if (count < 0) return -1;
+
+    int width = table->num_columns;
+    Value* values = (Value*)malloc((count > 0 ? (size_t)count * width : 1) * sizeof(Value));
+    if (!values) {
+        validator_set_error(result, 404, "Error de memoria al actualizar filas");
+        free(rows);
+        return -1;
+    }
+
+    // Calcular todas las filas nuevas antes de modificar la tabla: si una asignación
+    // falla, la sentencia no cambia nada
+    int built = 0;
+    int status = 0;
+    int rowid = 0;     // Filas visibles antes de la actual (rows va en orden)
+    int scanned = 0;
+    for (; built < count; built++) {
+        const Row* row = &table->rows[rows[built]];
+        for (; scanned < rows[built]; scanned++) rowid += plan_row_visible(plan, &table->rows[scanned]);
+        Value* new_values = values + (size_t)built * width;
+
+        // Las columnas sin asignar comparten las cadenas de la fila anterior, que
+        // table_append_versions copia
+        memcpy(new_values, row->values, width * sizeof(Value));
+
+        Value assigned[plan->num_assignments];
+        int a = 0;
+        for (; a < plan->num_assignments; a++) {
+            ExprValue value;
+            LiteralData literal;
+            int col = plan->assign_columns[a];
+
+            if (eval_expr(plan->assign_values[a], table, row, rowid, params, &value, result) != 0 ||
+                (literal_from_expr(&value, &literal),
+                 literal_to_column_value(&literal, &table->columns[col], &assigned[a], result)) != 0) {
+                break;
+            }
+        }
+        if (a < plan->num_assignments) {
+            free_column_values(table, plan->assign_columns, assigned, a);
+            status = -1;
+            break;
+        }
+
+        for (a = 0; a < plan->num_assignments; a++) {
+            new_values[plan->assign_columns[a]] = assigned[a];
+        }
+    }
+
+    if (status == 0) {
+        if (table_append_versions(table, values, count, ws->txn) == 0) {
+            table_set_xmax(table, rows, count, ws->txn);
+            ws->num_new = count;
+            ws->old_rows = rows;
+            ws->num_old = count;
+            rows = NULL;
+        } else {
+            validator_set_error(result, 404, "Error de memoria al actualizar filas");
+            status = -1;
+        }
+    }
+
+    // Liberar las cadenas asignadas (la tabla guarda sus propias copias)
+    for (int i = 0; i < built; i++) {
+        Value* new_values = values + (size_t)i * width;
+        for (int a = 0; a < plan->num_assignments; a++) {
+            int col = plan->assign_columns[a];
+            if (table->columns[col].type == TYPE_STRING) {
+                free(new_values[col].string_val);
+                new_values[col].string_val = NULL;
+            }
+        }
+    }
+
+    free(values);
+    free(rows);
+    if (status != 0) return -1;
+
+    output_printf("%d fila%s actualizada%s en %s\n", count,
+                  count == 1 ? "" : "s", count == 1 ? "" : "s", table->name);
+    return 0;
+}
+
+// Las filas eliminadas se conservan hasta que ninguna lectura pueda verlas
+static int run_delete(Plan* plan, const LiteralData* params, WriteSet* ws, ExplainPlan* explain,
+                      int scan_node, ValidationResult* result) {
+    int* rows = NULL;
+    int count = plan_find_rows(plan, params, &rows, explain, scan_node, result);
+    if (count < 0) return -1;
+
+    table_set_xmax(plan->table, rows, count, ws->txn);
+    ws->old_rows = rows;
+    ws->num_old = count;
+
+    output_printf("%d fila%s eliminada%s de %s\n", count,
+                  count == 1 ? "" : "s", count == 1 ? "" : "s", plan->table->name);
+    return 0;
+}
+
+// Comprueba el número y el tipo de los parámetros enlazados (0 si son válidos)
+static int check_params(const Plan* plan, const LiteralData* params, int num_params,
+                        ValidationResult* result) {
+    if (num_params != plan->num_params) {
+        char error[200];
+        snprintf(error, sizeof(error), "Se esperaban %d parámetros, pero se proporcionaron %d",
+                 plan->num_params, num_params);
+        validator_set_error(result, 411, error);
+        return -1;
+    }
+
+    // Comprobar el tipo de cada parámetro contra el inferido por el validador
+    for (int i = 0; i < num_params; i++) {
+        int literal_type = ast_type_to_column_type(params[i].lit_type);
+        if (plan->param_types[i] >= 0 && params[i].lit_type != LIT_NULL &&
+            !validator_check_type_compatibility(plan->param_types[i], literal_type)) {
+            char error[200];
+            snprintf(error, sizeof(error), "Tipo no compatible para el parámetro %d. Valor de tipo %d no es compatible con tipo %d",
+                     i + 1, literal_type, plan->param_types[i]);
+            validator_set_error(result, 412, error);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Instantánea de las tablas de una consulta
+typedef struct {
+    RowVersion version;            // Última versión confirmada al abrirla
+    Table table;                   // Vista de la tabla del plan
+    Table join_table;              // Vista de la tabla derecha del JOIN
+} Snapshot;
+
+// Abre una instantánea de las tablas del plan y prepara en view_plan una copia del
+// plan que lee de ella. Mientras esté abierta las escrituras no la modifican.
+static int snapshot_open(Snapshot* snapshot, const Plan* plan, Plan* view_plan,
+                         ValidationResult* result) {
+    if (mvcc_begin_read(&snapshot->version) != 0) {
+        validator_set_error(result, 404, "Error de memoria al abrir la lectura");
+        return -1;
+    }
+
+    // Dentro de una transacción se ven también sus cambios pendientes
+    RowVersion write = transaction_current_write();
+
+    *view_plan = *plan;
+    table_open_snapshot(plan->table, &snapshot->table, snapshot->version, write);
+    view_plan->table = &snapshot->table;
+
+    if (plan->join_table) {
+        table_open_snapshot(plan->join_table, &snapshot->join_table, snapshot->version, write);
+        view_plan->join_table = &snapshot->join_table;
+    }
+
+    return 0;
+}
+
+static void snapshot_close(Snapshot* snapshot, const Plan* plan) {
+    if (plan->join_table) table_close_snapshot(plan->join_table);
+    table_close_snapshot(plan->table);
+    mvcc_end_read(snapshot->version);
+}
+
+// Ejecuta un plan con los parámetros indicados. Con explain describe sus operadores y,
+// si es EXPLAIN ANALYZE, anota lo que hace cada uno (sin EXPLAIN ANALYZE no lo ejecuta).
+static int run_plan(Plan* plan, const LiteralData* params, int num_params, ExplainPlan* explain,
+                    ValidationResult* result) {
+    if (!plan || !result) return -1;
+    if (check_params(plan, params, num_params, result) != 0) return -1;
+
+    switch (plan->type) {
+        case NODE_BEGIN_STMT: return transaction_begin(result);
+        case NODE_COMMIT_STMT: return transaction_commit(result);
+        case NODE_ROLLBACK_STMT: return transaction_rollback(result);
+        default: break;
+    }
+
+    // Las consultas leen una instantánea sin bloquear la tabla, igual que EXPLAIN
+    // sin ANALYZE para describir una escritura
+    if (plan->type == NODE_SELECT_STMT || (explain && !explain->analyze)) {
+        Snapshot snapshot;
+        Plan view_plan;
+        if (snapshot_open(&snapshot, plan, &view_plan, result) != 0) return -1;
+
+        int status = 0;
+        if (plan->type == NODE_SELECT_STMT) {
+            status = run_select(&view_plan, params, explain, result);
+        } else {
+            WriteNodes nodes;
+            describe_write(explain, &view_plan, &nodes);
+        }
+        snapshot_close(&snapshot, plan);
+        return status;
+    }
+
+    // Las escrituras sobre una misma tabla se hacen de una en una
+    int status;
+    WriteSet ws;
+    if (transaction_write_begin(plan->table, &ws, result) != 0) return -1;
+
+    WriteNodes nodes = { -1, -1 };
+    if (explain) describe_write(explain, plan, &nodes);
+    long long start = explain_start(explain);
+
+    switch (plan->type) {
+        case NODE_INSERT_STMT: status = run_insert(plan, params, &ws, result); break;
+        case NODE_UPDATE_STMT: status = run_update(plan, params, &ws, explain, nodes.scan, result); break;
+        case NODE_DELETE_STMT: status = run_delete(plan, params, &ws, explain, nodes.scan, result); break;
+        default:
+            validator_set_error(result, 408, "Solo se pueden ejecutar sentencias SELECT, INSERT, UPDATE o DELETE");
+            status = -1;
+            break;
+    }
+
+    // El tiempo de la escritura no incluye el del recorrido que buscó las filas
+    long long written = plan->type == NODE_INSERT_STMT ? ws.num_new : ws.num_old;
+    status = transaction_write_end(&ws, status, result);
+    if (status == 0 && nodes.write >= 0) {
+        long long scan_time = nodes.scan >= 0 ? explain->nodes[nodes.scan].time_ns : 0;
+        explain_record(explain, nodes.write, written, -1, -1, explain_elapsed(explain, start) - scan_time);
+    }
+    return status;
+}
+
+// La escritura del resultado se cuenta aparte (fase de salida)
+int executor_run(Plan* plan, const LiteralData* params, int num_params, ValidationResult* result) {
+    int mark = timing_enter(TIMING_EXECUTE);
+    int status = run_plan(plan, params, num_params, NULL, result);
+    timing_leave(mark);
+    return status;
+}
+
+int executor_explain(Plan* plan, const LiteralData* params, int num_params, int analyze,
+                     ValidationResult* result) {
+    if (!plan || !result) return -1;
+
+    if (plan->type != NODE_SELECT_STMT && plan->type != NODE_INSERT_STMT &&
+        plan->type != NODE_UPDATE_STMT && plan->type != NODE_DELETE_STMT) {
+        validator_set_error(result, 408, "Solo se puede usar EXPLAIN con sentencias SELECT, INSERT, UPDATE o DELETE");
+        return -1;
+    }
+
+    ExplainPlan explain;
+    explain_init(&explain, analyze);
+
+    // EXPLAIN ANALYZE ejecuta la sentencia, pero no escribe su resultado
+    FILE* discard = NULL;
+    FILE* previous = NULL;
+    if (analyze) {
+        discard = fopen("/dev/null", "w");
+        if (!discard) {
+            validator_set_error(result, 404, "No se pudo descartar el resultado de la sentencia");
+            return -1;
+        }
+        previous = output_redirect(discard);
+    }
+
+    int mark = timing_enter(TIMING_EXECUTE);
+    long long start = explain_start(&explain);
+    int status = run_plan(plan, params, num_params, &explain, result);
+    explain.total_ns = explain_elapsed(&explain, start);
+    timing_leave(mark);
+
+    if (analyze) {
+        output_redirect(previous);
+        fclose(discard);
+    }
+
+    if (status == 0) explain_print(&explain);
+    return status;
+}
+
+// Ejecuta varios INSERT sobre la misma tabla como una sola escritura
+static int insert_batch(Plan** plans, LiteralData** params, const int* num_params, int count,
+                        ValidationResult* result) {
+    if (!plans || !params || !num_params || count <= 0 || !result) return -1;
+
+    Table* table = plans[0]->table;
+    int total_rows = 0;
+    for (int i = 0; i < count; i++) {
+        if (plans[i]->type != NODE_INSERT_STMT || plans[i]->table != table) {
+            validator_set_error(result, 408, "Solo se pueden agrupar sentencias INSERT sobre la misma tabla");
+            return -1;
+        }
+        if (check_params(plans[i], params[i], num_params[i], result) != 0) return -1;
+        total_rows += plans[i]->num_insert_rows;
+    }
+
+    int row_size = table->num_columns;
+    Value* values = (Value*)malloc((total_rows * row_size > 0 ? total_rows * row_size : 1) * sizeof(Value));
+    if (!values) {
+        validator_set_error(result, 404, "Error de memoria al insertar filas");
+        return -1;
+    }
+
+    WriteSet ws;
+    if (transaction_write_begin(table, &ws, result) != 0) {
+        free(values);
+        return -1;
+    }
+
+    // Las filas de todas las sentencias, una tras otra
+    int status = 0;
+    int bound = 0;
+    Value* next = values;
+    for (; bound < count; bound++) {
+        if (insert_bind_values(plans[bound], params[bound], next, result) != 0) {
+            insert_free_values(plans[bound], next);
+            status = -1;
+            break;
+        }
+        next += plans[bound]->num_insert_rows * row_size;
+    }
+
+    // Un único añadido y una única confirmación para todo el grupo
+    if (status == 0) {
+        if (table_append_versions(table, values, total_rows, ws.txn) == 0) {
+            ws.num_new = total_rows;
+        } else {
+            validator_set_error(result, 409, "No se pudo insertar la fila");
+            status = -1;
+        }
+    }
+
+    next = values;
+    for (int i = 0; i < bound; i++) {
+        insert_free_values(plans[i], next);
+        next += plans[i]->num_insert_rows * row_size;
+    }
+    free(values);
+
+    return transaction_write_end(&ws, status, result);
+}
+
+int executor_insert_batch(Plan** plans, LiteralData** params, const int* num_params, int count,
+                          ValidationResult* result) {
+    int mark = timing_enter(TIMING_EXECUTE);
+    int status = insert_batch(plans, params, num_params, count, result);
+    timing_leave(mark);
+    return status;
+}
+
+// Cuenta las filas que cumplen la condición de un plan SELECT
+static int count_rows(Plan* plan, const LiteralData* params, int num_params, ValidationResult* result) {
+    if (!plan || !result) return -1;
+
+    if (plan->type != NODE_SELECT_STMT) {
+        validator_set_error(result, 408, "Solo se pueden contar las filas de una sentencia SELECT");
+        return -1;
+    }
+    if (check_params(plan, params, num_params, result) != 0) return -1;
+
+    Snapshot snapshot;
+    Plan view_plan;
+    if (snapshot_open(&snapshot, plan, &view_plan, result) != 0) return -1;
+
+    int count;
+    if (view_plan.join_table) {
+        Table* joined = plan_build_join(&view_plan, params, -1, NULL, result);
+        count = joined ? joined->num_rows : -1;
+        table_free(joined);
+    } else {
+        int* rows = NULL;
+        count = plan_collect_rows(&view_plan, params, -1, &rows, result);
+        free(rows);
+    }
+    snapshot_close(&snapshot, plan);
+
+    return count;
+}
+
+int executor_count_rows(Plan* plan, const LiteralData* params, int num_params, ValidationResult* result) {
+    int mark = timing_enter(TIMING_EXECUTE);
+    int count = count_rows(plan, params, num_params, result);
+    timing_leave(mark);
+    return count;
+}
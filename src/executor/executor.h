@@ -0,0 +1,98 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include "../parser/ast.h"
+#include "../parser/validator.h"
+#include "../db/database.h"
+#include "sort.h"
+
+// Valor resultante de evaluar una expresión sobre una fila
+typedef struct {
+    int is_null;
+    DataType type;
+    Value value;          // Para STRING apunta a memoria que no pertenece al valor
+} ExprValue;
+
+// Plan compilado a partir de una sentencia validada
+typedef struct {
+    ASTNodeType type;              // Tipo de sentencia
+    ASTNode* stmt;                 // AST validado (no pertenece al plan)
+    Table* table;                  // Tabla destino
+    unsigned int schema_version;   // Versión del esquema al compilar
+    int num_params;                // Número de parámetros '?'
+    int* param_types;              // DataType esperado de cada parámetro (-1 si cualquiera)
+
+    // INSERT (arrays de num_insert_rows * columnas, una fila tras otra)
+    int num_insert_rows;
+    int num_insert_values;         // Valores ya convertidos (para liberarlos)
+    Value* insert_values;          // Literales ya convertidos al tipo de cada columna
+    DataType* insert_types;        // Tipo de cada valor (la tabla puede cambiar o liberarse)
+    int* insert_params;            // Índice de parámetro por valor (-1 si es literal)
+
+    // SELECT
+    int* out_columns;              // Columnas a mostrar (-1 para COUNT(*))
+    int num_out_columns;
+
+    // SELECT con funciones de agregación o GROUP BY
+    int is_aggregate;
+    int* out_aggregates;           // AggregateType de cada columna de salida
+    int num_group_columns;
+    int* group_columns;            // Columnas de agrupación
+
+    // SELECT con JOIN (las columnas de join_table siguen a las de table)
+    Table* join_table;             // Tabla derecha del JOIN (NULL si no hay)
+    int join_left_key;             // Columna de la clave en la tabla izquierda
+    int join_right_key;            // Columna de la clave en la tabla derecha
+
+    // SELECT con ORDER BY / LIMIT
+    int num_order_keys;
+    SortKey* order_keys;           // Columnas de la tabla (o del resultado si hay agregación)
+    ASTNode* limit;                // Expresión de LIMIT (NULL si no hay)
+    ASTNode* offset;               // Expresión de OFFSET (NULL si no hay)
+
+    // SELECT / UPDATE / DELETE
+    ASTNode* condition;            // Condición del WHERE (NULL si no hay)
+
+    // UPDATE
+    int num_assignments;
+    int* assign_columns;           // Columna destino de cada asignación
+    ASTNode** assign_values;       // Expresión de cada asignación
+} Plan;
+
+// Valida una sentencia y construye su plan (NULL si hay error)
+Plan* executor_compile(ASTNode* stmt, int num_params, Database* db, ValidationResult* result);
+
+// Indica si el esquema cambió desde que se compiló el plan
+int executor_plan_is_stale(const Plan* plan, const Database* db);
+
+// Ejecuta un plan con los parámetros indicados (0 si tuvo éxito, -1 si hubo error).
+// Un SELECT lee una instantánea de sus tablas sin bloquearlas; INSERT, UPDATE y DELETE
+// bloquean la tabla destino y confirman todos sus cambios a la vez (o ninguno).
+// El llamador debe tener el catálogo en lectura (db_lock_read) desde que comprueba
+// que el plan no está obsoleto.
+int executor_run(Plan* plan, const LiteralData* params, int num_params, ValidationResult* result);
+
+// Escribe el árbol de operadores con el que se ejecutaría un plan SELECT, INSERT, UPDATE
+// o DELETE: recorridos, filtros, índices, método del JOIN, agregación y ordenación.
+// Con analyze lo ejecuta (sin escribir su resultado; las escrituras sí se aplican) y
+// añade las filas, los lotes y el tiempo de cada operador. Mismas condiciones que
+// executor_run.
+int executor_explain(Plan* plan, const LiteralData* params, int num_params, int analyze,
+                     ValidationResult* result);
+
+// Ejecuta varios planes INSERT sobre la misma tabla como una sola escritura: las filas de
+// todos se añaden juntas (o ninguna) y se confirman con una única versión. No escribe el
+// resultado de cada sentencia (ver executor_report_insert). Mismas condiciones que executor_run.
+int executor_insert_batch(Plan** plans, LiteralData** params, const int* num_params, int count,
+                          ValidationResult* result);
+
+// Escribe el resultado de un INSERT que se ejecutó en grupo
+void executor_report_insert(const Plan* plan);
+
+// Cuenta las filas que cumplen la condición de un plan SELECT (-1 si hay error)
+int executor_count_rows(Plan* plan, const LiteralData* params, int num_params, ValidationResult* result);
+
+// Libera un plan
+void executor_free_plan(Plan* plan);
+
+#endif /* EXECUTOR_H */
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include "explain.h"
+#include "../utils/output.h"
+
+// Espacios por nivel del árbol
+#define EXPLAIN_INDENT 3
+
+static long long explain_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void explain_init(ExplainPlan* explain, int analyze) {
+    memset(explain, 0, sizeof(ExplainPlan));
+    explain->analyze = analyze;
+}
+
+int explain_add(ExplainPlan* explain, int depth, const char* format, ...) {
+    if (!explain || explain->count >= EXPLAIN_MAX_NODES) return -1;
+
+    ExplainNode* node = &explain->nodes[explain->count];
+    memset(node, 0, sizeof(ExplainNode));
+    node->depth = depth;
+    node->rows_read = -1;
+    node->batches = -1;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(node->name, sizeof(node->name), format, args);
+    va_end(args);
+
+    return explain->count++;
+}
+
+void explain_detail(ExplainPlan* explain, int node, const char* format, ...) {
+    if (!explain || node < 0 || node >= explain->count) return;
+
+    ExplainNode* target = &explain->nodes[node];
+    if (target->num_details >= EXPLAIN_MAX_DETAILS) return;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(target->details[target->num_details++], EXPLAIN_TEXT_SIZE, format, args);
+    va_end(args);
+}
+
+long long explain_start(const ExplainPlan* explain) {
+    return explain && explain->analyze ? explain_now() : 0;
+}
+
+long long explain_elapsed(const ExplainPlan* explain, long long start) {
+    return explain && explain->analyze ? explain_now() - start : 0;
+}
+
+void explain_record(ExplainPlan* explain, int node, long long rows, long long rows_read,
+                    long long batches, long long time_ns) {
+    if (!explain || !explain->analyze || node < 0 || node >= explain->count) return;
+
+    ExplainNode* target = &explain->nodes[node];
+    target->executed = 1;
+    target->rows = rows;
+    target->rows_read = rows_read;
+    target->batches = batches;
+    target->time_ns = time_ns;
+}
+
+// Medidas de un operador: "  (filas: 10, leídas: 100, lotes: 1, tiempo: 0.010 ms)"
+static void explain_print_measures(const ExplainNode* node) {
+    if (!node->executed) {
+        output_printf("  (no se ejecutó)");
+        return;
+    }
+
+    output_printf("  (filas: %lld", node->rows);
+    if (node->rows_read >= 0) output_printf(", leídas: %lld", node->rows_read);
+    if (node->batches >= 0) output_printf(", lotes: %lld", node->batches);
+    if (node->time_ns >= 0) output_printf(", tiempo: %.3f ms", node->time_ns / 1e6);
+    output_printf(")");
+}
+
+void explain_print(const ExplainPlan* explain) {
+    if (!explain) return;
+
+    for (int i = 0; i < explain->count; i++) {
+        const ExplainNode* node = &explain->nodes[i];
+        int indent = node->depth * EXPLAIN_INDENT;
+
+        output_printf("%*s-> %s", indent, "", node->name);
+        if (explain->analyze) explain_print_measures(node);
+        output_printf("\n");
+
+        for (int d = 0; d < node->num_details; d++) {
+            output_printf("%*s%s\n", indent + EXPLAIN_INDENT + 2, "", node->details[d]);
+        }
+    }
+
+    if (explain->analyze) {
+        output_printf("Tiempo de ejecución: %.3f ms\n", explain->total_ns / 1e6);
+    }
+}
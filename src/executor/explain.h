@@ -0,0 +1,56 @@
+#ifndef EXPLAIN_H
+#define EXPLAIN_H
+
+// Máximo de operadores de un plan, de detalles por operador y de texto por línea
+#define EXPLAIN_MAX_NODES 8
+#define EXPLAIN_MAX_DETAILS 6
+#define EXPLAIN_TEXT_SIZE 256
+
+// Operador del plan físico y, con EXPLAIN ANALYZE, lo que hizo al ejecutarse. Los
+// operadores se ejecutan uno tras otro, así que el tiempo de cada uno es solo el suyo.
+typedef struct {
+    int depth;                                        // Nivel en el árbol (0 para la raíz)
+    char name[EXPLAIN_TEXT_SIZE];                     // Operador y lo que recorre
+    char details[EXPLAIN_MAX_DETAILS][EXPLAIN_TEXT_SIZE]; // Filtro, claves, índice...
+    int num_details;
+    int executed;                                     // Tiene medidas
+    long long rows;                                   // Filas que produjo
+    long long rows_read;                              // Filas que leyó (-1 si no aplica)
+    long long batches;                                // Morsels o lotes (-1 si no aplica)
+    long long time_ns;                                // Tiempo real del operador (-1 si va
+                                                      // incluido en el de su padre)
+} ExplainNode;
+
+// Árbol de operadores en preorden: cada operador va seguido de sus entradas
+typedef struct {
+    int analyze;                   // Se ejecuta y se miden los operadores
+    ExplainNode nodes[EXPLAIN_MAX_NODES];
+    int count;
+    long long total_ns;            // Tiempo de toda la sentencia (EXPLAIN ANALYZE)
+} ExplainPlan;
+
+// Prepara un plan vacío
+void explain_init(ExplainPlan* explain, int analyze);
+
+// Añade un operador en el nivel depth y devuelve su posición (-1 si explain es NULL
+// o no caben más)
+int explain_add(ExplainPlan* explain, int depth, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+// Añade una línea de detalle a un operador
+void explain_detail(ExplainPlan* explain, int node, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+// Instante en que empieza un operador (0 si no se está midiendo)
+long long explain_start(const ExplainPlan* explain);
+
+// Nanosegundos desde start (0 si no se está midiendo)
+long long explain_elapsed(const ExplainPlan* explain, long long start);
+
+// Anota lo que hizo un operador (no hace nada si no se está midiendo o node es -1).
+// rows_read, batches y time_ns pueden ser -1 si no aplican.
+void explain_record(ExplainPlan* explain, int node, long long rows, long long rows_read,
+                    long long batches, long long time_ns);
+
+// Escribe el plan en la salida del hilo actual
+void explain_print(const ExplainPlan* explain);
+
+#endif /* EXPLAIN_H */
@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "join.h"
+
+/**
+ * Claves del JOIN
+ */
+
+// Indica si la fila tiene una clave con la que se puede unir
+static int join_key_usable(const Table* table, int row, int key) {
+    const Row* data = &table->rows[row];
+    if (!table_row_visible(table, data) || data->is_deleted) return 0;
+
+    return table->columns[key].type != TYPE_STRING || data->values[key].string_val != NULL;
+}
+
+// Valor numérico de la clave (INT, FLOAT y BOOL se comparan entre sí)
+static double join_key_number(const Table* table, int row, int key) {
+    Value value = table->rows[row].values[key];
+
+    switch (table->columns[key].type) {
+        case TYPE_FLOAT: return value.float_val;
+        case TYPE_BOOL: return value.bool_val != 0;
+        default: return value.int_val;
+    }
+}
+
+// Hash FNV-1a de la clave
+static unsigned int join_key_hash(const Table* table, int row, int key) {
+    unsigned int hash = 2166136261u;
+
+    if (table->columns[key].type == TYPE_STRING) {
+        for (const unsigned char* p = (const unsigned char*)table->rows[row].values[key].string_val; *p; p++) {
+            hash ^= *p;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Las claves numéricas se convierten a double para que 1 y 1.0 coincidan
+    double number = join_key_number(table, row, key);
+    if (number == 0) number = 0;
+
+    unsigned char bytes[sizeof(double)];
+    memcpy(bytes, &number, sizeof(double));
+    for (size_t i = 0; i < sizeof(double); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Compara las claves de dos filas (ambas utilizables y del mismo tipo de clave)
+static int join_compare_keys(const Table* a, int row_a, int key_a, const Table* b, int row_b, int key_b) {
+    if (a->columns[key_a].type == TYPE_STRING) {
+        return strcmp(a->rows[row_a].values[key_a].string_val, b->rows[row_b].values[key_b].string_val);
+    }
+
+    double x = join_key_number(a, row_a, key_a);
+    double y = join_key_number(b, row_b, key_b);
+    return (x > y) - (x < y);
+}
+
+static int join_keys_equal(const HashJoin* join, int build_row, int probe_row) {
+    return join_compare_keys(join->build, build_row, join->build_key,
+                             join->probe, probe_row, join->probe_key) == 0;
+}
+
+int join_is_sorted(const Table* table, int key) {
+    // Mientras la tabla no cambie vale lo que comprobó un JOIN anterior
+    int sorted = table_cached_order(table, key);
+    if (sorted >= 0) return sorted;
+
+    sorted = 1;
+    int prev = -1;
+    for (int row = 0; row < table->num_rows && sorted; row++) {
+        if (!join_key_usable(table, row, key)) continue;
+
+        if (prev >= 0 && join_compare_keys(table, prev, key, table, row, key) > 0) sorted = 0;
+        prev = row;
+    }
+
+    table_cache_order(table, key, sorted);
+    return sorted;
+}
+
+/**
+ * Construcción y sondeo
+ */
+
+int hash_join_init(HashJoin* join, const Table* left, int left_key, const Table* right, int right_key) {
+    memset(join, 0, sizeof(HashJoin));
+
+    // La tabla hash se construye sobre la tabla más pequeña
+    join->build_is_left = left->num_rows <= right->num_rows;
+    join->build = join->build_is_left ? left : right;
+    join->build_key = join->build_is_left ? left_key : right_key;
+    join->probe = join->build_is_left ? right : left;
+    join->probe_key = join->build_is_left ? right_key : left_key;
+    join->chain = -1;
+
+    // Cubetas: potencia de dos con al menos el doble de filas
+    int num_buckets = 16;
+    while (num_buckets < join->build->num_rows * 2) num_buckets *= 2;
+    join->mask = num_buckets - 1;
+
+    int num_rows = join->build->num_rows;
+    join->heads = (int*)malloc(num_buckets * sizeof(int));
+    join->next = (int*)malloc((num_rows > 0 ? num_rows : 1) * sizeof(int));
+    join->hashes = (unsigned int*)malloc((num_rows > 0 ? num_rows : 1) * sizeof(unsigned int));
+    if (!join->heads || !join->next || !join->hashes) {
+        hash_join_free(join);
+        return -1;
+    }
+
+    for (int b = 0; b < num_buckets; b++) join->heads[b] = -1;
+
+    // Insertar de atrás hacia delante para que cada cubeta quede en el orden de la tabla
+    for (int row = num_rows - 1; row >= 0; row--) {
+        if (!join_key_usable(join->build, row, join->build_key)) continue;
+        join->build_used++;
+
+        unsigned int hash = join_key_hash(join->build, row, join->build_key);
+        int bucket = (int)(hash & (unsigned int)join->mask);
+        join->hashes[row] = hash;
+        join->next[row] = join->heads[bucket];
+        join->heads[bucket] = row;
+    }
+
+    return 0;
+}
+
+// Prepara el siguiente lote de filas de sondeo (0 si no quedan)
+static int hash_join_load_batch(HashJoin* join) {
+    join->batch_count = 0;
+    join->batch_pos = 0;
+
+    while (join->batch_count < JOIN_BATCH_SIZE && join->probe_next < join->probe->num_rows) {
+        int row = join->probe_next++;
+        if (!join_key_usable(join->probe, row, join->probe_key)) continue;
+        join->probe_used++;
+
+        join->batch_rows[join->batch_count] = row;
+        join->batch_hashes[join->batch_count] = join_key_hash(join->probe, row, join->probe_key);
+        join->batch_count++;
+    }
+
+    return join->batch_count;
+}
+
+int hash_join_next(HashJoin* join, int* left_rows, int* right_rows, int capacity) {
+    int count = 0;
+
+    while (count < capacity) {
+        // Recorrer la cubeta de la fila de sondeo actual
+        while (join->chain >= 0 && count < capacity) {
+            int build_row = join->chain;
+            int probe_row = join->batch_rows[join->batch_pos];
+            join->chain = join->next[build_row];
+
+            if (join->hashes[build_row] == join->batch_hashes[join->batch_pos] &&
+                join_keys_equal(join, build_row, probe_row)) {
+                left_rows[count] = join->build_is_left ? build_row : probe_row;
+                right_rows[count] = join->build_is_left ? probe_row : build_row;
+                count++;
+            }
+        }
+        if (join->chain >= 0) break;
+
+        // Pasar a la siguiente fila de sondeo (y al siguiente lote si hace falta)
+        if (++join->batch_pos >= join->batch_count && hash_join_load_batch(join) == 0) break;
+
+        join->chain = join->heads[join->batch_hashes[join->batch_pos] & (unsigned int)join->mask];
+    }
+
+    return count;
+}
+
+void hash_join_free(HashJoin* join) {
+    free(join->heads);
+    free(join->next);
+    free(join->hashes);
+    join->heads = NULL;
+    join->next = NULL;
+    join->hashes = NULL;
+}
+
+/**
+ * Merge join
+ */
+
+void merge_join_init(MergeJoin* join, const Table* left, int left_key, const Table* right, int right_key) {
+    memset(join, 0, sizeof(MergeJoin));
+
+    join->left = left;
+    join->right = right;
+    join->left_key = left_key;
+    join->right_key = right_key;
+    join->cursor = -1;
+}
+
+// Busca el tramo de filas derechas con la clave de la fila izquierda actual
+// (deja el tramo vacío si no hay ninguna; devuelve 0 si ya no quedan filas derechas)
+static int merge_join_seek(MergeJoin* join) {
+    const Table* right = join->right;
+    int row = join->group_end;
+
+    // Saltar las filas derechas con clave menor (ambas tablas van en orden ascendente)
+    while (row < right->num_rows) {
+        if (join_key_usable(right, row, join->right_key)) {
+            if (join_compare_keys(right, row, join->right_key, join->left, join->left_pos, join->left_key) >= 0) {
+                break;
+            }
+            join->right_used++;
+        }
+        row++;
+    }
+
+    // Sin filas derechas el tramo queda vacío al final de la tabla
+    join->group_start = row;
+    join->group_end = row;
+    if (row >= right->num_rows) return 0;
+    if (join_compare_keys(right, row, join->right_key, join->left, join->left_pos, join->left_key) > 0) {
+        return 1;
+    }
+
+    // El tramo llega hasta la primera fila utilizable con otra clave
+    int end = row + 1;
+    join->right_used++;
+    while (end < right->num_rows) {
+        if (join_key_usable(right, end, join->right_key)) {
+            if (join_compare_keys(right, end, join->right_key, right, row, join->right_key) != 0) break;
+            join->right_used++;
+        }
+        end++;
+    }
+    join->group_end = end;
+    return 1;
+}
+
+int merge_join_next(MergeJoin* join, int* left_rows, int* right_rows, int capacity) {
+    int count = 0;
+
+    while (count < capacity) {
+        // Emitir el tramo de la fila izquierda actual
+        if (join->cursor >= 0) {
+            while (join->cursor < join->group_end && count < capacity) {
+                int row = join->cursor++;
+                if (!join_key_usable(join->right, row, join->right_key)) continue;
+
+                left_rows[count] = join->left_pos;
+                right_rows[count] = row;
+                count++;
+            }
+            if (join->cursor < join->group_end) break;
+
+            join->cursor = -1;
+            join->left_pos++;
+        }
+
+        // Siguiente fila izquierda con clave
+        while (join->left_pos < join->left->num_rows &&
+               !join_key_usable(join->left, join->left_pos, join->left_key)) {
+            join->left_pos++;
+        }
+        if (join->left_pos >= join->left->num_rows) break;
+        join->left_used++;
+
+        // Una clave izquierda repetida vuelve a recorrer el mismo tramo
+        if (join->group_start < join->group_end &&
+            join_compare_keys(join->right, join->group_start, join->right_key,
+                              join->left, join->left_pos, join->left_key) == 0) {
+            join->cursor = join->group_start;
+            continue;
+        }
+
+        if (!merge_join_seek(join)) {
+            join->left_pos = join->left->num_rows;
+            break;
+        }
+
+        if (join->group_start < join->group_end) {
+            join->cursor = join->group_start;
+        } else {
+            join->left_pos++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Elección del operador
+ */
+
+int join_init(Join* join, const Table* left, int left_key, const Table* right, int right_key) {
+    memset(join, 0, sizeof(Join));
+
+    // Con las dos entradas ya ordenadas no hace falta construir una tabla hash
+    if (join_is_sorted(left, left_key) && join_is_sorted(right, right_key)) {
+        join->method = JOIN_MERGE;
+        merge_join_init(&join->merge, left, left_key, right, right_key);
+        return 0;
+    }
+
+    join->method = JOIN_HASH;
+    return hash_join_init(&join->hash, left, left_key, right, right_key);
+}
+
+int join_next(Join* join, int* left_rows, int* right_rows, int capacity) {
+    if (join->method == JOIN_MERGE) {
+        return merge_join_next(&join->merge, left_rows, right_rows, capacity);
+    }
+    return hash_join_next(&join->hash, left_rows, right_rows, capacity);
+}
+
+void join_free(Join* join) {
+    if (join->method == JOIN_HASH) hash_join_free(&join->hash);
+}
+
+void join_inputs(const Join* join, JoinInput* left, JoinInput* right) {
+    if (join->method == JOIN_MERGE) {
+        const MergeJoin* merge = &join->merge;
+        left->read = merge->left_pos < merge->left->num_rows ? merge->left_pos + 1 : merge->left->num_rows;
+        left->used = merge->left_used;
+        right->read = merge->group_end;
+        right->used = merge->right_used;
+        return;
+    }
+
+    // La tabla de construcción se lee entera al crear la tabla hash
+    const HashJoin* hash = &join->hash;
+    JoinInput build = { hash->build->num_rows, hash->build_used };
+    JoinInput probe = { hash->probe_next, hash->probe_used };
+    *left = hash->build_is_left ? build : probe;
+    *right = hash->build_is_left ? probe : build;
+}
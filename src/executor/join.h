@@ -0,0 +1,96 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include "../db/table.h"
+
+// Filas de la tabla de sondeo que se preparan de una vez
+#define JOIN_BATCH_SIZE 1024
+
+// Hash join por igualdad de una columna de cada tabla. La tabla hash se construye
+// sobre la tabla con menos filas y la otra se sondea por lotes.
+typedef struct {
+    const Table* build;
+    const Table* probe;
+    int build_key;
+    int probe_key;
+    int build_is_left;        // 1 si la tabla de construcción es la izquierda
+
+    int* heads;               // Primera fila de cada cubeta (-1 si está vacía)
+    int mask;                 // Número de cubetas - 1 (potencia de dos)
+    int* next;                // Siguiente fila de construcción en la misma cubeta
+    unsigned int* hashes;     // Hash de la clave de cada fila de construcción
+
+    // Lote de sondeo en curso (solo filas vivas con clave no nula)
+    int batch_rows[JOIN_BATCH_SIZE];
+    unsigned int batch_hashes[JOIN_BATCH_SIZE];
+    int batch_count;
+    int batch_pos;
+    int probe_next;           // Siguiente fila de la tabla de sondeo por leer
+    int chain;                // Siguiente fila de construcción a comparar (-1 si ninguna)
+
+    int build_used;           // Filas con clave que entraron en la tabla hash
+    int probe_used;           // Filas de sondeo con clave leídas
+} HashJoin;
+
+// Merge join: recorre a la vez dos tablas ya ordenadas por la clave, sin memoria
+// adicional. Para cada fila izquierda vuelve a recorrer el tramo de filas derechas
+// con su misma clave.
+typedef struct {
+    const Table* left;
+    const Table* right;
+    int left_key;
+    int right_key;
+
+    int left_pos;             // Fila izquierda actual
+    int group_start;          // Tramo de filas derechas con la clave actual
+    int group_end;
+    int cursor;               // Siguiente fila del tramo a emitir (-1 si ninguna)
+
+    int left_used;            // Filas izquierdas con clave recorridas
+    int right_used;           // Filas derechas con clave recorridas
+} MergeJoin;
+
+// Operador de JOIN elegido para un par de tablas
+typedef enum {
+    JOIN_HASH,
+    JOIN_MERGE,
+    JOIN_UNDECIDED            // Solo en EXPLAIN: se elige al ejecutar, según el orden de las tablas
+} JoinMethod;
+
+typedef struct {
+    JoinMethod method;
+    HashJoin hash;
+    MergeJoin merge;
+} Join;
+
+// Lo que el JOIN ha leído de una de sus tablas
+typedef struct {
+    int read;                 // Filas recorridas
+    int used;                 // Filas visibles con clave no nula que entraron en el JOIN
+} JoinInput;
+
+// Indica si las filas vivas de la tabla están ordenadas de forma ascendente por la clave.
+// En una vista el resultado se guarda para los JOIN siguientes hasta que cambie la tabla.
+int join_is_sorted(const Table* table, int key);
+
+// Construye la tabla hash (0 si tuvo éxito, -1 si faltó memoria)
+int hash_join_init(HashJoin* join, const Table* left, int left_key, const Table* right, int right_key);
+
+// Devuelve en left_rows/right_rows hasta capacity parejas de filas con claves iguales
+// (0 cuando no quedan más)
+int hash_join_next(HashJoin* join, int* left_rows, int* right_rows, int capacity);
+
+void hash_join_free(HashJoin* join);
+
+void merge_join_init(MergeJoin* join, const Table* left, int left_key, const Table* right, int right_key);
+int merge_join_next(MergeJoin* join, int* left_rows, int* right_rows, int capacity);
+
+// Usa merge join si ambas tablas ya están ordenadas por la clave y hash join si no
+int join_init(Join* join, const Table* left, int left_key, const Table* right, int right_key);
+int join_next(Join* join, int* left_rows, int* right_rows, int capacity);
+void join_free(Join* join);
+
+// Filas que el JOIN ha leído hasta ahora de la tabla izquierda y de la derecha
+void join_inputs(const Join* join, JoinInput* left, JoinInput* right);
+
+#endif /* JOIN_H */
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "parallel.h"
+#include "../utils/timing.h"
+
+// Recorrido en curso
+typedef struct {
+    MorselFunc func;
+    void* ctx;
+    int num_rows;
+    atomic_int next_row;          // Primera fila del siguiente morsel libre
+} MorselJob;
+
+// Tarea del planificador que procesa morsels con un índice de hilo fijo, de modo
+// que el estado por hilo del recorrido nunca lo comparten dos tareas
+typedef struct {
+    MorselJob* job;
+    int worker;
+} MorselRunner;
+
+// Procesa morsels del recorrido hasta que no quede ninguno
+static void run_morsels(MorselJob* job, int worker) {
+    while (1) {
+        int start = atomic_fetch_add(&job->next_row, MORSEL_SIZE);
+        if (start >= job->num_rows) return;
+
+        int end = start > job->num_rows - MORSEL_SIZE ? job->num_rows : start + MORSEL_SIZE;
+        job->func(job->ctx, worker, start, end);
+    }
+}
+
+static void morsel_task(void* arg) {
+    MorselRunner* runner = (MorselRunner*)arg;
+    run_morsels(runner->job, runner->worker);
+}
+
+int parallel_num_workers(void) {
+    return scheduler_num_workers();
+}
+
+void parallel_for_morsels(int num_rows, MorselFunc func, void* ctx) {
+    MorselJob job;
+    job.func = func;
+    job.ctx = ctx;
+    job.num_rows = num_rows;
+    atomic_init(&job.next_row, 0);
+
+    int num_morsels = (num_rows + MORSEL_SIZE - 1) / MORSEL_SIZE;
+    int workers = parallel_num_workers();
+    if (workers > num_morsels) workers = num_morsels;
+
+    // Con pocas filas no compensa repartir
+    if (num_rows < PARALLEL_MIN_ROWS || workers <= 1) {
+        run_morsels(&job, 0);
+        return;
+    }
+
+    // Si los hilos del planificador están ocupados, el que llama se queda con los morsels
+    MorselRunner runners[PARALLEL_MAX_WORKERS];
+    TaskGroup group;
+    task_group_init(&group);
+
+    for (int w = 1; w < workers; w++) {
+        runners[w].job = &job;
+        runners[w].worker = w;
+        scheduler_spawn(&group, morsel_task, &runners[w]);
+    }
+
+    run_morsels(&job, 0);
+    scheduler_wait(&group);
+
+    // La CPU de los otros hilos también es de esta sentencia
+    timing_add_cpu(atomic_load(&group.cpu_ns));
+}
@@ -0,0 +1,26 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "../utils/scheduler.h"
+
+// Filas de cada morsel (tramo de filas que procesa un hilo de una vez)
+#define MORSEL_SIZE 4096
+
+// Por debajo de este número de filas el recorrido se hace en el hilo actual
+#define PARALLEL_MIN_ROWS (4 * MORSEL_SIZE)
+
+// Máximo de hilos de trabajo (incluido el que lanza el recorrido)
+#define PARALLEL_MAX_WORKERS SCHEDULER_MAX_WORKERS
+
+// Procesa las filas [start, end) de un morsel en el hilo worker (0 .. workers - 1)
+typedef void (*MorselFunc)(void* ctx, int worker, int start, int end);
+
+// Número de hilos que pueden participar en un recorrido
+int parallel_num_workers(void);
+
+// Reparte las filas [0, num_rows) en morsels entre los hilos del planificador y espera
+// a que terminen. Cada hilo toma el siguiente morsel libre hasta agotarlos; el hilo que
+// llama también trabaja. Con pocas filas todo se hace en el hilo que llama.
+void parallel_for_morsels(int num_rows, MorselFunc func, void* ctx);
+
+#endif /* PARALLEL_H */
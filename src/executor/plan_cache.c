@@ -0,0 +1,508 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <strings.h>
+#include "plan_cache.h"
+#include "../parser/lexer.h"
+#include "../parser/parser.h"
+#include "../db/value.h"
+#include "../utils/timing.h"
+
+/**
+ * Normalización de sentencias
+ */
+
+// Buffer de texto que crece según se necesita
+typedef struct {
+    char* data;
+    int length;
+    int capacity;
+} TextBuffer;
+
+static int buffer_append(TextBuffer* buffer, const char* text) {
+    int length = strlen(text);
+
+    if (buffer->length + length + 2 > buffer->capacity) {
+        int capacity = buffer->capacity * 2;
+        while (buffer->length + length + 2 > capacity) capacity *= 2;
+
+        char* data = (char*)realloc(buffer->data, capacity);
+        if (!data) return -1;
+
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    // Separar los tokens con un único espacio
+    if (buffer->length > 0) buffer->data[buffer->length++] = ' ';
+
+    memcpy(buffer->data + buffer->length, text, length + 1);
+    buffer->length += length;
+    return 0;
+}
+
+// Añade un literal al array de parámetros
+static LiteralData* params_append(LiteralData** params, int* count, int* capacity) {
+    if (*count >= *capacity) {
+        int new_capacity = *capacity * 2;
+        LiteralData* new_params = (LiteralData*)realloc(*params, new_capacity * sizeof(LiteralData));
+        if (!new_params) return NULL;
+
+        *params = new_params;
+        *capacity = new_capacity;
+    }
+
+    LiteralData* literal = &(*params)[(*count)++];
+    memset(literal, 0, sizeof(LiteralData));
+    return literal;
+}
+
+void plan_cache_free_params(LiteralData* params, int num_params) {
+    if (!params) return;
+
+    for (int i = 0; i < num_params; i++) {
+        if (params[i].lit_type == LIT_STRING) free(params[i].string_value);
+    }
+    free(params);
+}
+
+// Normaliza una sentencia (ver plan_cache_normalize)
+static char* normalize(const char* sql, LiteralData** params_out, int* num_params_out) {
+    if (!sql || !params_out || !num_params_out) return NULL;
+
+    Lexer* lexer = lexer_create(sql);
+    if (!lexer) return NULL;
+
+    TextBuffer buffer = { (char*)malloc(64), 0, 64 };
+    int capacity = 8;
+    int count = 0;
+    LiteralData* params = (LiteralData*)malloc(capacity * sizeof(LiteralData));
+    int prev_is_value = 0;     // El token anterior termina un operando
+    int negate = 0;            // '-' unario pendiente de aplicar al siguiente número
+    int ok = buffer.data && params;
+
+    if (ok) buffer.data[0] = '\0';
+
+    while (ok) {
+        Token token = lexer_next_token(lexer);
+
+        if (token.type == TOKEN_EOF) break;
+
+        if (token.type == TOKEN_ERROR || lexer_has_error(lexer) || !token.value) {
+            token_free(&token);
+            ok = 0;
+            break;
+        }
+
+        int is_literal = token.type == TOKEN_INTEGER || token.type == TOKEN_FLOAT ||
+                         token.type == TOKEN_STRING ||
+                         (token.type == TOKEN_KEYWORD &&
+                          (strcasecmp(token.value, "TRUE") == 0 ||
+                           strcasecmp(token.value, "FALSE") == 0 ||
+                           strcasecmp(token.value, "NULL") == 0));
+
+        // Un '-' que no sigue a un operando es unario: se pliega en el número siguiente
+        if (token.type == TOKEN_OPERATOR && strcmp(token.value, "-") == 0 && !prev_is_value && !negate) {
+            negate = 1;
+            token_free(&token);
+            continue;
+        }
+
+        if (negate && token.type != TOKEN_INTEGER && token.type != TOKEN_FLOAT) {
+            ok = buffer_append(&buffer, "-") == 0;
+        }
+
+        if (!ok) {
+            token_free(&token);
+            break;
+        }
+
+        if (is_literal) {
+            LiteralData* literal = params_append(&params, &count, &capacity);
+            if (!literal) {
+                token_free(&token);
+                ok = 0;
+                break;
+            }
+
+            // Un número que no cabe en su tipo no se normaliza: el parser da el error
+            if (token.type == TOKEN_INTEGER) {
+                literal->lit_type = LIT_INTEGER;
+                ok = value_parse_int(token.value, strlen(token.value), negate,
+                                     &literal->int_value) == VALUE_PARSE_OK;
+            } else if (token.type == TOKEN_FLOAT) {
+                float value = 0.0f;
+                literal->lit_type = LIT_FLOAT;
+                ok = value_parse_float(token.value, strlen(token.value), negate, &value) == VALUE_PARSE_OK;
+                literal->float_value = value;
+            } else if (token.type == TOKEN_STRING) {
+                literal->lit_type = LIT_STRING;
+                literal->string_value = token.value;
+                token.value = NULL;   // La cadena pasa al array de parámetros
+            } else if (strcasecmp(token.value, "NULL") == 0) {
+                literal->lit_type = LIT_NULL;
+            } else {
+                literal->lit_type = LIT_BOOLEAN;
+                literal->bool_value = strcasecmp(token.value, "TRUE") == 0;
+            }
+
+            if (ok) ok = buffer_append(&buffer, "?") == 0;
+        } else if (token.type == TOKEN_PUNCTUATION && strcmp(token.value, "?") == 0) {
+            // Los parámetros explícitos solo se pueden enlazar con EXECUTE
+            ok = 0;
+        } else {
+            // Palabras clave en mayúsculas e identificadores en minúsculas
+            for (char* c = token.value; *c; c++) {
+                *c = token.type == TOKEN_KEYWORD ? toupper((unsigned char)*c)
+                                                 : tolower((unsigned char)*c);
+            }
+            ok = buffer_append(&buffer, token.value) == 0;
+        }
+
+        prev_is_value = is_literal || token.type == TOKEN_IDENTIFIER ||
+                        (token.type == TOKEN_PUNCTUATION && strcmp(token.value ? token.value : "", ")") == 0);
+        negate = 0;
+        token_free(&token);
+    }
+
+    // Un '-' final sin operando
+    if (ok && negate) ok = buffer_append(&buffer, "-") == 0;
+
+    // Los valores de los tokens ya se liberaron (o pasaron a params)
+    lexer->current_token.value = NULL;
+    lexer_free(lexer);
+
+    if (!ok) {
+        free(buffer.data);
+        plan_cache_free_params(params, count);
+        return NULL;
+    }
+
+    *params_out = params;
+    *num_params_out = count;
+    return buffer.data;
+}
+
+// Es la pasada del lexer sobre la sentencia: cuenta como la fase léxica de \timing
+char* plan_cache_normalize(const char* sql, LiteralData** params_out, int* num_params_out) {
+    int mark = timing_enter(TIMING_LEX);
+    char* key = normalize(sql, params_out, num_params_out);
+    timing_leave(mark);
+    return key;
+}
+
+/**
+ * Caché LRU de planes
+ */
+
+typedef struct {
+    char* key;                     // Texto normalizado (NULL si la entrada está libre)
+    unsigned int hash;
+    PreparedStatement* prepared;
+    int prev;                      // Entrada usada más recientemente (-1 si es la primera)
+    int next;                      // Entrada usada menos recientemente (-1 si es la última)
+    int chain;                     // Siguiente entrada en la misma cubeta o en la lista libre
+} PlanCacheEntry;
+
+// Cada hilo tiene su propia caché: los planes en uso no se comparten ni se
+// expulsan desde otro hilo
+static __thread PlanCacheEntry entries[PLAN_CACHE_SIZE];
+static __thread int buckets[PLAN_CACHE_BUCKETS];
+static __thread int lru_head = -1;          // Más reciente
+static __thread int lru_tail = -1;          // Menos reciente
+static __thread int free_list = -1;
+static __thread int cache_ready = 0;
+static __thread PlanCacheStats stats;
+
+// Hash FNV-1a del texto normalizado
+static unsigned int plan_cache_hash(const char* key) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)key; *c; c++) {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void plan_cache_init() {
+    for (int i = 0; i < PLAN_CACHE_BUCKETS; i++) buckets[i] = -1;
+
+    // Todas las entradas empiezan en la lista libre
+    for (int i = 0; i < PLAN_CACHE_SIZE; i++) {
+        entries[i].key = NULL;
+        entries[i].prepared = NULL;
+        entries[i].chain = i + 1 < PLAN_CACHE_SIZE ? i + 1 : -1;
+    }
+
+    free_list = 0;
+    lru_head = lru_tail = -1;
+    memset(&stats, 0, sizeof(stats));
+    cache_ready = 1;
+}
+
+static void lru_unlink(int index) {
+    PlanCacheEntry* entry = &entries[index];
+
+    if (entry->prev >= 0) entries[entry->prev].next = entry->next;
+    else lru_head = entry->next;
+
+    if (entry->next >= 0) entries[entry->next].prev = entry->prev;
+    else lru_tail = entry->prev;
+}
+
+static void lru_push_front(int index) {
+    entries[index].prev = -1;
+    entries[index].next = lru_head;
+
+    if (lru_head >= 0) entries[lru_head].prev = index;
+    lru_head = index;
+
+    if (lru_tail < 0) lru_tail = index;
+}
+
+// Quita una entrada de la caché y libera su plan
+static void plan_cache_remove(int index) {
+    PlanCacheEntry* entry = &entries[index];
+    int* link = &buckets[entry->hash & (PLAN_CACHE_BUCKETS - 1)];
+
+    while (*link != index) link = &entries[*link].chain;
+    *link = entry->chain;
+
+    lru_unlink(index);
+
+    prepared_free(entry->prepared);
+    free(entry->key);
+    entry->key = NULL;
+    entry->prepared = NULL;
+
+    entry->chain = free_list;
+    free_list = index;
+    stats.entries--;
+}
+
+PreparedStatement* plan_cache_lookup(const char* key, const Database* db) {
+    if (!key) return NULL;
+    if (!cache_ready) plan_cache_init();
+
+    unsigned int hash = plan_cache_hash(key);
+
+    for (int i = buckets[hash & (PLAN_CACHE_BUCKETS - 1)]; i >= 0; i = entries[i].chain) {
+        if (entries[i].hash != hash || strcmp(entries[i].key, key) != 0) continue;
+
+        // Un cambio de esquema invalida el plan
+        if (executor_plan_is_stale(entries[i].prepared->plan, db)) {
+            plan_cache_remove(i);
+            stats.invalidations++;
+            break;
+        }
+
+        lru_unlink(i);
+        lru_push_front(i);
+        stats.hits++;
+        return entries[i].prepared;
+    }
+
+    stats.misses++;
+    return NULL;
+}
+
+int plan_cache_insert(const char* key, PreparedStatement* prepared) {
+    if (!key || !prepared) return -1;
+    if (!cache_ready) plan_cache_init();
+
+    // Sin entradas libres se expulsa la menos usada recientemente
+    if (free_list < 0) {
+        plan_cache_remove(lru_tail);
+        stats.evictions++;
+    }
+
+    char* key_copy = strdup(key);
+    if (!key_copy) return -1;
+
+    int index = free_list;
+    PlanCacheEntry* entry = &entries[index];
+    free_list = entry->chain;
+
+    entry->key = key_copy;
+    entry->hash = plan_cache_hash(key);
+    entry->prepared = prepared;
+
+    int bucket = entry->hash & (PLAN_CACHE_BUCKETS - 1);
+    entry->chain = buckets[bucket];
+    buckets[bucket] = index;
+
+    lru_push_front(index);
+    stats.entries++;
+    return 0;
+}
+
+// Ejecuta una sentencia sin pasar por la caché
+static int execute_uncached(const char* sql, Database* db, ValidationResult* result) {
+    Parser* parser = parser_create(sql);
+    if (!parser) {
+        validator_set_error(result, 404, "Error de memoria al crear el parser");
+        return -1;
+    }
+
+    ASTNode* stmt = parser_parse(parser);
+    if (!stmt || parser_has_error(parser)) {
+        validator_set_error(result, 413, parser_has_error(parser) ? parser_get_error(parser) : "Sentencia no válida");
+        if (stmt) ast_free_node(stmt);
+        parser_free(parser);
+        return -1;
+    }
+
+    int num_params = parser->param_count;
+    parser_free(parser);
+
+    PreparedStatement* prepared = prepared_create(NULL, stmt, num_params, db, result);
+    if (!prepared) {
+        ast_free_node(stmt);
+        return -1;
+    }
+
+    int status = prepared_execute(prepared, NULL, 0, db, result);
+    prepared_free(prepared);
+    return status;
+}
+
+// Busca el plan de un texto normalizado o lo compila y lo guarda en la caché. El
+// llamador tiene el catálogo en lectura. Devuelve NULL si hubo error; unparsable
+// indica que el texto normalizado no se pudo analizar (hay que usar el original).
+static PreparedStatement* plan_cache_prepare(const char* key, int num_params, Database* db,
+                                             ValidationResult* result, int* unparsable) {
+    *unparsable = 0;
+    PreparedStatement* prepared = plan_cache_lookup(key, db);
+    if (prepared) return prepared;
+
+    Parser* parser = parser_create(key);
+    ASTNode* stmt = parser ? parser_parse(parser) : NULL;
+
+    if (!stmt || parser_has_error(parser) || parser->param_count != num_params) {
+        if (stmt) ast_free_node(stmt);
+        parser_free(parser);
+        *unparsable = 1;
+        return NULL;
+    }
+    parser_free(parser);
+
+    prepared = prepared_create(NULL, stmt, num_params, db, result);
+    if (!prepared) {
+        ast_free_node(stmt);
+        return NULL;
+    }
+
+    if (plan_cache_insert(key, prepared) != 0) {
+        prepared_free(prepared);
+        validator_set_error(result, 404, "Error de memoria al guardar el plan");
+        return NULL;
+    }
+    return prepared;
+}
+
+int plan_cache_execute(const char* sql, Database* db, ValidationResult* result) {
+    if (!sql || !db || !result) return -1;
+
+    LiteralData* params = NULL;
+    int num_params = 0;
+    char* key = plan_cache_normalize(sql, &params, &num_params);
+
+    // Sentencias que no se pueden normalizar se ejecutan (o se rechazan) directamente
+    if (!key) return execute_uncached(sql, db, result);
+
+    // El catálogo se mantiene tomado desde la búsqueda hasta la ejecución
+    db_lock_read();
+    int unparsable;
+    PreparedStatement* prepared = plan_cache_prepare(key, num_params, db, result, &unparsable);
+
+    int status;
+    if (prepared) {
+        status = prepared_execute(prepared, params, num_params, db, result);
+    } else if (unparsable) {
+        // Informar del error con el texto original
+        status = execute_uncached(sql, db, result);
+    } else {
+        status = -1;
+    }
+    db_unlock();
+
+    free(key);
+    plan_cache_free_params(params, num_params);
+    return status;
+}
+
+// Indica si una sentencia empieza por INSERT (antes de normalizarla)
+static int looks_like_insert(const char* sql) {
+    while (*sql == ' ' || *sql == '\t' || *sql == '\n' || *sql == '\r') sql++;
+    return strncasecmp(sql, "INSERT", 6) == 0;
+}
+
+int plan_cache_execute_inserts(char* const* sqls, int count, Database* db,
+                               PlanCacheDone done, void* ctx) {
+    if (!sqls || !db || count < 2) return 0;
+    if (count > PLAN_CACHE_MAX_BATCH) count = PLAN_CACHE_MAX_BATCH;
+
+    Plan* plans[PLAN_CACHE_MAX_BATCH];
+    LiteralData* params[PLAN_CACHE_MAX_BATCH];
+    int num_params[PLAN_CACHE_MAX_BATCH];
+    int grouped = 0;
+
+    ValidationResult* result = validator_create_result();
+    if (!result) return 0;
+
+    // El catálogo se mantiene tomado hasta ejecutar el grupo
+    db_lock_read();
+    for (; grouped < count; grouped++) {
+        if (!looks_like_insert(sqls[grouped])) break;
+
+        char* key = plan_cache_normalize(sqls[grouped], &params[grouped], &num_params[grouped]);
+        if (!key) break;
+
+        // Solo el primero puede compilar un plan nuevo: guardar otro en la caché podría
+        // expulsar el plan de una sentencia anterior del grupo
+        PreparedStatement* prepared = grouped == 0 ? NULL : plan_cache_lookup(key, db);
+        if (grouped == 0) {
+            int unparsable;
+            prepared = plan_cache_prepare(key, num_params[grouped], db, result, &unparsable);
+        }
+        free(key);
+
+        Plan* plan = prepared ? prepared_current_plan(prepared, db, result) : NULL;
+        if (!plan || plan->type != NODE_INSERT_STMT ||
+            (grouped > 0 && plan->table != plans[0]->table)) {
+            plan_cache_free_params(params[grouped], num_params[grouped]);
+            break;
+        }
+        plans[grouped] = plan;
+    }
+
+    // Si el grupo no se puede insertar entero no se cambia nada y cada sentencia se
+    // ejecuta después por separado, con su propio error
+    int status = grouped >= 2 ? executor_insert_batch(plans, params, num_params, grouped, result) : -1;
+    if (status == 0) {
+        for (int i = 0; i < grouped; i++) {
+            executor_report_insert(plans[i]);
+            if (done) done(ctx);
+        }
+    }
+    db_unlock();
+
+    for (int i = 0; i < grouped; i++) {
+        plan_cache_free_params(params[i], num_params[i]);
+    }
+    validator_free_result(result);
+    return status == 0 ? grouped : 0;
+}
+
+PlanCacheStats plan_cache_get_stats() {
+    if (!cache_ready) plan_cache_init();
+    return stats;
+}
+
+void plan_cache_cleanup() {
+    if (!cache_ready) return;
+
+    while (lru_head >= 0) plan_cache_remove(lru_head);
+    cache_ready = 0;
+}
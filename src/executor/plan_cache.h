@@ -0,0 +1,60 @@
+#ifndef PLAN_CACHE_H
+#define PLAN_CACHE_H
+
+#include "prepared.h"
+
+// Número máximo de planes en la caché (se expulsa el menos usado recientemente)
+#define PLAN_CACHE_SIZE 64
+
+// Número de cubetas de la tabla hash de la caché (potencia de dos)
+#define PLAN_CACHE_BUCKETS 128
+
+// Estadísticas de la caché de planes
+typedef struct {
+    int hits;
+    int misses;
+    int evictions;       // Expulsados por falta de espacio
+    int invalidations;   // Descartados por cambios de esquema
+    int entries;         // Planes almacenados actualmente
+} PlanCacheStats;
+
+// Normaliza una sentencia: literales sustituidos por '?', palabras clave en
+// mayúsculas, identificadores en minúsculas y espacios simples entre tokens.
+// Devuelve el texto normalizado (NULL si la sentencia no se puede normalizar) y
+// los literales extraídos en params (las cadenas pertenecen al array).
+char* plan_cache_normalize(const char* sql, LiteralData** params, int* num_params);
+
+// Libera los literales devueltos por plan_cache_normalize
+void plan_cache_free_params(LiteralData* params, int num_params);
+
+// Busca un plan por su texto normalizado (NULL si no está o quedó obsoleto)
+PreparedStatement* plan_cache_lookup(const char* key, const Database* db);
+
+// Guarda un plan en la caché (toma posesión de la sentencia preparada)
+int plan_cache_insert(const char* key, PreparedStatement* prepared);
+
+// Ejecuta una sentencia SELECT, INSERT, UPDATE o DELETE reutilizando planes cacheados
+// (la caché es propia de cada hilo; plan_cache_cleanup libera la del hilo actual)
+int plan_cache_execute(const char* sql, Database* db, ValidationResult* result);
+
+// Máximo de sentencias que plan_cache_execute_inserts agrupa en una escritura
+#define PLAN_CACHE_MAX_BATCH 256
+
+// Se llama tras escribir el resultado de cada sentencia de un grupo
+typedef void (*PlanCacheDone)(void* ctx);
+
+// Ejecuta como una sola escritura las sentencias INSERT consecutivas sobre una misma
+// tabla con las que empieza sqls (como mucho count). Si se insertan todas, escribe el
+// resultado de cada una seguido de una llamada a done y devuelve cuántas eran. Devuelve
+// 0 si no hay al menos dos que agrupar o si el grupo falló: entonces no se ha cambiado
+// nada y las sentencias se deben ejecutar una a una.
+int plan_cache_execute_inserts(char* const* sqls, int count, Database* db,
+                               PlanCacheDone done, void* ctx);
+
+// Obtiene las estadísticas de la caché
+PlanCacheStats plan_cache_get_stats();
+
+// Libera todos los planes de la caché
+void plan_cache_cleanup();
+
+#endif /* PLAN_CACHE_H */
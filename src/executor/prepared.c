@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "prepared.h"
+#include "../utils/output.h"
+
+// Registro de sentencias preparadas con nombre: cada hilo tiene el suyo, salvo que
+// esté atendiendo una sesión que lleva el propio (prepared_use_session)
+static __thread PreparedSession thread_session;
+static __thread PreparedSession* session = NULL;
+
+static PreparedSession* current_session(void) {
+    return session ? session : &thread_session;
+}
+
+// Crea una sentencia preparada a partir de un AST
+PreparedStatement* prepared_create(const char* name, ASTNode* stmt, int num_params,
+                                   Database* db, ValidationResult* result) {
+    if (!stmt || !db || !result) return NULL;
+
+    // Validar y compilar una sola vez
+    Plan* plan = executor_compile(stmt, num_params, db, result);
+    if (!plan) return NULL;
+
+    PreparedStatement* prepared = (PreparedStatement*)calloc(1, sizeof(PreparedStatement));
+    if (!prepared) {
+        executor_free_plan(plan);
+        validator_set_error(result, 404, "Error de memoria al preparar la sentencia");
+        return NULL;
+    }
+
+    if (name) {
+        prepared->name = strdup(name);
+        if (!prepared->name) {
+            free(prepared);
+            executor_free_plan(plan);
+            validator_set_error(result, 404, "Error de memoria al preparar la sentencia");
+            return NULL;
+        }
+    }
+
+    prepared->stmt = stmt;
+    prepared->plan = plan;
+    prepared->num_params = num_params;
+
+    return prepared;
+}
+
+// Ejecuta una sentencia preparada
+int prepared_execute(PreparedStatement* prepared, const LiteralData* params, int num_params,
+                     Database* db, ValidationResult* result) {
+    if (!prepared || !db || !result) return -1;
+
+    // El esquema no puede cambiar entre la comprobación y la ejecución
+    db_lock_read();
+
+    Plan* plan = prepared_current_plan(prepared, db, result);
+    int status = plan ? executor_run(plan, params, num_params, result) : -1;
+    db_unlock();
+    return status;
+}
+
+// Obtiene el plan de una sentencia preparada para el esquema actual
+Plan* prepared_current_plan(PreparedStatement* prepared, Database* db, ValidationResult* result) {
+    // Si el esquema cambió, volver a validar y compilar contra el esquema actual
+    if (executor_plan_is_stale(prepared->plan, db)) {
+        executor_free_plan(prepared->plan);
+        prepared->plan = executor_compile(prepared->stmt, prepared->num_params, db, result);
+    }
+    return prepared->plan;
+}
+
+// Libera una sentencia preparada
+void prepared_free(PreparedStatement* prepared) {
+    if (!prepared) return;
+
+    executor_free_plan(prepared->plan);
+    ast_free_node(prepared->stmt);
+    free(prepared->name);
+    free(prepared);
+}
+
+// Busca la posición de una sentencia en el registro
+static int prepared_index(const char* name) {
+    if (!name) return -1;
+
+    PreparedSession* registry = current_session();
+    for (int i = 0; i < registry->count; i++) {
+        if (strcasecmp(registry->statements[i]->name, name) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// Registra una sentencia preparada con nombre
+int prepared_register(PreparedStatement* prepared) {
+    if (!prepared || !prepared->name) return -1;
+
+    if (prepared_index(prepared->name) >= 0) {
+        output_printf("Error: La sentencia preparada '%s' ya existe\n", prepared->name);
+        return -1;
+    }
+
+    PreparedSession* registry = current_session();
+    if (registry->count >= MAX_PREPARED) {
+        output_printf("Error: Se alcanzó el número máximo de sentencias preparadas\n");
+        return -1;
+    }
+
+    registry->statements[registry->count++] = prepared;
+    return 0;
+}
+
+// Busca una sentencia preparada por nombre
+PreparedStatement* prepared_find(const char* name) {
+    int index = prepared_index(name);
+    return index >= 0 ? current_session()->statements[index] : NULL;
+}
+
+// Elimina una sentencia preparada del registro y la libera
+int prepared_remove(const char* name) {
+    int index = prepared_index(name);
+    if (index < 0) return -1;
+
+    PreparedSession* registry = current_session();
+    prepared_free(registry->statements[index]);
+
+    // Mover las sentencias restantes
+    for (int i = index; i < registry->count - 1; i++) {
+        registry->statements[i] = registry->statements[i + 1];
+    }
+    registry->count--;
+
+    return 0;
+}
+
+// Libera todas las sentencias preparadas
+void prepared_cleanup() {
+    PreparedSession* registry = current_session();
+    for (int i = 0; i < registry->count; i++) {
+        prepared_free(registry->statements[i]);
+        registry->statements[i] = NULL;
+    }
+    registry->count = 0;
+}
+
+// Cambia el registro que usa el hilo actual
+PreparedSession* prepared_use_session(PreparedSession* registry) {
+    PreparedSession* previous = session;
+    session = registry;
+    return previous;
+}
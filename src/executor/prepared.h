@@ -0,0 +1,48 @@
+#ifndef PREPARED_H
+#define PREPARED_H
+
+#include "executor.h"
+
+// Número máximo de sentencias preparadas con nombre
+#define MAX_PREPARED 64
+
+// Sentencia preparada: AST validado y plan compilado listos para reutilizar
+typedef struct {
+    char* name;          // NULL para sentencias anónimas (API de C)
+    ASTNode* stmt;       // AST de la sentencia (pertenece a la sentencia preparada)
+    Plan* plan;          // Plan compilado (se recompila si cambia el esquema)
+    int num_params;      // Número de parámetros '?'
+} PreparedStatement;
+
+// Registro de sentencias preparadas con nombre de una sesión
+typedef struct {
+    PreparedStatement* statements[MAX_PREPARED];
+    int count;
+} PreparedSession;
+
+// Crea una sentencia preparada a partir de un AST (toma posesión de stmt si tiene éxito)
+PreparedStatement* prepared_create(const char* name, ASTNode* stmt, int num_params,
+                                   Database* db, ValidationResult* result);
+
+// Ejecuta una sentencia preparada con los parámetros indicados (0 si tuvo éxito, -1 si hubo error)
+int prepared_execute(PreparedStatement* prepared, const LiteralData* params, int num_params,
+                     Database* db, ValidationResult* result);
+
+// Obtiene el plan de una sentencia preparada, recompilándolo si el esquema cambió (NULL
+// si ya no es válida). El llamador debe tener el catálogo en lectura.
+Plan* prepared_current_plan(PreparedStatement* prepared, Database* db, ValidationResult* result);
+
+// Libera una sentencia preparada
+void prepared_free(PreparedStatement* prepared);
+
+// Registro de sentencias preparadas con nombre (propio de cada hilo)
+int prepared_register(PreparedStatement* prepared);
+PreparedStatement* prepared_find(const char* name);
+int prepared_remove(const char* name);
+void prepared_cleanup();
+
+// Hace que el hilo actual use el registro de otra sesión (NULL: el suyo) hasta el
+// siguiente cambio, para que un hilo atienda varias sesiones. Devuelve el anterior.
+PreparedSession* prepared_use_session(PreparedSession* registry);
+
+#endif /* PREPARED_H */
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "script.h"
+#include "../utils/output.h"
+
+// Escribe el error de una sentencia del script
+static void script_report_error(const char* message) {
+    output_printf("Error: %s\n", message ? message : "Sentencia no válida");
+}
+
+// Indica si una sentencia se puede añadir a un grupo de INSERT
+static int script_is_insert(const ScriptStatement* statement) {
+    return statement->stmt && statement->stmt->type == NODE_INSERT_STMT && statement->num_params == 0;
+}
+
+// Ejecuta la sentencia first y, si es un INSERT, los INSERT sobre la misma tabla que la
+// siguen. Devuelve cuántas sentencias se ejecutaron y acumula los fallos en status.
+static int script_execute_from(ParsedScript* script, int first, Database* db, int* status) {
+    ScriptStatement* statement = &script->statements[first];
+    if (!statement->stmt) {
+        script_report_error(statement->error);
+        *status = -1;
+        return 1;
+    }
+
+    ValidationResult* result = validator_create_result();
+    if (!result) {
+        script_report_error("Error de memoria al ejecutar la sentencia");
+        *status = -1;
+        return 1;
+    }
+
+    Plan* plans[SCRIPT_MAX_BATCH];
+    LiteralData* params[SCRIPT_MAX_BATCH] = {NULL};
+    int num_params[SCRIPT_MAX_BATCH] = {0};
+    int count = 0;
+
+    // El catálogo se mantiene tomado desde la compilación hasta la ejecución
+    db_lock_read();
+    Plan* plan = executor_compile(statement->stmt, statement->num_params, db, result);
+    if (!plan) {
+        script_report_error(result->error_message);
+        *status = -1;
+    } else {
+        plans[count++] = plan;
+
+        // Los INSERT que siguen sobre la misma tabla se compilan para escribirlos juntos
+        while (script_is_insert(statement) && count < SCRIPT_MAX_BATCH &&
+               first + count < script->count && script_is_insert(&script->statements[first + count])) {
+            Plan* next = executor_compile(script->statements[first + count].stmt, 0, db, result);
+            if (!next) break;
+            if (next->table != plan->table) {
+                executor_free_plan(next);
+                break;
+            }
+            plans[count++] = next;
+        }
+    }
+
+    if (count >= 2 && executor_insert_batch(plans, params, num_params, count, result) == 0) {
+        for (int i = 0; i < count; i++) executor_report_insert(plans[i]);
+    } else {
+        // Si el grupo no se puede insertar entero no se ha cambiado nada: cada sentencia
+        // se ejecuta por separado, con su propio error
+        for (int i = 0; i < count; i++) {
+            if (executor_run(plans[i], NULL, 0, result) != 0) {
+                script_report_error(result->error_message);
+                *status = -1;
+            }
+        }
+    }
+    db_unlock();
+
+    for (int i = 0; i < count; i++) executor_free_plan(plans[i]);
+    validator_free_result(result);
+    return count > 0 ? count : 1;
+}
+
+int script_execute(ParsedScript* script, Database* db) {
+    if (!script || !db) return -1;
+
+    int status = 0;
+    int next = 0;
+    while (next < script->count) {
+        next += script_execute_from(script, next, db, &status);
+    }
+    return status;
+}
@@ -0,0 +1,17 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include "../parser/parser.h"
+#include "executor.h"
+
+// Máximo de INSERT consecutivos de un script que se escriben juntos
+#define SCRIPT_MAX_BATCH 256
+
+// Ejecuta una tras otra las sentencias SELECT, INSERT, UPDATE, DELETE, BEGIN, COMMIT y
+// ROLLBACK de un script, sin normalizarlas ni pasar por la caché de planes. Los INSERT
+// consecutivos sobre una misma tabla se insertan con una sola escritura; si el grupo
+// falla, se ejecutan uno a uno. Escribe el resultado o el error de cada sentencia.
+// Devuelve 0 si todas tuvieron éxito y -1 si falló alguna.
+int script_execute(ParsedScript* script, Database* db);
+
+#endif /* SCRIPT_H */
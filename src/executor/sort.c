@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sort.h"
+
+/**
+ * Comparación de filas
+ */
+
+// Compara dos valores de una columna (los NULL van primero)
+static int compare_key_values(Value a, Value b, DataType type) {
+    switch (type) {
+        case TYPE_STRING:
+            if (!a.string_val || !b.string_val) {
+                return (a.string_val != NULL) - (b.string_val != NULL);
+            }
+            return strcmp(a.string_val, b.string_val);
+        case TYPE_FLOAT: return (a.float_val > b.float_val) - (a.float_val < b.float_val);
+        case TYPE_BOOL: return (a.bool_val != 0) - (b.bool_val != 0);
+        default: return (a.int_val > b.int_val) - (a.int_val < b.int_val);
+    }
+}
+
+// Compara dos filas según las claves; a igualdad decide la posición en la tabla
+static int compare_rows(const Table* table, const SortKey* keys, int num_keys, int a, int b) {
+    for (int k = 0; k < num_keys; k++) {
+        int col = keys[k].column;
+        int cmp = compare_key_values(table->rows[a].values[col], table->rows[b].values[col],
+                                     table->columns[col].type);
+        if (cmp != 0) return keys[k].descending ? -cmp : cmp;
+    }
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * Radix sort para claves numéricas
+ */
+
+// Convierte un valor numérico en una clave sin signo con el mismo orden
+static uint32_t radix_key(Value value, DataType type, int descending) {
+    uint32_t key;
+
+    if (type == TYPE_FLOAT) {
+        float f = value.float_val == 0 ? 0 : value.float_val;
+        memcpy(&key, &f, sizeof(key));
+        // Los negativos se invierten por completo; los positivos solo cambian el signo
+        key = (key & 0x80000000u) ? ~key : key | 0x80000000u;
+    } else {
+        int x = type == TYPE_BOOL ? (value.bool_val != 0) : value.int_val;
+        key = (uint32_t)x ^ 0x80000000u;
+    }
+
+    return descending ? ~key : key;
+}
+
+// Radix sort LSD de 8 bits por pasada sobre pares (clave, fila); es estable
+static int radix_sort_rows(const Table* table, int* rows, int num_rows, const SortKey* key) {
+    uint64_t* items = (uint64_t*)malloc(num_rows * sizeof(uint64_t));
+    uint64_t* buffer = (uint64_t*)malloc(num_rows * sizeof(uint64_t));
+    if (!items || !buffer) {
+        free(items);
+        free(buffer);
+        return -1;
+    }
+
+    // La clave ocupa los 32 bits altos y la fila los bajos
+    DataType type = table->columns[key->column].type;
+    for (int i = 0; i < num_rows; i++) {
+        uint32_t k = radix_key(table->rows[rows[i]].values[key->column], type, key->descending);
+        items[i] = ((uint64_t)k << 32) | (uint32_t)rows[i];
+    }
+
+    for (int shift = 32; shift < 64; shift += 8) {
+        int counts[257] = {0};
+
+        for (int i = 0; i < num_rows; i++) {
+            counts[((items[i] >> shift) & 0xff) + 1]++;
+        }
+
+        // Todas las claves comparten este byte: la pasada no cambia nada
+        if (counts[((items[0] >> shift) & 0xff) + 1] == num_rows) continue;
+
+        for (int b = 0; b < 256; b++) counts[b + 1] += counts[b];
+
+        for (int i = 0; i < num_rows; i++) {
+            buffer[counts[(items[i] >> shift) & 0xff]++] = items[i];
+        }
+
+        uint64_t* swap = items;
+        items = buffer;
+        buffer = swap;
+    }
+
+    for (int i = 0; i < num_rows; i++) {
+        rows[i] = (int)(uint32_t)items[i];
+    }
+
+    free(items);
+    free(buffer);
+    return 0;
+}
+
+/**
+ * Ordenación por mezcla para el resto de claves
+ */
+
+static int merge_sort_rows(const Table* table, int* rows, int num_rows,
+                           const SortKey* keys, int num_keys) {
+    int* buffer = (int*)malloc(num_rows * sizeof(int));
+    if (!buffer) return -1;
+
+    int* src = rows;
+    int* dst = buffer;
+
+    // Mezclas de abajo arriba: tramos de 1, 2, 4... elementos
+    for (int width = 1; width < num_rows; width *= 2) {
+        for (int start = 0; start < num_rows; start += 2 * width) {
+            int mid = start + width < num_rows ? start + width : num_rows;
+            int end = start + 2 * width < num_rows ? start + 2 * width : num_rows;
+            int i = start, j = mid, out = start;
+
+            while (i < mid && j < end) {
+                if (compare_rows(table, keys, num_keys, src[j], src[i]) < 0) {
+                    dst[out++] = src[j++];
+                } else {
+                    dst[out++] = src[i++];
+                }
+            }
+            while (i < mid) dst[out++] = src[i++];
+            while (j < end) dst[out++] = src[j++];
+        }
+
+        int* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != rows) memcpy(rows, src, num_rows * sizeof(int));
+
+    free(buffer);
+    return 0;
+}
+
+// Ordena índices de filas según las claves
+int sort_rows(const Table* table, int* rows, int num_rows, const SortKey* keys, int num_keys) {
+    if (num_rows < 2 || num_keys == 0) return 0;
+
+    if (num_keys == 1 && table->columns[keys[0].column].type != TYPE_STRING) {
+        return radix_sort_rows(table, rows, num_rows, &keys[0]);
+    }
+
+    return merge_sort_rows(table, rows, num_rows, keys, num_keys);
+}
+
+/**
+ * Montículo acotado (top-N)
+ */
+
+// Indica si la fila a va después que b (en la raíz queda la última conservada)
+static int topn_after(const TopN* topn, int a, int b) {
+    return compare_rows(topn->table, topn->keys, topn->num_keys, a, b) > 0;
+}
+
+static void topn_sift_down(TopN* topn, int pos, int size) {
+    int* heap = topn->rows;
+
+    while (1) {
+        int largest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+
+        if (left < size && topn_after(topn, heap[left], heap[largest])) largest = left;
+        if (right < size && topn_after(topn, heap[right], heap[largest])) largest = right;
+        if (largest == pos) return;
+
+        int swap = heap[pos];
+        heap[pos] = heap[largest];
+        heap[largest] = swap;
+        pos = largest;
+    }
+}
+
+int topn_init(TopN* topn, const Table* table, const SortKey* keys, int num_keys, int k) {
+    memset(topn, 0, sizeof(TopN));
+
+    topn->table = table;
+    topn->keys = keys;
+    topn->num_keys = num_keys;
+    topn->capacity = k;
+    topn->rows = (int*)malloc((k > 0 ? k : 1) * sizeof(int));
+
+    return topn->rows ? 0 : -1;
+}
+
+void topn_push(TopN* topn, int row) {
+    int* heap = topn->rows;
+
+    if (topn->size < topn->capacity) {
+        // Subir la fila nueva hasta su posición
+        int pos = topn->size++;
+        heap[pos] = row;
+
+        while (pos > 0) {
+            int parent = (pos - 1) / 2;
+            if (!topn_after(topn, heap[pos], heap[parent])) break;
+
+            int swap = heap[pos];
+            heap[pos] = heap[parent];
+            heap[parent] = swap;
+            pos = parent;
+        }
+        return;
+    }
+
+    // Lleno: solo entra si va antes que la última conservada
+    if (topn->capacity > 0 && topn_after(topn, heap[0], row)) {
+        heap[0] = row;
+        topn_sift_down(topn, 0, topn->size);
+    }
+}
+
+int topn_finish(TopN* topn) {
+    // Heapsort en el sitio: la raíz (la última) se mueve al final en cada paso
+    for (int end = topn->size - 1; end > 0; end--) {
+        int swap = topn->rows[0];
+        topn->rows[0] = topn->rows[end];
+        topn->rows[end] = swap;
+        topn_sift_down(topn, 0, end);
+    }
+
+    return topn->size;
+}
+
+void topn_free(TopN* topn) {
+    free(topn->rows);
+    topn->rows = NULL;
+}
@@ -0,0 +1,37 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "../db/table.h"
+
+// Clave de ordenación: columna de la tabla y dirección
+typedef struct {
+    int column;
+    int descending;
+} SortKey;
+
+// Montículo acotado que conserva las k primeras filas según las claves
+// (la peor de las conservadas está en la raíz y se sustituye al llegar una mejor)
+typedef struct {
+    const Table* table;
+    const SortKey* keys;
+    int num_keys;
+    int* rows;            // Filas conservadas
+    int size;
+    int capacity;         // k
+} TopN;
+
+// Ordena índices de filas según las claves; las filas con claves iguales
+// conservan su orden. Con una sola clave INT, FLOAT o BOOL usa radix sort.
+// Devuelve 0 si tuvo éxito, -1 si faltó memoria.
+int sort_rows(const Table* table, int* rows, int num_rows, const SortKey* keys, int num_keys);
+
+// Montículo para seleccionar las k primeras filas en O(n log k)
+int topn_init(TopN* topn, const Table* table, const SortKey* keys, int num_keys, int k);
+void topn_push(TopN* topn, int row);
+
+// Ordena las filas conservadas (quedan en topn->rows) y devuelve cuántas son
+int topn_finish(TopN* topn);
+
+void topn_free(TopN* topn);
+
+#endif /* SORT_H */
@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "transaction.h"
+#include "../db/mvcc.h"
+#include "../utils/output.h"
+
+// Transacción explícita (BEGIN ... COMMIT/ROLLBACK)
+typedef struct {
+    RowVersion id;                 // Versión pendiente de todos sus cambios
+    WriteSet* undo;                // Registro de deshacer: cambios de cada sentencia en orden
+    int num_undo;
+    int undo_capacity;
+    Table** tables;                // Tablas bloqueadas por la transacción
+    int num_tables;
+    int tables_capacity;
+} Transaction;
+
+// Cada hilo tiene su propia transacción, como una sesión
+static __thread Transaction* current = NULL;
+
+// Duplica la capacidad de un array si está lleno (0 si hay sitio)
+static int ensure_capacity(void** items, int count, int* capacity, size_t item_size) {
+    if (count < *capacity) return 0;
+
+    int new_capacity = *capacity == 0 ? 8 : *capacity * 2;
+    void* grown = realloc(*items, new_capacity * item_size);
+    if (!grown) return -1;
+
+    *items = grown;
+    *capacity = new_capacity;
+    return 0;
+}
+
+static int transaction_holds(const Transaction* txn, const Table* table) {
+    for (int i = 0; i < txn->num_tables; i++) {
+        if (txn->tables[i] == table) return 1;
+    }
+    return 0;
+}
+
+// Bloquea una tabla para modificarla sin esperar indefinidamente a otra transacción
+static int transaction_lock_table(Table* table, ValidationResult* result) {
+    if (table_lock_write_timeout(table, TRANSACTION_LOCK_TIMEOUT_MS) == 0) return 0;
+
+    char error[200];
+    snprintf(error, sizeof(error), "La tabla '%s' está bloqueada por otra transacción", table->name);
+    validator_set_error(result, 416, error);
+    return -1;
+}
+
+// Suelta las tablas y el catálogo y libera la transacción del hilo
+static void transaction_finish(void) {
+    for (int i = 0; i < current->num_undo; i++) {
+        free(current->undo[i].old_rows);
+    }
+
+    // Ya se pueden recoger las versiones que dejó la transacción: sus índices
+    // de fila dejan de usarse
+    RowVersion oldest = mvcc_oldest_read();
+    for (int i = 0; i < current->num_tables; i++) {
+        Table* table = current->tables[i];
+        table->write = 0;
+        table_collect_garbage(table, oldest);
+        table_unlock(table);
+    }
+    db_unlock();
+
+    free(current->undo);
+    free(current->tables);
+    free(current);
+    current = NULL;
+}
+
+int transaction_begin(ValidationResult* result) {
+    if (current) {
+        validator_set_error(result, 414, "Ya hay una transacción en curso");
+        return -1;
+    }
+
+    current = (Transaction*)calloc(1, sizeof(Transaction));
+    if (!current) {
+        validator_set_error(result, 404, "Error de memoria al iniciar la transacción");
+        return -1;
+    }
+    current->id = mvcc_new_write();
+
+    // El esquema no puede cambiar mientras la transacción guarde índices de filas
+    db_lock_read();
+
+    output_printf("Transacción iniciada\n");
+    return 0;
+}
+
+int transaction_commit(ValidationResult* result) {
+    if (!current) {
+        validator_set_error(result, 415, "No hay ninguna transacción en curso");
+        return -1;
+    }
+
+    // Todos los cambios se publican con una única versión
+    int changes = 0;
+    if (current->num_undo > 0) {
+        RowVersion version = mvcc_begin_commit();
+        for (int i = 0; i < current->num_undo; i++) {
+            WriteSet* ws = &current->undo[i];
+            table_commit_versions(ws->table, ws->first_new, ws->num_new, ws->old_rows, ws->num_old, version);
+            changes += ws->num_new > ws->num_old ? ws->num_new : ws->num_old;
+        }
+        mvcc_end_commit(version);
+    }
+
+    transaction_finish();
+    output_printf("Transacción confirmada (%d fila%s modificada%s)\n", changes,
+                  changes == 1 ? "" : "s", changes == 1 ? "" : "s");
+    return 0;
+}
+
+int transaction_rollback(ValidationResult* result) {
+    if (!current) {
+        validator_set_error(result, 415, "No hay ninguna transacción en curso");
+        return -1;
+    }
+
+    // Deshacer en orden inverso: cada sentencia solo quita las filas que añadió
+    for (int i = current->num_undo - 1; i >= 0; i--) {
+        WriteSet* ws = &current->undo[i];
+        table_rollback_versions(ws->table, ws->first_new, ws->old_rows, ws->num_old);
+    }
+
+    transaction_finish();
+    output_printf("Transacción deshecha\n");
+    return 0;
+}
+
+int transaction_active(void) {
+    return current != NULL;
+}
+
+RowVersion transaction_current_write(void) {
+    return current ? current->id : 0;
+}
+
+int transaction_write_begin(Table* table, WriteSet* ws, ValidationResult* result) {
+    memset(ws, 0, sizeof(WriteSet));
+    ws->table = table;
+
+    if (!current) {
+        // Una transacción abierta puede tener la tabla hasta su COMMIT o ROLLBACK
+        if (transaction_lock_table(table, result) != 0) return -1;
+        ws->txn = mvcc_new_write();
+    } else {
+        if (!transaction_holds(current, table)) {
+            if (ensure_capacity((void**)&current->tables, current->num_tables,
+                                &current->tables_capacity, sizeof(Table*)) != 0) {
+                validator_set_error(result, 404, "Error de memoria al bloquear la tabla");
+                return -1;
+            }
+
+            // Dos transacciones que se esperan mutuamente acaban fallando una sentencia
+            if (transaction_lock_table(table, result) != 0) return -1;
+            current->tables[current->num_tables++] = table;
+        }
+        ws->txn = current->id;
+    }
+
+    // Quien modifica la tabla ve sus propios cambios pendientes
+    table->write = ws->txn;
+    ws->first_new = table->num_rows;
+    return 0;
+}
+
+int transaction_write_end(WriteSet* ws, int status, ValidationResult* result) {
+    Table* table = ws->table;
+
+    if (!current) {
+        if (status == 0) {
+            RowVersion version = mvcc_begin_commit();
+            table_commit_versions(table, ws->first_new, ws->num_new, ws->old_rows, ws->num_old, version);
+            mvcc_end_commit(version);
+        } else {
+            table_rollback_versions(table, ws->first_new, ws->old_rows, ws->num_old);
+        }
+
+        free(ws->old_rows);
+        table->write = 0;
+        table_collect_garbage(table, mvcc_oldest_read());
+        table_unlock(table);
+        return status;
+    }
+
+    // Una sentencia que falla se deshace sola; la transacción sigue abierta
+    if (status == 0 && (ws->num_new > 0 || ws->num_old > 0) &&
+        ensure_capacity((void**)&current->undo, current->num_undo,
+                        &current->undo_capacity, sizeof(WriteSet)) != 0) {
+        validator_set_error(result, 404, "Error de memoria al guardar los cambios de la transacción");
+        status = -1;
+    }
+
+    if (status != 0) {
+        table_rollback_versions(table, ws->first_new, ws->old_rows, ws->num_old);
+        free(ws->old_rows);
+        return status;
+    }
+
+    if (ws->num_new > 0 || ws->num_old > 0) {
+        current->undo[current->num_undo++] = *ws;
+    } else {
+        free(ws->old_rows);
+    }
+    return 0;
+}
+
+void transaction_cleanup(void) {
+    if (!current) return;
+
+    ValidationResult result = {0};
+    transaction_rollback(&result);
+}
@@ -0,0 +1,47 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include "../db/database.h"
+#include "../parser/validator.h"
+
+// Milisegundos que una escritura espera por una tabla que modifica otra transacción
+// antes de dar la sentencia por fallida (evita interbloqueos y esperas sin fin)
+#define TRANSACTION_LOCK_TIMEOUT_MS 5000
+
+// Cambios de una sentencia INSERT, UPDATE o DELETE sobre una tabla. Dentro de una
+// transacción forman su registro de deshacer hasta COMMIT o ROLLBACK.
+typedef struct {
+    Table* table;
+    RowVersion txn;                // Versión pendiente con la que se marcan los cambios
+    int first_new;                 // Primera fila añadida
+    int num_new;                   // Filas añadidas
+    int* old_rows;                 // Filas eliminadas o sustituidas
+    int num_old;
+} WriteSet;
+
+// BEGIN, COMMIT y ROLLBACK de la transacción del hilo actual (0 si tuvo éxito, -1 si hubo
+// error). La transacción mantiene el catálogo en lectura y bloqueadas las tablas que
+// modifica hasta terminar; sus cambios se confirman todos con una sola versión.
+int transaction_begin(ValidationResult* result);
+int transaction_commit(ValidationResult* result);
+int transaction_rollback(ValidationResult* result);
+
+// Indica si el hilo actual tiene una transacción en curso
+int transaction_active(void);
+
+// Versión pendiente de la transacción en curso, cuyos cambios ven sus lecturas (0 si no hay)
+RowVersion transaction_current_write(void);
+
+// Prepara una escritura sobre table: la bloquea (fuera de una transacción, solo hasta
+// transaction_write_end) e inicializa ws
+int transaction_write_begin(Table* table, WriteSet* ws, ValidationResult* result);
+
+// Termina una escritura con el estado de la sentencia. Si falló se deshacen sus cambios;
+// si no, se confirman o, dentro de una transacción, se añaden a su registro de deshacer.
+// Devuelve el estado final de la sentencia.
+int transaction_write_end(WriteSet* ws, int status, ValidationResult* result);
+
+// Deshace la transacción del hilo actual si quedó abierta
+void transaction_cleanup(void);
+
+#endif /* TRANSACTION_H */
@@ -1,22 +1,66 @@
 #include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "cli/cli.h"
+#include "cli/batch.h"
 #include "db/database.h"
+#include "db/result.h"
 
-int main(){
+static void print_usage(const char *program) {
+    printf("Uso: %s [-f script.sql] [--format table|csv|tsv|jsonl|binary]\n", program);
+    printf("  -f script   Ejecuta el script y termina (también si la entrada es una tubería)\n");
+    printf("  --format f  Formato de los resultados (por defecto table)\n");
+}
+
+int main(int argc, char *argv[]){
+    const char *script = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        ResultFormat format;
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            script = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc &&
+            result_format_from_name(argv[i + 1], &format) == 0) {
+            result_set_format(format);
+            i++;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Sin terminal (o con -f) se ejecuta el script sin readline
+    int fd = STDIN_FILENO;
+    if (script) {
+        fd = open(script, O_RDONLY);
+        if (fd < 0) {
+            printf("Error: No se pudo abrir el script '%s'\n", script);
+            return 1;
+        }
+    }
+    int batch = script || !isatty(STDIN_FILENO);
+    
     // Inicializar la base de datos
     db_init();
     
     // Inicializar la interfaz de línea de comandos
     cli_init();
     
-    // Mostrar mensaje de bienvenida
-    printf("NQL Database CLI - Type 'help' for commands, 'exit' to quit\n");
-    
-    // Ejecutar el bucle principal de la CLI
-    cli_run();
+    int status = 0;
+    if (batch) {
+        status = batch_run(fd) == 0 ? 0 : 1;
+        if (script) close(fd);
+    } else {
+        // Mostrar mensaje de bienvenida
+        printf("NQL Database CLI - Type 'help' for commands, 'exit' to quit\n");
+        
+        // Ejecutar el bucle principal de la CLI
+        cli_run();
+    }
     
     // Limpieza al salir
     cli_cleanup();
     db_cleanup();
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nql.h"
+#include "parser/parser.h"
+#include "executor/prepared.h"
+#include "executor/plan_cache.h"
+#include "executor/transaction.h"
+#include "utils/scheduler.h"
+
+// Sentencia preparada de la API pública
+struct nql_stmt {
+    PreparedStatement *prepared;
+    LiteralData *params;    // Valores enlazados (las cadenas pertenecen a la sentencia)
+};
+
+// Último error de cada hilo, como el resto del estado de la sesión
+static __thread char last_error[256] = "";
+
+static void set_last_error(const char *message) {
+    snprintf(last_error, sizeof(last_error), "%s", message ? message : "");
+}
+
+// Copia el error de un resultado de validación
+static void set_last_error_from(ValidationResult *result) {
+    set_last_error(result->error_message ? result->error_message : "Error desconocido");
+}
+
+int nql_init(void) {
+    db_init();
+    set_last_error("");
+    return 0;
+}
+
+void nql_shutdown(void) {
+    transaction_cleanup();
+    prepared_cleanup();
+    plan_cache_cleanup();
+    scheduler_shutdown();
+    db_cleanup();
+}
+
+const char *nql_last_error(void) {
+    return last_error;
+}
+
+int nql_exec(const char *sql) {
+    if (!sql) {
+        set_last_error("Sentencia vacía");
+        return -1;
+    }
+
+    ValidationResult *result = validator_create_result();
+    if (!result) {
+        set_last_error("Error de memoria al ejecutar la sentencia");
+        return -1;
+    }
+
+    int status = plan_cache_execute(sql, db_get_database(), result);
+    if (status != 0) {
+        set_last_error_from(result);
+    }
+
+    validator_free_result(result);
+    return status;
+}
+
+nql_stmt *nql_prepare(const char *sql) {
+    if (!sql) {
+        set_last_error("Sentencia vacía");
+        return NULL;
+    }
+
+    Parser *parser = parser_create(sql);
+    if (!parser) {
+        set_last_error("Error de memoria al crear el parser");
+        return NULL;
+    }
+
+    ASTNode *stmt = parser_parse(parser);
+    if (!stmt || parser_has_error(parser)) {
+        set_last_error(parser_has_error(parser) ? parser_get_error(parser) : "Sentencia no válida");
+        if (stmt) ast_free_node(stmt);
+        parser_free(parser);
+        return NULL;
+    }
+
+    int num_params = parser->param_count;
+    parser_free(parser);
+
+    ValidationResult *result = validator_create_result();
+    if (!result) {
+        ast_free_node(stmt);
+        set_last_error("Error de memoria al validar la sentencia");
+        return NULL;
+    }
+
+    PreparedStatement *prepared = prepared_create(NULL, stmt, num_params, db_get_database(), result);
+    if (!prepared) {
+        set_last_error_from(result);
+        validator_free_result(result);
+        ast_free_node(stmt);
+        return NULL;
+    }
+    validator_free_result(result);
+
+    nql_stmt *handle = (nql_stmt *)calloc(1, sizeof(nql_stmt));
+    LiteralData *params = (LiteralData *)calloc(num_params > 0 ? num_params : 1, sizeof(LiteralData));
+    if (!handle || !params) {
+        free(handle);
+        free(params);
+        prepared_free(prepared);
+        set_last_error("Error de memoria al preparar la sentencia");
+        return NULL;
+    }
+
+    handle->prepared = prepared;
+    handle->params = params;
+
+    // Los parámetros sin enlazar valen NULL
+    for (int i = 0; i < num_params; i++) {
+        params[i].lit_type = LIT_NULL;
+    }
+
+    return handle;
+}
+
+int nql_param_count(const nql_stmt *stmt) {
+    return stmt ? stmt->prepared->num_params : 0;
+}
+
+// Obtiene el parámetro indicado (desde 1) liberando su valor anterior
+static LiteralData *param_slot(nql_stmt *stmt, int index) {
+    if (!stmt || index < 1 || index > stmt->prepared->num_params) {
+        set_last_error("Índice de parámetro fuera de rango");
+        return NULL;
+    }
+
+    LiteralData *slot = &stmt->params[index - 1];
+    if (slot->lit_type == LIT_STRING) {
+        free(slot->string_value);
+    }
+    memset(slot, 0, sizeof(LiteralData));
+    slot->lit_type = LIT_NULL;
+
+    return slot;
+}
+
+int nql_bind_int(nql_stmt *stmt, int index, int value) {
+    LiteralData *slot = param_slot(stmt, index);
+    if (!slot) return -1;
+
+    slot->lit_type = LIT_INTEGER;
+    slot->int_value = value;
+    return 0;
+}
+
+int nql_bind_float(nql_stmt *stmt, int index, double value) {
+    LiteralData *slot = param_slot(stmt, index);
+    if (!slot) return -1;
+
+    slot->lit_type = LIT_FLOAT;
+    slot->float_value = value;
+    return 0;
+}
+
+int nql_bind_string(nql_stmt *stmt, int index, const char *value) {
+    LiteralData *slot = param_slot(stmt, index);
+    if (!slot) return -1;
+    if (!value) return 0;
+
+    slot->string_value = strdup(value);
+    if (!slot->string_value) {
+        set_last_error("Error de memoria al enlazar el parámetro");
+        return -1;
+    }
+    slot->lit_type = LIT_STRING;
+    return 0;
+}
+
+int nql_bind_bool(nql_stmt *stmt, int index, int value) {
+    LiteralData *slot = param_slot(stmt, index);
+    if (!slot) return -1;
+
+    slot->lit_type = LIT_BOOLEAN;
+    slot->bool_value = value != 0;
+    return 0;
+}
+
+int nql_bind_null(nql_stmt *stmt, int index) {
+    return param_slot(stmt, index) ? 0 : -1;
+}
+
+int nql_execute(nql_stmt *stmt) {
+    if (!stmt) {
+        set_last_error("Sentencia no válida");
+        return -1;
+    }
+
+    ValidationResult *result = validator_create_result();
+    if (!result) {
+        set_last_error("Error de memoria al ejecutar la sentencia");
+        return -1;
+    }
+
+    int status = prepared_execute(stmt->prepared, stmt->params, stmt->prepared->num_params,
+                                  db_get_database(), result);
+    if (status != 0) {
+        set_last_error_from(result);
+    }
+
+    validator_free_result(result);
+    return status;
+}
+
+void nql_clear_bindings(nql_stmt *stmt) {
+    if (!stmt) return;
+
+    for (int i = 1; i <= stmt->prepared->num_params; i++) {
+        param_slot(stmt, i);
+    }
+}
+
+void nql_finalize(nql_stmt *stmt) {
+    if (!stmt) return;
+
+    nql_clear_bindings(stmt);
+    free(stmt->params);
+    prepared_free(stmt->prepared);
+    free(stmt);
+}
@@ -1,7 +1,35 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include "ast.h"
+#include "../utils/arena.h"
+
+/**
+ * Reserva de memoria de los nodos: con malloc o, mientras el hilo tiene una arena
+ * (ast_use_arena), de la arena
+ */
+
+static __thread Arena* current_arena = NULL;
+
+Arena* ast_use_arena(Arena* arena) {
+    Arena* previous = current_arena;
+    current_arena = arena;
+    return previous;
+}
+
+static void* ast_alloc(size_t size) {
+    return current_arena ? arena_alloc(current_arena, size) : malloc(size);
+}
+
+static char* ast_strdup(const char* text) {
+    return current_arena ? arena_strdup(current_arena, text) : strdup(text);
+}
+
+// Libera algo reservado con ast_alloc (lo de la arena se libera con ella)
+static void ast_release(void* memory) {
+    if (!current_arena) free(memory);
+}
 
 /**
  * Funciones auxiliares privadas para liberar cada tipo específico de datos
@@ -11,6 +39,7 @@ static void free_select_stmt(void* data) {
     SelectStmtData* stmt_data = (SelectStmtData*)data;
     if (stmt_data) {
         if (stmt_data->table_name) free(stmt_data->table_name);
+        if (stmt_data->join_table) free(stmt_data->join_table);
         // Los nodos columns y where_clause se liberan en ast_free_node
         free(stmt_data);
     }
@@ -86,6 +115,9 @@ static void free_column_list(void* data) {
             }
             free(list_data->columns);
         }
+        free(list_data->column_indices);
+        free(list_data->aggregates);
+        free(list_data->descending);
         free(list_data);
     }
 }
@@ -152,15 +184,51 @@ static void free_literal(void* data) {
     }
 }
 
+static void free_parameter(void* data) {
+    free(data);
+}
+
+static void free_prepare_stmt(void* data) {
+    PrepareStmtData* stmt_data = (PrepareStmtData*)data;
+    if (stmt_data) {
+        if (stmt_data->name) free(stmt_data->name);
+        // El nodo statement se libera en ast_free_node
+        free(stmt_data);
+    }
+}
+
+static void free_execute_stmt(void* data) {
+    ExecuteStmtData* stmt_data = (ExecuteStmtData*)data;
+    if (stmt_data) {
+        if (stmt_data->name) free(stmt_data->name);
+        // El nodo arguments se libera en ast_free_node
+        free(stmt_data);
+    }
+}
+
+static void free_explain_stmt(void* data) {
+    // El nodo statement se libera en ast_free_node
+    free(data);
+}
+
+static void free_deallocate_stmt(void* data) {
+    DeallocateStmtData* stmt_data = (DeallocateStmtData*)data;
+    if (stmt_data) {
+        if (stmt_data->name) free(stmt_data->name);
+        free(stmt_data);
+    }
+}
+
 /**
  * Funciones de creación de nodos
  */
 
 ASTNode* ast_create_node(ASTNodeType type) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = (ASTNode*)ast_alloc(sizeof(ASTNode));
     if (!node) return NULL;
     
     node->type = type;
+    node->in_arena = current_arena != NULL;
     node->data = NULL;
     node->free_data = NULL;
     node->parent = NULL;
@@ -170,19 +238,25 @@ ASTNode* ast_create_node(ASTNodeType type) {
     return node;
 }
 
-ASTNode* ast_create_select(char* table_name, ASTNode* columns, ASTNode* where) {
+ASTNode* ast_create_select(char* table_name, ASTNode* columns, ASTNode* where, ASTNode* group_by) {
     ASTNode* node = ast_create_node(NODE_SELECT_STMT);
     if (!node) return NULL;
     
-    SelectStmtData* data = (SelectStmtData*)malloc(sizeof(SelectStmtData));
+    SelectStmtData* data = (SelectStmtData*)ast_alloc(sizeof(SelectStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
+    data->join_table = NULL;
+    data->join_condition = NULL;
     data->columns = columns;
     data->where_clause = where;
+    data->group_by = group_by;
+    data->order_by = NULL;
+    data->limit = NULL;
+    data->offset = NULL;
     
     node->data = data;
     node->free_data = free_select_stmt;
@@ -190,6 +264,7 @@ ASTNode* ast_create_select(char* table_name, ASTNode* columns, ASTNode* where) {
     // Establecer relaciones padre-hijo
     if (columns) columns->parent = node;
     if (where) where->parent = node;
+    if (group_by) group_by->parent = node;
     
     return node;
 }
@@ -198,14 +273,21 @@ ASTNode* ast_create_insert(char* table_name, ASTNode* values) {
     ASTNode* node = ast_create_node(NODE_INSERT_STMT);
     if (!node) return NULL;
     
-    InsertStmtData* data = (InsertStmtData*)malloc(sizeof(InsertStmtData));
+    InsertStmtData* data = (InsertStmtData*)ast_alloc(sizeof(InsertStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
     data->values = values;
+    data->num_rows = 0;
+    
+    // Cada fila es una lista de valores enlazada con la siguiente
+    for (ASTNode* row = values; row; row = row->next) {
+        row->parent = node;
+        data->num_rows++;
+    }
     
     node->data = data;
     node->free_data = free_insert_stmt;
@@ -220,13 +302,13 @@ ASTNode* ast_create_update(char* table_name, ASTNode* assignments, ASTNode* wher
     ASTNode* node = ast_create_node(NODE_UPDATE_STMT);
     if (!node) return NULL;
     
-    UpdateStmtData* data = (UpdateStmtData*)malloc(sizeof(UpdateStmtData));
+    UpdateStmtData* data = (UpdateStmtData*)ast_alloc(sizeof(UpdateStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
     data->assignments = assignments;
     data->where_clause = where;
     
@@ -244,13 +326,13 @@ ASTNode* ast_create_delete(char* table_name, ASTNode* where) {
     ASTNode* node = ast_create_node(NODE_DELETE_STMT);
     if (!node) return NULL;
     
-    DeleteStmtData* data = (DeleteStmtData*)malloc(sizeof(DeleteStmtData));
+    DeleteStmtData* data = (DeleteStmtData*)ast_alloc(sizeof(DeleteStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
     data->where_clause = where;
     
     node->data = data;
@@ -266,13 +348,13 @@ ASTNode* ast_create_create_table(char* table_name, ASTNode* columns) {
     ASTNode* node = ast_create_node(NODE_CREATE_TABLE_STMT);
     if (!node) return NULL;
     
-    CreateTableStmtData* data = (CreateTableStmtData*)malloc(sizeof(CreateTableStmtData));
+    CreateTableStmtData* data = (CreateTableStmtData*)ast_alloc(sizeof(CreateTableStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
     data->columns = columns;
     
     node->data = data;
@@ -288,13 +370,13 @@ ASTNode* ast_create_alter_table(char* table_name, ASTNode* column) {
     ASTNode* node = ast_create_node(NODE_ALTER_TABLE_STMT);
     if (!node) return NULL;
     
-    AlterTableStmtData* data = (AlterTableStmtData*)malloc(sizeof(AlterTableStmtData));
+    AlterTableStmtData* data = (AlterTableStmtData*)ast_alloc(sizeof(AlterTableStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
     data->column = column;
     
     node->data = data;
@@ -310,13 +392,13 @@ ASTNode* ast_create_drop_table(char* table_name) {
     ASTNode* node = ast_create_node(NODE_DROP_TABLE_STMT);
     if (!node) return NULL;
     
-    DropTableStmtData* data = (DropTableStmtData*)malloc(sizeof(DropTableStmtData));
+    DropTableStmtData* data = (DropTableStmtData*)ast_alloc(sizeof(DropTableStmtData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->table_name = table_name ? strdup(table_name) : NULL;
+    data->table_name = table_name ? ast_strdup(table_name) : NULL;
     
     node->data = data;
     node->free_data = free_drop_table_stmt;
@@ -328,13 +410,13 @@ ASTNode* ast_create_column_def(char* name, int data_type, int max_length, int is
     ASTNode* node = ast_create_node(NODE_COLUMN_DEF);
     if (!node) return NULL;
     
-    ColumnDefData* data = (ColumnDefData*)malloc(sizeof(ColumnDefData));
+    ColumnDefData* data = (ColumnDefData*)ast_alloc(sizeof(ColumnDefData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->name = name ? strdup(name) : NULL;
+    data->name = name ? ast_strdup(name) : NULL;
     data->data_type = data_type;
     data->max_length = max_length;
     data->is_primary_key = is_primary_key;
@@ -350,25 +432,37 @@ ASTNode* ast_create_column_list(int is_all, char** columns, int count) {
     ASTNode* node = ast_create_node(NODE_COLUMN_LIST);
     if (!node) return NULL;
     
-    ColumnListData* data = (ColumnListData*)malloc(sizeof(ColumnListData));
+    ColumnListData* data = (ColumnListData*)ast_alloc(sizeof(ColumnListData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
     data->is_all = is_all;
     data->count = count;
+    data->column_indices = NULL;
+    data->aggregates = NULL;
+    data->descending = NULL;
     
     if (count > 0 && columns) {
-        data->columns = (char**)malloc(count * sizeof(char*));
+        data->columns = (char**)ast_alloc(count * sizeof(char*));
         if (!data->columns) {
-            free(data);
-            free(node);
+            ast_release(data);
+            ast_release(node);
+            return NULL;
+        }
+        
+        // Los índices los rellena el validador
+        data->column_indices = (int*)ast_alloc(count * sizeof(int));
+        if (!data->column_indices) {
+            ast_release(data->columns);
+            ast_release(data);
+            ast_release(node);
             return NULL;
         }
         
         for (int i = 0; i < count; i++) {
-            data->columns[i] = columns[i] ? strdup(columns[i]) : NULL;
+            data->columns[i] = columns[i] ? ast_strdup(columns[i]) : NULL;
         }
     } else {
         data->columns = NULL;
@@ -384,19 +478,19 @@ ASTNode* ast_create_value_list(ASTNode** values, int count) {
     ASTNode* node = ast_create_node(NODE_VALUE_LIST);
     if (!node) return NULL;
     
-    ValueListData* data = (ValueListData*)malloc(sizeof(ValueListData));
+    ValueListData* data = (ValueListData*)ast_alloc(sizeof(ValueListData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
     data->count = count;
     
     if (count > 0 && values) {
-        data->values = (ASTNode**)malloc(count * sizeof(ASTNode*));
+        data->values = (ASTNode**)ast_alloc(count * sizeof(ASTNode*));
         if (!data->values) {
-            free(data);
-            free(node);
+            ast_release(data);
+            ast_release(node);
             return NULL;
         }
         
@@ -418,9 +512,9 @@ ASTNode* ast_create_where_clause(ASTNode* condition) {
     ASTNode* node = ast_create_node(NODE_WHERE_CLAUSE);
     if (!node) return NULL;
     
-    WhereClauseData* data = (WhereClauseData*)malloc(sizeof(WhereClauseData));
+    WhereClauseData* data = (WhereClauseData*)ast_alloc(sizeof(WhereClauseData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -439,13 +533,14 @@ ASTNode* ast_create_assignment(char* column_name, ASTNode* value) {
     ASTNode* node = ast_create_node(NODE_ASSIGNMENT);
     if (!node) return NULL;
     
-    AssignmentData* data = (AssignmentData*)malloc(sizeof(AssignmentData));
+    AssignmentData* data = (AssignmentData*)ast_alloc(sizeof(AssignmentData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->column_name = column_name ? strdup(column_name) : NULL;
+    data->column_name = column_name ? ast_strdup(column_name) : NULL;
+    data->column_index = -1;
     data->value = value;
     
     node->data = data;
@@ -461,9 +556,9 @@ ASTNode* ast_create_binary_expr(BinaryOpType op, ASTNode* left, ASTNode* right)
     ASTNode* node = ast_create_node(NODE_BINARY_EXPR);
     if (!node) return NULL;
     
-    BinaryExprData* data = (BinaryExprData*)malloc(sizeof(BinaryExprData));
+    BinaryExprData* data = (BinaryExprData*)ast_alloc(sizeof(BinaryExprData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -485,9 +580,9 @@ ASTNode* ast_create_unary_expr(UnaryOpType op, ASTNode* operand) {
     ASTNode* node = ast_create_node(NODE_UNARY_EXPR);
     if (!node) return NULL;
     
-    UnaryExprData* data = (UnaryExprData*)malloc(sizeof(UnaryExprData));
+    UnaryExprData* data = (UnaryExprData*)ast_alloc(sizeof(UnaryExprData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -507,13 +602,15 @@ ASTNode* ast_create_identifier(char* name) {
     ASTNode* node = ast_create_node(NODE_IDENTIFIER);
     if (!node) return NULL;
     
-    IdentifierData* data = (IdentifierData*)malloc(sizeof(IdentifierData));
+    IdentifierData* data = (IdentifierData*)ast_alloc(sizeof(IdentifierData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
-    data->name = name ? strdup(name) : NULL;
+    data->name = name ? ast_strdup(name) : NULL;
+    data->column_index = -1;
+    data->column_type = -1;
     
     node->data = data;
     node->free_data = free_identifier;
@@ -525,9 +622,9 @@ ASTNode* ast_create_literal_int(int value) {
     ASTNode* node = ast_create_node(NODE_LITERAL);
     if (!node) return NULL;
     
-    LiteralData* data = (LiteralData*)malloc(sizeof(LiteralData));
+    LiteralData* data = (LiteralData*)ast_alloc(sizeof(LiteralData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -544,9 +641,9 @@ ASTNode* ast_create_literal_float(double value) {
     ASTNode* node = ast_create_node(NODE_LITERAL);
     if (!node) return NULL;
     
-    LiteralData* data = (LiteralData*)malloc(sizeof(LiteralData));
+    LiteralData* data = (LiteralData*)ast_alloc(sizeof(LiteralData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -563,14 +660,14 @@ ASTNode* ast_create_literal_string(char* value) {
     ASTNode* node = ast_create_node(NODE_LITERAL);
     if (!node) return NULL;
     
-    LiteralData* data = (LiteralData*)malloc(sizeof(LiteralData));
+    LiteralData* data = (LiteralData*)ast_alloc(sizeof(LiteralData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
     data->lit_type = LIT_STRING;
-    data->string_value = value ? strdup(value) : NULL;
+    data->string_value = value ? ast_strdup(value) : NULL;
     
     node->data = data;
     node->free_data = free_literal;
@@ -582,9 +679,9 @@ ASTNode* ast_create_literal_bool(int value) {
     ASTNode* node = ast_create_node(NODE_LITERAL);
     if (!node) return NULL;
     
-    LiteralData* data = (LiteralData*)malloc(sizeof(LiteralData));
+    LiteralData* data = (LiteralData*)ast_alloc(sizeof(LiteralData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -601,9 +698,9 @@ ASTNode* ast_create_literal_null() {
     ASTNode* node = ast_create_node(NODE_LITERAL);
     if (!node) return NULL;
     
-    LiteralData* data = (LiteralData*)malloc(sizeof(LiteralData));
+    LiteralData* data = (LiteralData*)ast_alloc(sizeof(LiteralData));
     if (!data) {
-        free(node);
+        ast_release(node);
         return NULL;
     }
     
@@ -615,6 +712,119 @@ ASTNode* ast_create_literal_null() {
     return node;
 }
 
+ASTNode* ast_create_parameter(int index) {
+    ASTNode* node = ast_create_node(NODE_PARAMETER);
+    if (!node) return NULL;
+    
+    ParameterData* data = (ParameterData*)ast_alloc(sizeof(ParameterData));
+    if (!data) {
+        ast_release(node);
+        return NULL;
+    }
+    
+    data->index = index;
+    data->expected_type = -1;
+    
+    node->data = data;
+    node->free_data = free_parameter;
+    
+    return node;
+}
+
+ASTNode* ast_create_prepare(char* name, ASTNode* statement, int num_params) {
+    ASTNode* node = ast_create_node(NODE_PREPARE_STMT);
+    if (!node) return NULL;
+    
+    PrepareStmtData* data = (PrepareStmtData*)ast_alloc(sizeof(PrepareStmtData));
+    if (!data) {
+        ast_release(node);
+        return NULL;
+    }
+    
+    data->name = name ? ast_strdup(name) : NULL;
+    data->statement = statement;
+    data->num_params = num_params;
+    
+    node->data = data;
+    node->free_data = free_prepare_stmt;
+    
+    // Establecer relaciones padre-hijo
+    if (statement) statement->parent = node;
+    
+    return node;
+}
+
+ASTNode* ast_create_execute(char* name, ASTNode* arguments) {
+    ASTNode* node = ast_create_node(NODE_EXECUTE_STMT);
+    if (!node) return NULL;
+    
+    ExecuteStmtData* data = (ExecuteStmtData*)ast_alloc(sizeof(ExecuteStmtData));
+    if (!data) {
+        ast_release(node);
+        return NULL;
+    }
+    
+    data->name = name ? ast_strdup(name) : NULL;
+    data->arguments = arguments;
+    
+    node->data = data;
+    node->free_data = free_execute_stmt;
+    
+    // Establecer relaciones padre-hijo
+    if (arguments) arguments->parent = node;
+    
+    return node;
+}
+
+ASTNode* ast_create_deallocate(char* name) {
+    ASTNode* node = ast_create_node(NODE_DEALLOCATE_STMT);
+    if (!node) return NULL;
+    
+    DeallocateStmtData* data = (DeallocateStmtData*)ast_alloc(sizeof(DeallocateStmtData));
+    if (!data) {
+        ast_release(node);
+        return NULL;
+    }
+    
+    data->name = name ? ast_strdup(name) : NULL;
+    
+    node->data = data;
+    node->free_data = free_deallocate_stmt;
+    
+    return node;
+}
+
+// BEGIN, COMMIT y ROLLBACK no tienen datos
+ASTNode* ast_create_transaction(ASTNodeType type) {
+    if (type != NODE_BEGIN_STMT && type != NODE_COMMIT_STMT && type != NODE_ROLLBACK_STMT) {
+        return NULL;
+    }
+    
+    return ast_create_node(type);
+}
+
+ASTNode* ast_create_explain(ASTNode* statement, int analyze, int num_params) {
+    ASTNode* node = ast_create_node(NODE_EXPLAIN_STMT);
+    if (!node) return NULL;
+    
+    ExplainStmtData* data = (ExplainStmtData*)ast_alloc(sizeof(ExplainStmtData));
+    if (!data) {
+        ast_release(node);
+        return NULL;
+    }
+    
+    data->statement = statement;
+    data->analyze = analyze;
+    data->num_params = num_params;
+    
+    node->data = data;
+    node->free_data = free_explain_stmt;
+    
+    if (statement) statement->parent = node;
+    
+    return node;
+}
+
 /**
  * Funciones para manipulación de AST
  */
@@ -640,7 +850,8 @@ ASTNode* ast_get_next_sibling(ASTNode* node) {
 }
 
 void ast_free_node(ASTNode* node) {
-    if (!node) return;
+    // Los nodos de una arena se liberan con ella
+    if (!node || node->in_arena) return;
     
     // Primero liberar recursivamente todos los hijos según el tipo de nodo
     switch (node->type) {
@@ -648,14 +859,27 @@ void ast_free_node(ASTNode* node) {
             if (node->data) {
                 SelectStmtData* data = (SelectStmtData*)node->data;
                 if (data->columns) ast_free_node(data->columns);
+                if (data->join_condition) ast_free_node(data->join_condition);
                 if (data->where_clause) ast_free_node(data->where_clause);
+                if (data->group_by) ast_free_node(data->group_by);
+                if (data->order_by) ast_free_node(data->order_by);
+                if (data->limit) ast_free_node(data->limit);
+                if (data->offset) ast_free_node(data->offset);
             }
             break;
             
         case NODE_INSERT_STMT:
             if (node->data) {
                 InsertStmtData* data = (InsertStmtData*)node->data;
-                if (data->values) ast_free_node(data->values);
+                
+                // Liberar las listas de valores de todas las filas
+                ASTNode* current = data->values;
+                while (current) {
+                    ASTNode* next = current->next;
+                    current->next = NULL;
+                    ast_free_node(current);
+                    current = next;
+                }
             }
             break;
             
@@ -737,6 +961,27 @@ void ast_free_node(ASTNode* node) {
             }
             break;
             
+        case NODE_PREPARE_STMT:
+            if (node->data) {
+                PrepareStmtData* data = (PrepareStmtData*)node->data;
+                if (data->statement) ast_free_node(data->statement);
+            }
+            break;
+            
+        case NODE_EXECUTE_STMT:
+            if (node->data) {
+                ExecuteStmtData* data = (ExecuteStmtData*)node->data;
+                if (data->arguments) ast_free_node(data->arguments);
+            }
+            break;
+            
+        case NODE_EXPLAIN_STMT:
+            if (node->data) {
+                ExplainStmtData* data = (ExplainStmtData*)node->data;
+                if (data->statement) ast_free_node(data->statement);
+            }
+            break;
+            
         default:
             // Los nodos hoja (NODE_IDENTIFIER, NODE_LITERAL, etc.) no tienen hijos que liberar
             break;
@@ -756,6 +1001,25 @@ void ast_free_node(ASTNode* node) {
     free(node);
 }
 
+// Símbolo de un operador binario
+static const char* binary_op_symbol(BinaryOpType op) {
+    switch (op) {
+        case OP_EQ: return "=";
+        case OP_NEQ: return "<>";
+        case OP_LT: return "<";
+        case OP_GT: return ">";
+        case OP_LTE: return "<=";
+        case OP_GTE: return ">=";
+        case OP_AND: return "AND";
+        case OP_OR: return "OR";
+        case OP_PLUS: return "+";
+        case OP_MINUS: return "-";
+        case OP_MULTIPLY: return "*";
+        case OP_DIVIDE: return "/";
+        default: return "???";
+    }
+}
+
 // Función para imprimir indentación
 void ast_print_indent(int level) {
     for (int i = 0; i < level; i++) {
@@ -785,11 +1049,41 @@ void ast_print(ASTNode* node, int level) {
                 ast_print(data->columns, level+2);
             }
             
+            if (data->join_table) {
+                ast_print_indent(level+1);
+                printf("JOIN %s ON:\n", data->join_table);
+                ast_print(data->join_condition, level+2);
+            }
+            
             if (data->where_clause) {
                 ast_print_indent(level+1);
                 printf("WHERE:\n");
                 ast_print(data->where_clause, level+2);
             }
+            
+            if (data->group_by) {
+                ast_print_indent(level+1);
+                printf("GROUP BY:\n");
+                ast_print(data->group_by, level+2);
+            }
+            
+            if (data->order_by) {
+                ast_print_indent(level+1);
+                printf("ORDER BY:\n");
+                ast_print(data->order_by, level+2);
+            }
+            
+            if (data->limit) {
+                ast_print_indent(level+1);
+                printf("LIMIT:\n");
+                ast_print(data->limit, level+2);
+            }
+            
+            if (data->offset) {
+                ast_print_indent(level+1);
+                printf("OFFSET:\n");
+                ast_print(data->offset, level+2);
+            }
             break;
         }
         
@@ -797,10 +1091,10 @@ void ast_print(ASTNode* node, int level) {
             InsertStmtData* data = (InsertStmtData*)node->data;
             printf("INSERT (into: %s)\n", data->table_name ? data->table_name : "NULL");
             
-            if (data->values) {
+            for (ASTNode* row = data->values; row; row = row->next) {
                 ast_print_indent(level+1);
                 printf("VALUES:\n");
-                ast_print(data->values, level+2);
+                ast_print(row, level+2);
             }
             break;
         }
@@ -885,7 +1179,13 @@ void ast_print(ASTNode* node, int level) {
             
             for (int i = 0; i < data->count; i++) {
                 ast_print_indent(level+1);
-                printf("%s\n", data->columns[i] ? data->columns[i] : "NULL");
+                if (data->aggregates && data->aggregates[i] != AGG_NONE) {
+                    printf("%s(%s)", ast_aggregate_name(data->aggregates[i]),
+                           data->columns[i] ? data->columns[i] : "NULL");
+                } else {
+                    printf("%s", data->columns[i] ? data->columns[i] : "NULL");
+                }
+                printf("%s\n", data->descending ? (data->descending[i] ? " DESC" : " ASC") : "");
             }
             break;
         }
@@ -917,24 +1217,7 @@ void ast_print(ASTNode* node, int level) {
         case NODE_BINARY_EXPR: {
             BinaryExprData* data = (BinaryExprData*)node->data;
             // Mostrar el tipo de operador como texto, no como número
-            const char* op_str;
-            switch (data->op_type) {
-                case OP_EQ: op_str = "="; break;
-                case OP_NEQ: op_str = "<>"; break;
-                case OP_LT: op_str = "<"; break;
-                case OP_GT: op_str = ">"; break;
-                case OP_LTE: op_str = "<="; break;
-                case OP_GTE: op_str = ">="; break;
-                case OP_AND: op_str = "AND"; break;
-                case OP_OR: op_str = "OR"; break;
-                case OP_PLUS: op_str = "+"; break;
-                case OP_MINUS: op_str = "-"; break;
-                case OP_MULTIPLY: op_str = "*"; break;
-                case OP_DIVIDE: op_str = "/"; break;
-                default: op_str = "???";
-            }
-            
-            printf("BINARY EXPR: %s\n", op_str);
+            printf("BINARY EXPR: %s\n", binary_op_symbol(data->op_type));
             ast_print(data->left, level+1);
             ast_print(data->right, level+1);
             break;
@@ -975,6 +1258,54 @@ void ast_print(ASTNode* node, int level) {
             break;
         }
 
+        case NODE_PARAMETER: {
+            ParameterData* data = (ParameterData*)node->data;
+            printf("PARAMETER: ?%d\n", data->index + 1);
+            break;
+        }
+
+        case NODE_PREPARE_STMT: {
+            PrepareStmtData* data = (PrepareStmtData*)node->data;
+            printf("PREPARE (name: %s, params: %d)\n", 
+                   data->name ? data->name : "NULL", data->num_params);
+            ast_print(data->statement, level+1);
+            break;
+        }
+
+        case NODE_EXECUTE_STMT: {
+            ExecuteStmtData* data = (ExecuteStmtData*)node->data;
+            printf("EXECUTE (name: %s)\n", data->name ? data->name : "NULL");
+            if (data->arguments) {
+                ast_print(data->arguments, level+1);
+            }
+            break;
+        }
+
+        case NODE_DEALLOCATE_STMT: {
+            DeallocateStmtData* data = (DeallocateStmtData*)node->data;
+            printf("DEALLOCATE (name: %s)\n", data->name ? data->name : "NULL");
+            break;
+        }
+
+        case NODE_BEGIN_STMT:
+            printf("BEGIN\n");
+            break;
+
+        case NODE_COMMIT_STMT:
+            printf("COMMIT\n");
+            break;
+
+        case NODE_ROLLBACK_STMT:
+            printf("ROLLBACK\n");
+            break;
+
+        case NODE_EXPLAIN_STMT: {
+            ExplainStmtData* data = (ExplainStmtData*)node->data;
+            printf("EXPLAIN%s\n", data->analyze ? " ANALYZE" : "");
+            ast_print(data->statement, level+1);
+            break;
+        }
+
         default:
             printf("TIPO DESCONOCIDO\n");
             break;
@@ -1019,10 +1350,176 @@ void ast_set_column_name(ASTNode* node, const char* column_name) {
     } else if (data->column->type == NODE_COLUMN_DEF) {
         // Si ya existe una definición de columna, actualizar el nombre
         ColumnDefData* col_data = (ColumnDefData*)data->column->data;
-        if (col_data->name) free(col_data->name);
-        col_data->name = strdup(column_name);
+        ast_release(col_data->name);
+        col_data->name = ast_strdup(column_name);
     }
 }
 
+// Asigna las funciones de agregación de una lista de columnas
+int ast_set_column_aggregates(ASTNode* node, const int* aggregates) {
+    if (!node || node->type != NODE_COLUMN_LIST || !aggregates) return -1;
+    
+    ColumnListData* data = (ColumnListData*)node->data;
+    int* copy = (int*)ast_alloc((data->count > 0 ? data->count : 1) * sizeof(int));
+    if (!copy) return -1;
+    
+    memcpy(copy, aggregates, data->count * sizeof(int));
+    ast_release(data->aggregates);
+    data->aggregates = copy;
+    
+    return 0;
+}
 
+// Asigna el sentido de cada columna de un ORDER BY (1 si es descendente)
+int ast_set_column_directions(ASTNode* node, const int* descending) {
+    if (!node || node->type != NODE_COLUMN_LIST || !descending) return -1;
+    
+    ColumnListData* data = (ColumnListData*)node->data;
+    int* copy = (int*)ast_alloc((data->count > 0 ? data->count : 1) * sizeof(int));
+    if (!copy) return -1;
+    
+    memcpy(copy, descending, data->count * sizeof(int));
+    ast_release(data->descending);
+    data->descending = copy;
+    
+    return 0;
+}
+
+// Asigna las cláusulas ORDER BY, LIMIT y OFFSET de un SELECT
+void ast_set_select_order(ASTNode* node, ASTNode* order_by, ASTNode* limit, ASTNode* offset) {
+    if (!node || node->type != NODE_SELECT_STMT) return;
+    
+    SelectStmtData* data = (SelectStmtData*)node->data;
+    data->order_by = order_by;
+    data->limit = limit;
+    data->offset = offset;
+    
+    if (order_by) order_by->parent = node;
+    if (limit) limit->parent = node;
+    if (offset) offset->parent = node;
+}
+
+// Asigna la tabla y la condición ON del JOIN de un SELECT
+int ast_set_select_join(ASTNode* node, const char* join_table, ASTNode* condition) {
+    if (!node || node->type != NODE_SELECT_STMT || !join_table) return -1;
+    
+    char* copy = ast_strdup(join_table);
+    if (!copy) return -1;
+    
+    SelectStmtData* data = (SelectStmtData*)node->data;
+    ast_release(data->join_table);
+    data->join_table = copy;
+    data->join_condition = condition;
+    
+    if (condition) condition->parent = node;
+    return 0;
+}
+
+// Nombre de una función de agregación
+const char* ast_aggregate_name(AggregateType type) {
+    switch (type) {
+        case AGG_COUNT: return "COUNT";
+        case AGG_SUM: return "SUM";
+        case AGG_MIN: return "MIN";
+        case AGG_MAX: return "MAX";
+        case AGG_AVG: return "AVG";
+        default: return "";
+    }
+}
+
+// Texto que se va escribiendo en un buffer de tamaño fijo
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+    int truncated;
+} ExprText;
+
+static void expr_text_append(ExprText* text, const char* format, ...) __attribute__((format(printf, 2, 3)));
 
+static void expr_text_append(ExprText* text, const char* format, ...) {
+    if (text->truncated) return;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text->buffer + text->length, text->size - text->length, format, args);
+    va_end(args);
+
+    if (written < 0 || (size_t)written >= text->size - text->length) {
+        text->truncated = 1;
+        text->length = text->size - 1;
+    } else {
+        text->length += written;
+    }
+}
+
+// Las subexpresiones binarias van entre paréntesis para no depender de la precedencia
+static void format_expr(const ASTNode* expr, ExprText* text) {
+    if (!expr) {
+        expr_text_append(text, "NULL");
+        return;
+    }
+
+    switch (expr->type) {
+        case NODE_BINARY_EXPR: {
+            BinaryExprData* data = (BinaryExprData*)expr->data;
+            expr_text_append(text, "(");
+            format_expr(data->left, text);
+            expr_text_append(text, " %s ", binary_op_symbol(data->op_type));
+            format_expr(data->right, text);
+            expr_text_append(text, ")");
+            break;
+        }
+
+        case NODE_UNARY_EXPR: {
+            UnaryExprData* data = (UnaryExprData*)expr->data;
+            expr_text_append(text, data->op_type == OP_NOT ? "NOT " : "-");
+            format_expr(data->operand, text);
+            break;
+        }
+
+        case NODE_IDENTIFIER: {
+            IdentifierData* data = (IdentifierData*)expr->data;
+            expr_text_append(text, "%s", data->name ? data->name : "?");
+            break;
+        }
+
+        case NODE_LITERAL: {
+            LiteralData* data = (LiteralData*)expr->data;
+            switch (data->lit_type) {
+                case LIT_INTEGER: expr_text_append(text, "%d", data->int_value); break;
+                case LIT_FLOAT: expr_text_append(text, "%g", data->float_value); break;
+                case LIT_STRING:
+                    expr_text_append(text, "\"%s\"", data->string_value ? data->string_value : "");
+                    break;
+                case LIT_BOOLEAN: expr_text_append(text, data->bool_value ? "TRUE" : "FALSE"); break;
+                case LIT_NULL: expr_text_append(text, "NULL"); break;
+            }
+            break;
+        }
+
+        case NODE_PARAMETER: {
+            ParameterData* data = (ParameterData*)expr->data;
+            expr_text_append(text, "?%d", data->index + 1);
+            break;
+        }
+
+        case NODE_WHERE_CLAUSE:
+            format_expr(((WhereClauseData*)expr->data)->condition, text);
+            break;
+
+        default:
+            expr_text_append(text, "...");
+            break;
+    }
+}
+
+// Escribe una expresión como texto SQL
+int ast_format_expr(const ASTNode* expr, char* buffer, size_t size) {
+    if (!buffer || size == 0) return -1;
+
+    ExprText text = { buffer, size, 0, 0 };
+    buffer[0] = '\0';
+    format_expr(expr, &text);
+    return text.truncated ? -1 : 0;
+}
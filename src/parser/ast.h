@@ -22,7 +22,15 @@ typedef enum {
     NODE_BINARY_EXPR,
     NODE_UNARY_EXPR,
     NODE_IDENTIFIER,
-    NODE_LITERAL
+    NODE_LITERAL,
+    NODE_PARAMETER,
+    NODE_PREPARE_STMT,
+    NODE_EXECUTE_STMT,
+    NODE_DEALLOCATE_STMT,
+    NODE_BEGIN_STMT,
+    NODE_COMMIT_STMT,
+    NODE_ROLLBACK_STMT,
+    NODE_EXPLAIN_STMT
 } ASTNodeType;
 
 // Tipos de operadores binarios
@@ -56,20 +64,37 @@ typedef enum {
     LIT_NULL
 } LiteralType;
 
+// Funciones de agregación
+typedef enum {
+    AGG_NONE,
+    AGG_COUNT,
+    AGG_SUM,
+    AGG_MIN,
+    AGG_MAX,
+    AGG_AVG
+} AggregateType;
+
 // Declaración forward de ASTNode
 typedef struct ASTNode ASTNode;
 
 // Datos para SELECT
 typedef struct {
     char* table_name;
+    char* join_table;     // Tabla del JOIN (opcional)
+    ASTNode* join_condition; // Condición ON del JOIN (opcional)
     ASTNode* columns;     // NODE_COLUMN_LIST
     ASTNode* where_clause; // NODE_WHERE_CLAUSE (opcional)
+    ASTNode* group_by;    // NODE_COLUMN_LIST (opcional)
+    ASTNode* order_by;    // NODE_COLUMN_LIST con direcciones (opcional)
+    ASTNode* limit;       // Expresión de LIMIT (opcional)
+    ASTNode* offset;      // Expresión de OFFSET (opcional)
 } SelectStmtData;
 
 // Datos para INSERT
 typedef struct {
     char* table_name;
-    ASTNode* values;      // NODE_VALUE_LIST
+    ASTNode* values;      // NODE_VALUE_LIST (una por fila, enlazadas como hermanas)
+    int num_rows;         // Número de filas a insertar
 } InsertStmtData;
 
 // Datos para UPDATE
@@ -116,6 +141,9 @@ typedef struct {
     int count;
     int is_all;  // Para SELECT *
     char** columns;
+    int* column_indices;  // Resueltos por el validador (NULL hasta validar)
+    int* aggregates;      // AggregateType de cada columna (NULL si no hay agregados)
+    int* descending;      // ORDER BY: 1 si la columna se ordena de mayor a menor (NULL si no es ORDER BY)
 } ColumnListData;
 
 // Datos para lista de valores
@@ -132,6 +160,7 @@ typedef struct {
 // Datos para asignación
 typedef struct {
     char* column_name;
+    int column_index;     // Resuelto por el validador (-1 si no resuelto)
     ASTNode* value;
 } AssignmentData;
 
@@ -151,6 +180,8 @@ typedef struct {
 // Datos para identificador
 typedef struct {
     char* name;
+    int column_index;     // Resuelto por el validador (-1 si no resuelto)
+    int column_type;      // DataType de la columna resuelta (-1 si no resuelto)
 } IdentifierData;
 
 // Datos para literal
@@ -164,12 +195,44 @@ typedef struct {
     };
 } LiteralData;
 
+// Datos para parámetro posicional (?)
+typedef struct {
+    int index;            // Posición del parámetro (desde 0)
+    int expected_type;    // DataType inferido por el validador (-1 si desconocido)
+} ParameterData;
+
+// Datos para PREPARE
+typedef struct {
+    char* name;
+    ASTNode* statement;   // Sentencia a preparar
+    int num_params;       // Número de parámetros '?' en la sentencia
+} PrepareStmtData;
+
+// Datos para EXECUTE
+typedef struct {
+    char* name;
+    ASTNode* arguments;   // NODE_VALUE_LIST (opcional)
+} ExecuteStmtData;
+
+// Datos para DEALLOCATE
+typedef struct {
+    char* name;
+} DeallocateStmtData;
+
+// Datos para EXPLAIN
+typedef struct {
+    ASTNode* statement;   // Sentencia cuyo plan se muestra
+    int analyze;          // EXPLAIN ANALYZE: se ejecuta y se miden sus operadores
+    int num_params;       // Número de parámetros '?' en la sentencia
+} ExplainStmtData;
+
 // Función para liberar un tipo específico de datos
 typedef void (*ASTNodeFreeFunc)(void*);
 
 // Estructura principal del nodo AST
 struct ASTNode {
     ASTNodeType type;
+    int in_arena;     // Reservado en una arena (ast_use_arena)
     void* data;
     ASTNodeFreeFunc free_data;
     ASTNode* parent;
@@ -179,7 +242,7 @@ struct ASTNode {
 
 // Funciones de creación de nodos
 ASTNode* ast_create_node(ASTNodeType type);
-ASTNode* ast_create_select(char* table_name, ASTNode* columns, ASTNode* where);
+ASTNode* ast_create_select(char* table_name, ASTNode* columns, ASTNode* where, ASTNode* group_by);
 ASTNode* ast_create_insert(char* table_name, ASTNode* values);
 ASTNode* ast_create_update(char* table_name, ASTNode* assignments, ASTNode* where);
 ASTNode* ast_create_delete(char* table_name, ASTNode* where);
@@ -199,16 +262,47 @@ ASTNode* ast_create_literal_float(double value);
 ASTNode* ast_create_literal_string(char* value);
 ASTNode* ast_create_literal_bool(int value);
 ASTNode* ast_create_literal_null();
+ASTNode* ast_create_parameter(int index);
+ASTNode* ast_create_prepare(char* name, ASTNode* statement, int num_params);
+ASTNode* ast_create_execute(char* name, ASTNode* arguments);
+ASTNode* ast_create_deallocate(char* name);
+ASTNode* ast_create_transaction(ASTNodeType type);
+ASTNode* ast_create_explain(ASTNode* statement, int analyze, int num_params);
 
 // Añadir esta línea cerca de las otras declaraciones de funciones AST
 void ast_set_column_name(ASTNode* node, const char* column_name);
 
+// Asigna las funciones de agregación de una lista de columnas (copia el array)
+int ast_set_column_aggregates(ASTNode* node, const int* aggregates);
+
+// Asigna el sentido de cada columna de un ORDER BY (copia el array; 1 si es descendente)
+int ast_set_column_directions(ASTNode* node, const int* descending);
+
+// Asigna las cláusulas ORDER BY, LIMIT y OFFSET de un SELECT (pueden ser NULL)
+void ast_set_select_order(ASTNode* node, ASTNode* order_by, ASTNode* limit, ASTNode* offset);
+
+// Asigna la tabla y la condición ON del JOIN de un SELECT (copia el nombre)
+int ast_set_select_join(ASTNode* node, const char* join_table, ASTNode* condition);
+
+// Nombre de una función de agregación (COUNT, SUM...)
+const char* ast_aggregate_name(AggregateType type);
+
+// Hace que los nodos que cree el hilo actual se reserven en una arena (NULL: con malloc)
+// hasta el siguiente cambio, y devuelve la anterior. Esos nodos se liberan con la arena
+// y ast_free_node no hace nada con ellos.
+struct Arena;
+struct Arena* ast_use_arena(struct Arena* arena);
+
 // Funciones para manipulación de AST
 void ast_free_node(ASTNode* node);
 void ast_append_sibling(ASTNode* node, ASTNode* sibling);
 ASTNode* ast_get_next_sibling(ASTNode* node);
 void ast_print(ASTNode* node, int level);
 
+// Escribe una expresión como texto SQL en buffer (siempre terminado en '\0').
+// Devuelve 0, o -1 si no cabía entera y se ha recortado.
+int ast_format_expr(const ASTNode* expr, char* buffer, size_t size);
+
 // Estructura para AST completo
 typedef struct {
     ASTNode* root;
@@ -4,11 +4,13 @@
 const char* grammar_get_specification() {
     static const char* spec =
         "<statement> ::= <select_stmt> | <insert_stmt> | <update_stmt> | <delete_stmt> | "
-        "<create_table_stmt> | <alter_table_stmt> | <drop_table_stmt>\n\n"
+        "<create_table_stmt> | <alter_table_stmt> | <drop_table_stmt> | "
+        "<prepare_stmt> | <execute_stmt> | <deallocate_stmt> | <transaction_stmt> | <explain_stmt>\n\n"
         
-        "<select_stmt> ::= SELECT <column_list> FROM <table_name> [<where_clause>]\n\n"
+        "<select_stmt> ::= SELECT <select_list> FROM <table_name> [<join_clause>] [<where_clause>] "
+        "[<group_by_clause>] [<order_by_clause>] [<limit_clause>]\n\n"
         
-        "<insert_stmt> ::= INSERT INTO <table_name> VALUES <value_list>\n\n"
+        "<insert_stmt> ::= INSERT INTO <table_name> VALUES <value_list> {, <value_list>}\n\n"
         
         "<update_stmt> ::= UPDATE <table_name> SET <assignment_list> [<where_clause>]\n\n"
         
@@ -20,6 +22,36 @@ const char* grammar_get_specification() {
         
         "<drop_table_stmt> ::= DROP TABLE <table_name>\n\n"
         
+        "<prepare_stmt> ::= PREPARE <identifier> AS (<select_stmt> | <insert_stmt> | <update_stmt> | <delete_stmt>)\n\n"
+        
+        "<execute_stmt> ::= EXECUTE <identifier> [<value_list>]\n\n"
+        
+        "<deallocate_stmt> ::= DEALLOCATE [PREPARE] <identifier>\n\n"
+        
+        "<transaction_stmt> ::= BEGIN [TRANSACTION] | COMMIT | ROLLBACK\n\n"
+        
+        "<explain_stmt> ::= EXPLAIN [ANALYZE] (<select_stmt> | <insert_stmt> | <update_stmt> | <delete_stmt>)\n\n"
+        
+        "<select_list> ::= * | <select_item> {, <select_item>}\n\n"
+        
+        "<select_item> ::= <column_ref> | <aggregate>\n\n"
+        
+        "<column_ref> ::= [<table_name> .] <identifier>\n\n"
+        
+        "<join_clause> ::= [INNER] JOIN <table_name> ON <column_ref> = <column_ref>\n\n"
+        
+        "<aggregate> ::= COUNT ( * ) | <aggregate_func> ( <column_ref> )\n\n"
+        
+        "<aggregate_func> ::= COUNT | SUM | MIN | MAX | AVG\n\n"
+        
+        "<group_by_clause> ::= GROUP BY <column_ref> {, <column_ref>}\n\n"
+        
+        "<order_by_clause> ::= ORDER BY <order_item> {, <order_item>}\n\n"
+        
+        "<order_item> ::= <select_item> [ASC | DESC]\n\n"
+        
+        "<limit_clause> ::= LIMIT (<integer> | <parameter>) [OFFSET (<integer> | <parameter>)]\n\n"
+        
         "<column_list> ::= * | <identifier> {, <identifier>}\n\n"
         
         "<column_def_list> ::= ( <column_def> {, <column_def>} )\n\n"
@@ -36,7 +68,9 @@ const char* grammar_get_specification() {
         
         "<value_list> ::= ( <expression> {, <expression>} )\n\n"
         
-        "<expression> ::= <literal> | <identifier> | <unary_expr> | <binary_expr> | ( <expression> )\n\n"
+        "<expression> ::= <literal> | <column_ref> | <parameter> | <unary_expr> | <binary_expr> | ( <expression> )\n\n"
+        
+        "<parameter> ::= ?\n\n"
         
         "<binary_expr> ::= <expression> <binary_op> <expression>\n\n"
         
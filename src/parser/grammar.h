@@ -14,11 +14,13 @@
 
 /*
  * <statement> ::= <select_stmt> | <insert_stmt> | <update_stmt> | <delete_stmt> | 
- *                <create_table_stmt> | <alter_table_stmt> | <drop_table_stmt>
+ *                <create_table_stmt> | <alter_table_stmt> | <drop_table_stmt> |
+ *                <prepare_stmt> | <execute_stmt> | <deallocate_stmt> | <transaction_stmt>
  *
- * <select_stmt> ::= SELECT <column_list> FROM <table_name> [<where_clause>]
+ * <select_stmt> ::= SELECT <select_list> FROM <table_name> [<join_clause>] [<where_clause>]
+ *                  [<group_by_clause>] [<order_by_clause>] [<limit_clause>]
  *
- * <insert_stmt> ::= INSERT INTO <table_name> VALUES <value_list>
+ * <insert_stmt> ::= INSERT INTO <table_name> VALUES <value_list> {, <value_list>}
  *
  * <update_stmt> ::= UPDATE <table_name> SET <assignment_list> [<where_clause>]
  *
@@ -30,6 +32,34 @@
  *
  * <drop_table_stmt> ::= DROP TABLE <table_name>
  *
+ * <prepare_stmt> ::= PREPARE <identifier> AS (<select_stmt> | <insert_stmt> | <update_stmt> | <delete_stmt>)
+ *
+ * <execute_stmt> ::= EXECUTE <identifier> [<value_list>]
+ *
+ * <deallocate_stmt> ::= DEALLOCATE [PREPARE] <identifier>
+ *
+ * <transaction_stmt> ::= BEGIN [TRANSACTION] | COMMIT | ROLLBACK
+ *
+ * <select_list> ::= * | <select_item> {, <select_item>}
+ *
+ * <select_item> ::= <column_ref> | <aggregate>
+ *
+ * <column_ref> ::= [<table_name> .] <identifier>
+ *
+ * <join_clause> ::= [INNER] JOIN <table_name> ON <column_ref> = <column_ref>
+ *
+ * <aggregate> ::= COUNT ( * ) | <aggregate_func> ( <column_ref> )
+ *
+ * <aggregate_func> ::= COUNT | SUM | MIN | MAX | AVG
+ *
+ * <group_by_clause> ::= GROUP BY <column_ref> {, <column_ref>}
+ *
+ * <order_by_clause> ::= ORDER BY <order_item> {, <order_item>}
+ *
+ * <order_item> ::= <select_item> [ASC | DESC]
+ *
+ * <limit_clause> ::= LIMIT (<integer> | <parameter>) [OFFSET (<integer> | <parameter>)]
+ *
  * <column_list> ::= * | <identifier> {, <identifier>}
  *
  * <column_def_list> ::= ( <column_def> {, <column_def>} )
@@ -46,7 +76,9 @@
  *
  * <value_list> ::= ( <expression> {, <expression>} )
  *
- * <expression> ::= <literal> | <identifier> | <unary_expr> | <binary_expr> | ( <expression> )
+ * <expression> ::= <literal> | <column_ref> | <parameter> | <unary_expr> | <binary_expr> | ( <expression> )
+ *
+ * <parameter> ::= ?
  *
  * <binary_expr> ::= <expression> <binary_op> <expression>
  *
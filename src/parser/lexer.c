@@ -10,7 +10,11 @@ static const char* keywords[] = {
     "UPDATE", "SET", "DELETE", "CREATE", "TABLE", "ALTER",
     "ADD", "COLUMN", "DROP", "PRIMARY", "KEY", "NOT",
     "NULL", "INT", "FLOAT", "STRING", "BOOL", "TRUE",
-    "FALSE", "AND", "OR", NULL
+    "FALSE", "AND", "OR", "PREPARE", "EXECUTE", "DEALLOCATE",
+    "AS", "COUNT", "SUM", "MIN", "MAX", "AVG", "GROUP", "BY",
+    "ORDER", "ASC", "DESC", "LIMIT", "OFFSET", "JOIN", "INNER", "ON",
+    "BEGIN", "TRANSACTION", "COMMIT", "ROLLBACK", "EXPLAIN", "ANALYZE",
+    NULL
 };
 
 // Verifica si una cadena es una palabra clave
@@ -50,7 +54,7 @@ static int is_operator_char(char c) {
 }
 
 static int is_punctuation(char c) {
-    return c == '(' || c == ')' || c == ',' || c == ';' || c == '.';
+    return c == '(' || c == ')' || c == ',' || c == ';' || c == '.' || c == '?';
 }
 
 // Función para crear un nuevo token vacío
@@ -424,9 +428,13 @@ static Token lexer_read_operator(Lexer* lexer) {
 
 // Función principal para obtener el siguiente token
 Token lexer_next_token(Lexer* lexer) {
-    // Omitir espacios en blanco y comentarios
-    lexer_skip_whitespace(lexer);
-    lexer_skip_comments(lexer);
+    // Omitir espacios en blanco y comentarios (puede haber varios seguidos)
+    int skipped_from;
+    do {
+        skipped_from = lexer->position;
+        lexer_skip_whitespace(lexer);
+        lexer_skip_comments(lexer);
+    } while (lexer->position != skipped_from);
     
     // Guardar la posición actual para el token
     int start_position = lexer->position;
@@ -509,6 +517,49 @@ Token lexer_next_token(Lexer* lexer) {
     return token;
 }
 
+// Función para buscar el final de una sentencia sin crear tokens
+size_t lexer_scan_statement(const char* text, size_t length, LexerScan* scan) {
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        char next = i + 1 < length ? text[i + 1] : '\0';
+        
+        switch (scan->state) {
+            case LEXER_SCAN_STRING:
+                if (c == '\\') scan->state = LEXER_SCAN_STRING_ESCAPE;
+                else if (c == '"') scan->state = LEXER_SCAN_CODE;
+                break;
+            case LEXER_SCAN_STRING_ESCAPE:
+                scan->state = LEXER_SCAN_STRING;
+                break;
+            case LEXER_SCAN_LINE_COMMENT:
+                if (c == '\n') scan->state = LEXER_SCAN_CODE;
+                break;
+            case LEXER_SCAN_BLOCK_COMMENT:
+                if (c == '*' && next == '/') {
+                    scan->state = LEXER_SCAN_CODE;
+                    i++;
+                }
+                break;
+            case LEXER_SCAN_CODE:
+                if (c == ';') return i;
+                
+                if (c == '-' && next == '-') {
+                    scan->state = LEXER_SCAN_LINE_COMMENT;
+                    i++;
+                } else if (c == '/' && next == '*') {
+                    scan->state = LEXER_SCAN_BLOCK_COMMENT;
+                    i++;
+                } else if (!is_whitespace(c)) {
+                    if (c == '"') scan->state = LEXER_SCAN_STRING;
+                    scan->has_tokens = 1;
+                }
+                break;
+        }
+    }
+    
+    return length;
+}
+
 // Función para ver el siguiente token sin consumirlo
 Token lexer_peek_token(Lexer* lexer) {
     // Guardar estado actual
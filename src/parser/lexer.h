@@ -57,6 +57,27 @@ int lexer_has_error(Lexer* lexer);
 // Función para obtener un mensaje de error
 const char* lexer_get_error(Lexer* lexer);
 
+// Dónde se quedó lexer_scan_statement al terminar el texto anterior
+typedef enum {
+    LEXER_SCAN_CODE,             // Entre tokens
+    LEXER_SCAN_STRING,           // Dentro de una cadena
+    LEXER_SCAN_STRING_ESCAPE,    // Tras una '\\' dentro de una cadena
+    LEXER_SCAN_LINE_COMMENT,     // Dentro de un comentario "--"
+    LEXER_SCAN_BLOCK_COMMENT     // Dentro de un comentario "/* */"
+} LexerScanState;
+
+// Estado del recorrido de un script que llega por partes
+typedef struct {
+    LexerScanState state;
+    int has_tokens;              // La sentencia actual tiene algo más que espacios y comentarios
+} LexerScan;
+
+// Función para buscar el ';' que termina una sentencia sin crear tokens, con las mismas
+// reglas de cadenas, escapes y comentarios que el lexer. Devuelve su posición en text
+// (length si no hay ninguno) y deja en scan el estado para seguir con el texto siguiente.
+// El texto se recorre por líneas completas: "--", "/*" y "*/" no pueden quedar partidos.
+size_t lexer_scan_statement(const char* text, size_t length, LexerScan* scan);
+
 // Función para convertir un tipo de token a cadena (para depuración)
 const char* token_type_to_string(TokenType type);
 
@@ -2,6 +2,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include "parser.h"
+#include "../db/value.h"
+#include "../utils/arena.h"
+#include "../utils/timing.h"
 
 // Funciones de utilidad para el parser
 
@@ -34,19 +37,6 @@ static int parser_check_keyword(Parser* parser, const char* keyword) {
            strcasecmp(parser->current_token.value, keyword) == 0;
 }
 
-// Función para consumir un token si es del tipo esperado, o generar un error
-static int parser_match(Parser* parser, TokenType type) {
-    if (parser_check(parser, type)) {
-        parser_consume(parser);
-        return 1;
-    }
-    
-    char error[100];
-    snprintf(error, sizeof(error), "Se esperaba token de tipo %s", token_type_to_string(type));
-    parser_set_error(parser, error);
-    return 0;
-}
-
 // Función para consumir una palabra clave específica, o generar un error
 static int parser_match_keyword(Parser* parser, const char* keyword) {
     if (parser_check_keyword(parser, keyword)) {
@@ -73,6 +63,7 @@ Parser* parser_create(const char* sql) {
     
     parser->error_message = NULL;
     parser->error_position = -1;
+    parser->param_count = 0;
     
     // Inicializar con el primer token
     parser->current_token = lexer_next_token(parser->lexer);
@@ -90,21 +81,42 @@ const char* parser_get_error(Parser* parser) {
     return parser->error_message;
 }
 
+// Parsear un literal numérico (negative indica un '-' delante ya consumido)
+static ASTNode* parser_parse_number(Parser* parser, int negative) {
+    const char* text = parser->current_token.value;
+    ValueParseStatus status;
+    ASTNode* node = NULL;
+
+    if (parser->current_token.type == TOKEN_INTEGER) {
+        int value = 0;
+        status = value_parse_int(text, strlen(text), negative, &value);
+        if (status == VALUE_PARSE_OK) node = ast_create_literal_int(value);
+    } else {
+        float value = 0.0f;
+        status = value_parse_float(text, strlen(text), negative, &value);
+        if (status == VALUE_PARSE_OK) node = ast_create_literal_float(value);
+    }
+
+    if (status != VALUE_PARSE_OK) {
+        char error[160];
+        snprintf(error, sizeof(error),
+                 status == VALUE_PARSE_RANGE ? "El número %s%.100s está fuera de rango"
+                                             : "Número no válido: %s%.100s",
+                 negative ? "-" : "", text);
+        parser_set_error(parser, error);
+        return NULL;
+    }
+
+    parser_consume(parser);
+    return node;
+}
+
 // Parsear un literal
 static ASTNode* parser_parse_literal(Parser* parser) {
     Token token = parser->current_token; // Guardar referencia al token actual
     
-    if (token.type == TOKEN_INTEGER) {
-        int value = atoi(token.value);
-        parser_consume(parser); // Ya no obtenemos un valor de retorno
-        return ast_create_literal_int(value);
-    }
-    else if (token.type == TOKEN_FLOAT) {
-        char* value_copy = strdup(token.value);
-        parser_consume(parser);
-        double value = atof(value_copy);
-        free(value_copy);
-        return ast_create_literal_float(value);
+    if (token.type == TOKEN_INTEGER || token.type == TOKEN_FLOAT) {
+        return parser_parse_number(parser, 0);
     }
     else if (token.type == TOKEN_STRING) {
         char* value_copy = strdup(token.value);
@@ -130,12 +142,47 @@ static ASTNode* parser_parse_literal(Parser* parser) {
     return NULL;
 }
 
+// Parsear un nombre de columna, opcionalmente calificado con su tabla (tabla.columna)
+static char* parser_parse_column_name(Parser* parser) {
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_set_error(parser, "Se esperaba un nombre de columna");
+        return NULL;
+    }
+    
+    char* name = strdup(parser->current_token.value);
+    parser_consume(parser);
+    
+    if (parser->current_token.type != TOKEN_PUNCTUATION || 
+        strcmp(parser->current_token.value, ".") != 0) {
+        return name;
+    }
+    parser_consume(parser);
+    
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_set_error(parser, "Se esperaba un nombre de columna después de '.'");
+        free(name);
+        return NULL;
+    }
+    
+    size_t length = strlen(name) + strlen(parser->current_token.value) + 2;
+    char* qualified = (char*)malloc(length);
+    if (qualified) {
+        snprintf(qualified, length, "%s.%s", name, parser->current_token.value);
+    } else {
+        parser_set_error(parser, "Error de memoria al leer el nombre de columna");
+    }
+    parser_consume(parser);
+    
+    free(name);
+    return qualified;
+}
+
 // Parsear un identificador
 static ASTNode* parser_parse_identifier(Parser* parser) {
     if (parser->current_token.type == TOKEN_IDENTIFIER) {
         // Copiar el valor antes de consumir el token
-        char* name_copy = strdup(parser->current_token.value);
-        parser_consume(parser);
+        char* name_copy = parser_parse_column_name(parser);
+        if (!name_copy) return NULL;
         
         ASTNode* result = ast_create_identifier(name_copy);
         free(name_copy); // Liberar la copia después de usarla
@@ -223,10 +270,29 @@ static ASTNode* parser_parse_primary(Parser* parser) {
         free(op);
         
         parser_consume(parser);
+
+        // Los números negativos se leen con su signo: -2147483648 cabe en un INT y 2147483648 no
+        if (type == OP_NEG && (parser_check(parser, TOKEN_INTEGER) || parser_check(parser, TOKEN_FLOAT))) {
+            return parser_parse_number(parser, 1);
+        }
+
         ASTNode* operand = parser_parse_primary(parser);
         
         if (!operand) return NULL;
         
+        // Plegar el signo de los literales numéricos negativos (-5, -2.5)
+        if (type == OP_NEG && operand->type == NODE_LITERAL) {
+            LiteralData* lit = (LiteralData*)operand->data;
+            if (lit->lit_type == LIT_INTEGER) {
+                lit->int_value = -lit->int_value;
+                return operand;
+            }
+            if (lit->lit_type == LIT_FLOAT) {
+                lit->float_value = -lit->float_value;
+                return operand;
+            }
+        }
+        
         return ast_create_unary_expr(type, operand);
     }
     
@@ -235,6 +301,13 @@ static ASTNode* parser_parse_primary(Parser* parser) {
         return parser_parse_identifier(parser);
     }
     
+    // Parámetro posicional (sentencias preparadas)
+    if (parser->current_token.type == TOKEN_PUNCTUATION && 
+        strcmp(parser->current_token.value, "?") == 0) {
+        parser_consume(parser);
+        return ast_create_parameter(parser->param_count++);
+    }
+    
     // Literal
     if (parser->current_token.type == TOKEN_INTEGER || 
         parser->current_token.type == TOKEN_FLOAT || 
@@ -379,53 +452,124 @@ ASTNode* parser_parse_value_list(Parser* parser) {
     return value_list;
 }
 
-// Parsear una lista de columnas
-ASTNode* parser_parse_column_list(Parser* parser) {
-    // Caso especial: SELECT *
+// Obtener la función de agregación del token actual (AGG_NONE si no es una)
+static AggregateType parser_check_aggregate(Parser* parser) {
+    if (parser_check_keyword(parser, "COUNT")) return AGG_COUNT;
+    if (parser_check_keyword(parser, "SUM")) return AGG_SUM;
+    if (parser_check_keyword(parser, "MIN")) return AGG_MIN;
+    if (parser_check_keyword(parser, "MAX")) return AGG_MAX;
+    if (parser_check_keyword(parser, "AVG")) return AGG_AVG;
+    return AGG_NONE;
+}
+
+// Parsear el argumento de una función de agregación: ( columna ) o, para COUNT, ( * )
+static char* parser_parse_aggregate_argument(Parser* parser, AggregateType aggregate) {
+    if (parser->current_token.type != TOKEN_PUNCTUATION || 
+        strcmp(parser->current_token.value, "(") != 0) {
+        parser_set_error(parser, "Se esperaba '(' después de la función de agregación");
+        return NULL;
+    }
+    parser_consume(parser);
+    
+    char* argument;
     if (parser->current_token.type == TOKEN_OPERATOR && 
         strcmp(parser->current_token.value, "*") == 0) {
+        if (aggregate != AGG_COUNT) {
+            parser_set_error(parser, "Solo COUNT admite '*' como argumento");
+            return NULL;
+        }
+        argument = strdup("*");
         parser_consume(parser);
-        return ast_create_column_list(1, NULL, 0);
+    } else {
+        argument = parser_parse_column_name(parser);
+        if (!argument) return NULL;
     }
     
-    // Lista normal de columnas separadas por comas
+    if (parser->current_token.type != TOKEN_PUNCTUATION || 
+        strcmp(parser->current_token.value, ")") != 0) {
+        parser_set_error(parser, "Se esperaba ')' después del argumento de la función de agregación");
+        free(argument);
+        return NULL;
+    }
+    parser_consume(parser);
+    
+    return argument;
+}
+
+// Parsear columnas separadas por comas (pueden ser funciones de agregación y,
+// en ORDER BY, ir seguidas de ASC o DESC)
+static ASTNode* parser_parse_column_items(Parser* parser, int allow_direction) {
     char** columns = NULL;
+    int* aggregates = NULL;
+    int* descending = NULL;
     int count = 0;
     int capacity = 8;
+    int has_aggregates = 0;
+    int failed = 0;
     
     columns = (char**)malloc(sizeof(char*) * capacity);
-    if (!columns) {
+    aggregates = (int*)malloc(sizeof(int) * capacity);
+    descending = (int*)malloc(sizeof(int) * capacity);
+    if (!columns || !aggregates || !descending) {
         parser_set_error(parser, "Error de memoria al crear lista de columnas");
+        free(columns);
+        free(aggregates);
+        free(descending);
         return NULL;
     }
     
     while (1) {
-        if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        AggregateType aggregate = parser_check_aggregate(parser);
+        
+        if (aggregate == AGG_NONE && parser->current_token.type != TOKEN_IDENTIFIER) {
             parser_set_error(parser, "Se esperaba un nombre de columna");
-            for (int i = 0; i < count; i++) {
-                free(columns[i]);
-            }
-            free(columns);
-            return NULL;
+            failed = 1;
+            break;
         }
         
         // Añadir columna a la lista
         if (count >= capacity) {
             capacity *= 2;
             char** new_columns = (char**)realloc(columns, sizeof(char*) * capacity);
-            if (!new_columns) {
+            if (new_columns) columns = new_columns;
+            int* new_aggregates = (int*)realloc(aggregates, sizeof(int) * capacity);
+            if (new_aggregates) aggregates = new_aggregates;
+            int* new_descending = (int*)realloc(descending, sizeof(int) * capacity);
+            if (new_descending) descending = new_descending;
+            if (!new_columns || !new_aggregates || !new_descending) {
                 parser_set_error(parser, "Error de memoria al expandir lista de columnas");
-                for (int i = 0; i < count; i++) {
-                    free(columns[i]);
-                }
-                free(columns);
-                return NULL;
+                failed = 1;
+                break;
             }
-            columns = new_columns;
         }
         
-        columns[count++] = strdup(parser->current_token.value);
-        parser_consume(parser);
+        if (aggregate != AGG_NONE) {
+            parser_consume(parser);
+            char* argument = parser_parse_aggregate_argument(parser, aggregate);
+            if (!argument) {
+                failed = 1;
+                break;
+            }
+            columns[count] = argument;
+            has_aggregates = 1;
+        } else {
+            columns[count] = parser_parse_column_name(parser);
+            if (!columns[count]) {
+                failed = 1;
+                break;
+            }
+        }
+        aggregates[count] = aggregate;
+        
+        // Dirección de ordenación (ascendente por defecto)
+        descending[count] = 0;
+        if (allow_direction && parser_check_keyword(parser, "DESC")) {
+            descending[count] = 1;
+            parser_consume(parser);
+        } else if (allow_direction && parser_check_keyword(parser, "ASC")) {
+            parser_consume(parser);
+        }
+        count++;
         
         // Si hay una coma, esperamos otra columna
         if (parser->current_token.type == TOKEN_PUNCTUATION && 
@@ -437,22 +581,136 @@ ASTNode* parser_parse_column_list(Parser* parser) {
     }
     
     // Crear nodo de la lista de columnas
-    ASTNode* column_list = ast_create_column_list(0, columns, count);
+    ASTNode* column_list = NULL;
+    if (!failed) {
+        column_list = ast_create_column_list(0, columns, count);
+        if (column_list && has_aggregates && ast_set_column_aggregates(column_list, aggregates) != 0) {
+            ast_free_node(column_list);
+            column_list = NULL;
+        }
+        if (column_list && allow_direction && ast_set_column_directions(column_list, descending) != 0) {
+            ast_free_node(column_list);
+            column_list = NULL;
+        }
+        if (!column_list) {
+            parser_set_error(parser, "Error de memoria al crear lista de columnas");
+        }
+    }
     
     // Liberar el array (sus contenidos ahora pertenecen al nodo)
     for (int i = 0; i < count; i++) {
         free(columns[i]);
     }
     free(columns);
+    free(aggregates);
+    free(descending);
     
     return column_list;
 }
 
+// Parsear una lista de columnas (pueden ser funciones de agregación)
+ASTNode* parser_parse_column_list(Parser* parser) {
+    // Caso especial: SELECT *
+    if (parser->current_token.type == TOKEN_OPERATOR && 
+        strcmp(parser->current_token.value, "*") == 0) {
+        parser_consume(parser);
+        return ast_create_column_list(1, NULL, 0);
+    }
+    
+    return parser_parse_column_items(parser, 0);
+}
+
+// Parsear una cláusula GROUP BY (solo nombres de columna)
+static ASTNode* parser_parse_group_by(Parser* parser) {
+    if (!parser_check_keyword(parser, "GROUP")) {
+        return NULL; // No es un error, GROUP BY es opcional
+    }
+    parser_consume(parser);
+    
+    if (!parser_match_keyword(parser, "BY")) {
+        return NULL;
+    }
+    
+    ASTNode* group_by = parser_parse_column_list(parser);
+    if (!group_by) return NULL;
+    
+    ColumnListData* data = (ColumnListData*)group_by->data;
+    if (data->is_all || data->aggregates) {
+        parser_set_error(parser, "GROUP BY solo admite nombres de columna");
+        ast_free_node(group_by);
+        return NULL;
+    }
+    
+    return group_by;
+}
+
+// Parsear una cláusula ORDER BY (columnas o agregados seguidos de ASC o DESC)
+static ASTNode* parser_parse_order_by(Parser* parser) {
+    if (!parser_check_keyword(parser, "ORDER")) {
+        return NULL; // No es un error, ORDER BY es opcional
+    }
+    parser_consume(parser);
+    
+    if (!parser_match_keyword(parser, "BY")) {
+        return NULL;
+    }
+    
+    return parser_parse_column_items(parser, 1);
+}
+
+// Parsear el valor de LIMIT u OFFSET tras su palabra clave (NULL si no aparece)
+static ASTNode* parser_parse_row_count(Parser* parser, const char* keyword) {
+    if (!parser_check_keyword(parser, keyword)) {
+        return NULL;
+    }
+    parser_consume(parser);
+    
+    return parser_parse_expression(parser);
+}
+
+// Parsear [INNER] JOIN <tabla> ON <expresión> (NULL si no aparece)
+static ASTNode* parser_parse_join(Parser* parser, char** join_table) {
+    if (parser_check_keyword(parser, "INNER")) {
+        parser_consume(parser);
+        if (!parser_check_keyword(parser, "JOIN")) {
+            parser_set_error(parser, "Se esperaba la palabra clave 'JOIN'");
+            return NULL;
+        }
+    }
+    if (!parser_check_keyword(parser, "JOIN")) {
+        return NULL; // No es un error, JOIN es opcional
+    }
+    parser_consume(parser);
+    
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_set_error(parser, "Se esperaba un nombre de tabla después de JOIN");
+        return NULL;
+    }
+    
+    char* table_name = strdup(parser->current_token.value);
+    parser_consume(parser);
+    
+    if (!parser_match_keyword(parser, "ON")) {
+        free(table_name);
+        return NULL;
+    }
+    
+    ASTNode* condition = parser_parse_expression(parser);
+    if (!condition) {
+        free(table_name);
+        return NULL;
+    }
+    
+    *join_table = table_name;
+    return condition;
+}
+
 // Parsear una cláusula WHERE
 ASTNode* parser_parse_where_clause(Parser* parser) {
-    if (!parser_match_keyword(parser, "WHERE")) {
+    if (!parser_check_keyword(parser, "WHERE")) {
         return NULL; // No es un error, WHERE es opcional
     }
+    parser_consume(parser);
     
     ASTNode* condition = parser_parse_expression(parser);
     if (!condition) return NULL;
@@ -648,22 +906,73 @@ ASTNode* parser_parse_select(Parser* parser) {
     char* table_name = strdup(parser->current_token.value);
     parser_consume(parser);
     
+    // JOIN (opcional)
+    char* join_table = NULL;
+    ASTNode* join_condition = parser_parse_join(parser, &join_table);
+    
     // Cláusula WHERE (opcional)
-    ASTNode* where = parser_parse_where_clause(parser);
+    ASTNode* where = NULL;
+    if (!parser_has_error(parser)) {
+        where = parser_parse_where_clause(parser);
+    }
+    
+    // Cláusula GROUP BY (opcional)
+    ASTNode* group_by = NULL;
+    if (!parser_has_error(parser)) {
+        group_by = parser_parse_group_by(parser);
+    }
+    
+    // Cláusulas ORDER BY, LIMIT y OFFSET (opcionales)
+    ASTNode* order_by = NULL;
+    ASTNode* limit = NULL;
+    ASTNode* offset = NULL;
+    if (!parser_has_error(parser)) {
+        order_by = parser_parse_order_by(parser);
+    }
+    if (!parser_has_error(parser)) {
+        limit = parser_parse_row_count(parser, "LIMIT");
+    }
+    if (limit && !parser_has_error(parser)) {
+        offset = parser_parse_row_count(parser, "OFFSET");
+    }
     
     // Crear nodo SELECT
-    ASTNode* select = ast_create_select(table_name, columns, where);
+    ASTNode* select = ast_create_select(table_name, columns, where, group_by);
     free(table_name);
     
     if (!select) {
         ast_free_node(columns);
+        free(join_table);
+        if (join_condition) ast_free_node(join_condition);
         if (where) ast_free_node(where);
+        if (group_by) ast_free_node(group_by);
+        if (order_by) ast_free_node(order_by);
+        if (limit) ast_free_node(limit);
+        if (offset) ast_free_node(offset);
         return NULL;
     }
     
+    ast_set_select_order(select, order_by, limit, offset);
+    
+    if (join_table && ast_set_select_join(select, join_table, join_condition) != 0) {
+        parser_set_error(parser, "Error de memoria al crear el JOIN");
+        ast_free_node(join_condition);
+    }
+    free(join_table);
+    
     return select;
 }
 
+// Libera las listas de valores de un INSERT enlazadas como hermanas
+static void parser_free_value_rows(ASTNode* values) {
+    while (values) {
+        ASTNode* next = values->next;
+        values->next = NULL;
+        ast_free_node(values);
+        values = next;
+    }
+}
+
 // Parsear una sentencia INSERT
 ASTNode* parser_parse_insert(Parser* parser) {
     // INSERT INTO
@@ -693,21 +1002,43 @@ ASTNode* parser_parse_insert(Parser* parser) {
         return NULL;
     }
     
-    // Verificar el paréntesis de apertura
-    if (parser->current_token.type != TOKEN_PUNCTUATION || 
-        !parser->current_token.value ||
-        strcmp(parser->current_token.value, "(") != 0) {
-        free(table_name);
-        parser_set_error(parser, "Se esperaba '(' para iniciar la lista de valores");
-        return NULL;
-    }
-    parser_consume(parser); // Añadir esta línea para consumir el paréntesis
-    
-    // Lista de valores
-    ASTNode* values = parser_parse_value_list(parser);
-    if (!values) {
-        free(table_name);
-        return NULL;
+    // Una o más listas de valores separadas por comas: (...), (...), ...
+    ASTNode* values = NULL;
+    ASTNode* last_row = NULL;    // Cola de la lista, para no recorrerla en cada fila
+    while (1) {
+        // Verificar el paréntesis de apertura
+        if (parser->current_token.type != TOKEN_PUNCTUATION || 
+            !parser->current_token.value ||
+            strcmp(parser->current_token.value, "(") != 0) {
+            free(table_name);
+            parser_free_value_rows(values);
+            parser_set_error(parser, "Se esperaba '(' para iniciar la lista de valores");
+            return NULL;
+        }
+        parser_consume(parser); // Añadir esta línea para consumir el paréntesis
+        
+        // Lista de valores
+        ASTNode* row = parser_parse_value_list(parser);
+        if (!row) {
+            free(table_name);
+            parser_free_value_rows(values);
+            return NULL;
+        }
+        
+        if (values) {
+            ast_append_sibling(last_row, row);
+        } else {
+            values = row;
+        }
+        last_row = row;
+        
+        // Si hay una coma, esperamos otra fila
+        if (parser->current_token.type == TOKEN_PUNCTUATION && 
+            strcmp(parser->current_token.value, ",") == 0) {
+            parser_consume(parser);
+        } else {
+            break;
+        }
     }
     
     // Crear nodo INSERT
@@ -715,7 +1046,7 @@ ASTNode* parser_parse_insert(Parser* parser) {
     free(table_name);
     
     if (!insert) {
-        ast_free_node(values);
+        parser_free_value_rows(values);
         return NULL;
     }
     
@@ -1116,6 +1447,179 @@ ASTNode* parser_parse_alter_table(Parser* parser) {
     return alter_table;
 }
 
+// Parsear una sentencia PREPARE
+ASTNode* parser_parse_prepare(Parser* parser) {
+    // PREPARE
+    if (!parser_match_keyword(parser, "PREPARE")) {
+        return NULL;
+    }
+    
+    // Nombre de la sentencia preparada
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_set_error(parser, "Se esperaba un nombre para la sentencia preparada");
+        return NULL;
+    }
+    
+    char* name = strdup(parser->current_token.value);
+    parser_consume(parser);
+    
+    // AS
+    if (!parser_match_keyword(parser, "AS")) {
+        free(name);
+        return NULL;
+    }
+    
+    // Solo se pueden preparar sentencias de manipulación de datos
+    if (!parser_check_keyword(parser, "SELECT") && !parser_check_keyword(parser, "INSERT") &&
+        !parser_check_keyword(parser, "UPDATE") && !parser_check_keyword(parser, "DELETE")) {
+        parser_set_error(parser, "Solo se pueden preparar sentencias SELECT, INSERT, UPDATE o DELETE");
+        free(name);
+        return NULL;
+    }
+    
+    // Sentencia a preparar (los parámetros se numeran desde cero)
+    parser->param_count = 0;
+    ASTNode* statement = parser_parse_statement(parser);
+    if (!statement) {
+        free(name);
+        return NULL;
+    }
+    
+    ASTNode* prepare = ast_create_prepare(name, statement, parser->param_count);
+    free(name);
+    
+    if (!prepare) {
+        ast_free_node(statement);
+        return NULL;
+    }
+    
+    return prepare;
+}
+
+// Parsear una sentencia EXECUTE
+ASTNode* parser_parse_execute(Parser* parser) {
+    // EXECUTE
+    if (!parser_match_keyword(parser, "EXECUTE")) {
+        return NULL;
+    }
+    
+    // Nombre de la sentencia preparada
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_set_error(parser, "Se esperaba el nombre de una sentencia preparada");
+        return NULL;
+    }
+    
+    char* name = strdup(parser->current_token.value);
+    parser_consume(parser);
+    
+    // Lista de argumentos (opcional)
+    ASTNode* arguments = NULL;
+    if (parser->current_token.type == TOKEN_PUNCTUATION && 
+        strcmp(parser->current_token.value, "(") == 0) {
+        parser_consume(parser);
+        
+        arguments = parser_parse_value_list(parser);
+        if (!arguments) {
+            free(name);
+            return NULL;
+        }
+    }
+    
+    ASTNode* execute = ast_create_execute(name, arguments);
+    free(name);
+    
+    if (!execute) {
+        if (arguments) ast_free_node(arguments);
+        return NULL;
+    }
+    
+    return execute;
+}
+
+// Parsear una sentencia DEALLOCATE
+ASTNode* parser_parse_deallocate(Parser* parser) {
+    // DEALLOCATE [PREPARE]
+    if (!parser_match_keyword(parser, "DEALLOCATE")) {
+        return NULL;
+    }
+    
+    if (parser_check_keyword(parser, "PREPARE")) {
+        parser_consume(parser);
+    }
+    
+    // Nombre de la sentencia preparada
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_set_error(parser, "Se esperaba el nombre de una sentencia preparada");
+        return NULL;
+    }
+    
+    char* name = strdup(parser->current_token.value);
+    parser_consume(parser);
+    
+    ASTNode* deallocate = ast_create_deallocate(name);
+    free(name);
+    
+    return deallocate;
+}
+
+// Parsear BEGIN [TRANSACTION], COMMIT o ROLLBACK
+ASTNode* parser_parse_transaction(Parser* parser) {
+    ASTNodeType type;
+    
+    if (parser_check_keyword(parser, "BEGIN")) {
+        type = NODE_BEGIN_STMT;
+    } else if (parser_check_keyword(parser, "COMMIT")) {
+        type = NODE_COMMIT_STMT;
+    } else if (parser_check_keyword(parser, "ROLLBACK")) {
+        type = NODE_ROLLBACK_STMT;
+    } else {
+        parser_set_error(parser, "Se esperaba BEGIN, COMMIT o ROLLBACK");
+        return NULL;
+    }
+    parser_consume(parser);
+    
+    if (type == NODE_BEGIN_STMT && parser_check_keyword(parser, "TRANSACTION")) {
+        parser_consume(parser);
+    }
+    
+    return ast_create_transaction(type);
+}
+
+// Parsear EXPLAIN [ANALYZE] sentencia
+ASTNode* parser_parse_explain(Parser* parser) {
+    // EXPLAIN
+    if (!parser_match_keyword(parser, "EXPLAIN")) {
+        return NULL;
+    }
+    
+    int analyze = 0;
+    if (parser_check_keyword(parser, "ANALYZE")) {
+        parser_consume(parser);
+        analyze = 1;
+    }
+    
+    // Solo las sentencias de manipulación de datos tienen un plan
+    if (!parser_check_keyword(parser, "SELECT") && !parser_check_keyword(parser, "INSERT") &&
+        !parser_check_keyword(parser, "UPDATE") && !parser_check_keyword(parser, "DELETE")) {
+        parser_set_error(parser, "Solo se puede usar EXPLAIN con sentencias SELECT, INSERT, UPDATE o DELETE");
+        return NULL;
+    }
+    
+    parser->param_count = 0;
+    ASTNode* statement = parser_parse_statement(parser);
+    if (!statement) {
+        return NULL;
+    }
+    
+    ASTNode* explain = ast_create_explain(statement, analyze, parser->param_count);
+    if (!explain) {
+        ast_free_node(statement);
+        return NULL;
+    }
+    
+    return explain;
+}
+
 // Parsear una sentencia
 ASTNode* parser_parse_statement(Parser* parser) {
     // Versión corregida:
@@ -1133,6 +1637,17 @@ ASTNode* parser_parse_statement(Parser* parser) {
         return parser_parse_drop_table(parser);
     else if (parser_check_keyword(parser, "ALTER"))
         return parser_parse_alter_table(parser);
+    else if (parser_check_keyword(parser, "PREPARE"))
+        return parser_parse_prepare(parser);
+    else if (parser_check_keyword(parser, "EXECUTE"))
+        return parser_parse_execute(parser);
+    else if (parser_check_keyword(parser, "DEALLOCATE"))
+        return parser_parse_deallocate(parser);
+    else if (parser_check_keyword(parser, "EXPLAIN"))
+        return parser_parse_explain(parser);
+    else if (parser_check_keyword(parser, "BEGIN") || parser_check_keyword(parser, "COMMIT") ||
+             parser_check_keyword(parser, "ROLLBACK"))
+        return parser_parse_transaction(parser);
     else {
         parser_set_error(parser, "Sentencia SQL desconocida");
         return NULL;
@@ -1140,14 +1655,139 @@ ASTNode* parser_parse_statement(Parser* parser) {
 }
 
 ASTNode* parser_parse(Parser* parser){
-    return parser_parse_statement(parser);
+    int mark = timing_enter(TIMING_PARSE);
+    ASTNode* statement = parser_parse_statement(parser);
+    if (!statement || parser_has_error(parser)) {
+        timing_leave(mark);
+        return statement;
+    }
+    
+    // Punto y coma final opcional
+    if (parser->current_token.type == TOKEN_PUNCTUATION && 
+        strcmp(parser->current_token.value, ";") == 0) {
+        parser_consume(parser);
+    }
+    
+    // No se admite texto después de la sentencia
+    if (parser->current_token.type != TOKEN_EOF) {
+        parser_set_error(parser, "Se esperaba el final de la sentencia");
+        ast_free_node(statement);
+        timing_leave(mark);
+        return NULL;
+    }
+    
+    timing_leave(mark);
+    return statement;
+}
+
+// Indica si el token actual termina una sentencia (';' o el final del texto)
+static int parser_at_statement_end(Parser* parser) {
+    return parser->current_token.type == TOKEN_EOF ||
+           (parser->current_token.type == TOKEN_PUNCTUATION &&
+            strcmp(parser->current_token.value, ";") == 0);
+}
+
+// Añade una sentencia vacía al script (NULL si falta memoria)
+static ScriptStatement* script_append(ParsedScript* script) {
+    if (script->count >= script->capacity) {
+        int capacity = script->capacity > 0 ? script->capacity * 2 : 64;
+        ScriptStatement* statements = (ScriptStatement*)realloc(script->statements,
+                                                                capacity * sizeof(ScriptStatement));
+        if (!statements) return NULL;
+
+        script->statements = statements;
+        script->capacity = capacity;
+    }
+
+    ScriptStatement* statement = &script->statements[script->count++];
+    memset(statement, 0, sizeof(ScriptStatement));
+    statement->error_position = -1;
+    return statement;
 }
 
+ParsedScript* parser_parse_script(const char* sql) {
+    ParsedScript* script = (ParsedScript*)calloc(1, sizeof(ParsedScript));
+    if (!script) return NULL;
+
+    script->arena = arena_create(0);
+    Parser* parser = script->arena ? parser_create(sql) : NULL;
+    if (!parser) {
+        parser_free_script(script);
+        return NULL;
+    }
+
+    // Todos los nodos del script van a su arena
+    struct Arena* previous = ast_use_arena(script->arena);
+    int mark = timing_enter(TIMING_PARSE);
+    int failed = 0;
+
+    while (!failed) {
+        // Separadores sobrantes (sentencias vacías)
+        while (parser->current_token.type == TOKEN_PUNCTUATION &&
+               strcmp(parser->current_token.value, ";") == 0) {
+            parser_consume(parser);
+        }
+        if (parser->current_token.type == TOKEN_EOF) break;
+
+        ScriptStatement* statement = script_append(script);
+        if (!statement) {
+            failed = 1;
+            break;
+        }
+
+        parser->param_count = 0;
+        ASTNode* stmt = parser_parse_statement(parser);
+        if (stmt && !parser_has_error(parser) && !parser_at_statement_end(parser)) {
+            parser_set_error(parser, "Se esperaba el final de la sentencia");
+        }
+
+        if (stmt && !parser_has_error(parser)) {
+            statement->stmt = stmt;
+            statement->num_params = parser->param_count;
+            continue;
+        }
+
+        // El error se guarda en la sentencia y se sigue con la siguiente
+        statement->error = arena_strdup(script->arena, parser_has_error(parser) ?
+                                        parser_get_error(parser) : "Sentencia no válida");
+        statement->error_position = parser->error_position;
+        if (!statement->error) failed = 1;
+
+        free(parser->error_message);
+        parser->error_message = NULL;
+        parser->error_position = -1;
+
+        while (!parser_at_statement_end(parser)) parser_consume(parser);
+    }
+
+    timing_leave(mark);
+    ast_use_arena(previous);
+    parser_free(parser);
+
+    if (failed) {
+        parser_free_script(script);
+        return NULL;
+    }
+    return script;
+}
+
+void parser_free_script(ParsedScript* script) {
+    if (!script) return;
+
+    free(script->statements);
+    arena_free(script->arena);
+    free(script);
+}
 
 // Función para liberar recursos del parser
 void parser_free(Parser* parser) {
     if (!parser) return;
     
+    // El token actual del parser y el del lexer comparten la misma cadena
+    if (parser->lexer && parser->lexer->current_token.value == parser->current_token.value) {
+        parser->lexer->current_token.value = NULL;
+    }
+    
     // Liberar token actual del parser
     token_free(&parser->current_token);
     
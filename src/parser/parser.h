@@ -10,6 +10,7 @@ typedef struct {
     Token current_token;       // Token actual
     char* error_message;       // Mensaje de error
     int error_position;        // Posición del error
+    int param_count;           // Parámetros '?' encontrados en la sentencia actual
 } Parser;
 
 // Crear un nuevo parser para una cadena SQL
@@ -21,6 +22,30 @@ void parser_free(Parser* parser);
 // Analizar la entrada y generar un AST
 ASTNode* parser_parse(Parser* parser);
 
+// Sentencia de un script
+typedef struct {
+    ASTNode* stmt;             // AST de la sentencia (NULL si tiene un error de sintaxis)
+    int num_params;            // Parámetros '?' de la sentencia
+    const char* error;         // Mensaje del error de sintaxis (NULL si no hay)
+    int error_position;        // Posición del error en el texto
+} ScriptStatement;
+
+// Script: sentencias separadas por ';' analizadas con un único lexer. Los AST y los
+// mensajes de error se reservan en una arena que se libera con el script.
+typedef struct {
+    ScriptStatement* statements;
+    int count;
+    int capacity;
+    struct Arena* arena;
+} ParsedScript;
+
+// Analiza todas las sentencias de un texto (NULL si falta memoria). Un error de sintaxis
+// solo afecta a su sentencia: el análisis sigue después del siguiente ';'.
+ParsedScript* parser_parse_script(const char* sql);
+
+// Libera un script con todos sus AST
+void parser_free_script(ParsedScript* script);
+
 // Verificar si hay un error de sintaxis
 int parser_has_error(Parser* parser);
 
@@ -36,6 +61,11 @@ ASTNode* parser_parse_delete(Parser* parser);
 ASTNode* parser_parse_create_table(Parser* parser);
 ASTNode* parser_parse_alter_table(Parser* parser);
 ASTNode* parser_parse_drop_table(Parser* parser);
+ASTNode* parser_parse_prepare(Parser* parser);
+ASTNode* parser_parse_execute(Parser* parser);
+ASTNode* parser_parse_deallocate(Parser* parser);
+ASTNode* parser_parse_transaction(Parser* parser);
+ASTNode* parser_parse_explain(Parser* parser);
 
 // Funciones para analizar componentes
 ASTNode* parser_parse_column_list(Parser* parser);
@@ -52,30 +52,68 @@ Table* validator_find_table(const char* table_name, Database* db) {
     return NULL;
 }
 
-// Verificar si una columna existe en una tabla
-int validator_check_column_exists(const char* column_name, Table* table) {
-    if (!column_name || !table) return 0;
+// Buscar una columna sin calificar entre las columnas tabla.columna de un JOIN
+// (devuelve cuántas coinciden y en index la última)
+static int validator_find_unqualified(const char* column_name, Table* table, int* index) {
+    int matches = 0;
     
     for (int i = 0; i < table->num_columns; i++) {
-        if (strcasecmp(table->columns[i].name, column_name) == 0) {
-            return 1;
+        const char* dot = strchr(table->columns[i].name, '.');
+        if (dot && strcasecmp(dot + 1, column_name) == 0) {
+            *index = i;
+            matches++;
         }
     }
     
-    return 0;
+    return matches;
 }
 
-// Obtener una columna por nombre
-Column* validator_get_column(const char* column_name, Table* table) {
-    if (!column_name || !table) return NULL;
-    
-    for (int i = 0; i < table->num_columns; i++) {
-        if (strcasecmp(table->columns[i].name, column_name) == 0) {
-            return &table->columns[i];
+// Resolver el índice de una columna por nombre (búsqueda hash en la tabla)
+int validator_resolve_column(const char* column_name, Table* table) {
+    if (!column_name || !table) return -1;
+    
+    int index = column_get_index(table, column_name);
+    if (index >= 0) return index;
+    
+    // tabla.columna sobre una sola tabla
+    const char* dot = strchr(column_name, '.');
+    if (dot) {
+        size_t length = dot - column_name;
+        if (strlen(table->name) == length && strncasecmp(table->name, column_name, length) == 0) {
+            return column_get_index(table, dot + 1);
         }
+        return -1;
     }
     
-    return NULL;
+    // Columna sin calificar en un JOIN: solo si no es ambigua
+    return validator_find_unqualified(column_name, table, &index) == 1 ? index : -1;
+}
+
+// Registrar el error de una columna que no se pudo resolver
+static int validator_column_error(ValidationResult* result, int code, const char* column_name, Table* table) {
+    char error[200];
+    int index;
+    
+    if (!strchr(column_name, '.') && validator_find_unqualified(column_name, table, &index) > 1) {
+        snprintf(error, sizeof(error), "La columna '%s' es ambigua; indique su tabla (tabla.%s)", 
+                 column_name, column_name);
+    } else {
+        snprintf(error, sizeof(error), "La columna '%s' no existe en la tabla '%s'", 
+                 column_name, table->name);
+    }
+    
+    return validator_set_error(result, code, error);
+}
+
+// Verificar si una columna existe en una tabla
+int validator_check_column_exists(const char* column_name, Table* table) {
+    return validator_resolve_column(column_name, table) >= 0;
+}
+
+// Obtener una columna por nombre
+Column* validator_get_column(const char* column_name, Table* table) {
+    int index = validator_resolve_column(column_name, table);
+    return index >= 0 ? &table->columns[index] : NULL;
 }
 
 // Verificar compatibilidad de tipos
@@ -123,13 +161,74 @@ int validator_validate_column_list(ASTNode* columns_node, Table* table, Validati
         return 1;
     }
     
-    // Verificar cada columna individualmente
+    // Resolver cada columna una sola vez y guardar su índice para la ejecución
+    // (el array se reserva con el nodo)
+    int* indices = columns->column_indices;
+    if (!indices) {
+        return validator_set_error(result, 100, "Lista de columnas sin índices");
+    }
+    
     for (int i = 0; i < columns->count; i++) {
-        if (!validator_check_column_exists(columns->columns[i], table)) {
+        int aggregate = columns->aggregates ? columns->aggregates[i] : AGG_NONE;
+        
+        // COUNT(*) no hace referencia a ninguna columna
+        if (aggregate == AGG_COUNT && strcmp(columns->columns[i], "*") == 0) {
+            indices[i] = -1;
+            continue;
+        }
+        
+        indices[i] = validator_resolve_column(columns->columns[i], table);
+        if (indices[i] < 0) {
+            return validator_column_error(result, 102, columns->columns[i], table);
+        }
+        
+        // SUM y AVG solo se aplican a columnas numéricas
+        if ((aggregate == AGG_SUM || aggregate == AGG_AVG) &&
+            table->columns[indices[i]].type == TYPE_STRING) {
             char error[200];
-            snprintf(error, sizeof(error), "La columna '%s' no existe en la tabla '%s'", 
-                     columns->columns[i], table->name);
-            return validator_set_error(result, 102, error);
+            snprintf(error, sizeof(error), "%s no se puede aplicar a la columna de texto '%s'", 
+                     ast_aggregate_name(aggregate), columns->columns[i]);
+            return validator_set_error(result, 125, error);
+        }
+    }
+    
+    return 1;
+}
+
+// Validar GROUP BY y el uso de funciones de agregación en un SELECT
+static int validator_validate_grouping(SelectStmtData* data, Table* table, ValidationResult* result) {
+    ColumnListData* columns = (ColumnListData*)data->columns->data;
+    
+    if (!data->group_by && !columns->aggregates) {
+        return 1;
+    }
+    
+    if (columns->is_all) {
+        return validator_set_error(result, 126, "SELECT * no se puede combinar con GROUP BY ni con funciones de agregación");
+    }
+    
+    ColumnListData* group_by = NULL;
+    if (data->group_by) {
+        if (!validator_validate_column_list(data->group_by, table, result)) {
+            return 0;
+        }
+        group_by = (ColumnListData*)data->group_by->data;
+    }
+    
+    // Las columnas sin agregar deben ser columnas de agrupación
+    for (int i = 0; i < columns->count; i++) {
+        if (columns->aggregates && columns->aggregates[i] != AGG_NONE) continue;
+        
+        int grouped = 0;
+        for (int g = 0; group_by && g < group_by->count && !grouped; g++) {
+            grouped = group_by->column_indices[g] == columns->column_indices[i];
+        }
+        
+        if (!grouped) {
+            char error[200];
+            snprintf(error, sizeof(error), "La columna '%s' debe aparecer en GROUP BY o usarse en una función de agregación", 
+                     columns->columns[i]);
+            return validator_set_error(result, 127, error);
         }
     }
     
@@ -142,14 +241,21 @@ int validator_validate_expression(ASTNode* expr, Table* table, ValidationResult*
     
     switch (expr->type) {
         case NODE_IDENTIFIER: {
-            // Verificar que el identificador sea una columna válida
+            // Verificar que el identificador sea una columna válida y anotar
+            // su índice y tipo para que la ejecución no busque por nombre
             IdentifierData* id_data = (IdentifierData*)expr->data;
-            if (!validator_check_column_exists(id_data->name, table)) {
-                char error[200];
-                snprintf(error, sizeof(error), "La columna '%s' no existe en la tabla '%s'", 
-                         id_data->name, table->name);
-                return validator_set_error(result, 103, error);
+            int index = validator_resolve_column(id_data->name, table);
+            if (index < 0 && strcasecmp(id_data->name, ROWID_COLUMN_NAME) == 0) {
+                // Pseudocolumna con la posición de la fila (compatibilidad con la CLI)
+                id_data->column_index = ROWID_COLUMN_INDEX;
+                id_data->column_type = TYPE_INT;
+                break;
+            }
+            if (index < 0) {
+                return validator_column_error(result, 103, id_data->name, table);
             }
+            id_data->column_index = index;
+            id_data->column_type = table->columns[index].type;
             break;
         }
         case NODE_BINARY_EXPR: {
@@ -172,34 +278,39 @@ int validator_validate_expression(ASTNode* expr, Table* table, ValidationResult*
                     IdentifierData* id_data = (IdentifierData*)bin_data->left->data;
                     LiteralData* lit_data = (LiteralData*)bin_data->right->data;
                     
-                    Column* column = validator_get_column(id_data->name, table);
-                    if (column) {
-                        int literal_type = ast_type_to_column_type(lit_data->lit_type);
-                        if (!validator_check_type_compatibility(column->type, literal_type)) {
-                            char error[200];
-                            snprintf(error, sizeof(error), 
-                                    "Incompatibilidad de tipos: no se puede comparar columna '%s' (%d) con valor de tipo %d", 
-                                    id_data->name, column->type, literal_type);
-                            return validator_set_error(result, 104, error);
-                        }
+                    // El identificador ya fue resuelto al validar los operandos
+                    int literal_type = ast_type_to_column_type(lit_data->lit_type);
+                    if (lit_data->lit_type != LIT_NULL && !validator_check_type_compatibility(id_data->column_type, literal_type)) {
+                        char error[200];
+                        snprintf(error, sizeof(error), 
+                                "Incompatibilidad de tipos: no se puede comparar columna '%s' (%d) con valor de tipo %d", 
+                                id_data->name, id_data->column_type, literal_type);
+                        return validator_set_error(result, 104, error);
                     }
                 }
                 else if (bin_data->right->type == NODE_IDENTIFIER && bin_data->left->type == NODE_LITERAL) {
                     IdentifierData* id_data = (IdentifierData*)bin_data->right->data;
                     LiteralData* lit_data = (LiteralData*)bin_data->left->data;
                     
-                    Column* column = validator_get_column(id_data->name, table);
-                    if (column) {
-                        int literal_type = ast_type_to_column_type(lit_data->lit_type);
-                        if (!validator_check_type_compatibility(column->type, literal_type)) {
-                            char error[200];
-                            snprintf(error, sizeof(error), 
-                                    "Incompatibilidad de tipos: no se puede comparar columna '%s' (%d) con valor de tipo %d", 
-                                    id_data->name, column->type, literal_type);
-                            return validator_set_error(result, 104, error);
-                        }
+                    // El identificador ya fue resuelto al validar los operandos
+                    int literal_type = ast_type_to_column_type(lit_data->lit_type);
+                    if (lit_data->lit_type != LIT_NULL && !validator_check_type_compatibility(id_data->column_type, literal_type)) {
+                        char error[200];
+                        snprintf(error, sizeof(error), 
+                                "Incompatibilidad de tipos: no se puede comparar columna '%s' (%d) con valor de tipo %d", 
+                                id_data->name, id_data->column_type, literal_type);
+                        return validator_set_error(result, 104, error);
                     }
                 }
+                // Columna comparada con un parámetro: el parámetro toma el tipo de la columna
+                else if (bin_data->left->type == NODE_IDENTIFIER && bin_data->right->type == NODE_PARAMETER) {
+                    IdentifierData* id_data = (IdentifierData*)bin_data->left->data;
+                    ((ParameterData*)bin_data->right->data)->expected_type = id_data->column_type;
+                }
+                else if (bin_data->right->type == NODE_IDENTIFIER && bin_data->left->type == NODE_PARAMETER) {
+                    IdentifierData* id_data = (IdentifierData*)bin_data->right->data;
+                    ((ParameterData*)bin_data->left->data)->expected_type = id_data->column_type;
+                }
             }
             break;
         }
@@ -214,6 +325,9 @@ int validator_validate_expression(ASTNode* expr, Table* table, ValidationResult*
         case NODE_LITERAL:
             // Los literales siempre son válidos en sí mismos
             break;
+        case NODE_PARAMETER:
+            // Los parámetros se comprueban al enlazar sus valores
+            break;
         default:
             return validator_set_error(result, 105, "Tipo de expresión no válido");
     }
@@ -259,12 +373,12 @@ int validator_validate_values(ASTNode* values_node, Table* table, ValidationResu
     for (int i = 0; i < values->count; i++) {
         ASTNode* value = values->values[i];
         
-        // Para literales, verificar compatibilidad de tipo
+        // Para literales, verificar compatibilidad de tipo (NULL vale para cualquier tipo)
         if (value->type == NODE_LITERAL) {
             LiteralData* lit_data = (LiteralData*)value->data;
             int literal_type = ast_type_to_column_type(lit_data->lit_type);
             
-            if (!validator_check_type_compatibility(table->columns[i].type, literal_type)) {
+            if (lit_data->lit_type != LIT_NULL && !validator_check_type_compatibility(table->columns[i].type, literal_type)) {
                 char error[200];
                 snprintf(error, sizeof(error), "Tipo no compatible para columna '%s'. Valor de tipo %d no es compatible con columna de tipo %d", 
                          table->columns[i].name, literal_type, table->columns[i].type);
@@ -289,6 +403,9 @@ int validator_validate_values(ASTNode* values_node, Table* table, ValidationResu
                     return validator_set_error(result, 111, error);
                 }
             }
+        } else if (value->type == NODE_PARAMETER) {
+            // El valor se comprobará al enlazarlo con el tipo de la columna
+            ((ParameterData*)value->data)->expected_type = table->columns[i].type;
         } else {
             // Solo se permiten literales en INSERT VALUES
             return validator_set_error(result, 112, "Los valores para INSERT deben ser literales");
@@ -312,15 +429,17 @@ int validator_validate_assignments(ASTNode* assignments_node, Table* table, Vali
         
         AssignmentData* assign_data = (AssignmentData*)current->data;
         
-        // Verificar que la columna exista
-        if (!validator_check_column_exists(assign_data->column_name, table)) {
+        // Verificar que la columna exista (una sola búsqueda) y anotar su índice
+        int index = validator_resolve_column(assign_data->column_name, table);
+        if (index < 0) {
             char error[200];
             snprintf(error, sizeof(error), "La columna '%s' no existe en la tabla '%s'", 
                      assign_data->column_name, table->name);
             return validator_set_error(result, 114, error);
         }
+        assign_data->column_index = index;
         
-        Column* column = validator_get_column(assign_data->column_name, table);
+        Column* column = &table->columns[index];
         
         // No permitir modificar la clave primaria
         if (column->is_primary_key) {
@@ -335,7 +454,7 @@ int validator_validate_assignments(ASTNode* assignments_node, Table* table, Vali
             LiteralData* lit_data = (LiteralData*)assign_data->value->data;
             int literal_type = ast_type_to_column_type(lit_data->lit_type);
             
-            if (!validator_check_type_compatibility(column->type, literal_type)) {
+            if (lit_data->lit_type != LIT_NULL && !validator_check_type_compatibility(column->type, literal_type)) {
                 char error[200];
                 snprintf(error, sizeof(error), "Tipo no compatible para columna '%s'. Valor de tipo %d no es compatible con columna de tipo %d", 
                          column->name, literal_type, column->type);
@@ -359,6 +478,9 @@ int validator_validate_assignments(ASTNode* assignments_node, Table* table, Vali
                     return validator_set_error(result, 118, error);
                 }
             }
+        } else if (assign_data->value->type == NODE_PARAMETER) {
+            // El valor se comprobará al enlazarlo con el tipo de la columna
+            ((ParameterData*)assign_data->value->data)->expected_type = column->type;
         } else {
             // Validar expresiones más complejas
             if (!validator_validate_expression(assign_data->value, table, result)) {
@@ -433,6 +555,153 @@ int validator_validate_column_defs(ASTNode* column_defs_node, ValidationResult*
     return 1;
 }
 
+// Posición en la lista del SELECT de una columna con el mismo agregado
+int validator_find_select_item(const ColumnListData* columns, int aggregate, int column_index) {
+    for (int i = 0; i < columns->count; i++) {
+        int item_aggregate = columns->aggregates ? columns->aggregates[i] : AGG_NONE;
+        if (item_aggregate == aggregate && columns->column_indices[i] == column_index) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+// Validar el valor de LIMIT u OFFSET: un entero no negativo o un parámetro
+static int validator_validate_row_count(ASTNode* node, const char* clause, ValidationResult* result) {
+    if (node->type == NODE_PARAMETER) {
+        ((ParameterData*)node->data)->expected_type = TYPE_INT;
+        return 1;
+    }
+    
+    if (node->type == NODE_LITERAL) {
+        LiteralData* lit = (LiteralData*)node->data;
+        if (lit->lit_type == LIT_INTEGER && lit->int_value >= 0) {
+            return 1;
+        }
+    }
+    
+    char error[200];
+    snprintf(error, sizeof(error), "%s debe ser un número entero no negativo", clause);
+    return validator_set_error(result, 130, error);
+}
+
+// Validar ORDER BY, LIMIT y OFFSET de un SELECT
+static int validator_validate_ordering(SelectStmtData* data, Table* table, ValidationResult* result) {
+    ColumnListData* columns = (ColumnListData*)data->columns->data;
+    int is_aggregate = columns->aggregates || data->group_by;
+    
+    if (data->order_by) {
+        if (!validator_validate_column_list(data->order_by, table, result)) {
+            return 0;
+        }
+        
+        ColumnListData* order_by = (ColumnListData*)data->order_by->data;
+        for (int i = 0; i < order_by->count; i++) {
+            int aggregate = order_by->aggregates ? order_by->aggregates[i] : AGG_NONE;
+            
+            // Sin agregación se ordena por cualquier columna de la tabla
+            if (!is_aggregate) {
+                if (aggregate != AGG_NONE) {
+                    return validator_set_error(result, 129, "ORDER BY solo admite funciones de agregación en consultas con agregación");
+                }
+                continue;
+            }
+            
+            // Con agregación se ordena el resultado: la columna debe estar en el SELECT
+            if (validator_find_select_item(columns, aggregate, order_by->column_indices[i]) < 0) {
+                char error[200];
+                snprintf(error, sizeof(error), "La columna de ORDER BY '%s' debe aparecer en la lista del SELECT", 
+                         order_by->columns[i]);
+                return validator_set_error(result, 128, error);
+            }
+        }
+    }
+    
+    if (data->limit && !validator_validate_row_count(data->limit, "LIMIT", result)) {
+        return 0;
+    }
+    if (data->offset && !validator_validate_row_count(data->offset, "OFFSET", result)) {
+        return 0;
+    }
+    
+    return 1;
+}
+
+// Indica si una expresión usa la pseudocolumna rowid
+int validator_uses_rowid(ASTNode* expr) {
+    if (!expr) return 0;
+    
+    switch (expr->type) {
+        case NODE_IDENTIFIER:
+            return ((IdentifierData*)expr->data)->column_index == ROWID_COLUMN_INDEX;
+        case NODE_BINARY_EXPR:
+            return validator_uses_rowid(((BinaryExprData*)expr->data)->left) ||
+                   validator_uses_rowid(((BinaryExprData*)expr->data)->right);
+        case NODE_UNARY_EXPR:
+            return validator_uses_rowid(((UnaryExprData*)expr->data)->operand);
+        default:
+            return 0;
+    }
+}
+
+// Validar la condición ON de un JOIN: igualdad entre una columna de cada tabla
+static int validator_validate_join(SelectStmtData* data, Table* left, Table* joined, ValidationResult* result) {
+    ASTNode* condition = data->join_condition;
+    
+    if (!validator_validate_expression(condition, joined, result)) {
+        return 0;
+    }
+    
+    BinaryExprData* bin_data = condition->type == NODE_BINARY_EXPR ? (BinaryExprData*)condition->data : NULL;
+    if (!bin_data || bin_data->op_type != OP_EQ ||
+        bin_data->left->type != NODE_IDENTIFIER || bin_data->right->type != NODE_IDENTIFIER) {
+        return validator_set_error(result, 131, "La condición ON debe igualar una columna de cada tabla (a.x = b.y)");
+    }
+    
+    IdentifierData* a = (IdentifierData*)bin_data->left->data;
+    IdentifierData* b = (IdentifierData*)bin_data->right->data;
+    if (a->column_index < 0 || b->column_index < 0 ||
+        (a->column_index < left->num_columns) == (b->column_index < left->num_columns)) {
+        return validator_set_error(result, 131, "La condición ON debe igualar una columna de cada tabla (a.x = b.y)");
+    }
+    
+    // Las claves se comparan como números o como cadenas, no mezcladas
+    if ((a->column_type == TYPE_STRING) != (b->column_type == TYPE_STRING)) {
+        char error[200];
+        snprintf(error, sizeof(error), "Las columnas '%s' y '%s' del JOIN no tienen tipos compatibles", 
+                 a->name, b->name);
+        return validator_set_error(result, 132, error);
+    }
+    
+    return 1;
+}
+
+// Validar las cláusulas de un SELECT contra su tabla (o el esquema unido de un JOIN)
+static int validator_validate_select_clauses(SelectStmtData* data, Table* table, ValidationResult* result) {
+    // Validar columnas
+    if (!validator_validate_column_list(data->columns, table, result)) {
+        return 0;
+    }
+    
+    // Validar cláusula WHERE si existe
+    if (data->where_clause && !validator_validate_where_clause(data->where_clause, table, result)) {
+        return 0;
+    }
+    
+    // Validar agrupación y funciones de agregación
+    if (!validator_validate_grouping(data, table, result)) {
+        return 0;
+    }
+    
+    // Validar ordenación y límite de filas
+    if (!validator_validate_ordering(data, table, result)) {
+        return 0;
+    }
+    
+    return 1;
+}
+
 // Validar una sentencia SELECT
 int validator_validate_select(ASTNode* node, Database* db, ValidationResult* result) {
     if (!node || !db || !result) return 0;
@@ -447,17 +716,37 @@ int validator_validate_select(ASTNode* node, Database* db, ValidationResult* res
         return validator_set_error(result, 201, error);
     }
     
-    // Validar columnas
-    if (!validator_validate_column_list(data->columns, table, result)) {
-        return 0;
+    if (!data->join_table) {
+        return validator_validate_select_clauses(data, table, result);
     }
     
-    // Validar cláusula WHERE si existe
-    if (data->where_clause && !validator_validate_where_clause(data->where_clause, table, result)) {
-        return 0;
+    // JOIN: las columnas se resuelven contra las de ambas tablas, una tras otra
+    Table* right = validator_find_table(data->join_table, db);
+    if (!right) {
+        char error[200];
+        snprintf(error, sizeof(error), "La tabla '%s' no existe", data->join_table);
+        return validator_set_error(result, 201, error);
+    }
+    if (right == table) {
+        return validator_set_error(result, 134, "No se puede unir una tabla consigo misma");
     }
     
-    return 1;
+    Table* joined = table_create_joined(table, right);
+    if (!joined) {
+        return validator_set_error(result, 100, "Error de memoria al preparar el JOIN");
+    }
+    
+    int valid = validator_validate_join(data, table, joined, result) &&
+                validator_validate_select_clauses(data, joined, result);
+    
+    // rowid no identifica las filas del resultado de un JOIN
+    if (valid && data->where_clause &&
+        validator_uses_rowid(((WhereClauseData*)data->where_clause->data)->condition)) {
+        valid = validator_set_error(result, 133, "rowid no se puede usar en consultas con JOIN");
+    }
+    
+    table_free(joined);
+    return valid;
 }
 
 // Validar una sentencia INSERT
@@ -474,9 +763,11 @@ int validator_validate_insert(ASTNode* node, Database* db, ValidationResult* res
         return validator_set_error(result, 202, error);
     }
     
-    // Validar valores
-    if (!validator_validate_values(data->values, table, result)) {
-        return 0;
+    // Validar los valores de cada fila contra la misma tabla
+    for (ASTNode* row = data->values; row; row = row->next) {
+        if (!validator_validate_values(row, table, result)) {
+            return 0;
+        }
     }
     
     return 1;
@@ -4,6 +4,10 @@
 #include "ast.h"
 #include "../db/database.h"
 
+// Pseudocolumna con la posición de cada fila entre las visibles (WHERE rowid = n)
+#define ROWID_COLUMN_NAME "rowid"
+#define ROWID_COLUMN_INDEX -2
+
 // Estructura para almacenar resultado de validación
 typedef struct {
     int error_code;
@@ -35,10 +39,19 @@ int validator_validate_expression(ASTNode* expr, Table* table, ValidationResult*
 int validator_validate_where_clause(ASTNode* where, Table* table, ValidationResult* result);
 int validator_validate_values(ASTNode* values, Table* table, ValidationResult* result);
 
+// Posición en la lista del SELECT de una columna con el mismo agregado (-1 si no está)
+int validator_find_select_item(const ColumnListData* columns, int aggregate, int column_index);
+
+// Indica si una expresión usa la pseudocolumna rowid
+int validator_uses_rowid(ASTNode* expr);
+
 // Utilidades
 Table* validator_find_table(const char* table_name, Database* db);
+int validator_resolve_column(const char* column_name, Table* table);
 int validator_check_column_exists(const char* column_name, Table* table);
+Column* validator_get_column(const char* column_name, Table* table);
 int validator_check_type_compatibility(int expected_type, int actual_type);
+int ast_type_to_column_type(LiteralType lit_type);
 int validator_set_error(ValidationResult* result, int code, const char* message);
 
 #endif /* VALIDATOR_H */
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "server.h"
+#include "protocol.h"
+#include "../cli/batch.h"
+
+// Sentencias (y bytes) que se envían sin esperar respuesta cuando la entrada no es
+// una terminal. Los bytes quedan por debajo de lo que cabe en el socket, para que el
+// cliente nunca se bloquee enviando mientras el servidor espera a que lea.
+#define CLIENT_PIPELINE_DEPTH 256
+#define CLIENT_PIPELINE_BYTES (32 * 1024)
+
+// Sentencias pendientes de enviar, ya codificadas como mensajes
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    int count;
+} Pipeline;
+
+// Sesión con el servidor
+typedef struct {
+    int fd;
+    int depth;                 // Sentencias que se envían sin esperar respuesta
+    Pipeline pipeline;
+    int failed;                // Sentencias que han fallado
+    int lost;                  // Se perdió la conexión
+} Client;
+
+static void print_usage(const char *program) {
+    printf("Uso: %s [-s ruta_socket] [-p puerto_tcp] [--format formato]\n", program);
+    printf("  -s ruta     Socket Unix del servidor (por defecto %s)\n", SERVER_DEFAULT_SOCKET);
+    printf("  -p puerto   Conectar a 127.0.0.1:puerto en lugar del socket Unix\n");
+    printf("  --format f  Formato de los resultados: table, csv, tsv, jsonl o binary\n");
+}
+
+// Conecta con el servidor (-1 si hubo error)
+static int client_connect(const char *path, int port) {
+    int fd;
+    int status;
+
+    if (port > 0) {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        status = connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+    } else {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+        strcpy(addr.sun_path, path);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        status = connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+    }
+
+    if (status != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Muestra la salida de una sentencia hasta su fin
+// (0 si tuvo éxito, 1 si falló, -1 si se perdió la conexión)
+static int print_response(int fd) {
+    while (1) {
+        char type;
+        char *data;
+        size_t length;
+        if (protocol_read_message(fd, &type, &data, &length) != 0) return -1;
+
+        int status = length == 1 && data[0] == 0 ? 0 : 1;
+        if (type == PROTOCOL_DATA) {
+            fwrite(data, 1, length, stdout);
+        }
+        free(data);
+
+        if (type == PROTOCOL_DONE) {
+            fflush(stdout);
+            return status;
+        }
+    }
+}
+
+// Cambia el formato de los resultados de la sesión sin mostrar la respuesta
+// (0 si el servidor lo aceptó, 1 si no, -1 si se perdió la conexión)
+static int client_set_format(int fd, const char *format) {
+    char command[64];
+    snprintf(command, sizeof(command), "\\format %s", format);
+    if (protocol_send_query(fd, command) != 0) return -1;
+
+    while (1) {
+        char type;
+        char *data;
+        size_t length;
+        if (protocol_read_message(fd, &type, &data, &length) != 0) return -1;
+
+        int status = length == 1 && data[0] == 0 ? 0 : 1;
+        free(data);
+        if (type == PROTOCOL_DONE) return status;
+    }
+}
+
+// Añade una sentencia a las pendientes (-1 si faltó memoria)
+static int pipeline_add(Pipeline *pipeline, const char *sql, size_t length) {
+    size_t needed = pipeline->length + PROTOCOL_HEADER_SIZE + length;
+    if (needed > pipeline->capacity) {
+        size_t capacity = pipeline->capacity == 0 ? 4096 : pipeline->capacity;
+        while (capacity < needed) capacity *= 2;
+        char *grown = (char *)realloc(pipeline->data, capacity);
+        if (!grown) return -1;
+        pipeline->data = grown;
+        pipeline->capacity = capacity;
+    }
+
+    protocol_encode_header((unsigned char *)pipeline->data + pipeline->length, PROTOCOL_QUERY, length);
+    memcpy(pipeline->data + pipeline->length + PROTOCOL_HEADER_SIZE, sql, length);
+    pipeline->length = needed;
+    pipeline->count++;
+    return 0;
+}
+
+// Envía las sentencias pendientes y muestra sus respuestas en orden, contando las que
+// fallan (-1 si se perdió la conexión)
+static int pipeline_flush(Client *client) {
+    Pipeline *pipeline = &client->pipeline;
+    int status = protocol_write_all(client->fd, pipeline->data, pipeline->length);
+    for (int i = 0; i < pipeline->count && status == 0; i++) {
+        int response = print_response(client->fd);
+        if (response < 0) status = -1;
+        else client->failed += response;
+    }
+    pipeline->length = 0;
+    pipeline->count = 0;
+    if (status != 0) client->lost = 1;
+    return status;
+}
+
+// Envía una sentencia, o la deja pendiente hasta completar un grupo
+// (0 si tuvo éxito, -1 si faltó memoria o se perdió la conexión)
+static int client_send(Client *client, const char *sql, size_t length) {
+    if (pipeline_add(&client->pipeline, sql, length) != 0) {
+        printf("Error: Memoria insuficiente\n");
+        return -1;
+    }
+    if (client->pipeline.count >= client->depth || client->pipeline.length >= CLIENT_PIPELINE_BYTES) {
+        return pipeline_flush(client);
+    }
+    return 0;
+}
+
+// Recibe las sentencias de la entrada cuando no es una terminal
+static int client_statement(void *ctx, const CommandEntry *entry, const char *text, size_t length) {
+    (void)entry;
+    return client_send((Client *)ctx, text, length) == 0 ? 0 : -1;
+}
+
+// Lee una sentencia por línea de la terminal hasta el final o "exit" (-1 si se
+// perdió la conexión o faltó memoria)
+static int client_interactive(Client *client) {
+    char *line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    int status = 0;
+
+    while (status == 0) {
+        printf("NQL> ");
+        fflush(stdout);
+        if ((length = getline(&line, &capacity, stdin)) < 0) break;
+
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if (length == 0) continue;
+        if (strcmp(line, "exit") == 0) break;
+
+        status = client_send(client, line, length);
+    }
+
+    free(line);
+    return status;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = SERVER_DEFAULT_SOCKET;
+    int port = 0;
+    const char *format = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    int fd = client_connect(path, port);
+    if (fd < 0) {
+        printf("Error: No se pudo conectar con el servidor\n");
+        return 1;
+    }
+
+    if (format) {
+        int status = client_set_format(fd, format);
+        if (status != 0) {
+            if (status > 0) {
+                printf("Error: Formato de salida no válido: '%s'\n", format);
+            } else {
+                printf("Error: Se perdió la conexión con el servidor\n");
+            }
+            close(fd);
+            return 1;
+        }
+    }
+
+    // En una terminal cada línea es una sentencia y espera su respuesta; leyendo de un
+    // archivo o de una tubería las sentencias terminan en ';' como en el modo por lotes
+    // de nql_cli y se envían varias seguidas
+    int interactive = isatty(STDIN_FILENO);
+    Client client = {fd, interactive ? 1 : CLIENT_PIPELINE_DEPTH, {NULL, 0, 0, 0}, 0, 0};
+    int status;
+
+    if (interactive) {
+        status = client_interactive(&client);
+    } else {
+        cmd_registry_init();
+        status = batch_split(STDIN_FILENO, client_statement, &client);
+        cmd_registry_cleanup();
+    }
+
+    if (!client.lost && client.pipeline.count > 0) pipeline_flush(&client);
+    if (client.lost) printf("Error: Se perdió la conexión con el servidor\n");
+
+    protocol_write_message(fd, PROTOCOL_TERMINATE, NULL, 0);
+    close(fd);
+    free(client.pipeline.data);
+
+    // Como nql_cli con un script, termina con error si falló alguna sentencia
+    return status != 0 || client.lost || client.failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "server.h"
+#include "../cli/commands/cmd_registry.h"
+#include "../db/database.h"
+#include "../utils/scheduler.h"
+
+static void handle_signal(int signal) {
+    (void)signal;
+    server_stop();
+}
+
+static void print_usage(const char *program) {
+    printf("Uso: %s [-s ruta_socket] [-p puerto_tcp] [-w hilos] [-t segundos]\n", program);
+    printf("  -s ruta   Socket Unix en el que escuchar (por defecto %s)\n", SERVER_DEFAULT_SOCKET);
+    printf("  -p puerto Escuchar también en 127.0.0.1:puerto\n");
+    printf("  -w hilos  Hilos que ejecutan sentencias (por defecto dos por CPU); una\n");
+    printf("            transacción abierta ocupa un hilo más hasta COMMIT o ROLLBACK\n");
+    printf("  -t seg    Segundos que una transacción puede estar inactiva antes de\n");
+    printf("            deshacerse y cerrar su conexión (por defecto %d)\n", SERVER_IDLE_TIMEOUT_MS / 1000);
+}
+
+int main(int argc, char *argv[]) {
+    ServerConfig config = {SERVER_DEFAULT_SOCKET, 0, 0, 0};
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.socket_path = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            config.tcp_port = atoi(argv[++i]);
+            if (config.tcp_port <= 0 || config.tcp_port > 65535) {
+                printf("Error: Puerto no válido: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            config.workers = atoi(argv[++i]);
+            if (config.workers <= 0) {
+                printf("Error: Número de hilos no válido: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            int seconds = atoi(argv[++i]);
+            if (seconds <= 0 || seconds > 24 * 3600) {
+                printf("Error: Tiempo de inactividad no válido: %s\n", argv[i]);
+                return 1;
+            }
+            config.idle_timeout_ms = seconds * 1000;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Todos los clientes comparten la base de datos de este proceso
+    db_init();
+    cmd_registry_init();
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("NQL server escuchando en %s", config.socket_path);
+    if (config.tcp_port > 0) printf(" y 127.0.0.1:%d", config.tcp_port);
+    printf("\n");
+    fflush(stdout);
+
+    int status = server_run(&config);
+
+    cmd_registry_cleanup();
+    scheduler_shutdown();
+    db_cleanup();
+    return status == 0 ? 0 : 1;
+}
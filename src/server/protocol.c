@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "protocol.h"
+
+// Envía la cabecera y los datos con una sola llamada mientras se pueda,
+// reintentando con lo que falte si el envío es parcial. Si el otro extremo deja de
+// leer durante PROTOCOL_SEND_TIMEOUT_MS se da por perdida la conexión.
+static int send_all(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        // MSG_NOSIGNAL: un cliente que se va no debe terminar el servidor con SIGPIPE
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+
+            // Socket no bloqueante: se espera a que el cliente lea
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd = {fd, POLLOUT, 0};
+                int ready = poll(&pfd, 1, PROTOCOL_SEND_TIMEOUT_MS);
+                if (ready < 0 && errno != EINTR) return -1;
+                if (ready == 0) {
+                    errno = ETIMEDOUT;
+                    return -1;
+                }
+                continue;
+            }
+            return -1;
+        }
+
+        while (count > 0 && (size_t)sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return 0;
+}
+
+// Lee exactamente length bytes (0 si tuvo éxito, 1 si la conexión se cerró antes
+// del primer byte, -1 si hubo error o se cerró a medias)
+static int read_all(int fd, void* buffer, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t got = read(fd, (char*)buffer + done, length - done);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) return done == 0 ? 1 : -1;
+        done += got;
+    }
+    return 0;
+}
+
+// Longitud de los datos de un mensaje según su cabecera
+static size_t decode_length(const unsigned char* header) {
+    return ((size_t)header[1] << 24) | ((size_t)header[2] << 16) |
+           ((size_t)header[3] << 8) | header[4];
+}
+
+void protocol_encode_header(unsigned char* header, char type, size_t length) {
+    header[0] = (unsigned char)type;
+    header[1] = (length >> 24) & 0xFF;
+    header[2] = (length >> 16) & 0xFF;
+    header[3] = (length >> 8) & 0xFF;
+    header[4] = length & 0xFF;
+}
+
+int protocol_write_all(int fd, const void* data, size_t length) {
+    struct iovec iov;
+    iov.iov_base = (void*)data;
+    iov.iov_len = length;
+    return length > 0 ? send_all(fd, &iov, 1) : 0;
+}
+
+int protocol_write_message(int fd, char type, const void* data, size_t length) {
+    if (length > PROTOCOL_MAX_MESSAGE) return -1;
+
+    unsigned char header[PROTOCOL_HEADER_SIZE];
+    protocol_encode_header(header, type, length);
+
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = (void*)data;
+    iov[1].iov_len = length;
+
+    return send_all(fd, iov, length > 0 ? 2 : 1);
+}
+
+int protocol_read_message(int fd, char* type, char** data, size_t* length) {
+    unsigned char header[PROTOCOL_HEADER_SIZE];
+    int status = read_all(fd, header, sizeof(header));
+    if (status != 0) return status;
+
+    size_t size = decode_length(header);
+    if (size > PROTOCOL_MAX_MESSAGE) return -1;
+
+    char* buffer = (char*)malloc(size + 1);
+    if (!buffer) return -1;
+
+    if (size > 0 && read_all(fd, buffer, size) != 0) {
+        free(buffer);
+        return -1;
+    }
+    buffer[size] = '\0';
+
+    *type = (char)header[0];
+    *data = buffer;
+    *length = size;
+    return 0;
+}
+
+int protocol_parse_message(const char* buffer, size_t available, char* type,
+                           const char** data, size_t* length) {
+    if (available < PROTOCOL_HEADER_SIZE) return 0;
+
+    size_t size = decode_length((const unsigned char*)buffer);
+    if (size > PROTOCOL_MAX_MESSAGE) return -1;
+    if (available - PROTOCOL_HEADER_SIZE < size) return 0;
+
+    *type = buffer[0];
+    *data = buffer + PROTOCOL_HEADER_SIZE;
+    *length = size;
+    return (int)(PROTOCOL_HEADER_SIZE + size);
+}
+
+int protocol_send_query(int fd, const char* sql) {
+    return protocol_write_message(fd, PROTOCOL_QUERY, sql, strlen(sql));
+}
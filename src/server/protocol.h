@@ -0,0 +1,59 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Protocolo entre nql_server y sus clientes. Cada mensaje es un byte de tipo,
+// la longitud de los datos (4 bytes, big-endian) y los datos.
+//
+//   Cliente -> servidor:  'Q' sentencia (texto sin '\0')
+//                         'X' fin de la conexión (sin datos)
+//   Servidor -> cliente:  'D' fragmento de la salida de la sentencia
+//                         'Z' fin de la sentencia (1 byte: 0 éxito, 1 error)
+//
+// La salida de una sentencia se envía en varios 'D' a medida que se genera,
+// sin esperar a tener el resultado completo.
+//
+// El cliente puede enviar varias sentencias seguidas sin esperar respuesta; el
+// servidor las ejecuta y responde en el mismo orden.
+#define PROTOCOL_QUERY      'Q'
+#define PROTOCOL_TERMINATE  'X'
+#define PROTOCOL_DATA       'D'
+#define PROTOCOL_DONE       'Z'
+
+// Bytes de cabecera de cada mensaje
+#define PROTOCOL_HEADER_SIZE 5
+
+// Máximo de datos de un mensaje; uno mayor se considera un error del otro extremo
+#define PROTOCOL_MAX_MESSAGE (16 * 1024 * 1024)
+
+// Milisegundos que se espera a que el otro extremo lea cuando el socket está lleno
+#define PROTOCOL_SEND_TIMEOUT_MS 30000
+
+// Envía un mensaje completo, esperando si el socket no bloqueante está lleno
+// (0 si tuvo éxito, -1 si se cerró la conexión, dejó de leer o hubo error)
+int protocol_write_message(int fd, char type, const void* data, size_t length);
+
+// Escribe la cabecera de un mensaje (PROTOCOL_HEADER_SIZE bytes), para quien acumula
+// varios mensajes antes de enviarlos
+void protocol_encode_header(unsigned char* header, char type, size_t length);
+
+// Envía bytes ya codificados como mensajes (0 si tuvo éxito, -1 si hubo error o el
+// otro extremo dejó de leer)
+int protocol_write_all(int fd, const void* data, size_t length);
+
+// Recibe un mensaje. Los datos se devuelven en un buffer terminado en '\0' que
+// libera quien llama. Devuelve 0 si tuvo éxito, 1 si el otro extremo cerró la
+// conexión entre mensajes y -1 si hubo error.
+int protocol_read_message(int fd, char* type, char** data, size_t* length);
+
+// Extrae el primer mensaje de los bytes recibidos en buffer, sin copiarlo. Devuelve los
+// bytes que ocupa, 0 si aún no ha llegado entero y -1 si la cabecera no es válida.
+int protocol_parse_message(const char* buffer, size_t available, char* type,
+                           const char** data, size_t* length);
+
+// Envía una sentencia
+int protocol_send_query(int fd, const char* sql);
+
+#endif /* PROTOCOL_H */
@@ -0,0 +1,763 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "server.h"
+#include "protocol.h"
+#include "../cli/cli.h"
+#include "../db/database.h"
+#include "../db/result.h"
+#include "../executor/prepared.h"
+#include "../executor/plan_cache.h"
+#include "../executor/transaction.h"
+#include "../utils/output.h"
+
+// Descriptores que vigila el bucle de eventos
+typedef enum {
+    ENDPOINT_STOP,                // Tubería de server_stop
+    ENDPOINT_LISTENER,            // Socket en el que se aceptan conexiones
+    ENDPOINT_TIMER,               // Vencimiento de las transacciones inactivas
+    ENDPOINT_CLIENT               // Conexión de un cliente
+} EndpointKind;
+
+typedef struct {
+    EndpointKind kind;
+    int fd;
+} Endpoint;
+
+typedef struct Worker Worker;
+
+// Conexión de un cliente. Mientras no la atiende un hilo de trabajo solo la toca
+// el bucle de eventos, que lee lo que envía el cliente.
+typedef struct Connection {
+    Endpoint endpoint;            // Debe ser el primer campo (epoll guarda su dirección)
+    char* input;                  // Bytes recibidos aún sin ejecutar
+    size_t input_length;
+    size_t input_capacity;
+    int eof;                      // El cliente cerró su lado de la conexión
+    int closing;                  // La conexión se cierra al terminar de atenderla
+    int busy;                     // La atiende un hilo de trabajo (epoll no la vigila)
+    Worker* bound;                // Hilo que guarda su transacción abierta (NULL si no hay)
+    long long idle_deadline;      // Cuándo se deshace su transacción si sigue inactiva (0: no vence)
+    int expired;                  // Su transacción estuvo inactiva demasiado tiempo
+    PreparedSession prepared;     // Sentencias preparadas de la sesión
+    ResultFormat format;          // Formato de los resultados de la sesión (\format)
+    struct Connection* prev;      // Lista de conexiones abiertas
+    struct Connection* next;
+    struct Connection* queue_next; // Cola de conexiones con sentencias listas
+} Connection;
+
+// Hilo que ejecuta sentencias. Una transacción abierta guarda bloqueos que son del
+// hilo que la empezó, así que su conexión se queda con ese hilo hasta COMMIT o
+// ROLLBACK. Mientras tanto el hilo sale del grupo (no atiende a nadie más) y se
+// arranca otro en su lugar; al terminar la transacción sobra uno y se retira.
+struct Worker {
+    pthread_t thread;
+    struct Worker* next;          // Lista de hilos en marcha o retirados
+    Connection* bound;            // Conexión cuya transacción guarda
+    Connection* ready;            // Esa conexión, cuando tiene sentencias listas
+    Connection* current;          // Conexión que se está atendiendo
+    int failed;                   // El cliente actual dejó de aceptar datos
+    FILE* out;                    // Salida de las sentencias (se envía como 'D')
+    char* response;               // Mensajes para el cliente actual aún sin enviar
+    size_t response_length;
+    size_t response_capacity;
+};
+
+// Estado del servidor (uno por proceso)
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t connections_done = PTHREAD_COND_INITIALIZER;
+static Connection* queue_head = NULL;
+static Connection* queue_tail = NULL;
+static Connection* connections = NULL;
+static int num_connections = 0;
+static int stopping = 0;
+static int workers_exit = 0;
+static int epoll_fd = -1;
+static Worker* workers = NULL;              // Hilos en marcha
+static Worker* retired_workers = NULL;      // Hilos que han terminado y falta esperar
+static int pool_size = 0;                   // Hilos libres (sin transacción) que se mantienen
+static int free_workers = 0;                // Hilos en marcha sin transacción abierta
+static int num_threads = 0;                 // Hilos en marcha
+static int idle_timeout_ms = SERVER_IDLE_TIMEOUT_MS;
+static Endpoint timer_endpoint = {ENDPOINT_TIMER, -1};
+static long long timer_deadline = 0;        // Vencimiento programado en el temporizador (0 ninguno)
+// Tubería con la que server_stop despierta al bucle de eventos. Dura todo el proceso:
+// la parada puede llegar desde una señal en cualquier momento.
+static Endpoint stop_endpoint = {ENDPOINT_STOP, -1};
+static atomic_int stop_write_fd = -1;
+
+// Bytes que se leen de un cliente antes de ponerse a ejecutar lo recibido
+#define SERVER_READ_BATCH (256 * 1024)
+
+static void* worker_main(void* arg);
+
+// Milisegundos del reloj monótono
+static long long now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Programa el temporizador para el vencimiento indicado si es anterior al que tiene
+// (con pool_lock tomado)
+static void timer_schedule(long long deadline) {
+    if (timer_deadline != 0 && timer_deadline <= deadline) return;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = deadline / 1000;
+    spec.it_value.tv_nsec = (deadline % 1000) * 1000000;
+    if (timerfd_settime(timer_endpoint.fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0) timer_deadline = deadline;
+}
+
+// Envía al cliente actual los mensajes acumulados
+static void worker_flush(Worker* worker) {
+    if (worker->response_length == 0) return;
+
+    // Si el cliente se fue o dejó de leer (PROTOCOL_SEND_TIMEOUT_MS), la salida se
+    // descarta, las sentencias terminan igualmente y se cierra la conexión
+    if (!worker->failed &&
+        protocol_write_all(worker->current->endpoint.fd, worker->response, worker->response_length) != 0) {
+        worker->failed = 1;
+    }
+    worker->response_length = 0;
+}
+
+// Añade un mensaje para el cliente actual. Las respuestas de varias sentencias
+// seguidas se envían juntas con una sola llamada.
+static void worker_send(Worker* worker, char type, const void* data, size_t length) {
+    if (worker->failed) return;
+
+    size_t needed = worker->response_length + PROTOCOL_HEADER_SIZE + length;
+    if (needed > worker->response_capacity) {
+        size_t capacity = worker->response_capacity == 0 ? 4096 : worker->response_capacity;
+        while (capacity < needed) capacity *= 2;
+        char* grown = (char*)realloc(worker->response, capacity);
+        if (!grown) {
+            worker->failed = 1;
+            return;
+        }
+        worker->response = grown;
+        worker->response_capacity = capacity;
+    }
+
+    protocol_encode_header((unsigned char*)worker->response + worker->response_length, type, length);
+    if (length > 0) memcpy(worker->response + worker->response_length + PROTOCOL_HEADER_SIZE, data, length);
+    worker->response_length = needed;
+
+    if (worker->response_length >= SERVER_OUTPUT_BUFFER) worker_flush(worker);
+}
+
+// Pasa al cliente actual lo que la sentencia ha escrito en su salida
+static ssize_t worker_write(void* cookie, const char* buffer, size_t size) {
+    Worker* worker = (Worker*)cookie;
+    if (worker->current) worker_send(worker, PROTOCOL_DATA, buffer, size);
+    return size;
+}
+
+// Cierra la respuesta de una sentencia con su estado
+static void worker_done(Worker* worker, int status) {
+    unsigned char code = status == 0 ? 0 : 1;
+    fflush(worker->out);
+    worker_send(worker, PROTOCOL_DONE, &code, 1);
+}
+
+// Fin de una sentencia de un grupo de INSERT, que siempre tiene éxito
+static void worker_insert_done(void* ctx) {
+    worker_done((Worker*)ctx, 0);
+}
+
+// Vuelve a vigilar la conexión (0 si tuvo éxito)
+static int connection_arm(Connection* conn, int op) {
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = conn;
+    return epoll_ctl(epoll_fd, op, conn->endpoint.fd, &event);
+}
+
+// Entrega la conexión a un hilo de trabajo (con pool_lock tomado)
+static void connection_dispatch(Connection* conn) {
+    conn->busy = 1;
+    conn->idle_deadline = 0;
+
+    if (conn->bound) {
+        conn->bound->ready = conn;
+    } else {
+        conn->queue_next = NULL;
+        if (queue_tail) queue_tail->queue_next = conn;
+        else queue_head = conn;
+        queue_tail = conn;
+    }
+    pthread_cond_broadcast(&pool_cond);
+}
+
+// Cierra la conexión y la libera (con pool_lock tomado)
+static void connection_close(Connection* conn) {
+    if (conn->prev) conn->prev->next = conn->next;
+    else connections = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+
+    if (--num_connections == 0) pthread_cond_broadcast(&connections_done);
+
+    close(conn->endpoint.fd);
+    free(conn->input);
+    free(conn);
+}
+
+// Ejecuta las sentencias completas que ha enviado el cliente
+static void worker_serve(Worker* worker, Connection* conn) {
+    worker->current = conn;
+    worker->failed = 0;
+    PreparedSession* previous = prepared_use_session(&conn->prepared);
+    result_set_format(conn->format);
+
+    // El cliente lo lee al esperar la respuesta a su siguiente sentencia
+    if (conn->expired) {
+        char message[200];
+        int length = snprintf(message, sizeof(message),
+                              "Error: Se deshizo la transacción por estar inactiva más de %.1f s; "
+                              "se cierra la conexión\n", idle_timeout_ms / 1000.0);
+        worker_send(worker, PROTOCOL_DATA, message, length);
+        worker_flush(worker);
+        conn->closing = 1;
+    }
+
+    size_t offset = 0;
+    while (!conn->closing && !worker->failed) {
+        // Sentencias que el cliente ha enviado sin esperar respuesta
+        char* sqls[PLAN_CACHE_MAX_BATCH];
+        int count = 0;
+        while (count < PLAN_CACHE_MAX_BATCH) {
+            char type;
+            const char* data;
+            size_t length;
+            int used = protocol_parse_message(conn->input + offset, conn->input_length - offset,
+                                              &type, &data, &length);
+            if (used == 0) break;
+            if (used < 0 || type != PROTOCOL_QUERY) {
+                conn->closing = 1;
+                break;
+            }
+            offset += used;
+
+            sqls[count] = strndup(data, length);
+            if (!sqls[count] || strcmp(sqls[count], "exit") == 0) {
+                free(sqls[count]);
+                conn->closing = 1;
+                break;
+            }
+            count++;
+        }
+        if (count == 0) break;
+
+        // Se responden en orden; los INSERT seguidos sobre una tabla se añaden de una vez
+        for (int i = 0; i < count && !worker->failed; ) {
+            int grouped = plan_cache_execute_inserts(sqls + i, count - i, db_get_database(),
+                                                     worker_insert_done, worker);
+            if (grouped > 0) {
+                i += grouped;
+            } else {
+                worker_done(worker, cli_execute(sqls[i]));
+                i++;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            free(sqls[i]);
+        }
+        worker_flush(worker);
+    }
+    if (worker->failed) conn->closing = 1;
+
+    // Se quita lo ejecutado; lo que quede es un mensaje a medias
+    conn->input_length -= offset;
+    if (conn->input_length == 0) {
+        free(conn->input);
+        conn->input = NULL;
+        conn->input_capacity = 0;
+    } else if (offset > 0) {
+        memmove(conn->input, conn->input + offset, conn->input_length);
+    }
+
+    if (conn->eof) conn->closing = 1;
+
+    // Una transacción que el cliente dejó abierta se deshace
+    if (conn->closing) {
+        worker->failed = 1;
+        transaction_cleanup();
+        fflush(worker->out);
+        prepared_cleanup();
+        worker->response_length = 0;
+    }
+
+    prepared_use_session(previous);
+    conn->format = result_get_format();
+    result_set_format(RESULT_FORMAT_TABLE);
+    worker->current = NULL;
+
+    // Si sigue abierta una transacción, la conexión se queda con este hilo
+    worker->bound = transaction_active() ? conn : NULL;
+    conn->bound = worker->bound ? worker : NULL;
+}
+
+// Devuelve la conexión al bucle de eventos o la cierra (con pool_lock tomado)
+static void worker_finish(Connection* conn) {
+    conn->busy = 0;
+
+    if (conn->closing) {
+        connection_close(conn);
+    } else if (stopping) {
+        // El servidor se para: se atiende otra vez para deshacer su sesión
+        conn->eof = 1;
+        connection_dispatch(conn);
+    } else if (connection_arm(conn, EPOLL_CTL_MOD) != 0) {
+        conn->eof = 1;
+        connection_dispatch(conn);
+    } else if (conn->bound) {
+        // Una transacción no puede quedarse abierta indefinidamente sin actividad
+        conn->idle_deadline = now_ms() + idle_timeout_ms;
+        timer_schedule(conn->idle_deadline);
+    }
+}
+
+// Arranca un hilo de trabajo sin transacción (con pool_lock tomado; 0 si tuvo éxito)
+static int worker_start(void) {
+    if (num_threads >= SERVER_MAX_THREADS) return -1;
+
+    Worker* worker = (Worker*)calloc(1, sizeof(Worker));
+    if (!worker) return -1;
+
+    cookie_io_functions_t io = {NULL, worker_write, NULL, NULL};
+    worker->out = fopencookie(worker, "w", io);
+    if (!worker->out) {
+        free(worker);
+        return -1;
+    }
+    setvbuf(worker->out, NULL, _IOFBF, SERVER_OUTPUT_BUFFER);
+
+    if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+        fclose(worker->out);
+        free(worker);
+        return -1;
+    }
+
+    worker->next = workers;
+    workers = worker;
+    num_threads++;
+    free_workers++;
+    return 0;
+}
+
+// Espera a que termine un hilo y libera lo suyo
+static void worker_free(Worker* worker) {
+    pthread_join(worker->thread, NULL);
+    fclose(worker->out);
+    free(worker->response);
+    free(worker);
+}
+
+// Espera a los hilos retirados (con pool_lock tomado: ya no lo necesitan)
+static void reap_retired_workers(void) {
+    while (retired_workers) {
+        Worker* worker = retired_workers;
+        retired_workers = worker->next;
+        worker_free(worker);
+    }
+}
+
+// Saca al hilo de la lista de los que están en marcha (con pool_lock tomado)
+static void worker_retire(Worker* worker) {
+    for (Worker** link = &workers; *link; link = &(*link)->next) {
+        if (*link == worker) {
+            *link = worker->next;
+            break;
+        }
+    }
+    worker->next = retired_workers;
+    retired_workers = worker;
+    num_threads--;
+    free_workers--;
+}
+
+static void* worker_main(void* arg) {
+    Worker* worker = (Worker*)arg;
+
+    // Toda la salida de este hilo va al cliente que atiende
+    output_redirect(worker->out);
+
+    pthread_mutex_lock(&pool_lock);
+    while (1) {
+        Connection* conn = NULL;
+        if (worker->bound) {
+            conn = worker->ready;
+            worker->ready = NULL;
+        } else if (queue_head) {
+            conn = queue_head;
+            queue_head = conn->queue_next;
+            if (!queue_head) queue_tail = NULL;
+        } else if (workers_exit) {
+            break;
+        }
+
+        if (!conn) {
+            pthread_cond_wait(&pool_cond, &pool_lock);
+            continue;
+        }
+
+        int was_bound = worker->bound != NULL;
+        pthread_mutex_unlock(&pool_lock);
+        worker_serve(worker, conn);
+        pthread_mutex_lock(&pool_lock);
+
+        worker_finish(conn);
+
+        // El grupo no pierde hilos por las transacciones abiertas
+        if (!was_bound && worker->bound) {
+            free_workers--;
+            reap_retired_workers();
+            if (free_workers < pool_size) worker_start();
+        } else if (was_bound && !worker->bound) {
+            free_workers++;
+            if (free_workers > pool_size) {
+                worker_retire(worker);
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    output_redirect(NULL);
+    plan_cache_cleanup();
+    return NULL;
+}
+
+// Lee lo que haya enviado el cliente y, si ya hay algo que ejecutar, se lo pasa
+// a un hilo de trabajo
+static void connection_read(Connection* conn) {
+    static char buffer[64 * 1024];   // Solo lo usa el hilo del bucle de eventos
+
+    // El socket no bloquea: el bloqueo se tiene solo mientras se copia lo recibido y
+    // garantiza que se ve lo que dejó el último hilo que atendió la conexión
+    pthread_mutex_lock(&pool_lock);
+    while (1) {
+        ssize_t got = read(conn->endpoint.fd, buffer, sizeof(buffer));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) conn->eof = 1;
+            break;
+        }
+        if (got == 0) {
+            conn->eof = 1;
+            break;
+        }
+
+        if (conn->input_length + got > conn->input_capacity) {
+            size_t capacity = conn->input_capacity == 0 ? 4096 : conn->input_capacity;
+            while (capacity < conn->input_length + got) capacity *= 2;
+            char* grown = (char*)realloc(conn->input, capacity);
+            if (!grown) {
+                conn->eof = 1;
+                break;
+            }
+            conn->input = grown;
+            conn->input_capacity = capacity;
+        }
+        memcpy(conn->input + conn->input_length, buffer, got);
+        conn->input_length += got;
+
+        // Un cliente que envía sin parar no acapara el bucle de eventos
+        if (conn->input_length >= SERVER_READ_BATCH) break;
+    }
+
+    char type;
+    const char* data;
+    size_t length;
+    int ready = conn->eof ||
+                protocol_parse_message(conn->input, conn->input_length, &type, &data, &length) != 0;
+
+    if (ready) {
+        connection_dispatch(conn);
+    } else if (connection_arm(conn, EPOLL_CTL_MOD) != 0) {
+        conn->eof = 1;
+        connection_dispatch(conn);
+    }
+    pthread_mutex_unlock(&pool_lock);
+}
+
+// Acepta las conexiones pendientes de un socket
+static void accept_connections(int listener) {
+    while (1) {
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        // Los mensajes son pequeños y se esperan respuestas: sin retraso de Nagle
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        Connection* conn = (Connection*)calloc(1, sizeof(Connection));
+        if (!conn) {
+            close(fd);
+            continue;
+        }
+        conn->endpoint.kind = ENDPOINT_CLIENT;
+        conn->endpoint.fd = fd;
+
+        pthread_mutex_lock(&pool_lock);
+        conn->next = connections;
+        if (connections) connections->prev = conn;
+        connections = conn;
+        num_connections++;
+
+        if (connection_arm(conn, EPOLL_CTL_ADD) != 0) connection_close(conn);
+        pthread_mutex_unlock(&pool_lock);
+    }
+}
+
+// Crea el socket Unix en path (-1 si hubo error)
+static int listen_unix(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Error: La ruta del socket '%s' es demasiado larga\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    // Un socket que quedó de una ejecución anterior impediría escuchar
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("Error: No se pudo escuchar en '%s': %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Crea el socket TCP en 127.0.0.1:port (-1 si hubo error)
+static int listen_tcp(int port) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("Error: No se pudo escuchar en el puerto %d: %s\n", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Deshace las transacciones inactivas desde hace demasiado tiempo: su hilo recibe la
+// conexión para deshacerla y cerrarla. Se llama con todos los eventos ya atendidos,
+// así que ninguno pendiente se refiere a una de esas conexiones.
+static void expire_idle_transactions(void) {
+    uint64_t expirations;
+    while (read(timer_endpoint.fd, &expirations, sizeof(expirations)) > 0);
+
+    pthread_mutex_lock(&pool_lock);
+    long long now = now_ms();
+    long long next = 0;
+    timer_deadline = 0;
+
+    for (Connection* conn = connections; conn; conn = conn->next) {
+        if (conn->busy || !conn->bound || conn->idle_deadline == 0) continue;
+
+        if (conn->idle_deadline <= now) {
+            // Deja de vigilarla para que no llegue ningún evento suyo mientras se cierra
+            struct epoll_event event;
+            event.events = EPOLLONESHOT;
+            event.data.ptr = conn;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn->endpoint.fd, &event);
+
+            conn->expired = 1;
+            connection_dispatch(conn);
+        } else if (next == 0 || conn->idle_deadline < next) {
+            next = conn->idle_deadline;
+        }
+    }
+    if (next != 0) timer_schedule(next);
+    pthread_mutex_unlock(&pool_lock);
+}
+
+// Añade un descriptor al bucle de eventos (0 si tuvo éxito)
+static int watch_endpoint(Endpoint* endpoint) {
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = endpoint;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, endpoint->fd, &event);
+}
+
+// Atiende eventos hasta que se pida parar (0) o falle epoll (-1)
+static int event_loop(void) {
+    struct epoll_event events[SERVER_MAX_EVENTS];
+
+    while (1) {
+        int count = epoll_wait(epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+
+        int timer = 0;
+        for (int i = 0; i < count; i++) {
+            Endpoint* endpoint = (Endpoint*)events[i].data.ptr;
+            switch (endpoint->kind) {
+                case ENDPOINT_STOP: {
+                    char drain[64];
+                    while (read(endpoint->fd, drain, sizeof(drain)) > 0);
+                    return 0;
+                }
+                case ENDPOINT_LISTENER:
+                    accept_connections(endpoint->fd);
+                    break;
+                case ENDPOINT_TIMER:
+                    timer = 1;
+                    break;
+                case ENDPOINT_CLIENT:
+                    connection_read((Connection*)endpoint);
+                    break;
+            }
+        }
+        if (timer) expire_idle_transactions();
+    }
+}
+
+// Cierra todas las conexiones y espera a que terminen los hilos de trabajo
+static void shutdown_connections(void) {
+    pthread_mutex_lock(&pool_lock);
+    stopping = 1;
+
+    // Las que atiende un hilo se cortan; el resto se atiende una última vez
+    for (Connection* conn = connections; conn; conn = conn->next) {
+        if (conn->busy) {
+            shutdown(conn->endpoint.fd, SHUT_RDWR);
+        } else {
+            conn->eof = 1;
+            connection_dispatch(conn);
+        }
+    }
+    while (num_connections > 0) {
+        pthread_cond_wait(&connections_done, &pool_lock);
+    }
+
+    workers_exit = 1;
+    pthread_cond_broadcast(&pool_cond);
+    reap_retired_workers();
+    pthread_mutex_unlock(&pool_lock);
+
+    // Sin conexiones ya no se arranca ni se retira ningún hilo
+    while (workers) {
+        Worker* worker = workers;
+        workers = worker->next;
+        worker_free(worker);
+    }
+    num_threads = 0;
+    free_workers = 0;
+}
+
+// Número de hilos de trabajo si no se indica: de sobra para que las sentencias que
+// esperan por una tabla no dejen sin hilos al resto de conexiones
+static int default_workers(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    return cpus * 2 < SERVER_MAX_WORKERS ? (int)cpus * 2 : SERVER_MAX_WORKERS;
+}
+
+int server_run(const ServerConfig* config) {
+    if (!config->socket_path && config->tcp_port <= 0) {
+        printf("Error: No se indicó ningún socket en el que escuchar\n");
+        return -1;
+    }
+
+    if (stop_endpoint.fd < 0) {
+        int stop_pipe[2];
+        if (pipe2(stop_pipe, O_CLOEXEC | O_NONBLOCK) != 0) return -1;
+        stop_endpoint.fd = stop_pipe[0];
+        stop_write_fd = stop_pipe[1];
+    }
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_endpoint.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    timer_deadline = 0;
+    idle_timeout_ms = config->idle_timeout_ms > 0 ? config->idle_timeout_ms : SERVER_IDLE_TIMEOUT_MS;
+    Endpoint listeners[2];
+    int num_listeners = 0;
+    int status = epoll_fd >= 0 && timer_endpoint.fd >= 0 && watch_endpoint(&stop_endpoint) == 0 &&
+                 watch_endpoint(&timer_endpoint) == 0 ? 0 : -1;
+
+    if (status == 0 && config->socket_path) {
+        listeners[num_listeners].kind = ENDPOINT_LISTENER;
+        listeners[num_listeners].fd = listen_unix(config->socket_path);
+        if (listeners[num_listeners].fd < 0) status = -1;
+        else num_listeners++;
+    }
+    if (status == 0 && config->tcp_port > 0) {
+        listeners[num_listeners].kind = ENDPOINT_LISTENER;
+        listeners[num_listeners].fd = listen_tcp(config->tcp_port);
+        if (listeners[num_listeners].fd < 0) status = -1;
+        else num_listeners++;
+    }
+    for (int i = 0; i < num_listeners && status == 0; i++) {
+        if (watch_endpoint(&listeners[i]) != 0) status = -1;
+    }
+
+    // Hilos de trabajo, cada uno con su salida hacia el cliente que atiende
+    pool_size = config->workers > 0 ? config->workers : default_workers();
+    if (pool_size > SERVER_MAX_WORKERS) pool_size = SERVER_MAX_WORKERS;
+    stopping = 0;
+    workers_exit = 0;
+
+    pthread_mutex_lock(&pool_lock);
+    for (int i = 0; i < pool_size && status == 0; i++) {
+        if (worker_start() != 0) status = -1;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    if (status == 0) status = event_loop();
+
+    for (int i = 0; i < num_listeners; i++) {
+        close(listeners[i].fd);
+    }
+    if (config->socket_path && num_listeners > 0) unlink(config->socket_path);
+
+    shutdown_connections();
+
+    if (timer_endpoint.fd >= 0) close(timer_endpoint.fd);
+    timer_endpoint.fd = -1;
+    if (epoll_fd >= 0) close(epoll_fd);
+    epoll_fd = -1;
+    return status;
+}
+
+void server_stop(void) {
+    int fd = stop_write_fd;
+    if (fd >= 0) {
+        char byte = 0;
+        ssize_t ignored = write(fd, &byte, 1);
+        (void)ignored;
+    }
+}
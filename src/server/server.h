@@ -0,0 +1,43 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// Socket Unix por defecto de nql_server y nql_client
+#define SERVER_DEFAULT_SOCKET "/tmp/nql.sock"
+
+// Bytes de salida que se acumulan antes de enviar un fragmento al cliente
+#define SERVER_OUTPUT_BUFFER (64 * 1024)
+
+// Máximo de hilos de trabajo y de eventos que se recogen de epoll de una vez
+#define SERVER_MAX_WORKERS 256
+#define SERVER_MAX_EVENTS 256
+
+// Máximo de hilos contando los que guardan una transacción abierta fuera del grupo
+#define SERVER_MAX_THREADS 1024
+
+// Milisegundos que una transacción puede seguir abierta sin recibir sentencias
+// antes de deshacerse (cerrando la conexión)
+#define SERVER_IDLE_TIMEOUT_MS 60000
+
+// Configuración del servidor
+typedef struct {
+    const char* socket_path;      // Ruta del socket Unix (NULL: sin socket Unix)
+    int tcp_port;                 // Puerto TCP en 127.0.0.1 (0: sin TCP)
+    int workers;                  // Hilos que ejecutan sentencias (0: dos por CPU)
+    int idle_timeout_ms;          // Inactividad máxima de una transacción (0: SERVER_IDLE_TIMEOUT_MS)
+} ServerConfig;
+
+// Atiende conexiones hasta que se llame a server_stop. Un único hilo vigila todas las
+// conexiones con epoll y, cuando una tiene sentencias completas, la pasa a un grupo
+// fijo de hilos de trabajo; una conexión inactiva no ocupa ningún hilo. Una conexión
+// con una transacción abierta se queda con su hilo, que sale del grupo hasta COMMIT o
+// ROLLBACK (otro ocupa su lugar); si pasa idle_timeout_ms sin enviar nada, la
+// transacción se deshace y se cierra la conexión. Cada conexión tiene su propia
+// sesión (transacción y sentencias preparadas) sobre la base de datos compartida del
+// proceso. Devuelve 0 al parar, -1 si no pudo escuchar.
+int server_run(const ServerConfig* config);
+
+// Pide al servidor que pare y cierra las conexiones abiertas (se puede llamar
+// desde un manejador de señales)
+void server_stop(void);
+
+#endif /* SERVER_H */
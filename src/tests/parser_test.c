@@ -1,12 +1,34 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <pthread.h>
 #include "../parser/lexer.h"
 #include "../parser/parser.h"
 #include "../parser/ast.h"
 #include "../parser/validator.h"
 #include "../parser/grammar.h"
 #include "../db/database.h"
+#include "../executor/prepared.h"
+#include "../executor/plan_cache.h"
+#include "../executor/join.h"
+#include "../executor/aggregate.h"
+#include "../executor/parallel.h"
+#include "../executor/transaction.h"
+#include "../executor/script.h"
+#include "../executor/analyze.h"
+#include "../utils/scheduler.h"
+#include "../utils/output.h"
+#include "../utils/timing.h"
+#include "../db/mvcc.h"
+#include "../db/result.h"
+#include "../cli/commands/cmd_registry.h"
+#include "../cli/batch.h"
+#include "../server/server.h"
+#include "../server/protocol.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 // Constantes para el formato de salida
 #define ANSI_COLOR_GREEN   "\x1b[32m"
@@ -15,8 +37,12 @@
 #define ANSI_COLOR_BLUE    "\x1b[34m"
 #define ANSI_COLOR_RESET   "\x1b[0m"
 
+// Pruebas que han fallado (main termina con estado 1 si hay alguna)
+static int tests_failed = 0;
+
 // Funciones de utilidad
 void print_test_result(const char* test_name, int success) {
+    if (!success) tests_failed++;
     printf("[%s] %s: %s\n", 
            success ? ANSI_COLOR_GREEN "PASS" ANSI_COLOR_RESET : ANSI_COLOR_RED "FAIL" ANSI_COLOR_RESET,
            test_name,
@@ -38,6 +64,7 @@ void test_lexer_basic_tokens() {
     Lexer* lexer = lexer_create(sql);
     if (!lexer) {
         printf("Error: No se pudo crear el lexer\n");
+        tests_failed++;
         return;
     }
     
@@ -47,7 +74,7 @@ void test_lexer_basic_tokens() {
     // Tokens esperados
     TokenType expected_types[] = {
         TOKEN_KEYWORD,    // SELECT
-        TOKEN_PUNCTUATION, // *
+        TOKEN_OPERATOR,   // * (el lexer no distingue el de SELECT * de la multiplicación)
         TOKEN_KEYWORD,    // FROM
         TOKEN_IDENTIFIER, // tabla
         TOKEN_KEYWORD,    // WHERE
@@ -97,6 +124,7 @@ void test_lexer_string_literals() {
     Lexer* lexer = lexer_create(sql);
     if (!lexer) {
         printf("Error: No se pudo crear el lexer\n");
+        tests_failed++;
         return;
     }
     
@@ -129,6 +157,7 @@ void test_lexer_keywords_vs_identifiers() {
     Lexer* lexer = lexer_create(sql);
     if (!lexer) {
         printf("Error: No se pudo crear el lexer\n");
+        tests_failed++;
         return;
     }
     
@@ -143,12 +172,13 @@ void test_lexer_keywords_vs_identifiers() {
         i++;
     }
     
-    // Verificar tipos esperados
+    // Verificar tipos esperados (las palabras clave no distinguen mayúsculas, pero una
+    // palabra que solo empieza por una palabra clave es un identificador)
     int success = (i == 6 &&
                   tokens[0].type == TOKEN_KEYWORD &&    // SELECT
-                  tokens[1].type == TOKEN_IDENTIFIER && // select
+                  tokens[1].type == TOKEN_KEYWORD &&    // select
                   tokens[2].type == TOKEN_KEYWORD &&    // FROM
-                  tokens[3].type == TOKEN_IDENTIFIER && // from
+                  tokens[3].type == TOKEN_KEYWORD &&    // from
                   tokens[4].type == TOKEN_KEYWORD &&    // WHERE
                   tokens[5].type == TOKEN_IDENTIFIER);  // select_column
     
@@ -173,6 +203,7 @@ Database* create_test_database() {
     db->name = strdup("test_db");
     db->num_tables = 0;
     db->max_tables = 10;
+    db->schema_version = 0;
     db->tables = (Table**)malloc(sizeof(Table*) * 10);
     
     if (!db->tables) {
@@ -183,7 +214,7 @@ Database* create_test_database() {
     }
     
     // Crear tabla de usuarios
-    Table* usuarios = (Table*)malloc(sizeof(Table));
+    Table* usuarios = table_create("usuarios");
     if (!usuarios) {
         printf("Error: No se pudo asignar memoria para la tabla usuarios\n");
         free(db->tables);
@@ -192,44 +223,11 @@ Database* create_test_database() {
         return NULL;
     }
     
-    usuarios->name = strdup("usuarios");
-    usuarios->num_columns = 4;
-    usuarios->columns = (Column*)malloc(sizeof(Column) * 4);
-    
-    if (!usuarios->columns) {
-        printf("Error: No se pudo asignar memoria para las columnas\n");
-        free(usuarios->name);
-        free(usuarios);
-        free(db->tables);
-        free(db->name);
-        free(db);
-        return NULL;
-    }
-    
     // Configurar columnas
-    usuarios->columns[0].name = strdup("id");
-    usuarios->columns[0].type = TYPE_INT;  // Asumiendo que TYPE_INT está definido en database.h
-    usuarios->columns[0].max_length = 0;
-    usuarios->columns[0].is_primary_key = 1;
-    usuarios->columns[0].allows_null = 0;
-    
-    usuarios->columns[1].name = strdup("nombre");
-    usuarios->columns[1].type = TYPE_STRING;
-    usuarios->columns[1].max_length = 50;
-    usuarios->columns[1].is_primary_key = 0;
-    usuarios->columns[1].allows_null = 0;
-    
-    usuarios->columns[2].name = strdup("edad");
-    usuarios->columns[2].type = TYPE_INT;
-    usuarios->columns[2].max_length = 0;
-    usuarios->columns[2].is_primary_key = 0;
-    usuarios->columns[2].allows_null = 1;
-    
-    usuarios->columns[3].name = strdup("activo");
-    usuarios->columns[3].type = TYPE_BOOL;
-    usuarios->columns[3].max_length = 0;
-    usuarios->columns[3].is_primary_key = 0;
-    usuarios->columns[3].allows_null = 0;
+    table_add_column(usuarios, "id", TYPE_INT, 0, 1, 0);
+    table_add_column(usuarios, "nombre", TYPE_STRING, 50, 0, 0);
+    table_add_column(usuarios, "edad", TYPE_INT, 0, 0, 1);
+    table_add_column(usuarios, "activo", TYPE_BOOL, 0, 0, 0);
     
     // Añadir a la base de datos
     db->tables[0] = usuarios;
@@ -243,13 +241,7 @@ void free_test_database(Database* db) {
     if (!db) return;
     
     for (int i = 0; i < db->num_tables; i++) {
-        Table* table = db->tables[i];
-        for (int j = 0; j < table->num_columns; j++) {
-            free(table->columns[j].name);
-        }
-        free(table->columns);
-        free(table->name);
-        free(table);
+        table_free(db->tables[i]);
     }
     
     free(db->tables);
@@ -292,10 +284,8 @@ void test_parser_if_available(const char* sql) {
 ASTNode* create_test_select_ast() {
     // Crear un nodo para "SELECT * FROM usuarios"
     // Crear lista de columnas (* = all)
-    ColumnListData* columns_data = (ColumnListData*)malloc(sizeof(ColumnListData));
+    ColumnListData* columns_data = (ColumnListData*)calloc(1, sizeof(ColumnListData));
     columns_data->is_all = 1;
-    columns_data->count = 0;
-    columns_data->columns = NULL;
     
     ASTNode* columns_node = (ASTNode*)malloc(sizeof(ASTNode));
     columns_node->type = NODE_COLUMN_LIST;
@@ -306,7 +296,7 @@ ASTNode* create_test_select_ast() {
     columns_node->free_data = NULL; // Idealmente, tendríamos una función free_column_list
     
     // Crear nodo SELECT
-    SelectStmtData* select_data = (SelectStmtData*)malloc(sizeof(SelectStmtData));
+    SelectStmtData* select_data = (SelectStmtData*)calloc(1, sizeof(SelectStmtData));
     select_data->table_name = strdup("usuarios");
     select_data->columns = columns_node;
     select_data->where_clause = NULL; // Sin cláusula WHERE
@@ -325,6 +315,19 @@ ASTNode* create_test_select_ast() {
     return select_node;
 }
 
+// Liberar el AST creado manualmente (los nodos no tienen free_data)
+void free_test_select_ast(ASTNode* ast) {
+    SelectStmtData* select_data = (SelectStmtData*)ast->data;
+    ColumnListData* columns_data = (ColumnListData*)select_data->columns->data;
+    
+    free(columns_data->column_indices);
+    free(columns_data);
+    free(select_data->columns);
+    free(select_data->table_name);
+    free(select_data);
+    free(ast);
+}
+
 // ============= PRUEBA MANUAL DE VALIDACIÓN =============
 
 void test_validator_with_manual_ast(Database* db) {
@@ -338,12 +341,8 @@ void test_validator_with_manual_ast(Database* db) {
     ValidationResult* result = validator_create_result();
     if (!result) {
         printf("Error: No se pudo crear el resultado de validación\n");
-        // Liberar AST (idealmente con una función ast_free_node)
-        free(((SelectStmtData*)ast->data)->table_name);
-        free(ast->data);
-        free(((ColumnListData*)((SelectStmtData*)ast->data)->columns->data));
-        free(((SelectStmtData*)ast->data)->columns);
-        free(ast);
+        free_test_select_ast(ast);
+        tests_failed++;
         return;
     }
     
@@ -356,21 +355,1714 @@ void test_validator_with_manual_ast(Database* db) {
         printf(ANSI_COLOR_RED "Validación fallida: %s (código: %d)\n" ANSI_COLOR_RESET,
                result->error_message ? result->error_message : "Error desconocido",
                result->error_code);
+        tests_failed++;
     }
     
     // Liberar recursos
     validator_free_result(result);
     
-    // Liberar AST (idealmente con una función ast_free_node)
-    free(((SelectStmtData*)ast->data)->table_name);
-    free(ast->data);
-    free(((ColumnListData*)((SelectStmtData*)ast->data)->columns->data));
-    free(((SelectStmtData*)ast->data)->columns);
-    free(ast);
+    // Liberar AST
+    free_test_select_ast(ast);
+}
+
+// ============= PRUEBA DE RESOLUCIÓN DE COLUMNAS =============
+
+void test_validator_resolves_columns(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de resolución de columnas en el validador\n" ANSI_COLOR_RESET);
+    
+    const char* sql = "SELECT nombre, EDAD FROM usuarios WHERE Edad > 18 AND activo = TRUE";
+    printf("SQL: %s\n", sql);
+    
+    Parser* parser = parser_create(sql);
+    ASTNode* ast = parser_parse(parser);
+    ValidationResult* result = validator_create_result();
+    
+    int success = ast && validator_validate(ast, db, result);
+    
+    if (success) {
+        SelectStmtData* data = (SelectStmtData*)ast->data;
+        ColumnListData* columns = (ColumnListData*)data->columns->data;
+        WhereClauseData* where = (WhereClauseData*)data->where_clause->data;
+        BinaryExprData* and_expr = (BinaryExprData*)where->condition->data;
+        BinaryExprData* edad_cmp = (BinaryExprData*)and_expr->left->data;
+        BinaryExprData* activo_cmp = (BinaryExprData*)and_expr->right->data;
+        IdentifierData* edad = (IdentifierData*)edad_cmp->left->data;
+        IdentifierData* activo = (IdentifierData*)activo_cmp->left->data;
+        
+        success = columns->column_indices &&
+                  columns->column_indices[0] == 1 &&
+                  columns->column_indices[1] == 2 &&
+                  edad->column_index == 2 && edad->column_type == TYPE_INT &&
+                  activo->column_index == 3 && activo->column_type == TYPE_BOOL;
+    }
+    
+    // Columna inexistente
+    if (success) {
+        Table* usuarios = validator_find_table("usuarios", db);
+        success = column_get_index(usuarios, "no_existe") == -1 &&
+                  column_get_index(usuarios, "NOMBRE") == 1;
+    }
+    
+    print_test_result("Resolución de columnas", success);
+    
+    validator_free_result(result);
+    if (ast) ast_free_node(ast);
+    parser_free(parser);
+}
+
+// ============= PRUEBA DE SENTENCIAS PREPARADAS =============
+
+void test_prepared_statements(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de sentencias preparadas\n" ANSI_COLOR_RESET);
+    
+    const char* sql = "PREPARE ins AS INSERT INTO usuarios VALUES (?, ?, ?, TRUE)";
+    printf("SQL: %s\n", sql);
+    
+    Parser* parser = parser_create(sql);
+    ASTNode* ast = parser_parse(parser);
+    ValidationResult* result = validator_create_result();
+    PreparedStatement* prepared = NULL;
+    Table* usuarios = validator_find_table("usuarios", db);
+    int initial_rows = usuarios->num_rows;
+    
+    int success = ast && ast->type == NODE_PREPARE_STMT;
+    
+    if (success) {
+        PrepareStmtData* data = (PrepareStmtData*)ast->data;
+        prepared = prepared_create(data->name, data->statement, data->num_params, db, result);
+        success = prepared && prepared->num_params == 3;
+        if (prepared) data->statement = NULL;
+    }
+    
+    // Ejecutar dos veces con distintos parámetros
+    if (success) {
+        LiteralData params[3] = {
+            { .lit_type = LIT_INTEGER, .int_value = 10 },
+            { .lit_type = LIT_STRING, .string_value = "Ana" },
+            { .lit_type = LIT_INTEGER, .int_value = 30 }
+        };
+        success = prepared_execute(prepared, params, 3, db, result) == 0;
+        
+        params[0].int_value = 11;
+        params[1].string_value = "Luis";
+        params[2].lit_type = LIT_NULL;
+        success = success && prepared_execute(prepared, params, 3, db, result) == 0;
+        
+        success = success && usuarios->num_rows == initial_rows + 2 &&
+                  usuarios->rows[initial_rows + 1].values[0].int_val == 11 &&
+                  strcmp(usuarios->rows[initial_rows + 1].values[1].string_val, "Luis") == 0;
+        
+        // Número incorrecto de parámetros y tipo no compatible
+        success = success && prepared_execute(prepared, params, 2, db, result) != 0;
+        params[0].lit_type = LIT_STRING;
+        success = success && prepared_execute(prepared, params, 3, db, result) != 0 &&
+                  usuarios->num_rows == initial_rows + 2;
+    }
+    
+    print_test_result("Sentencias preparadas", success);
+    
+    prepared_free(prepared);
+    validator_free_result(result);
+    if (ast) ast_free_node(ast);
+    parser_free(parser);
+}
+
+// ============= PRUEBA DE LA CACHÉ DE PLANES =============
+
+void test_plan_cache(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de la caché de planes\n" ANSI_COLOR_RESET);
+    
+    // Normalización: literales como parámetros, mayúsculas y espacios unificados
+    LiteralData* params = NULL;
+    int num_params = 0;
+    char* key = plan_cache_normalize("select  NOMBRE from Usuarios where edad > -18 AND nombre = \"Ana\"",
+                                     &params, &num_params);
+    printf("Normalizada: %s\n", key ? key : "(null)");
+    
+    int success = key && strcmp(key, "SELECT nombre FROM usuarios WHERE edad > ? AND nombre = ?") == 0 &&
+                  num_params == 2 &&
+                  params[0].lit_type == LIT_INTEGER && params[0].int_value == -18 &&
+                  params[1].lit_type == LIT_STRING && strcmp(params[1].string_value, "Ana") == 0;
+    
+    free(key);
+    plan_cache_free_params(params, num_params);
+    
+    // Sentencias con el mismo texto normalizado comparten el plan
+    ValidationResult* result = validator_create_result();
+    PlanCacheStats before = plan_cache_get_stats();
+    
+    success = success &&
+              plan_cache_execute("INSERT INTO usuarios VALUES (20, \"Eva\", 41, FALSE)", db, result) == 0 &&
+              plan_cache_execute("insert into usuarios values (21, \"Leo\", 19, TRUE)", db, result) == 0;
+    
+    PlanCacheStats after = plan_cache_get_stats();
+    success = success && after.misses == before.misses + 1 && after.hits == before.hits + 1;
+    
+    // Un cambio de esquema invalida el plan
+    db->schema_version++;
+    success = success &&
+              plan_cache_execute("INSERT INTO usuarios VALUES (22, \"Sol\", 33, TRUE)", db, result) == 0 &&
+              plan_cache_get_stats().invalidations == after.invalidations + 1;
+    
+    // Los errores de ejecución se siguen detectando con el plan cacheado
+    success = success &&
+              plan_cache_execute("INSERT INTO usuarios VALUES (\"x\", \"Sol\", 33, TRUE)", db, result) != 0;
+    
+    print_test_result("Caché de planes", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// ============= PRUEBA DE INSERT CON VARIAS FILAS =============
+
+void test_multi_row_insert(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de INSERT con varias filas\n" ANSI_COLOR_RESET);
+    
+    Table* table = validator_find_table("usuarios", db);
+    ValidationResult* result = validator_create_result();
+    int before = table->num_rows;
+    
+    // Todas las filas se insertan con una sola sentencia
+    int success = plan_cache_execute("INSERT INTO usuarios VALUES (30, \"Ana\", 20, TRUE), "
+                                     "(31, \"Bea\", 21, FALSE), (32, \"Cal\", 22, TRUE)", db, result) == 0 &&
+                  table->num_rows == before + 3 &&
+                  strcmp(table->rows[before + 2].values[1].string_val, "Cal") == 0;
+    
+    // Si una fila no es válida no se inserta ninguna
+    before = table->num_rows;
+    success = success &&
+              plan_cache_execute("INSERT INTO usuarios VALUES (33, \"Dan\", 23, TRUE), "
+                                 "(\"x\", \"Eli\", 24, TRUE)", db, result) != 0 &&
+              plan_cache_execute("INSERT INTO usuarios VALUES (33, \"Dan\", 23, TRUE), (34, \"Eli\")",
+                                 db, result) != 0 &&
+              table->num_rows == before;
+    
+    print_test_result("INSERT con varias filas", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// ============= PRUEBA DE AGREGADOS Y GROUP BY =============
+
+// Compila una sentencia SELECT (NULL si no es válida)
+static Plan* compile_select_sql(const char* sql, ASTNode** ast, Database* db, ValidationResult* result) {
+    Parser* parser = parser_create(sql);
+    *ast = parser_parse(parser);
+    int ok = *ast && !parser_has_error(parser);
+    parser_free(parser);
+    
+    Plan* plan = ok ? executor_compile(*ast, 0, db, result) : NULL;
+    if (!plan && *ast) {
+        ast_free_node(*ast);
+        *ast = NULL;
+    }
+    return plan;
+}
+
+void test_aggregates(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de agregados y GROUP BY\n" ANSI_COLOR_RESET);
+    
+    ValidationResult* result = validator_create_result();
+    ASTNode* ast = NULL;
+    
+    // Agrupación con varias funciones de agregación
+    Plan* plan = compile_select_sql("SELECT activo, COUNT(*), SUM(edad), MAX(nombre) FROM usuarios GROUP BY activo",
+                                    &ast, db, result);
+    int success = plan && plan->is_aggregate && plan->num_group_columns == 1 &&
+                  plan->group_columns[0] == 3 && plan->out_columns[1] == -1 &&
+                  plan->out_aggregates[2] == AGG_SUM &&
+                  executor_run(plan, NULL, 0, result) == 0;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    // Columnas sin agregar fuera de GROUP BY y SUM sobre texto
+    plan = compile_select_sql("SELECT nombre, COUNT(*) FROM usuarios", &ast, db, result);
+    success = success && !plan && result->error_code == 127;
+    plan = compile_select_sql("SELECT AVG(nombre) FROM usuarios", &ast, db, result);
+    success = success && !plan && result->error_code == 125;
+    
+    // Conteo de filas con WHERE
+    plan = compile_select_sql("SELECT * FROM usuarios WHERE id >= 30 AND id <= 32", &ast, db, result);
+    success = success && plan && executor_count_rows(plan, NULL, 0, result) == 3;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    // Una suma que no cabe en un INT es un error; sin filas, SUM y MIN valen 0
+    Table* sumas = table_create("sumas");
+    table_add_column(sumas, "a", TYPE_INT, 0, 0, 0);
+    for (int i = 0; i < 2; i++) {
+        Value value;
+        value.int_val = 2000000000;
+        table_add_row(sumas, &value);
+    }
+    db->tables[db->num_tables++] = sumas;
+    db->schema_version++;
+    
+    int all_rows[] = { 0, 1 };
+    plan = compile_select_sql("SELECT SUM(a), MAX(a) FROM sumas", &ast, db, result);
+    Table* groups = plan ? aggregate_build(plan, all_rows, 2, result) : NULL;
+    success = success && plan && !groups && result->error_code == 417;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    plan = compile_select_sql("SELECT MIN(a), SUM(a), COUNT(*) FROM sumas WHERE a < 0", &ast, db, result);
+    groups = plan ? aggregate_build(plan, all_rows, 0, result) : NULL;
+    success = success && groups && groups->num_rows == 1 &&
+              groups->rows[0].values[0].int_val == 0 && groups->rows[0].values[1].int_val == 0 &&
+              groups->rows[0].values[2].int_val == 0;
+    table_free(groups);
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    print_test_result("Agregados y GROUP BY", success);
+    
+    validator_free_result(result);
+}
+
+// ============= PRUEBA DE ORDER BY Y LIMIT =============
+
+void test_order_limit(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de ORDER BY y LIMIT\n" ANSI_COLOR_RESET);
+    
+    // Tabla con valores pseudoaleatorios, negativos y repetidos
+    Table* table = table_create("numeros");
+    table_add_column(table, "n", TYPE_INT, 0, 0, 0);
+    table_add_column(table, "f", TYPE_FLOAT, 0, 0, 0);
+    
+    int num_rows = 1000;
+    unsigned int seed = 12345;
+    for (int i = 0; i < num_rows; i++) {
+        Value values[2];
+        seed = seed * 1103515245u + 12345u;
+        values[0].int_val = (int)(seed % 2001) - 1000;
+        values[1].float_val = values[0].int_val / 7.0f;
+        table_add_row(table, values);
+    }
+    
+    int* rows = (int*)malloc(num_rows * sizeof(int));
+    for (int i = 0; i < num_rows; i++) rows[i] = i;
+    
+    // Radix sort descendente: orden correcto y estable
+    SortKey key = { 1, 1 };
+    int success = sort_rows(table, rows, num_rows, &key, 1) == 0;
+    for (int i = 1; i < num_rows && success; i++) {
+        float prev = table->rows[rows[i - 1]].values[1].float_val;
+        float cur = table->rows[rows[i]].values[1].float_val;
+        success = prev > cur || (prev == cur && rows[i - 1] < rows[i]);
+    }
+    
+    // El montículo acotado da las mismas 10 primeras filas que la ordenación completa
+    TopN topn;
+    success = success && topn_init(&topn, table, &key, 1, 10) == 0;
+    for (int i = 0; success && i < num_rows; i++) topn_push(&topn, i);
+    success = success && topn_finish(&topn) == 10 && memcmp(topn.rows, rows, 10 * sizeof(int)) == 0;
+    topn_free(&topn);
+    
+    free(rows);
+    table_free(table);
+    
+    // Sentencias con ORDER BY, LIMIT y OFFSET
+    ValidationResult* result = validator_create_result();
+    success = success &&
+              plan_cache_execute("SELECT id, nombre FROM usuarios ORDER BY edad DESC, id LIMIT 3 OFFSET 1", db, result) == 0 &&
+              plan_cache_execute("SELECT activo, COUNT(*) FROM usuarios GROUP BY activo ORDER BY COUNT(*) LIMIT 1", db, result) == 0 &&
+              plan_cache_execute("SELECT * FROM usuarios ORDER BY COUNT(*)", db, result) != 0;
+    
+    print_test_result("ORDER BY y LIMIT", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+void test_join(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de JOIN\n" ANSI_COLOR_RESET);
+    
+    // Pedidos de los usuarios (algunos sin usuario y otros con varios pedidos)
+    Table* pedidos = table_create("pedidos");
+    table_add_column(pedidos, "id", TYPE_INT, 0, 1, 0);
+    table_add_column(pedidos, "usuario", TYPE_INT, 0, 0, 0);
+    table_add_column(pedidos, "total", TYPE_FLOAT, 0, 0, 0);
+    for (int i = 0; i < 3000; i++) {
+        Value values[3];
+        values[0].int_val = i;
+        values[1].int_val = i % 50;
+        values[2].float_val = (i % 7) * 1.5f;
+        table_add_row(pedidos, values);
+    }
+    db->tables[db->num_tables++] = pedidos;
+    db->schema_version++;
+    
+    // El hash join encuentra las mismas parejas que un bucle anidado,
+    // construya la tabla hash sobre una tabla o sobre la otra
+    Table* usuarios = validator_find_table("usuarios", db);
+    int expected = 0;
+    for (int u = 0; u < usuarios->num_rows; u++) {
+        for (int p = 0; p < pedidos->num_rows; p++) {
+            expected += !usuarios->rows[u].is_deleted &&
+                        usuarios->rows[u].values[0].int_val == pedidos->rows[p].values[1].int_val;
+        }
+    }
+    
+    int success = 1;
+    int left_rows[100];
+    int right_rows[100];
+    for (int side = 0; side < 2 && success; side++) {
+        HashJoin join;
+        int found = 0;
+        int pairs;
+        
+        success = side == 0 ? hash_join_init(&join, usuarios, 0, pedidos, 1) == 0
+                            : hash_join_init(&join, pedidos, 1, usuarios, 0) == 0;
+        while (success && (pairs = hash_join_next(&join, left_rows, right_rows, 100)) > 0) {
+            for (int i = 0; i < pairs; i++) {
+                const Table* left = side == 0 ? usuarios : pedidos;
+                const Table* right = side == 0 ? pedidos : usuarios;
+                success = success && left->rows[left_rows[i]].values[side].int_val ==
+                                     right->rows[right_rows[i]].values[1 - side].int_val;
+            }
+            found += pairs;
+        }
+        success = success && found == expected;
+        hash_join_free(&join);
+    }
+    
+    // Con las dos entradas ordenadas se usa merge join, con el mismo resultado que el hash join
+    Table* lineas = table_create("lineas");
+    table_add_column(lineas, "pedido", TYPE_INT, 0, 0, 0);
+    for (int i = 0; i < 5000; i++) {
+        Value values[1];
+        values[0].int_val = i / 3 * 2;   // Claves repetidas y huecos
+        table_add_row(lineas, values);
+    }
+    table_delete_row(lineas, 10);
+    
+    Join merge;
+    HashJoin hash;
+    int merge_pairs = 0, hash_pairs = 0, pairs;
+    success = success && join_is_sorted(pedidos, 0) && !join_is_sorted(pedidos, 1) &&
+              join_init(&merge, pedidos, 0, lineas, 0) == 0 && merge.method == JOIN_MERGE &&
+              hash_join_init(&hash, pedidos, 0, lineas, 0) == 0;
+    while (success && (pairs = join_next(&merge, left_rows, right_rows, 100)) > 0) {
+        for (int i = 0; i < pairs; i++) {
+            success = success && pedidos->rows[left_rows[i]].values[0].int_val ==
+                                 lineas->rows[right_rows[i]].values[0].int_val;
+        }
+        merge_pairs += pairs;
+    }
+    while (success && (pairs = hash_join_next(&hash, left_rows, right_rows, 100)) > 0) {
+        hash_pairs += pairs;
+    }
+    success = success && merge_pairs == hash_pairs && merge_pairs == 1500 * 3 - 1;
+    join_free(&merge);
+    hash_join_free(&hash);
+    
+    // El orden que comprueba una vista lo reutilizan las siguientes hasta que cambia la tabla
+    RowVersion version;
+    Table view;
+    success = success && mvcc_begin_read(&version) == 0;
+    table_open_snapshot(lineas, &view, version, 0);
+    success = success && table_cached_order(&view, 0) == -1 && join_is_sorted(&view, 0) &&
+              table_cached_order(&view, 0) == 1;
+    table_close_snapshot(lineas);
+    table_open_snapshot(lineas, &view, version, 0);
+    success = success && table_cached_order(&view, 0) == 1;
+    table_close_snapshot(lineas);
+    
+    Value first[1];
+    first[0].int_val = -1;
+    table_add_row(lineas, first);
+    table_open_snapshot(lineas, &view, version, 0);
+    success = success && table_cached_order(&view, 0) == -1 && !join_is_sorted(&view, 0) &&
+              table_cached_order(&view, 0) == 0;
+    table_close_snapshot(lineas);
+    
+    // Ni una vista con cambios pendientes ni una anterior a la última confirmación lo usan
+    table_open_snapshot(lineas, &view, version, mvcc_new_write());
+    success = success && !join_is_sorted(&view, 0) && table_cached_order(&view, 0) == -1;
+    table_close_snapshot(lineas);
+    RowVersion commit = mvcc_begin_commit();
+    table_commit_versions(lineas, lineas->num_rows, 0, NULL, 0, commit);
+    mvcc_end_commit(commit);
+    table_open_snapshot(lineas, &view, version, 0);
+    success = success && !join_is_sorted(&view, 0) && table_cached_order(&view, 0) == -1;
+    table_close_snapshot(lineas);
+    mvcc_end_read(version);
+    table_free(lineas);
+    
+    // Sentencias con JOIN y columnas calificadas
+    ValidationResult* result = validator_create_result();
+    success = success &&
+              plan_cache_execute("SELECT nombre, pedidos.id, total FROM usuarios JOIN pedidos ON usuarios.id = usuario "
+                                 "WHERE total > 3 ORDER BY total DESC LIMIT 3", db, result) == 0 &&
+              plan_cache_execute("SELECT usuarios.activo, COUNT(*), SUM(total) FROM pedidos INNER JOIN usuarios "
+                                 "ON usuario = usuarios.id GROUP BY usuarios.activo", db, result) == 0;
+    
+    // Columna ambigua y condición ON que no es una igualdad entre tablas
+    success = success &&
+              plan_cache_execute("SELECT id FROM usuarios JOIN pedidos ON usuarios.id = usuario", db, result) != 0 &&
+              result->error_code == 102 &&
+              plan_cache_execute("SELECT * FROM usuarios JOIN pedidos ON usuarios.id > usuario", db, result) != 0 &&
+              result->error_code == 131;
+    
+    // Conteo de las filas unidas
+    ASTNode* ast = NULL;
+    Plan* plan = compile_select_sql("SELECT * FROM usuarios JOIN pedidos ON usuarios.id = usuario", &ast, db, result);
+    success = success && plan && executor_count_rows(plan, NULL, 0, result) == expected;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    print_test_result("JOIN", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// ============= PRUEBA DE SALIDA DE RESULTADOS =============
+
+// Cuenta las líneas de un texto
+static int count_lines(const char* text) {
+    int lines = 0;
+    for (; *text; text++) {
+        if (*text == '\n') lines++;
+    }
+    return lines;
+}
+
+void test_result_output(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de salida de resultados\n" ANSI_COLOR_RESET);
+    
+    Table* table = table_create("salida");
+    table_add_column(table, "n", TYPE_INT, 0, 0, 0);
+    table_add_column(table, "texto", TYPE_STRING, 50, 0, 0);
+    
+    // Una fila posterior a la muestra más ancha que las de la muestra
+    int num_rows = RESULT_SAMPLE_ROWS + 500;
+    for (int i = 0; i < num_rows; i++) {
+        Value values[2];
+        values[0].int_val = i;
+        values[1].string_val = i == num_rows - 1 ? "una cadena bastante más larga" : "corta";
+        table_add_row(table, values);
+    }
+    
+    char* text = NULL;
+    size_t size = 0;
+    FILE* capture = open_memstream(&text, &size);
+    FILE* previous = output_redirect(capture);
+    
+    // Resultado corto: anchos exactos
+    int columns[] = { 1, 0 };
+    int rows[] = { 2, 0 };
+    table_print_rows(table, rows, 2, columns, 2);
+    fflush(capture);
+    int success = strcmp(text,
+                         "Tabla: salida\n"
+                         "+-------+---+\n"
+                         "| texto| n|\n"
+                         "+-------+---+\n"
+                         "| corta| 2|\n"
+                         "| corta| 0|\n"
+                         "+-------+---+\n"
+                         "2 filas en total\n") == 0;
+    
+    // Resultado largo: se escribe en una pasada con los anchos de la muestra
+    fseek(capture, 0, SEEK_SET);
+    table_print_rows(table, NULL, num_rows, NULL, 2);
+    fputc('\0', capture);
+    fflush(capture);
+    success = success &&
+              strncmp(text, "Tabla: salida\n+-----+-------+\n", 30) == 0 &&
+              strstr(text, "| 999| corta|\n| 1000| corta|\n") != NULL &&
+              strstr(text, "| 1499| una cadena bastante más larga|\n") != NULL &&
+              strstr(text, "1500 filas en total\n") != NULL &&
+              count_lines(text) == num_rows + 6;
+    
+    // SELECT con LIMIT y OFFSET escrito según se recorre la tabla
+    ValidationResult* result = validator_create_result();
+    fseek(capture, 0, SEEK_SET);
+    success = success &&
+              plan_cache_execute("SELECT nombre FROM usuarios LIMIT 2 OFFSET 1", db, result) == 0;
+    fputc('\0', capture);
+    fflush(capture);
+    success = success && strstr(text, "2 filas en total\n") != NULL && count_lines(text) == 8;
+    
+    output_redirect(previous);
+    fclose(capture);
+    free(text);
+    table_free(table);
+    
+    print_test_result("Salida de resultados", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// Escribe unas filas de table en format y devuelve el texto capturado (hay que liberarlo)
+static char* capture_rows(Table* table, ResultFormat format, size_t* size) {
+    char* text = NULL;
+    FILE* capture = open_memstream(&text, size);
+    FILE* previous = output_redirect(capture);
+    ResultFormat previous_format = result_get_format();
+    
+    result_set_format(format);
+    table_print_rows(table, NULL, table->num_rows, NULL, table->num_columns);
+    result_set_format(previous_format);
+    
+    output_redirect(previous);
+    fclose(capture);
+    return text;
+}
+
+void test_output_formats(void) {
+    printf(ANSI_COLOR_BLUE "Prueba de formatos de salida\n" ANSI_COLOR_RESET);
+    
+    Table* table = table_create("formatos");
+    table_add_column(table, "n", TYPE_INT, 0, 0, 0);
+    table_add_column(table, "texto", TYPE_STRING, 50, 0, 0);
+    table_add_column(table, "f", TYPE_FLOAT, 0, 0, 0);
+    table_add_column(table, "b", TYPE_BOOL, 0, 0, 0);
+    
+    Value values[4];
+    values[0].int_val = -2147483647 - 1;
+    values[1].string_val = "a,\"b\"\tc\n";
+    values[2].float_val = 2.125f;
+    values[3].bool_val = 1;
+    table_add_row(table, values);
+    values[0].int_val = 7;
+    values[1].string_val = NULL;
+    values[2].float_val = -0.004f;
+    values[3].bool_val = 0;
+    table_add_row(table, values);
+    
+    size_t size;
+    char* text = capture_rows(table, RESULT_FORMAT_CSV, &size);
+    int success = strcmp(text,
+                         "n,texto,f,b\n"
+                         "-2147483648,\"a,\"\"b\"\"\tc\n\",2.125,true\n"
+                         "7,,-0.004,false\n") == 0;
+    free(text);
+    
+    text = capture_rows(table, RESULT_FORMAT_TSV, &size);
+    success = success && strcmp(text,
+                                "n\ttexto\tf\tb\n"
+                                "-2147483648\ta,\"b\"\\tc\\n\t2.125\ttrue\n"
+                                "7\t\t-0.004\tfalse\n") == 0;
+    free(text);
+    
+    text = capture_rows(table, RESULT_FORMAT_JSONL, &size);
+    success = success && strcmp(text,
+                                "{\"n\":-2147483648,\"texto\":\"a,\\\"b\\\"\\tc\\n\",\"f\":2.125,\"b\":true}\n"
+                                "{\"n\":7,\"texto\":null,\"f\":-0.004,\"b\":false}\n") == 0;
+    free(text);
+    
+    // Binario: cabecera, dos filas de 4 + 4 + 11 + 4 + 1 y 4 + 4 + 4 + 1 bytes y el final
+    text = capture_rows(table, RESULT_FORMAT_BINARY, &size);
+    success = success && size == 5 + 2 + (3 + 1) + (3 + 5) + (3 + 1) + (3 + 1) + (1 + 4 + 4 + 8 + 4 + 1) +
+                                 (1 + 4 + 4 + 4 + 1) + 5 &&
+              memcmp(text, "NQLB\1\4\0", 7) == 0 &&
+              memcmp(text + size - 5, "E\2\0\0\0", 5) == 0;
+    free(text);
+    
+    ResultFormat format;
+    success = success &&
+              result_format_from_name("JSONL", &format) == 0 && format == RESULT_FORMAT_JSONL &&
+              result_format_from_name("xml", &format) != 0 &&
+              result_get_format() == RESULT_FORMAT_TABLE;
+    
+    table_free(table);
+    print_test_result("Formatos de salida", success);
+}
+
+// ============= PRUEBA DE FORMATO DE NÚMEROS =============
+
+void test_number_formatting(void) {
+    printf(ANSI_COLOR_BLUE "Prueba de formato de números\n" ANSI_COLOR_RESET);
+    
+    char text[VALUE_NUMBER_LENGTH];
+    char expected[64];
+    int success = value_format_int(text, -2147483647 - 1) == 11 && strcmp(text, "-2147483648") == 0 &&
+                  value_format_int(text, 0) == 1 && strcmp(text, "0") == 0;
+    
+    // Representación más corta
+    const float values[] = { 0.1f, 25.5f, -0.0f, 1e21f, 123456792.0f, 1e-7f, 1.4e-45f, 3.4028235e38f };
+    const char* texts[] = { "0.1", "25.5", "-0", "1e+21", "123456790", "1e-7", "1e-45", "3.4028235e+38" };
+    for (int i = 0; i < 8 && success; i++) {
+        success = value_format_float(text, values[i]) == (int)strlen(texts[i]) && strcmp(text, texts[i]) == 0;
+    }
+    success = success && value_format_float(text, INFINITY) == 3 && strcmp(text, "inf") == 0;
+    
+    // Cualquier FLOAT vuelve a leerse igual, y con decimales fijos coincide con printf
+    unsigned int seed = 12345;
+    for (int i = 0; i < 100000 && success; i++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int bits = seed ^ (seed << 13);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value)) continue;
+        
+        value_format_float(text, value);
+        success = strtof(text, NULL) == value;
+        
+        float scaled = (float)((int)(seed >> 8) - (1 << 23)) / 1000.0f;
+        int decimals = i % 7;
+        value_format_float_fixed(text, scaled, decimals);
+        snprintf(expected, sizeof(expected), "%.*f", decimals, scaled);
+        success = success && strcmp(text, expected) == 0;
+    }
+    
+    print_test_result("Formato de números", success);
+}
+
+// ============= PRUEBA DE LECTURA DE NÚMEROS =============
+
+void test_number_parsing(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de lectura de números\n" ANSI_COLOR_RESET);
+    
+    // Enteros: rango exacto de INT, ceros a la izquierda y texto que no es un número
+    int number = 0;
+    int success = value_parse_int("2147483647", 10, 0, &number) == VALUE_PARSE_OK && number == 2147483647 &&
+                  value_parse_int("2147483648", 10, 1, &number) == VALUE_PARSE_OK && number == -2147483647 - 1 &&
+                  value_parse_int("000000000000042", 15, 0, &number) == VALUE_PARSE_OK && number == 42 &&
+                  value_parse_int("2147483648", 10, 0, &number) == VALUE_PARSE_RANGE &&
+                  value_parse_int("12345678901", 11, 1, &number) == VALUE_PARSE_RANGE &&
+                  value_parse_int("1234567x", 8, 0, &number) == VALUE_PARSE_INVALID &&
+                  value_parse_int("", 0, 0, &number) == VALUE_PARSE_INVALID;
+    
+    // Decimales: exponentes, desbordamiento y formatos incorrectos
+    float real = 0.0f;
+    success = success &&
+              value_parse_float("25.5", 4, 0, &real) == VALUE_PARSE_OK && real == 25.5f &&
+              value_parse_float("1.5E-2", 6, 1, &real) == VALUE_PARSE_OK && real == -0.015f &&
+              value_parse_float("1e39", 4, 0, &real) == VALUE_PARSE_RANGE &&
+              value_parse_float("1e-50", 5, 0, &real) == VALUE_PARSE_OK && real == 0.0f &&
+              value_parse_float("1.2.3", 5, 0, &real) == VALUE_PARSE_INVALID &&
+              value_parse_float("1e", 2, 0, &real) == VALUE_PARSE_INVALID &&
+              value_parse_float(".", 1, 0, &real) == VALUE_PARSE_INVALID;
+    
+    // Cualquier decimal se redondea igual que strtof
+    char text[64];
+    unsigned int seed = 4321;
+    for (int i = 0; i < 100000 && success; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int length = 2 + (int)(seed >> 16) % 24;
+        for (int j = 0; j < length; j++) {
+            seed = seed * 1103515245u + 12345u;
+            text[j] = (char)('0' + (seed >> 16) % 10);
+        }
+        text[length / 2] = '.';
+        length += snprintf(text + length, sizeof(text) - length, "e%d", (int)(seed >> 8) % 80 - 40);
+        
+        float expected = strtof(text, NULL);
+        ValueParseStatus status = value_parse_float(text, length, 0, &real);
+        success = isinf(expected) ? status == VALUE_PARSE_RANGE : status == VALUE_PARSE_OK && real == expected;
+    }
+    
+    // Conversión desde texto con signo y booleanos
+    Value value;
+    success = success &&
+              string_to_value("-42", TYPE_INT, &value) == VALUE_PARSE_OK && value.int_val == -42 &&
+              string_to_value("+0.25", TYPE_FLOAT, &value) == VALUE_PARSE_OK && value.float_val == 0.25f &&
+              string_to_value("no", TYPE_BOOL, &value) == VALUE_PARSE_OK && value.bool_val == 0 &&
+              string_to_value("quizá", TYPE_BOOL, &value) == VALUE_PARSE_INVALID &&
+              string_to_value("42abc", TYPE_INT, &value) == VALUE_PARSE_INVALID;
+    
+    // Un literal fuera de rango es un error en vez de un valor cualquiera
+    Table* table = validator_find_table("usuarios", db);
+    int rows = table ? table->num_rows : -1;
+    ValidationResult* result = validator_create_result();
+    success = success && table &&
+              plan_cache_execute("INSERT INTO usuarios VALUES (99999999999, \"Max\", 30, TRUE)", db, result) != 0 &&
+              table->num_rows == rows &&
+              plan_cache_execute("SELECT nombre FROM usuarios WHERE id = -2147483648", db, result) == 0;
+    validator_free_result(result);
+    
+    print_test_result("Lectura de números", success);
+}
+
+// ============= PRUEBA DEL PLANIFICADOR =============
+
+// Suma de [start, end) que se divide en subtareas hasta tramos de 1000 números
+typedef struct {
+    long long start;
+    long long end;
+    long long sum;
+} SumTask;
+
+static void sum_task(void* arg) {
+    SumTask* task = (SumTask*)arg;
+    
+    if (task->end - task->start <= 1000) {
+        task->sum = 0;
+        for (long long i = task->start; i < task->end; i++) task->sum += i;
+        return;
+    }
+    
+    // Las subtareas van a la cola del hilo y los demás se las roban
+    long long mid = task->start + (task->end - task->start) / 2;
+    SumTask halves[2] = { { task->start, mid, 0 }, { mid, task->end, 0 } };
+    TaskGroup group;
+    task_group_init(&group);
+    scheduler_spawn(&group, sum_task, &halves[0]);
+    scheduler_spawn(&group, sum_task, &halves[1]);
+    scheduler_wait(&group);
+    task->sum = halves[0].sum + halves[1].sum;
+}
+
+void test_scheduler(void) {
+    printf(ANSI_COLOR_BLUE "Prueba del planificador\n" ANSI_COLOR_RESET);
+    
+    // Se fuerzan varios hilos para que haya robos aunque la máquina tenga un solo núcleo
+    scheduler_shutdown();
+    scheduler_configure(4, 0);
+    int success = scheduler_num_workers() == 4;
+    
+    // Tareas anidadas que esperan a sus subtareas desde dentro del planificador
+    SumTask task = { 0, 1000000, 0 };
+    TaskGroup group;
+    task_group_init(&group);
+    scheduler_spawn(&group, sum_task, &task);
+    scheduler_wait(&group);
+    success = success && task.sum == 1000000LL * 999999 / 2;
+    
+    // Un grupo sin tareas no espera
+    task_group_init(&group);
+    scheduler_wait(&group);
+    
+    // Tras detenerlo, el planificador vuelve a arrancar al lanzar otra tarea
+    scheduler_shutdown();
+    task.sum = 0;
+    task_group_init(&group);
+    scheduler_spawn(&group, sum_task, &task);
+    scheduler_wait(&group);
+    success = success && task.sum == 1000000LL * 999999 / 2;
+    
+    print_test_result("Planificador", success);
+}
+
+// ============= PRUEBA DE RECORRIDOS PARALELOS =============
+
+// Marca cada fila del morsel (para comprobar que ninguna se procesa dos veces)
+static void mark_morsel(void* ctx, int worker, int start, int end) {
+    int* visits = (int*)ctx;
+    (void)worker;
+    for (int i = start; i < end; i++) visits[i]++;
+}
+
+void test_parallel_scan(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de recorridos paralelos\n" ANSI_COLOR_RESET);
+    
+    // Cada fila se reparte exactamente una vez, incluido el último morsel incompleto
+    int num_rows = 10 * MORSEL_SIZE + 123;
+    int* visits = (int*)calloc(num_rows, sizeof(int));
+    parallel_for_morsels(num_rows, mark_morsel, visits);
+    int success = 1;
+    for (int i = 0; i < num_rows; i++) success = success && visits[i] == 1;
+    free(visits);
+    
+    // Tabla lo bastante grande para recorrerse en paralelo
+    Table* lecturas = table_create("lecturas");
+    table_add_column(lecturas, "id", TYPE_INT, 0, 1, 0);
+    table_add_column(lecturas, "sensor", TYPE_INT, 0, 0, 0);
+    table_add_column(lecturas, "valor", TYPE_INT, 0, 0, 0);
+    for (int i = 0; i < num_rows; i++) {
+        Value values[3];
+        values[0].int_val = i;
+        values[1].int_val = (i * 7 + 3) % 37;
+        values[2].int_val = (i * 13) % 1000 - 500;
+        table_add_row(lecturas, values);
+    }
+    for (int i = 0; i < num_rows; i += 101) table_delete_row(lecturas, i);
+    db->tables[db->num_tables++] = lecturas;
+    db->schema_version++;
+    
+    // Conteo con WHERE
+    int expected = 0;
+    for (int i = 0; i < num_rows; i++) {
+        expected += !lecturas->rows[i].is_deleted && lecturas->rows[i].values[1].int_val < 10;
+    }
+    ValidationResult* result = validator_create_result();
+    ASTNode* ast = NULL;
+    Plan* plan = compile_select_sql("SELECT * FROM lecturas WHERE sensor < 10", &ast, db, result);
+    success = success && plan && executor_count_rows(plan, NULL, 0, result) == expected;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    // Los agregados parciales de cada hilo se mezclan en el mismo resultado
+    // (y en el mismo orden de grupos) que el recorrido secuencial
+    plan = compile_select_sql("SELECT sensor, COUNT(*), SUM(valor), MIN(valor) FROM lecturas GROUP BY sensor",
+                              &ast, db, result);
+    int* rows = (int*)malloc(num_rows * sizeof(int));
+    int count = 0;
+    for (int i = 0; i < num_rows; i++) {
+        if (!lecturas->rows[i].is_deleted) rows[count++] = i;
+    }
+    Table* groups = plan ? aggregate_build(plan, rows, count, result) : NULL;
+    success = success && groups && groups->num_rows == 37;
+    for (int g = 0; success && g < groups->num_rows; g++) {
+        int sensor = groups->rows[g].values[0].int_val;
+        int group_count = 0, sum = 0, min = 0;
+        for (int i = 0; i < count; i++) {
+            const Value* values = lecturas->rows[rows[i]].values;
+            if (values[1].int_val != sensor) continue;
+            if (group_count == 0 || values[2].int_val < min) min = values[2].int_val;
+            sum += values[2].int_val;
+            group_count++;
+        }
+        // Las 37 primeras filas vivas tienen sensores distintos: el grupo g es el de la fila g
+        success = sensor == lecturas->rows[rows[g]].values[1].int_val &&
+                  groups->rows[g].values[1].int_val == group_count &&
+                  groups->rows[g].values[2].int_val == sum &&
+                  groups->rows[g].values[3].int_val == min;
+    }
+    table_free(groups);
+    free(rows);
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    
+    // Sentencias completas sobre la tabla grande
+    success = success &&
+              plan_cache_execute("SELECT id, valor FROM lecturas WHERE valor > 490 ORDER BY valor DESC, id LIMIT 5", db, result) == 0 &&
+              plan_cache_execute("SELECT COUNT(*), MAX(valor) FROM lecturas WHERE sensor = 4", db, result) == 0;
+    
+    print_test_result("Recorridos paralelos", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// ============= PRUEBA DE ACCESO CONCURRENTE =============
+
+// Inserta lotes de 10 filas en eventos
+static void* insert_events(void* arg) {
+    Database* db = (Database*)arg;
+    ValidationResult* result = validator_create_result();
+    int* failed = (int*)calloc(1, sizeof(int));
+    
+    for (int i = 0; i < 50; i++) {
+        *failed |= plan_cache_execute("INSERT INTO eventos VALUES (1, 1), (2, 2), (3, 3), (4, 4), (5, 5), "
+                                      "(6, 6), (7, 7), (8, 8), (9, 9), (10, 10)", db, result) != 0;
+    }
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+    return failed;
+}
+
+// Cuenta las filas de eventos mientras otros hilos insertan: cada lote se ve entero o no se ve
+static void* count_events(void* arg) {
+    Database* db = (Database*)arg;
+    ValidationResult* result = validator_create_result();
+    int* failed = (int*)calloc(1, sizeof(int));
+    ASTNode* ast = NULL;
+    
+    Plan* plan = compile_select_sql("SELECT * FROM eventos WHERE valor > 0", &ast, db, result);
+    int previous = 0;
+    for (int i = 0; plan && i < 100; i++) {
+        db_lock_read();
+        int count = executor_count_rows(plan, NULL, 0, result);
+        db_unlock();
+        
+        *failed |= count < previous || count % 10 != 0;
+        previous = count;
+    }
+    *failed |= !plan;
+    
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    validator_free_result(result);
+    return failed;
+}
+
+void test_concurrent_access(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de acceso concurrente\n" ANSI_COLOR_RESET);
+    
+    Table* eventos = table_create("eventos");
+    table_add_column(eventos, "id", TYPE_INT, 0, 0, 0);
+    table_add_column(eventos, "valor", TYPE_INT, 0, 0, 0);
+    db->tables[db->num_tables++] = eventos;
+    db->schema_version++;
+    
+    // Dos hilos insertan y dos leen a la vez sobre la misma tabla
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, i < 2 ? insert_events : count_events, db);
+    }
+    
+    int success = 1;
+    for (int i = 0; i < 4; i++) {
+        int* failed = NULL;
+        pthread_join(threads[i], (void**)&failed);
+        success = success && failed && !*failed;
+        free(failed);
+    }
+    success = success && eventos->num_rows == 2 * 50 * 10;
+    
+    // Un lector no espera a otro lector
+    table_lock_read(eventos);
+    success = success && pthread_rwlock_tryrdlock(&eventos->lock) == 0;
+    table_unlock(eventos);
+    success = success && pthread_rwlock_trywrlock(&eventos->lock) != 0;
+    table_unlock(eventos);
+    
+    print_test_result("Acceso concurrente", success);
+}
+
+// ============= PRUEBA DE VERSIONES DE FILAS (MVCC) =============
+
+// Suma la columna cantidad de las filas que ve la tabla o vista (cuenta las filas en count)
+static int sum_visible(const Table* table, int* count) {
+    int sum = 0;
+    *count = 0;
+    for (int i = 0; i < table->num_rows; i++) {
+        if (!table_row_visible(table, &table->rows[i])) continue;
+        sum += table->rows[i].values[1].int_val;
+        (*count)++;
+    }
+    return sum;
+}
+
+void test_mvcc(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de versiones de filas\n" ANSI_COLOR_RESET);
+    
+    Table* saldos = table_create("saldos");
+    table_add_column(saldos, "id", TYPE_INT, 0, 0, 0);
+    table_add_column(saldos, "cantidad", TYPE_INT, 0, 0, 0);
+    db->tables[db->num_tables++] = saldos;
+    db->schema_version++;
+    
+    ValidationResult* result = validator_create_result();
+    int success = plan_cache_execute("INSERT INTO saldos VALUES (1, 10), (2, 20), (3, 30), (4, 40), "
+                                     "(5, 50), (6, 60), (7, 70), (8, 80)", db, result) == 0;
+    
+    // Una lectura abierta antes de modificar la tabla sigue viendo las filas anteriores
+    RowVersion version;
+    Table view;
+    success = success && mvcc_begin_read(&version) == 0;
+    table_open_snapshot(saldos, &view, version, 0);
+    
+    success = success &&
+              plan_cache_execute("UPDATE saldos SET cantidad = cantidad + 100 WHERE id <= 4", db, result) == 0 &&
+              plan_cache_execute("DELETE FROM saldos WHERE id > 6", db, result) == 0;
+    
+    int count = 0;
+    success = success && sum_visible(&view, &count) == 360 && count == 8;
+    success = success && sum_visible(saldos, &count) == 610 && count == 6;
+    
+    // Las versiones sustituidas se guardan mientras la lectura siga abierta
+    success = success && saldos->num_rows == 12 && saldos->num_dead == 6;
+    
+    table_close_snapshot(saldos);
+    mvcc_end_read(version);
+    
+    // Una sentencia que falla a mitad no cambia nada; al terminar, sin lecturas
+    // abiertas, se liberan las versiones muertas
+    success = success &&
+              plan_cache_execute("UPDATE saldos SET cantidad = 100 / (id - 5)", db, result) != 0 &&
+              sum_visible(saldos, &count) == 610 && count == 6 &&
+              saldos->num_rows == 6 && saldos->num_dead == 0;
+    
+    success = success &&
+              plan_cache_execute("DELETE FROM saldos WHERE id = 6", db, result) == 0 &&
+              sum_visible(saldos, &count) == 550 && count == 5;
+    
+    print_test_result("Versiones de filas", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// ============= PRUEBA DE ROWID =============
+
+// Filas de una consulta contadas por el ejecutor (-1 si no compila o falla)
+static int count_where(const char* sql, Database* db) {
+    ValidationResult* result = validator_create_result();
+    ASTNode* ast = NULL;
+    Plan* plan = compile_select_sql(sql, &ast, db, result);
+    int count = plan ? executor_count_rows(plan, NULL, 0, result) : -1;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    validator_free_result(result);
+    return count;
+}
+
+void test_rowid(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de rowid\n" ANSI_COLOR_RESET);
+    
+    Table* turnos = table_create("turnos");
+    table_add_column(turnos, "id", TYPE_INT, 0, 0, 0);
+    table_add_column(turnos, "cantidad", TYPE_INT, 0, 0, 0);
+    db->tables[db->num_tables++] = turnos;
+    db->schema_version++;
+    
+    // La fila actualizada pasa al final y la siguiente ocupa el rowid 0, aunque la
+    // versión anterior siga en la tabla para las lecturas abiertas
+    RowVersion version;
+    ValidationResult* result = validator_create_result();
+    int count = 0;
+    int success = plan_cache_execute("INSERT INTO turnos VALUES (1, 10), (2, 20), (3, 30), "
+                                     "(4, 40), (5, 50), (6, 60)", db, result) == 0 &&
+                  mvcc_begin_read(&version) == 0 &&
+                  plan_cache_execute("UPDATE turnos SET id = 100 WHERE rowid = 0", db, result) == 0 &&
+                  count_where("SELECT * FROM turnos WHERE rowid = 5 AND id = 100", db) == 1 &&
+                  plan_cache_execute("DELETE FROM turnos WHERE rowid = 0", db, result) == 0 &&
+                  sum_visible(turnos, &count) == 190 && count == 5 &&
+                  count_where("SELECT * FROM turnos WHERE rowid >= 0 AND rowid < 5", db) == 5;
+    mvcc_end_read(version);
+    
+    // Una asignación con rowid recibe la posición de la fila entre las visibles
+    success = success &&
+              plan_cache_execute("UPDATE turnos SET cantidad = rowid WHERE id > 3", db, result) == 0 &&
+              sum_visible(turnos, &count) == 30 + 1 + 2 + 3 + 4 && count == 5;
+    
+    // En una tabla grande cada morsel empieza por el rowid que le toca
+    Table* lecturas = validator_find_table("lecturas", db);
+    int visible = 0;
+    for (int i = 0; lecturas && i < lecturas->num_rows; i++) visible += !lecturas->rows[i].is_deleted;
+    success = success && lecturas && lecturas->num_rows >= PARALLEL_MIN_ROWS &&
+              count_where("SELECT * FROM lecturas WHERE rowid < 5000", db) == 5000 &&
+              count_where("SELECT * FROM lecturas WHERE rowid >= 5000", db) == visible - 5000;
+    
+    print_test_result("rowid", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// ============= PRUEBA DE TRANSACCIONES =============
+
+// Intenta tomar el catálogo en exclusiva desde otro hilo, como haría otra sesión
+static void* try_schema_lock(void* arg) {
+    int* locked = (int*)arg;
+    *locked = db_lock_write_timeout(50);
+    if (*locked == 0) db_unlock();
+    return NULL;
+}
+
+void test_transactions(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de transacciones\n" ANSI_COLOR_RESET);
+    
+    Table* saldos = validator_find_table("saldos", db);
+    ValidationResult* result = validator_create_result();
+    int count = 0;
+    int before = sum_visible(saldos, &count);
+    
+    // Los cambios de la transacción solo los ve ella hasta COMMIT
+    int success = plan_cache_execute("BEGIN", db, result) == 0 && transaction_active() &&
+                  plan_cache_execute("INSERT INTO saldos VALUES (20, 1000)", db, result) == 0 &&
+                  plan_cache_execute("UPDATE saldos SET cantidad = cantidad - 10 WHERE id = 20", db, result) == 0 &&
+                  plan_cache_execute("DELETE FROM saldos WHERE id = 1", db, result) == 0;
+    
+    RowVersion version;
+    Table view;
+    success = success && mvcc_begin_read(&version) == 0;
+    table_open_snapshot(saldos, &view, version, 0);
+    success = success && sum_visible(&view, &count) == before && count == 5;
+    table_close_snapshot(saldos);
+    table_open_snapshot(saldos, &view, version, transaction_current_write());
+    success = success && sum_visible(&view, &count) == before + 990 - 110 && count == 5;
+    table_close_snapshot(saldos);
+    mvcc_end_read(version);
+    
+    // Una sentencia que falla no cierra la transacción ni deshace las anteriores
+    success = success &&
+              plan_cache_execute("UPDATE saldos SET cantidad = 1 / (id - 20)", db, result) != 0 &&
+              transaction_active() &&
+              plan_cache_execute("BEGIN", db, result) != 0 &&
+              plan_cache_execute("COMMIT", db, result) == 0 && !transaction_active() &&
+              sum_visible(saldos, &count) == before + 990 - 110 && count == 5;
+    
+    // ROLLBACK deja la tabla como estaba
+    int rows = saldos->num_rows;
+    before = sum_visible(saldos, &count);
+    success = success &&
+              plan_cache_execute("BEGIN TRANSACTION", db, result) == 0 &&
+              plan_cache_execute("INSERT INTO saldos VALUES (21, 1), (22, 2)", db, result) == 0 &&
+              plan_cache_execute("UPDATE saldos SET cantidad = 0", db, result) == 0 &&
+              plan_cache_execute("DELETE FROM saldos WHERE id = 21", db, result) == 0 &&
+              plan_cache_execute("ROLLBACK", db, result) == 0 &&
+              saldos->num_rows == rows && sum_visible(saldos, &count) == before && count == 5;
+    
+    success = success &&
+              plan_cache_execute("COMMIT", db, result) != 0 &&
+              plan_cache_execute("ROLLBACK", db, result) != 0;
+    
+    // Un cambio de esquema no espera indefinidamente a una transacción abierta
+    pthread_t thread;
+    int locked = 0;
+    success = success && plan_cache_execute("BEGIN", db, result) == 0 &&
+              pthread_create(&thread, NULL, try_schema_lock, &locked) == 0 &&
+              pthread_join(thread, NULL) == 0 && locked == -1 &&
+              plan_cache_execute("ROLLBACK", db, result) == 0 &&
+              pthread_create(&thread, NULL, try_schema_lock, &locked) == 0 &&
+              pthread_join(thread, NULL) == 0 && locked == 0;
+    
+    print_test_result("Transacciones", success);
+    
+    validator_free_result(result);
+    plan_cache_cleanup();
+}
+
+// Conexiones que solo esperan mientras otras trabajan en la prueba del servidor
+#define SERVER_TEST_IDLE 100
+
+// Inactividad tras la que el servidor de la prueba deshace una transacción
+#define SERVER_TEST_IDLE_TIMEOUT_MS 2000
+
+// Lee la respuesta a una sentencia y guarda su salida (estado devuelto por el servidor, -1 si falló el protocolo)
+static int server_response(int fd, char* output, size_t size) {
+    size_t used = 0;
+    output[0] = '\0';
+    while (1) {
+        char type;
+        char* data;
+        size_t length;
+        if (protocol_read_message(fd, &type, &data, &length) != 0) return -1;
+        
+        if (type == PROTOCOL_DONE) {
+            int status = length == 1 ? data[0] : -1;
+            free(data);
+            return status;
+        }
+        if (type == PROTOCOL_DATA && used + length < size) {
+            memcpy(output + used, data, length + 1);
+            used += length;
+        }
+        free(data);
+    }
+}
+
+// Conecta con el servidor de pruebas, esperando a que empiece a escuchar (-1 si no se pudo)
+static int server_connect(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    
+    for (int attempt = 0; attempt < 200; attempt++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) return fd;
+        close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+// Envía una sentencia al servidor y espera su respuesta
+static int server_query(int fd, const char* sql, char* output, size_t size) {
+    if (protocol_send_query(fd, sql) != 0) return -1;
+    return server_response(fd, output, size);
+}
+
+static void* server_thread(void* arg) {
+    server_run((ServerConfig*)arg);
+    return NULL;
+}
+
+void test_server(void) {
+    printf(ANSI_COLOR_BLUE "Prueba del servidor\n" ANSI_COLOR_RESET);
+    
+    db_init();
+    cmd_registry_init();
+    
+    // Dos hilos de trabajo para muchas más conexiones
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/nql_test_%d.sock", (int)getpid());
+    ServerConfig config = {path, 0, 2, SERVER_TEST_IDLE_TIMEOUT_MS};
+    pthread_t thread;
+    pthread_create(&thread, NULL, server_thread, &config);
+    
+    int first = server_connect(path);
+    int second = server_connect(path);
+    int idle[SERVER_TEST_IDLE];
+    int success = first >= 0 && second >= 0;
+    for (int i = 0; i < SERVER_TEST_IDLE; i++) {
+        idle[i] = server_connect(path);
+        if (idle[i] < 0) success = 0;
+    }
+    
+    char output[8192];
+    success = success &&
+              server_query(first, "CREATE TABLE remota", output, sizeof(output)) == 0 &&
+              server_query(first, "ALTER TABLE remota ADD COLUMN id INT", output, sizeof(output)) == 0 &&
+              server_query(first, "INSERT INTO remota VALUES (1), (2)", output, sizeof(output)) == 0 &&
+              strstr(output, "2 filas insertadas") != NULL;
+    
+    // Los cambios de una transacción no los ve el otro cliente hasta COMMIT
+    success = success &&
+              server_query(first, "BEGIN", output, sizeof(output)) == 0 &&
+              server_query(first, "INSERT INTO remota VALUES (3)", output, sizeof(output)) == 0 &&
+              server_query(second, "COUNT FROM remota", output, sizeof(output)) == 0 &&
+              strstr(output, "registros en remota: 2") != NULL;
+    
+    // La transacción abierta saca su hilo del grupo: aunque otra escritura espere por
+    // la tabla, queda un hilo libre que atiende enseguida a las demás conexiones
+    success = success && protocol_send_query(second, "DELETE FROM remota WHERE id = 99") == 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < SERVER_TEST_IDLE && success; i++) {
+        success = server_query(idle[i], "COUNT FROM remota", output, sizeof(output)) == 0 &&
+                  strstr(output, "registros en remota: 2") != NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    success = success && end.tv_sec - start.tv_sec < 2;
+    
+    success = success &&
+              server_query(first, "COMMIT", output, sizeof(output)) == 0 &&
+              server_response(second, output, sizeof(output)) == 0 &&
+              server_query(second, "SELECT * FROM remota WHERE id = 3", output, sizeof(output)) == 0 &&
+              strstr(output, "1 fila en total") != NULL;
+    
+    // El formato de los resultados es de cada conexión
+    success = success &&
+              server_query(idle[0], "\\format csv", output, sizeof(output)) == 0 &&
+              server_query(idle[0], "SELECT * FROM remota WHERE id = 3", output, sizeof(output)) == 0 &&
+              strcmp(output, "id\n3\n") == 0 &&
+              server_query(idle[1], "SELECT * FROM remota WHERE id = 3", output, sizeof(output)) == 0 &&
+              strstr(output, "1 fila en total") != NULL;
+    
+    // Los errores llegan al cliente con su mensaje y la conexión sigue abierta
+    success = success &&
+              server_query(second, "SELECT * FROM inexistente", output, sizeof(output)) == 1 &&
+              strstr(output, "Error") != NULL &&
+              server_query(second, "COMMIT", output, sizeof(output)) == 1 &&
+              server_query(second, "COUNT FROM remota", output, sizeof(output)) == 0;
+    
+    // Un cliente que se va con una transacción abierta la deja deshecha y suelta la tabla
+    success = success &&
+              server_query(second, "BEGIN", output, sizeof(output)) == 0 &&
+              server_query(second, "DELETE FROM remota", output, sizeof(output)) == 0;
+    close(second);
+    
+    success = success &&
+              server_query(first, "INSERT INTO remota VALUES (4)", output, sizeof(output)) == 0 &&
+              server_query(first, "COUNT FROM remota", output, sizeof(output)) == 0 &&
+              strstr(output, "registros en remota: 4") != NULL;
+    
+    // Sentencias enviadas sin esperar respuesta: se responden en orden y los INSERT
+    // seguidos se añaden con una sola escritura (uno erróneo solo falla él)
+    RowVersion version = mvcc_current_version();
+    char sql[100];
+    for (int i = 0; i < 41 && success; i++) {
+        if (i == 20) snprintf(sql, sizeof(sql), "INSERT INTO remota VALUES ('x')");
+        else snprintf(sql, sizeof(sql), "INSERT INTO remota VALUES (%d)", 100 + i);
+        success = protocol_send_query(first, sql) == 0;
+    }
+    success = success && protocol_send_query(first, "COUNT FROM remota") == 0;
+    for (int i = 0; i < 41 && success; i++) {
+        if (i == 20) {
+            success = server_response(first, output, sizeof(output)) == 1 && strstr(output, "Error") != NULL;
+        } else {
+            success = server_response(first, output, sizeof(output)) == 0 &&
+                      strcmp(output, "1 fila insertada en remota\n") == 0;
+        }
+    }
+    success = success &&
+              server_response(first, output, sizeof(output)) == 0 &&
+              strstr(output, "registros en remota: 44") != NULL &&
+              mvcc_current_version() - version <= 3;
+    
+    // Una transacción inactiva demasiado tiempo se deshace y el servidor cierra la conexión
+    success = success &&
+              server_query(idle[2], "BEGIN", output, sizeof(output)) == 0 &&
+              server_query(idle[2], "DELETE FROM remota", output, sizeof(output)) == 0;
+    usleep((SERVER_TEST_IDLE_TIMEOUT_MS + 500) * 1000);
+    success = success &&
+              server_response(idle[2], output, sizeof(output)) == -1 && strstr(output, "inactiva") != NULL &&
+              server_query(first, "COUNT FROM remota", output, sizeof(output)) == 0 &&
+              strstr(output, "registros en remota: 44") != NULL;
+    
+    // Al parar se cierran las conexiones que quedan
+    server_stop();
+    pthread_join(thread, NULL);
+    success = success && server_query(first, "COUNT FROM remota", output, sizeof(output)) == -1 &&
+              access(path, F_OK) != 0;
+    
+    close(first);
+    for (int i = 0; i < SERVER_TEST_IDLE; i++) {
+        if (idle[i] >= 0) close(idle[i]);
+    }
+    
+    print_test_result("Servidor", success);
+    
+    cmd_registry_cleanup();
+    db_cleanup();
 }
 
 // ============= FUNCIÓN PRINCIPAL =============
 
+// ============= PRUEBA DE SCRIPTS =============
+
+// Sentencias que batch_split pasa al manejador de la prueba
+typedef struct {
+    int count;
+    size_t longest;
+    int multiline;             // Sentencias que ocupan varias líneas
+} SplitCounts;
+
+static int count_statement(void* ctx, const CommandEntry* entry, const char* text, size_t length) {
+    SplitCounts* counts = (SplitCounts*)ctx;
+    (void)entry;
+    counts->count++;
+    if (length > counts->longest) counts->longest = length;
+    if (memchr(text, '\n', length)) counts->multiline++;
+    return 0;
+}
+
+void test_batch_script(void) {
+    printf(ANSI_COLOR_BLUE "Prueba de scripts\n" ANSI_COLOR_RESET);
+    
+    // El ';' de una cadena o de un comentario no termina la sentencia
+    const char* text = "SELECT \"a;b\" -- c;\n/* ; */ FROM t; X";
+    LexerScan scan = {LEXER_SCAN_CODE, 0};
+    size_t end = lexer_scan_statement(text, strlen(text), &scan);
+    int success = end == strlen(text) - 3 && scan.has_tokens && scan.state == LEXER_SCAN_CODE;
+    
+    // Una cadena abierta sigue en el texto siguiente
+    scan.has_tokens = 0;
+    success = success && lexer_scan_statement("x = \"uno;", 10, &scan) == 10 &&
+              scan.state == LEXER_SCAN_STRING &&
+              lexer_scan_statement("dos\";", 5, &scan) == 4 && scan.state == LEXER_SCAN_CODE;
+    
+    // Script con sentencias de varias líneas, varias por línea y sin ';'
+    const char* script =
+        "-- carga\n"
+        "CREATE TABLE lote\n"
+        "ALTER TABLE lote ADD COLUMN id INT\n"
+        "ALTER TABLE lote ADD COLUMN texto STRING(30)\n"
+        "INSERT INTO lote VALUES (1, \"a;b\"); INSERT INTO lote VALUES (2, \"c\")\n"
+        "INSERT INTO lote\n"
+        "  VALUES (3, \"d\");\n"
+        "SELECT * FROM nada;\n"
+        "exit\n"
+        "INSERT INTO lote VALUES (4, \"no se ejecuta\");\n";
+    int fds[2];
+    success = success && pipe(fds) == 0;
+    if (success) {
+        success = write(fds[1], script, strlen(script)) == (ssize_t)strlen(script);
+        close(fds[1]);
+        
+        char* output = NULL;
+        size_t size = 0;
+        FILE* capture = open_memstream(&output, &size);
+        FILE* previous = output_redirect(capture);
+        
+        // La consulta sobre una tabla que no existe hace fallar el script
+        success = success && batch_run(fds[0]) == -1;
+        close(fds[0]);
+        
+        output_redirect(previous);
+        fclose(capture);
+        free(output);
+        
+        Table* table = validator_find_table("lote", db_get_database());
+        success = success && table && table->num_rows == 3;
+    }
+    
+    // batch_split pasa las sentencias sin ejecutarlas, con líneas de cualquier longitud
+    FILE* file = tmpfile();
+    SplitCounts counts = {0, 0, 0};
+    success = success && file;
+    if (file) {
+        fputs("SELECT * FROM lote WHERE texto = \"", file);
+        for (int i = 0; i < 100000; i++) fputc('x', file);
+        fputs("\"; SELECT\n  * FROM lote;\nexit\nSELECT * FROM lote;\n", file);
+        fflush(file);
+        rewind(file);
+        success = success && batch_split(fileno(file), count_statement, &counts) == 0 &&
+                  counts.count == 2 && counts.longest > 100000 && counts.multiline == 1;
+        fclose(file);
+    }
+    
+    print_test_result("Scripts", success);
+}
+
+// Cuenta las apariciones de un texto
+static int count_occurrences(const char* text, const char* needle) {
+    int count = 0;
+    for (const char* found = strstr(text, needle); found; found = strstr(found + 1, needle)) count++;
+    return count;
+}
+
+void test_script_parser(void) {
+    printf(ANSI_COLOR_BLUE "Prueba del analizador de scripts\n" ANSI_COLOR_RESET);
+    
+    // Un error de sintaxis solo afecta a su sentencia; los ';' sobrantes no cuentan
+    ParsedScript* script = parser_parse_script(
+        "INSERT INTO lote VALUES (10, \"x\");;\n"
+        "INSERT INTO lote VALUES (11 \"y\");\n"
+        "SELECT * FROM lote WHERE id = ?; insert into lote values (12, \"z;\"), (13, \"w\")");
+    int success = script && script->count == 4 &&
+                  script->statements[0].stmt && script->statements[0].stmt->type == NODE_INSERT_STMT &&
+                  !script->statements[1].stmt && script->statements[1].error &&
+                  script->statements[2].stmt && script->statements[2].num_params == 1 &&
+                  script->statements[3].stmt && script->statements[3].stmt->in_arena &&
+                  ((InsertStmtData*)script->statements[3].stmt->data)->num_rows == 2;
+    
+    // Los nodos de la arena se liberan con el script, no con ast_free_node
+    if (script) ast_free_node(script->statements[0].stmt);
+    parser_free_script(script);
+    
+    // Fuera del script los nodos vuelven a reservarse con malloc
+    ASTNode* literal = ast_create_literal_int(1);
+    success = success && literal && !literal->in_arena;
+    ast_free_node(literal);
+    
+    // Los INSERT consecutivos se agrupan; los que fallan se informan uno a uno
+    Table* table = validator_find_table("lote", db_get_database());
+    int rows = table ? table->num_rows : 0;
+    script = parser_parse_script(
+        "INSERT INTO lote VALUES (20, \"a\"); INSERT INTO lote VALUES (21, \"b\");\n"
+        "INSERT INTO lote VALUES (22, \"c\"), (23, \"d\"); INSERT INTO nada VALUES (1);\n"
+        "INSERT INTO lote VALUES (\"e\", 24); INSERT INTO lote VALUES (25 \"f\");\n"
+        "SELECT COUNT(*) FROM lote; INSERT INTO lote VALUES (26, \"g\"); INSERT INTO lote VALUES (NULL, \"h\")");
+    
+    char* output = NULL;
+    size_t size = 0;
+    FILE* capture = open_memstream(&output, &size);
+    FILE* previous = output_redirect(capture);
+    success = success && table && script && script_execute(script, db_get_database()) == -1;
+    output_redirect(previous);
+    fclose(capture);
+    
+    success = success && table->num_rows == rows + 6 &&
+              count_occurrences(output, "Error:") == 3 &&
+              count_occurrences(output, "insertada") == 5;
+    free(output);
+    parser_free_script(script);
+    
+    print_test_result("Analizador de scripts", success);
+}
+
+static void spin_task(void* arg) {
+    (void)arg;
+    for (volatile int i = 0; i < 1000000; i++) {}
+}
+
+void test_statement_timing(void) {
+    printf(ANSI_COLOR_BLUE "Prueba de \\timing\n" ANSI_COLOR_RESET);
+    
+    // Sin medición activada las fases no hacen nada
+    StatementTiming timing;
+    timing_begin();
+    int success = timing_enter(TIMING_PARSE) == TIMING_INACTIVE && timing_end(&timing) == -1;
+    
+    // Una fase anidada no cuenta en la exterior
+    timing_set_enabled(1);
+    timing_begin();
+    int outer = timing_enter(TIMING_EXECUTE);
+    int inner = timing_enter(TIMING_OUTPUT);
+    for (volatile int i = 0; i < 1000000; i++) {}
+    timing_leave(inner);
+    timing_leave(outer);
+    success = success && outer == -1 && inner == TIMING_EXECUTE && timing_end(&timing) == 0 &&
+              timing.phase_wall[TIMING_OUTPUT] > 0 &&
+              timing.phase_wall[TIMING_OUTPUT] + timing.phase_wall[TIMING_EXECUTE] <= timing.wall;
+
+    // La CPU de una tarea del planificador cuenta una vez, la ejecute el hilo que sea
+    timing_begin();
+    outer = timing_enter(TIMING_EXECUTE);
+    TaskGroup group;
+    task_group_init(&group);
+    scheduler_spawn(&group, spin_task, NULL);
+    scheduler_wait(&group);
+    long long task_cpu = atomic_load(&group.cpu_ns);
+    timing_add_cpu(task_cpu);
+    timing_leave(outer);
+    success = success && timing_end(&timing) == 0 && task_cpu > 0 &&
+              timing.phase_cpu[TIMING_EXECUTE] >= task_cpu && timing.cpu >= task_cpu;
+    timing_set_enabled(0);
+    
+    // \timing on escribe los tiempos de cada sentencia
+    char* output = NULL;
+    size_t size = 0;
+    FILE* capture = open_memstream(&output, &size);
+    FILE* previous = output_redirect(capture);
+    char* on[] = {"on"};
+    char* off[] = {"off"};
+    success = success && cmd_execute_input("\\timing", "\\timing on", on, 1) == 0 && timing_is_enabled();
+    success = success && cmd_execute_input("SELECT", "SELECT * FROM lote WHERE id < 3", NULL, 0) == 0;
+    success = success && cmd_execute_input("\\timing", "\\timing off", off, 1) == 0 && !timing_is_enabled();
+    success = success && cmd_execute_input("SELECT", "SELECT * FROM lote", NULL, 0) == 0;
+    output_redirect(previous);
+    fclose(capture);
+    
+    success = success && count_occurrences(output, "Tiempo:") == 1 &&
+              strstr(output, "léxico:") && strstr(output, "validación:") && strstr(output, "salida:");
+    free(output);
+    
+    print_test_result("Medición de tiempos", success);
+}
+
+void test_explain(Database* db) {
+    printf(ANSI_COLOR_BLUE "Prueba de EXPLAIN\n" ANSI_COLOR_RESET);
+    
+    // EXPLAIN solo admite sentencias SELECT, INSERT, UPDATE y DELETE
+    Parser* parser = parser_create("EXPLAIN ANALYZE SELECT * FROM lote WHERE id = ?");
+    ASTNode* node = parser_parse(parser);
+    ExplainStmtData* data = node && node->type == NODE_EXPLAIN_STMT ? (ExplainStmtData*)node->data : NULL;
+    int success = data && data->analyze && data->num_params == 1 &&
+                  data->statement && data->statement->type == NODE_SELECT_STMT;
+    if (node) ast_free_node(node);
+    parser_free(parser);
+    
+    parser = parser_create("EXPLAIN CREATE TABLE x");
+    node = parser_parse(parser);
+    success = success && !node && parser_has_error(parser);
+    parser_free(parser);
+    
+    // El plan de un JOIN sin ejecutarlo y con EXPLAIN ANALYZE, que no escribe el resultado
+    char* output = NULL;
+    size_t size = 0;
+    FILE* capture = open_memstream(&output, &size);
+    FILE* previous = output_redirect(capture);
+    
+    ValidationResult* result = validator_create_result();
+    ASTNode* ast = NULL;
+    Plan* plan = compile_select_sql("SELECT nombre, total FROM usuarios JOIN pedidos ON usuarios.id = usuario "
+                                    "WHERE total > 3 ORDER BY total DESC LIMIT 2", &ast, db, result);
+    success = success && plan && executor_explain(plan, NULL, 0, 0, result) == 0 &&
+              executor_explain(plan, NULL, 0, 1, result) == 0;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    validator_free_result(result);
+    
+    // EXPLAIN ANALYZE de una escritura la aplica; EXPLAIN solo la describe
+    Table* table = validator_find_table("lote", db_get_database());
+    int rows = table ? table->num_rows : 0;
+    success = success && table &&
+              cmd_execute_input("EXPLAIN", "EXPLAIN DELETE FROM lote WHERE id > 0", NULL, 0) == 0 &&
+              cmd_execute_input("EXPLAIN", "EXPLAIN ANALYZE INSERT INTO lote VALUES (30, \"e\")", NULL, 0) == 0 &&
+              table->num_rows == rows + 1 &&
+              cmd_execute_input("EXPLAIN", "EXPLAIN SELECT * FROM nada", NULL, 0) == -1;
+    
+    output_redirect(previous);
+    fclose(capture);
+    
+    success = success && count_occurrences(output, "Hash join de usuarios y pedidos") == 2 &&
+              count_occurrences(output, "-> Recorrido secuencial de usuarios (") == 2 &&
+              count_occurrences(output, "-> Recorrido secuencial de pedidos (") == 2 &&
+              count_occurrences(output, "Filtro: clave usuario no nula") == 2 &&
+              count_occurrences(output, "Hilos: 1 (dentro del JOIN)") == 4 &&
+              count_occurrences(output, "Filtro: (total > 3)") == 2 &&
+              count_occurrences(output, "Top-N secuencial del resultado del JOIN (k = 2)  (filas: 2") == 1 &&
+              count_occurrences(output, "Tiempo de ejecución:") == 2 &&
+              strstr(output, "Borrado en lote\n") && strstr(output, "Filtro: (id > 0)") &&
+              strstr(output, "Inserción en lote  (filas: 1,") && !strstr(output, "filas en total");
+    free(output);
+    
+    print_test_result("EXPLAIN", success);
+}
+
+// Filas que se estiman para el WHERE de una consulta (-2 si no compila)
+static long long estimate_where(const char* sql, Database* db) {
+    ValidationResult* result = validator_create_result();
+    ASTNode* ast = NULL;
+    Plan* plan = compile_select_sql(sql, &ast, db, result);
+    long long estimate = plan ? analyze_estimate_rows(plan->table, plan->condition) : -2;
+    executor_free_plan(plan);
+    if (ast) ast_free_node(ast);
+    validator_free_result(result);
+    return estimate;
+}
+
+void test_analyze() {
+    printf(ANSI_COLOR_BLUE "Prueba de ANALYZE\n" ANSI_COLOR_RESET);
+    
+    // ANALYZE trabaja sobre el catálogo global. id único, grupo con 7 valores y NULL
+    // en una de cada 10 filas, valor con 100.
+    Database* db = db_get_database();
+    int num_rows = 2000;
+    Table* medidas = db_create_table("medidas");
+    if (!medidas) {
+        print_test_result("ANALYZE", 0);
+        return;
+    }
+    db_add_column(medidas, "id", TYPE_INT, 0, 1, 0);
+    db_add_column(medidas, "grupo", TYPE_STRING, 8, 0, 1);
+    db_add_column(medidas, "valor", TYPE_FLOAT, 0, 0, 0);
+    for (int i = 0; i < num_rows; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "g%d", i % 7);
+        Value values[3];
+        values[0].int_val = i;
+        values[1].string_val = i % 10 == 0 ? NULL : name;
+        values[2].float_val = (float)(i % 100) / 4;
+        table_add_row(medidas, values);
+    }
+    
+    // Sin ANALYZE no hay estimaciones
+    int success = analyze_estimate_rows(medidas, NULL) == -1;
+    
+    char* output = NULL;
+    size_t size = 0;
+    FILE* capture = open_memstream(&output, &size);
+    FILE* previous = output_redirect(capture);
+    
+    char* args[] = { "medidas" };
+    char* missing[] = { "nada" };
+    success = success && cmd_execute_input("ANALYZE", "ANALYZE medidas", args, 1) == 0 &&
+              cmd_execute_input("ANALYZE", "ANALYZE nada", missing, 1) == -1;
+    
+    // Dentro de una transacción no se pueden sustituir las estadísticas
+    const TableStats* before = medidas->stats;
+    success = success && cmd_execute_input("BEGIN", "BEGIN", NULL, 0) == 0 &&
+              cmd_execute_input("ANALYZE", "ANALYZE medidas", args, 1) == -1 &&
+              cmd_execute_input("ROLLBACK", "ROLLBACK", NULL, 0) == 0 &&
+              !transaction_active() && medidas->stats == before;
+    
+    const TableStats* stats = medidas->stats;
+    const ColumnStats* id = stats_get_column(stats, 0);
+    const ColumnStats* grupo = stats_get_column(stats, 1);
+    const ColumnStats* valor = stats_get_column(stats, 2);
+    success = success && stats && stats->num_rows == num_rows && id && grupo && valor;
+    
+    // Mínimo, máximo e histograma de igual profundidad en orden
+    success = success && id->has_bounds && id->min.int_val == 0 && id->max.int_val == num_rows - 1 &&
+              id->num_buckets == STATS_HISTOGRAM_BUCKETS && id->bounds[0].int_val == 0 &&
+              id->bounds[id->num_buckets].int_val == num_rows - 1;
+    for (int b = 0; success && b < id->num_buckets; b++) {
+        success = id->bounds[b].int_val <= id->bounds[b + 1].int_val;
+    }
+    
+    // Nulos y valores distintos (HyperLogLog es casi exacto con pocos valores)
+    success = success && id->null_fraction == 0 && grupo->num_nulls == num_rows / 10 &&
+              fabs(grupo->null_fraction - 0.1) < 1e-9 && grupo->num_distinct == 7 &&
+              strcmp(grupo->min.string_val, "g0") == 0 && strcmp(grupo->max.string_val, "g6") == 0 &&
+              llabs(id->num_distinct - num_rows) <= num_rows / 20 &&
+              valor->num_distinct >= 95 && valor->num_distinct <= 105;
+    
+    // Estimaciones: rango por el histograma, igualdad por los distintos, fuera del
+    // rango al menos una fila
+    long long range = estimate_where("SELECT * FROM medidas WHERE id < 500", db);
+    long long equal = estimate_where("SELECT * FROM medidas WHERE grupo = \"g3\"", db);
+    long long both = estimate_where("SELECT * FROM medidas WHERE 500 > id AND grupo = \"g3\"", db);
+    success = success && range >= 450 && range <= 550 && equal >= 240 && equal <= 275 &&
+              both >= 55 && both <= 75 &&
+              estimate_where("SELECT * FROM medidas WHERE id > 5000", db) == 1 &&
+              estimate_where("SELECT * FROM medidas", db) == num_rows;
+    
+    // EXPLAIN muestra la estimación del recorrido
+    success = success && cmd_execute_input("EXPLAIN", "EXPLAIN SELECT * FROM medidas WHERE id < 500", NULL, 0) == 0;
+    
+    // Las columnas añadidas después no tienen estadísticas
+    success = success && db_add_column(medidas, "extra", TYPE_INT, 0, 0, 1) == 0 &&
+              stats_get_column(medidas->stats, 3) == NULL;
+    
+    output_redirect(previous);
+    fclose(capture);
+    
+    success = success && strstr(output, "Tabla analizada: medidas (2000 filas)") &&
+              strstr(output, "Error: No se puede usar ANALYZE dentro de una transacción") &&
+              strstr(output, "| grupo      |  10.00% |         7 | g0           | g6           |") &&
+              strstr(output, "Error: Tabla 'nada' no encontrada.") &&
+              strstr(output, "Filas estimadas: ") && strstr(output, " de 2000 (según ANALYZE)");
+    free(output);
+    
+    print_test_result("ANALYZE", success);
+}
+
 int main() {
     printf(ANSI_COLOR_YELLOW "=== PRUEBAS DEL ANALIZADOR SQL ===\n" ANSI_COLOR_RESET);
     
@@ -406,9 +2098,83 @@ int main() {
     test_validator_with_manual_ast(db);
     print_separator();
     
+    test_validator_resolves_columns(db);
+    print_separator();
+    
+    test_prepared_statements(db);
+    print_separator();
+    
+    test_plan_cache(db);
+    print_separator();
+    
+    test_multi_row_insert(db);
+    print_separator();
+    
+    test_aggregates(db);
+    print_separator();
+    
+    test_order_limit(db);
+    print_separator();
+    
+    test_join(db);
+    print_separator();
+    
+    test_result_output(db);
+    print_separator();
+    
+    test_output_formats();
+    print_separator();
+    
+    test_number_formatting();
+    print_separator();
+    
+    test_number_parsing(db);
+    print_separator();
+    
+    test_scheduler();
+    print_separator();
+    
+    test_parallel_scan(db);
+    print_separator();
+    
+    test_concurrent_access(db);
+    print_separator();
+    
+    test_mvcc(db);
+    print_separator();
+    
+    test_rowid(db);
+    print_separator();
+    
+    test_transactions(db);
+    print_separator();
+    
+    test_server();
+    print_separator();
+    
+    test_batch_script();
+    print_separator();
+    
+    test_script_parser();
+    print_separator();
+    
+    test_statement_timing();
+    print_separator();
+    
+    test_explain(db);
+    print_separator();
+    
+    test_analyze();
+    print_separator();
+    
     // Liberar recursos
     free_test_database(db);
+    scheduler_shutdown();
     
     printf(ANSI_COLOR_YELLOW "=== PRUEBAS COMPLETADAS ===\n" ANSI_COLOR_RESET);
-    return 0;
+    if (tests_failed > 0) {
+        printf(ANSI_COLOR_RED "%d prueba%s fallida%s\n" ANSI_COLOR_RESET, tests_failed,
+               tests_failed == 1 ? "" : "s", tests_failed == 1 ? "" : "s");
+    }
+    return tests_failed ? 1 : 0;
 }
\ No newline at end of file
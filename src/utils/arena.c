@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include "arena.h"
+
+// Alineación suficiente para cualquier tipo
+#define ARENA_ALIGN alignof(max_align_t)
+
+struct ArenaBlock {
+    ArenaBlock *previous;
+    size_t used;
+    size_t capacity;
+    alignas(max_align_t) unsigned char data[];
+};
+
+Arena *arena_create(size_t block_size) {
+    Arena *arena = (Arena *)malloc(sizeof(Arena));
+    if (!arena) return NULL;
+
+    arena->blocks = NULL;
+    arena->block_size = block_size > 0 ? block_size : ARENA_BLOCK_SIZE;
+    return arena;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    if (!arena) return NULL;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (size == 0) size = ARENA_ALIGN;
+
+    ArenaBlock *block = arena->blocks;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > arena->block_size ? size : arena->block_size;
+        ArenaBlock *grown = (ArenaBlock *)malloc(sizeof(ArenaBlock) + capacity);
+        if (!grown) return NULL;
+
+        grown->used = 0;
+        grown->capacity = capacity;
+
+        // Un bloque propio de una petición grande no sustituye al actual, que aún tiene sitio
+        if (block && capacity > arena->block_size) {
+            grown->previous = block->previous;
+            block->previous = grown;
+            grown->used = size;
+            return grown->data;
+        }
+
+        grown->previous = block;
+        arena->blocks = grown;
+        block = grown;
+    }
+
+    void *memory = block->data + block->used;
+    block->used += size;
+    return memory;
+}
+
+char *arena_strdup(Arena *arena, const char *text) {
+    if (!text) return NULL;
+
+    size_t length = strlen(text) + 1;
+    char *copy = (char *)arena_alloc(arena, length);
+    if (copy) memcpy(copy, text, length);
+    return copy;
+}
+
+void arena_free(Arena *arena) {
+    if (!arena) return;
+
+    ArenaBlock *block = arena->blocks;
+    while (block) {
+        ArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    free(arena);
+}
@@ -0,0 +1,48 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Tamaño por defecto de cada bloque de una arena
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+// Bloque de memoria de una arena (las reservas se toman de data una tras otra)
+typedef struct ArenaBlock ArenaBlock;
+
+// Arena: reservas rápidas que se liberan todas juntas
+typedef struct Arena {
+    ArenaBlock *blocks;     // Bloque actual, enlazado con los anteriores
+    size_t block_size;      // Tamaño de los bloques nuevos
+} Arena;
+
+/**
+ * Crea una arena vacía (el primer bloque se reserva con la primera petición)
+ * @param block_size Tamaño de cada bloque (0 para ARENA_BLOCK_SIZE)
+ * @return Arena, o NULL si falta memoria
+ */
+Arena *arena_create(size_t block_size);
+
+/**
+ * Reserva memoria alineada para cualquier tipo. Las peticiones mayores que un
+ * bloque reciben un bloque propio.
+ * @param arena Arena de la que se reserva
+ * @param size Bytes a reservar
+ * @return Memoria sin inicializar, o NULL si falta memoria
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Copia una cadena en la arena
+ * @param arena Arena de la que se reserva
+ * @param text Cadena a copiar
+ * @return Copia, o NULL si falta memoria
+ */
+char *arena_strdup(Arena *arena, const char *text);
+
+/**
+ * Libera la arena y todo lo que se reservó en ella
+ * @param arena Arena a liberar (puede ser NULL)
+ */
+void arena_free(Arena *arena);
+
+#endif /* ARENA_H */
@@ -0,0 +1,24 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include "output.h"
+
+// Salida del hilo actual (NULL: stdout)
+static __thread FILE *current_stream = NULL;
+
+FILE *output_stream(void) {
+    return current_stream ? current_stream : stdout;
+}
+
+FILE *output_redirect(FILE *stream) {
+    FILE *previous = current_stream;
+    current_stream = stream;
+    return previous;
+}
+
+int output_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int written = vfprintf(output_stream(), format, args);
+    va_end(args);
+    return written;
+}
@@ -0,0 +1,27 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+
+/**
+ * Flujo al que se escriben los resultados y mensajes de los comandos en el hilo
+ * actual (stdout si no se ha redirigido)
+ * @return Flujo de salida
+ */
+FILE *output_stream(void);
+
+/**
+ * Redirige la salida del hilo actual, por ejemplo a la conexión de un cliente
+ * @param stream Nuevo flujo (NULL para volver a stdout)
+ * @return Flujo anterior (NULL si era stdout)
+ */
+FILE *output_redirect(FILE *stream);
+
+/**
+ * printf sobre el flujo de salida del hilo actual
+ * @param format Formato de printf
+ * @return Número de caracteres escritos, o negativo si hubo error
+ */
+int output_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+#endif /* OUTPUT_H */
@@ -0,0 +1,339 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "scheduler.h"
+
+// Capacidad inicial de cada cola de tareas
+#define QUEUE_INITIAL_CAPACITY 64
+
+typedef struct {
+    TaskFunc func;
+    void *arg;
+    TaskGroup *group;
+} Task;
+
+// Cola doble de tareas (buffer circular). El hilo dueño mete y saca por el final
+// (lo último que lanzó, aún en caché) y los demás roban por el principio.
+typedef struct {
+    pthread_mutex_t lock;
+    Task *tasks;
+    int capacity;
+    int head;               // Posición de la primera tarea
+    int count;
+} TaskQueue;
+
+// Cola de cada hilo del planificador; la cola 0 es la compartida por los hilos ajenos
+static TaskQueue queues[SCHEDULER_MAX_WORKERS];
+static pthread_once_t queues_once = PTHREAD_ONCE_INIT;
+
+// Los hilos sin trabajo duermen en sched_cond hasta que haya tareas en cola,
+// termine un grupo o se detenga el planificador
+static pthread_mutex_t sched_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sched_cond = PTHREAD_COND_INITIALIZER;
+static atomic_int sched_queued;             // Tareas en las colas
+static int sched_stopping = 0;
+
+// Arranque y parada de los hilos
+static pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int sched_started;
+static atomic_int sched_num_threads;        // Hilos creados (colas 1 .. sched_num_threads)
+static pthread_t sched_threads[SCHEDULER_MAX_WORKERS];
+static int sched_pin = 0;
+
+// Configuración (-1: tomarla del entorno)
+static int configured_workers = -1;
+static int configured_pin = -1;
+
+// Cola del hilo actual (0 si no es un hilo del planificador)
+static __thread int current_queue = 0;
+static __thread unsigned int steal_seed = 0;
+static __thread int task_depth = 0;             // Tareas anidadas en curso en este hilo
+static __thread long long task_cpu_ns = 0;      // CPU gastada por este hilo en tareas
+
+/**
+ * Colas de tareas
+ */
+
+static void queues_init(void) {
+    for (int i = 0; i < SCHEDULER_MAX_WORKERS; i++) {
+        pthread_mutex_init(&queues[i].lock, NULL);
+    }
+}
+
+// Duplica la capacidad de la cola (con su lock tomado)
+static int queue_grow(TaskQueue *queue) {
+    int capacity = queue->capacity == 0 ? QUEUE_INITIAL_CAPACITY : queue->capacity * 2;
+    Task *tasks = (Task *)malloc(capacity * sizeof(Task));
+    if (!tasks) return -1;
+
+    for (int i = 0; i < queue->count; i++) {
+        tasks[i] = queue->tasks[(queue->head + i) % queue->capacity];
+    }
+
+    free(queue->tasks);
+    queue->tasks = tasks;
+    queue->capacity = capacity;
+    queue->head = 0;
+    return 0;
+}
+
+static int queue_push(TaskQueue *queue, Task task) {
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->count == queue->capacity && queue_grow(queue) != 0) {
+        pthread_mutex_unlock(&queue->lock);
+        return -1;
+    }
+
+    queue->tasks[(queue->head + queue->count) % queue->capacity] = task;
+    queue->count++;
+    atomic_fetch_add(&sched_queued, 1);
+
+    pthread_mutex_unlock(&queue->lock);
+    return 0;
+}
+
+// Saca una tarea por el principio (from_front) o por el final (1 si había alguna)
+static int queue_pop(TaskQueue *queue, int from_front, Task *task) {
+    int found = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count > 0) {
+        int pos = from_front ? queue->head : (queue->head + queue->count - 1) % queue->capacity;
+        *task = queue->tasks[pos];
+        if (from_front) queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        atomic_fetch_sub(&sched_queued, 1);
+        found = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+// Busca trabajo: la cola propia, la compartida y por último las de otros hilos
+static int find_task(Task *task) {
+    if (atomic_load(&sched_queued) <= 0) return 0;
+
+    if (current_queue > 0 && queue_pop(&queues[current_queue], 0, task)) return 1;
+    if (queue_pop(&queues[0], 1, task)) return 1;
+
+    int num_threads = atomic_load(&sched_num_threads);
+    if (num_threads == 0) return 0;
+
+    // Empezar por una víctima al azar para no robar todos a la misma
+    steal_seed = steal_seed * 1103515245u + 12345u;
+    int first = (int)((steal_seed >> 16) % (unsigned int)num_threads);
+    for (int i = 0; i < num_threads; i++) {
+        int victim = 1 + (first + i) % num_threads;
+        if (victim != current_queue && queue_pop(&queues[victim], 1, task)) return 1;
+    }
+
+    return 0;
+}
+
+static long long thread_cpu_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void run_task(Task task) {
+    // Solo se mide la tarea más externa: las que ejecuta mientras espera ya cuentan en ella
+    int outermost = task_depth++ == 0;
+    long long start = outermost ? thread_cpu_ns() : 0;
+
+    task.func(task.arg);
+
+    task_depth--;
+    if (outermost) {
+        long long spent = thread_cpu_ns() - start;
+        task_cpu_ns += spent;
+        atomic_fetch_add(&task.group->cpu_ns, spent);
+    }
+
+    // Al terminar la última tarea del grupo se despierta a quien lo espera
+    if (atomic_fetch_sub(&task.group->pending, 1) == 1) {
+        pthread_mutex_lock(&sched_lock);
+        pthread_cond_broadcast(&sched_cond);
+        pthread_mutex_unlock(&sched_lock);
+    }
+}
+
+/**
+ * Hilos del planificador
+ */
+
+// Ancla el hilo a una CPU, repartiendo los hilos por orden de CPU
+static void pin_thread(int index) {
+#ifdef __linux__
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+static void *worker_main(void *arg) {
+    current_queue = (int)(intptr_t)arg;
+    steal_seed = (unsigned int)current_queue * 2654435761u;
+
+    if (sched_pin) pin_thread(current_queue);
+
+    while (1) {
+        Task task;
+        if (find_task(&task)) {
+            run_task(task);
+            continue;
+        }
+
+        pthread_mutex_lock(&sched_lock);
+        while (!sched_stopping && atomic_load(&sched_queued) <= 0) {
+            pthread_cond_wait(&sched_cond, &sched_lock);
+        }
+        int stopping = sched_stopping;
+        pthread_mutex_unlock(&sched_lock);
+
+        if (stopping) break;
+    }
+
+    return NULL;
+}
+
+// Crea los hilos la primera vez que se lanza una tarea
+static void scheduler_start(void) {
+    pthread_once(&queues_once, queues_init);
+    if (atomic_load(&sched_started)) return;
+
+    pthread_mutex_lock(&start_lock);
+    if (!atomic_load(&sched_started)) {
+        int workers = scheduler_num_workers();
+
+        if (configured_pin >= 0) {
+            sched_pin = configured_pin;
+        } else {
+            const char *pin = getenv("NQL_PIN_THREADS");
+            sched_pin = pin && atoi(pin) > 0;
+        }
+
+        // El hilo que espera a sus tareas también trabaja, así que se crea uno menos.
+        // Si no se pueden crear todos, se trabaja con los que haya.
+        for (int i = 1; i < workers; i++) {
+            if (pthread_create(&sched_threads[i - 1], NULL, worker_main, (void *)(intptr_t)i) != 0) break;
+            atomic_fetch_add(&sched_num_threads, 1);
+        }
+
+        atomic_store(&sched_started, 1);
+    }
+    pthread_mutex_unlock(&start_lock);
+}
+
+/**
+ * API
+ */
+
+void scheduler_configure(int num_workers, int pin_threads) {
+    pthread_mutex_lock(&start_lock);
+    configured_workers = num_workers > 0 ? num_workers : -1;
+    configured_pin = pin_threads ? 1 : 0;
+    pthread_mutex_unlock(&start_lock);
+}
+
+int scheduler_num_workers(void) {
+    long workers = configured_workers;
+
+    if (workers <= 0) {
+        const char *env = getenv("NQL_THREADS");
+        workers = env ? atoi(env) : 0;
+    }
+    if (workers <= 0) workers = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (workers < 1) return 1;
+    return workers > SCHEDULER_MAX_WORKERS ? SCHEDULER_MAX_WORKERS : (int)workers;
+}
+
+void task_group_init(TaskGroup *group) {
+    atomic_init(&group->pending, 0);
+    atomic_init(&group->cpu_ns, 0);
+}
+
+void scheduler_spawn(TaskGroup *group, TaskFunc func, void *arg) {
+    Task task;
+    task.func = func;
+    task.arg = arg;
+    task.group = group;
+
+    scheduler_start();
+    atomic_fetch_add(&group->pending, 1);
+
+    if (queue_push(&queues[current_queue], task) != 0) {
+        run_task(task);
+        return;
+    }
+
+    pthread_mutex_lock(&sched_lock);
+    pthread_cond_signal(&sched_cond);
+    pthread_mutex_unlock(&sched_lock);
+}
+
+void scheduler_wait(TaskGroup *group) {
+    while (atomic_load(&group->pending) > 0) {
+        Task task;
+        if (find_task(&task)) {
+            run_task(task);
+            continue;
+        }
+
+        // Las tareas que faltan se están ejecutando en otros hilos
+        pthread_mutex_lock(&sched_lock);
+        while (atomic_load(&group->pending) > 0 && atomic_load(&sched_queued) <= 0) {
+            pthread_cond_wait(&sched_cond, &sched_lock);
+        }
+        pthread_mutex_unlock(&sched_lock);
+    }
+}
+
+long long scheduler_task_cpu(void) {
+    return task_cpu_ns;
+}
+
+void scheduler_shutdown(void) {
+    pthread_mutex_lock(&start_lock);
+
+    if (atomic_load(&sched_started)) {
+        pthread_mutex_lock(&sched_lock);
+        sched_stopping = 1;
+        pthread_cond_broadcast(&sched_cond);
+        pthread_mutex_unlock(&sched_lock);
+
+        int num_threads = atomic_load(&sched_num_threads);
+        for (int i = 0; i < num_threads; i++) {
+            pthread_join(sched_threads[i], NULL);
+        }
+
+        for (int i = 0; i < SCHEDULER_MAX_WORKERS; i++) {
+            free(queues[i].tasks);
+            queues[i].tasks = NULL;
+            queues[i].capacity = 0;
+            queues[i].head = 0;
+            queues[i].count = 0;
+        }
+
+        sched_stopping = 0;
+        atomic_store(&sched_num_threads, 0);
+        atomic_store(&sched_started, 0);
+    }
+
+    pthread_mutex_unlock(&start_lock);
+}
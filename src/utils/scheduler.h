@@ -0,0 +1,69 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdatomic.h>
+
+// Máximo de hilos que pueden trabajar a la vez (incluido el que espera a sus tareas)
+#define SCHEDULER_MAX_WORKERS 64
+
+// Tarea del planificador
+typedef void (*TaskFunc)(void *arg);
+
+// Grupo de tareas por cuya finalización se puede esperar
+typedef struct {
+    atomic_int pending;     // Tareas lanzadas que aún no han terminado
+    atomic_llong cpu_ns;    // CPU gastada en las tareas del grupo, las ejecute quien las ejecute
+} TaskGroup;
+
+/**
+ * Fija el número de hilos y si se anclan a una CPU. Se aplica la próxima vez
+ * que se arranquen los hilos (al lanzar la primera tarea o tras scheduler_shutdown).
+ * Por defecto se usan las variables de entorno NQL_THREADS y NQL_PIN_THREADS.
+ * @param num_workers Hilos que trabajan a la vez (0 para uno por núcleo)
+ * @param pin_threads 1 para anclar cada hilo a una CPU
+ */
+void scheduler_configure(int num_workers, int pin_threads);
+
+/**
+ * Número de hilos que pueden trabajar a la vez, contando al que espera
+ * @return Entre 1 y SCHEDULER_MAX_WORKERS
+ */
+int scheduler_num_workers(void);
+
+/**
+ * Prepara un grupo de tareas vacío
+ * @param group Grupo a inicializar
+ */
+void task_group_init(TaskGroup *group);
+
+/**
+ * Lanza una tarea. Desde un hilo del planificador va a su propia cola y desde
+ * cualquier otro hilo a la cola compartida; los hilos sin trabajo roban tareas
+ * de las colas de los demás. Si falta memoria la tarea se ejecuta en el acto.
+ * @param group Grupo al que pertenece la tarea
+ * @param func Función a ejecutar
+ * @param arg Argumento de la función
+ */
+void scheduler_spawn(TaskGroup *group, TaskFunc func, void *arg);
+
+/**
+ * Espera a que terminen todas las tareas del grupo. Mientras tanto el hilo
+ * ejecuta tareas pendientes, así que se puede esperar desde dentro de una tarea.
+ * @param group Grupo a esperar
+ */
+void scheduler_wait(TaskGroup *group);
+
+/**
+ * CPU que el hilo actual ha gastado ejecutando tareas (de cualquier grupo).
+ * Sirve para no contarla dos veces al medir el trabajo propio del hilo.
+ * @return Nanosegundos desde que arrancó el hilo
+ */
+long long scheduler_task_cpu(void);
+
+/**
+ * Detiene los hilos del planificador (se vuelven a crear si hacen falta).
+ * No debe haber tareas en curso.
+ */
+void scheduler_shutdown(void);
+
+#endif /* SCHEDULER_H */
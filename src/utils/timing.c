@@ -0,0 +1,108 @@
+#include <string.h>
+#include <time.h>
+#include "timing.h"
+#include "output.h"
+#include "scheduler.h"
+
+// Estado de la medición del hilo actual
+static __thread int enabled = 0;
+static __thread int active = 0;               // Hay una sentencia en curso
+static __thread int current = -1;             // Fase en curso (-1: ninguna)
+static __thread struct timespec start_wall, last_wall;
+static __thread long long start_cpu, last_cpu;
+static __thread long long added_cpu;          // CPU de otros hilos sumada con timing_add_cpu
+static __thread StatementTiming measured;
+
+static const char *phase_names[TIMING_NUM_PHASES] = {
+    "léxico", "análisis", "validación", "ejecución", "salida"
+};
+
+static long long elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (long long)(to->tv_sec - from->tv_sec) * 1000000000LL + (to->tv_nsec - from->tv_nsec);
+}
+
+// CPU del hilo sin la de las tareas que ejecuta, que se suman al grupo que las lanzó
+static long long thread_cpu_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec - scheduler_task_cpu();
+}
+
+// Suma a la fase en curso el tiempo transcurrido desde el último cambio de fase
+static void timing_charge(void) {
+    struct timespec now_wall;
+    clock_gettime(CLOCK_MONOTONIC, &now_wall);
+    long long now_cpu = thread_cpu_ns();
+
+    if (current >= 0) {
+        measured.phase_wall[current] += elapsed_ns(&last_wall, &now_wall);
+        measured.phase_cpu[current] += now_cpu - last_cpu;
+    }
+    last_wall = now_wall;
+    last_cpu = now_cpu;
+}
+
+void timing_set_enabled(int value) {
+    enabled = value ? 1 : 0;
+}
+
+int timing_is_enabled(void) {
+    return enabled;
+}
+
+void timing_begin(void) {
+    if (!enabled) return;
+
+    memset(&measured, 0, sizeof(measured));
+    current = -1;
+    active = 1;
+    added_cpu = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start_wall);
+    start_cpu = thread_cpu_ns();
+    last_wall = start_wall;
+    last_cpu = start_cpu;
+}
+
+int timing_end(StatementTiming *timing) {
+    if (!active) return -1;
+
+    timing_charge();
+    measured.wall = elapsed_ns(&start_wall, &last_wall);
+    measured.cpu = last_cpu - start_cpu + added_cpu;
+    active = 0;
+    current = -1;
+
+    if (timing) *timing = measured;
+    return 0;
+}
+
+int timing_enter(TimingPhase phase) {
+    if (!active) return TIMING_INACTIVE;
+
+    timing_charge();
+    int previous = current;
+    current = phase;
+    return previous;
+}
+
+void timing_leave(int mark) {
+    if (mark == TIMING_INACTIVE || !active) return;
+
+    timing_charge();
+    current = mark;
+}
+
+void timing_add_cpu(long long ns) {
+    if (!active) return;
+
+    added_cpu += ns;
+    if (current >= 0) measured.phase_cpu[current] += ns;
+}
+
+void timing_print(const StatementTiming *timing) {
+    output_printf("Tiempo: %.3f ms (CPU %.3f ms)\n", timing->wall / 1e6, timing->cpu / 1e6);
+    for (int i = 0; i < TIMING_NUM_PHASES; i++) {
+        output_printf("  %s: %.3f ms (CPU %.3f ms)\n", phase_names[i],
+                      timing->phase_wall[i] / 1e6, timing->phase_cpu[i] / 1e6);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+// Fases en las que se reparte el tiempo de una sentencia
+typedef enum {
+    TIMING_LEX,          // Normalización del texto para la caché de planes (lexer)
+    TIMING_PARSE,        // Análisis sintáctico (parser, con los tokens que lee)
+    TIMING_VALIDATE,     // Validación y compilación del plan
+    TIMING_EXECUTE,      // Ejecución del plan, sin la escritura del resultado
+    TIMING_OUTPUT,       // Escritura de las filas del resultado
+    TIMING_NUM_PHASES
+} TimingPhase;
+
+// Tiempos de una sentencia en nanosegundos. El de CPU es el del hilo que la ejecuta más
+// el de las tareas del planificador lanzadas para ella (puede superar al tiempo real).
+typedef struct {
+    long long wall;
+    long long cpu;
+    long long phase_wall[TIMING_NUM_PHASES];
+    long long phase_cpu[TIMING_NUM_PHASES];
+} StatementTiming;
+
+// Valor de timing_enter cuando no se está midiendo ninguna sentencia
+#define TIMING_INACTIVE -2
+
+/**
+ * Activa o desactiva la medición de tiempos de las sentencias del hilo actual
+ * @param enabled 1 para activarla
+ */
+void timing_set_enabled(int enabled);
+
+/**
+ * Indica si el hilo actual mide el tiempo de sus sentencias
+ * @return 1 si está activada
+ */
+int timing_is_enabled(void);
+
+/**
+ * Empieza a medir una sentencia (no hace nada si la medición está desactivada)
+ */
+void timing_begin(void);
+
+/**
+ * Termina de medir la sentencia en curso
+ * @param timing Tiempos medidos
+ * @return 0 si había una sentencia en curso, -1 si no
+ */
+int timing_end(StatementTiming *timing);
+
+/**
+ * Pasa a contar el tiempo en una fase hasta timing_leave. Las fases se pueden anidar:
+ * el tiempo de la interior no se cuenta en la exterior. Una sola lectura de los
+ * relojes por cambio de fase; no hace nada si no hay una sentencia en curso.
+ * @param phase Fase que empieza
+ * @return Marca que hay que pasar a timing_leave
+ */
+int timing_enter(TimingPhase phase);
+
+/**
+ * Vuelve a la fase que había antes del timing_enter correspondiente
+ * @param mark Valor devuelto por timing_enter
+ */
+void timing_leave(int mark);
+
+/**
+ * Suma a la fase en curso la CPU que otros hilos han gastado para la sentencia
+ * (no hace nada si no hay una sentencia en curso)
+ * @param ns Nanosegundos de CPU
+ */
+void timing_add_cpu(long long ns);
+
+/**
+ * Escribe los tiempos de una sentencia en la salida del hilo actual
+ * @param timing Tiempos a escribir
+ */
+void timing_print(const StatementTiming *timing);
+
+#endif /* TIMING_H */